@@ -111,6 +111,15 @@ typedef int (*ACL_AIO_TIMEO_FN)(ACL_ASTREAM *astream, void *context);
  */
 typedef int (*ACL_AIO_CLOSE_FN)(ACL_ASTREAM *astream, void *context);
 
+/**
+ * 첽дд͵Խˮλˮλʱصûעĺ
+ * @param astream {ACL_ASTREAM*} 첽ָ
+ * @param context {void*} ûݵĲ
+ * @param high {int}  0 ʾﵽˮλ0 ʾѻˮλ
+ * @return {int} ú -1 رո첽
+ */
+typedef int (*ACL_AIO_WATER_FN)(ACL_ASTREAM *astream, void *context, int high);
+
 /* 첽Ͷ */
 
 struct ACL_ASTREAM {
@@ -126,6 +135,7 @@ struct ACL_ASTREAM {
 #define	ACL_AIO_FLAG_ISWR           (1 << 2)
 #define ACL_AIO_FLAG_DELAY_CLOSE    (1 << 3)
 #define ACL_AIO_FLAG_DEAD           (1 << 4)
+#define ACL_AIO_FLAG_HIGH_WATER     (1 << 5)
 
 	ACL_FIFO write_fifo;	/**< 첽дʱȽȳ */
 	int   write_left;	/**< дδд */
@@ -161,6 +171,16 @@ struct ACL_ASTREAM {
 
 	/* ɶʱĻص */
 	void (*event_read_callback)(int event_type, ACL_ASTREAM *astream);
+
+	int   cork_limit;	/**< дϲģʽ͵ֵ0 ʾδ */
+	ACL_RING cork_entry;	/**< 첽ܴͶеλ */
+
+	int   write_low;	/**< деĵˮλ */
+	int   write_high;	/**< деĸˮλ0 ʾδ */
+	int   write_limit;	/**< деޣʱر0 ʾ */
+	int   write_peak;	/**< ддʷֵ */
+	ACL_AIO_WATER_FN water_fn;	/**< дˮλص */
+	void *water_ctx;		/**< water_fn Ĳ֮һ */
 };
 
 /**
@@ -677,6 +697,68 @@ ACL_API void acl_aio_writen(ACL_ASTREAM *astream, const char *data, int dlen);
 ACL_API void acl_aio_writev(ACL_ASTREAM *astream,
 		const struct iovec *vector, int count);
 
+/**
+ * 첽дϲ(cork)ģʽacl_aio_writen/acl_aio_writev/
+ * acl_aio_fprintf д׷дУ¼ѭʱ
+ * ( acl_aio_loop )ͨһ writev ͳһͣдеﵽ
+ * limit ʱͣдɻصϺűãرдϲ
+ * رʱȷдδ͵ݣACL_EVENT_WMSG ģʽ֧
+ * set the cork mode of the stream, the data written will be appended to
+ * the write queue and be sent by one writev at the end of the current
+ * event loop, or be sent at once when the queued data reaches limit
+ * @param astream {ACL_ASTREAM*} 첽
+ * @param limit {int} ͵ֵ<= 0 ʱʾرдϲģʽ
+ */
+ACL_API void acl_aio_set_cork(ACL_ASTREAM *astream, int limit);
+
+/**
+ * 첽дϲģʽֵ
+ * @param astream {ACL_ASTREAM*} 첽
+ * @return {int}  0 ʾδдϲģʽ
+ */
+ACL_API int acl_aio_get_cork(ACL_ASTREAM *astream);
+
+/**
+ * 첽деĸߵˮλˮλصдд͵ﵽ
+ * high ʱص water_fn(astream, context, 1)ʱӦÿͣд(
+ * ͣȡ)֮󵱴 low ʱص
+ * water_fn(astream, context, 0)ӦÿɻָдݣλصǳɶԽ
+ * set the low and high watermarks of the write queue, water_fn will be
+ * called with high = 1 when the queued data reaches high, and be called
+ * with high = 0 when the queued data drops to low or below
+ * @param astream {ACL_ASTREAM*} 첽
+ * @param low {int} ˮλС 0 ʱȡ 0
+ * @param high {int} ˮλ<= 0  water_fn Ϊ NULL ʱȡˮλص
+ * @param water_fn {ACL_AIO_WATER_FN} ˮλص
+ * @param context {void*} water_fn Ĳ֮һ
+ */
+ACL_API void acl_aio_set_water(ACL_ASTREAM *astream, int low, int high,
+		ACL_AIO_WATER_FN water_fn, void *context);
+
+/**
+ * 첽ддޣֵʱ(Զ˳ʱ䲻)
+ * ֱӹرո첽Էֹڴ
+ * set the hard limit of the write queue, the stream will be closed when
+ * the queued data exceeds the limit
+ * @param astream {ACL_ASTREAM*} 첽
+ * @param limit {int} <= 0 ʱʾ
+ */
+ACL_API void acl_aio_set_write_limit(ACL_ASTREAM *astream, int limit);
+
+/**
+ * 첽дδ͵
+ * @param astream {ACL_ASTREAM*} 첽
+ * @return {int}
+ */
+ACL_API int acl_aio_write_left(ACL_ASTREAM *astream);
+
+/**
+ * 첽ддʷֵ
+ * @param astream {ACL_ASTREAM*} 첽
+ * @return {int}
+ */
+ACL_API int acl_aio_write_peak(ACL_ASTREAM *astream);
+
 /**
  * Ըʽʽ첽д, дʱдɹʱ¼֪ͨ
  * @param astream {ACL_ASTREAM*} дص
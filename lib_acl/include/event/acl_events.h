@@ -164,6 +164,143 @@ ACL_API void acl_event_set_fire_hook(ACL_EVENT *eventp,
  */
 ACL_API void acl_event_set_check_inter(ACL_EVENT *eventp, int n);
 
+/**
+ * ں¼(epoll)ǷñԵʽÿֽ״α
+ * ʱעһζд¼֮Ķдصֹ޸û̬־λ
+ * ٵ epoll_ctlӶٳϵϵͳôԲˮƽ
+ * ʽκ֮ǰã ACL_EVENT_KERNEL  epoll 
+ * ЧעԵʽڶܷжںǷ
+ * ݣԲԶ˶( SSL)
+ * set the epoll engine in edge-triggered mode, each descriptor will be
+ * registered only once, and enabling or disabling the read/write events
+ * will only change the user space flags without calling epoll_ctl
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param onoff {int}  0 ʾԵʽ
+ */
+ACL_API void acl_event_set_edge_trigger(ACL_EVENT *eventp, int onoff);
+
+/**
+ * ں¼(epoll)ؼʱǷʹ EPOLLEXCLUSIVE ־λ
+ * ̵̻߳¼ͬһʱԱӵʱ
+ * е¼(Ⱥ)Ҫ Linux 4.5 ϰ汾
+ * use EPOLLEXCLUSIVE for the listening descriptors shared by several
+ * event engines to avoid the thundering herd
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param onoff {int}  0 ʾ
+ */
+ACL_API void acl_event_set_listen_exclusive(ACL_EVENT *eventp, int onoff);
+
+/**
+ * ¼ͳϢĿǰ ACL_EVENT_KERNEL ͳ
+ * the statistics of the event engine
+ */
+typedef struct ACL_EVENT_STAT {
+	acl_uint64 nctl;	/**< ޸ں¼( epoll_ctl)Ĵ */
+	acl_uint64 nwait;	/**< ȴں¼( epoll_wait)Ĵ */
+	acl_uint64 nevents;	/**< ں˷صľ¼ */
+	int   nslots;		/**< ǰÿεȴɷص¼ */
+} ACL_EVENT_STAT;
+
+/**
+ * ¼ͳϢ
+ * get the statistics of the event engine
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param stat {ACL_EVENT_STAT*} Ž, Ϊ
+ */
+ACL_API void acl_event_get_stat(ACL_EVENT *eventp, ACL_EVENT_STAT *stat);
+
+/**
+ * ¼ͳƼ
+ * reset the counters of the event engine
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ */
+ACL_API void acl_event_reset_stat(ACL_EVENT *eventp);
+
+/**
+ * ¼ѭܷõֱͼ 0 ͰͳֵΪ 0  i (i > 0) Ͱ
+ * ͳֵλ [2^(i-1), 2^i) һͰͳи
+ * the log2 histogram used by the event loop profiler
+ */
+#define	ACL_EVENT_HIST_BUCKETS	32
+
+typedef struct ACL_EVENT_HIST {
+	acl_uint64 count;	/**<  */
+	acl_uint64 sum;		/**< ֵ֮ */
+	acl_uint64 max;		/**< ֵ */
+	acl_uint64 buckets[ACL_EVENT_HIST_BUCKETS];
+} ACL_EVENT_HIST;
+
+/**
+ * ¼ѭܷʱ䵥λΪ΢
+ * the profile of the event loop, the time unit is microsecond
+ */
+typedef struct ACL_EVENT_PROFILE {
+	ACL_EVENT_HIST loop;		/**< ÿ¼ѭгȴĴʱ */
+	ACL_EVENT_HIST callback;	/**< ÿζдʱصĺʱ */
+	ACL_EVENT_HIST timer_lag;	/**< ʱʵʴԤʱĲֵ */
+	ACL_EVENT_HIST nready;		/**< ÿεȴʱصľ¼ */
+} ACL_EVENT_PROFILE;
+
+/**
+ * ر¼ѭܷͳÿѭĴʱÿص
+ * ĺʱ(صֱַͳ)ʱĴӳټÿεȴص
+ * ¼ڶλ¼ѭص̵ֵ֧߳ select/poll/
+ * kernel ¼棬رʱͷеͳƽ
+ * enable or disable the profiler of the event loop, which is used to find
+ * the slow callbacks blocking the event loop
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param onoff {int}  0 ʾ
+ */
+ACL_API void acl_event_set_profile(ACL_EVENT *eventp, int onoff);
+
+/**
+ * صһĶıǩͳƽʱڴ溯ַ
+ * set a readable tag for the callback which is used in the dumped result
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param callback {const void*} дʱصĵַ
+ * @param tag {const char*} ǩǿ
+ */
+ACL_API void acl_event_profile_tag(ACL_EVENT *eventp,
+		const void *callback, const char *tag);
+
+/**
+ * ¼ѭܷ
+ * get the profile of the event loop
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param out {ACL_EVENT_PROFILE*} Ž, Ϊ
+ * @return {int} δܷʱ -1
+ */
+ACL_API int acl_event_profile_get(ACL_EVENT *eventp, ACL_EVENT_PROFILE *out);
+
+/**
+ * ¼ѭܷ
+ * reset the profile of the event loop
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ */
+ACL_API void acl_event_profile_reset(ACL_EVENT *eventp);
+
+/**
+ * ¼ѭܷıʽиصܺʱӴС
+ * У max 
+ * dump the profile of the event loop as text
+ * @param eventp {ACL_EVENT*} ¼ָ, Ϊ
+ * @param buf {ACL_VSTRING*} Ž(׷ӷʽ), Ϊ
+ * @param max {int} Ļص
+ * @return {const char*}  buf еַδܷʱؿմ
+ */
+ACL_API const char *acl_event_profile_dump(ACL_EVENT *eventp,
+		ACL_VSTRING *buf, int max);
+
+/**
+ * ֱͼĳٷλֵ(Ͱ)
+ * get the estimated value of the percentile from the histogram
+ * @param hist {const ACL_EVENT_HIST*} ֱͼ
+ * @param pct {double} ٷλȡֵ (0, 100]
+ * @return {acl_uint64}
+ */
+ACL_API acl_uint64 acl_event_hist_percentile(const ACL_EVENT_HIST *hist,
+		double pct);
+
 /**
  * ͷ¼ṹ
  * @param eventp {ACL_EVENT*} ¼ָ, ΪΪ
@@ -10,6 +10,7 @@ extern "C" {
 #include "net/acl_net.h"
 #include "thread/acl_thread.h"
 #include "msg/acl_aqueue.h"
+#include "msg/acl_lfqueue.h"
 #include "msg/acl_msgio.h"
 #include "event/acl_events.h"
 #include "ioctl/acl_ioctl.h"
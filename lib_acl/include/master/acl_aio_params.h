@@ -113,6 +113,19 @@ extern int   acl_var_aio_max_debug;
 #define	ACL_DEF_AIO_STATUS_NOTIFY	1
 extern int   acl_var_aio_status_notify;
 
+#define	ACL_VAR_AIO_EDGE_TRIGGER	"aio_edge_trigger"
+#define	ACL_DEF_AIO_EDGE_TRIGGER	0
+extern int   acl_var_aio_edge_trigger;
+
+#define	ACL_VAR_AIO_LISTEN_EXCLUSIVE	"aio_listen_exclusive"
+#define	ACL_DEF_AIO_LISTEN_EXCLUSIVE	0
+extern int   acl_var_aio_listen_exclusive;
+
+/* ¼ѭܷʱͳƽʱ()0 ʾ */
+#define	ACL_VAR_AIO_PROFILE_INTER	"aio_profile_inter"
+#define	ACL_DEF_AIO_PROFILE_INTER	0
+extern int   acl_var_aio_profile_inter;
+
 #define	ACL_VAR_AIO_DISPATCH_ADDR	"aio_dispatch_addr"
 #define	ACL_DEF_AIO_DISPATCH_ADDR	""
 extern char *acl_var_aio_dispatch_addr;
@@ -114,6 +114,18 @@ extern char *acl_var_threads_access_allow;
 #define	ACL_DEF_THREADS_BATADD			0
 extern int   acl_var_threads_batadd;
 
+/* ̳߳ǷԼʱ( Linux Ч) */
+#define	ACL_VAR_THREADS_LOCKFREE		"ioctl_lockfree"
+#define	ACL_DEF_THREADS_LOCKFREE		0
+extern int   acl_var_threads_lockfree;
+
+/* ̳߳Ŷʱ()ֵʱֱӹر½Խ͸أ
+ * ŶӶʱ0 ʾйؽ
+ */
+#define	ACL_VAR_THREADS_SHED_WAIT		"ioctl_shed_wait"
+#define	ACL_DEF_THREADS_SHED_WAIT		0
+extern int   acl_var_threads_shed_wait;
+
 #define	ACL_VAR_THREADS_SCHEDULE_WARN		"ioctl_schedule_warn"
 #define	ACL_DEF_THREADS_SCHEDULE_WARN		100
 extern int   acl_var_threads_schedule_warn;
@@ -39,6 +39,14 @@ ACL_API void acl_aqueue_check_owner(ACL_AQUEUE *queue, char flag);
  */
 ACL_API void acl_aqueue_set_owner(ACL_AQUEUE *queue, unsigned int owner);
 
+/**
+ * ڼȴǰڶ˻ϵ߽ϿʱԼ
+ * ߼ѵĴȱʡΪ 0 ʾ
+ * @param queue ACL_AQUEUE ṹָ
+ * @param nspin 
+ */
+ACL_API void acl_aqueue_set_spin(ACL_AQUEUE *queue, int nspin);
+
 /**
  * ͷŶж
  * @param queue ACL_AQUEUE ṹָ
@@ -71,6 +79,27 @@ ACL_API void *acl_aqueue_pop_timedwait(ACL_AQUEUE *queue, int tmo_sec, int tmo_u
  */
 ACL_API int acl_aqueue_push(ACL_AQUEUE *queue, void *data);
 
+/**
+ * һӶԪأһΣ໽һ
+ * @param queue ACL_AQUEUE ṹָ
+ * @param data ûָ
+ * @param n Ԫصĸ
+ * @return {int} ӶԪǷɹ, 0: ok; < 0: error
+ */
+ACL_API int acl_aqueue_push_batch(ACL_AQUEUE *queue, void **data, int n);
+
+/**
+ * һδӶȡԪأһΣΪʱȴֱԪؿûʱ
+ * @param queue ACL_AQUEUE ṹָ
+ * @param out Ž
+ * @param max 
+ * @param tmo_sec ʱʱ()tmo_sec  tmo_usec С 0 ʱʾһֱȴ
+ * @param tmo_usec ʱʱ(΢)
+ * @return {int} ȡԪظ0 ʾʱ˳< 0 ʾ
+ */
+ACL_API int acl_aqueue_pop_batch(ACL_AQUEUE *queue, void **out, int max,
+	int tmo_sec, int tmo_usec);
+
 /**
  * һζвĴ, define as: ACL_AQUEUE_XXX
  * @param queue ACL_AQUEUE ṹָ
@@ -0,0 +1,99 @@
+#ifndef ACL_LFQUEUE_INCLUDE_H
+#define	ACL_LFQUEUE_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../stdlib/acl_define.h"
+
+/**
+ * нζУһ̣߳߿һ߳(SPSC)
+ * ߳(MPSC)Ԫʱߴ״̬ʱŻ֮
+ * ΪʱӦһʱ䣬Ȼ
+ * the bounded lock-free ring queue with only one consumer thread, and one
+ * (SPSC) or more (MPSC) producer threads; the consumer will be woken up only
+ * when it is sleeping, and the consumer will spin adaptively before sleeping
+ */
+typedef struct ACL_LFQUEUE ACL_LFQUEUE;
+
+#define	ACL_LFQUEUE_F_SPSC	0	/* ߵ */
+#define	ACL_LFQUEUE_F_MPSC	1	/* ߵ */
+
+typedef void (*ACL_LFQUEUE_FREE_FN)(void *);
+
+/**
+ * ζж
+ * @param size {unsigned} ڲΪ 2  N η
+ * @param flags {unsigned} ACL_LFQUEUE_F_SPSC  ACL_LFQUEUE_F_MPSC
+ * @return {ACL_LFQUEUE*}
+ */
+ACL_API ACL_LFQUEUE *acl_lfqueue_create(unsigned size, unsigned flags);
+
+/**
+ * ͷŶж󣬵ǰӦ֤߼ֹ߳̾ͣʸö
+ * @param queue {ACL_LFQUEUE*}
+ * @param free_fn {ACL_LFQUEUE_FREE_FN} ǿʱͷŶʣԪ
+ */
+ACL_API void acl_lfqueue_free(ACL_LFQUEUE *queue, ACL_LFQUEUE_FREE_FN free_fn);
+
+/**
+ * ǰڲĳɹ [0, nspin] ֮
+ * Զ CPU ȱʡֵΪ 0Ϊ 4096
+ * @param queue {ACL_LFQUEUE*}
+ * @param nspin {int} Ϊ 0 ʱʾ
+ */
+ACL_API void acl_lfqueue_set_spin(ACL_LFQUEUE *queue, int nspin);
+
+/**
+ * һԪأú
+ * @param queue {ACL_LFQUEUE*}
+ * @param data {void*} ǿָ
+ * @return {int} 0 ʾɹ-1 ʾ
+ */
+ACL_API int acl_lfqueue_push(ACL_LFQUEUE *queue, void *data);
+
+/**
+ * ӶԪأ໽һΣú
+ * @param queue {ACL_LFQUEUE*}
+ * @param data {void**} Ԫ
+ * @param n {int} Ԫظ
+ * @return {int} ʵӵԪظʱС n
+ */
+ACL_API int acl_lfqueue_push_batch(ACL_LFQUEUE *queue, void **data, int n);
+
+/**
+ * ӶȡһԪأֻΨһ̵߳
+ * @param queue {ACL_LFQUEUE*}
+ * @param timeout {int} ȴĺ< 0 ʾһֱȴֱԪػ˳
+ * @return {void*}  NULL ʾʱ˳
+ */
+ACL_API void *acl_lfqueue_pop(ACL_LFQUEUE *queue, int timeout);
+
+/**
+ * ӶһȡԪأֻΨһ̵߳
+ * @param queue {ACL_LFQUEUE*}
+ * @param out {void**} Ž
+ * @param max {int} 
+ * @param timeout {int} Ϊʱȴĺ< 0 ʾһֱȴ
+ * @return {int} ȡԪظ0 ʾʱ˳
+ */
+ACL_API int acl_lfqueue_pop_batch(ACL_LFQUEUE *queue, void **out,
+	int max, int timeout);
+
+/**
+ * öԪصĽƸ
+ * @param queue {ACL_LFQUEUE*}
+ * @return {int}
+ */
+ACL_API int acl_lfqueue_qlen(ACL_LFQUEUE *queue);
+
+/**
+ * öΪ˳״̬
+ * @param queue {ACL_LFQUEUE*}
+ */
+ACL_API void acl_lfqueue_set_quit(ACL_LFQUEUE *queue);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -6,11 +6,14 @@ extern "C" {
 #endif
 
 #include "acl_define.h"
+#include "acl_vstream.h"
 
 typedef struct ACL_MBOX ACL_MBOX;
 
 /**
- * Ϣж
+ * Ϣж Linux ƽ̨ʹ eventfd Ϊ֪ͨƽ̨
+ * ʹ socketpairֻе˴ڵȴ״̬ʱ߲Ż֪ᷢͨڶ
+ * ֪֮ͨһ
  * @return {ACL_MBOX}
  */
 ACL_API ACL_MBOX *acl_mbox_create(void);
@@ -41,14 +44,31 @@ ACL_API int acl_mbox_send(ACL_MBOX *mbox, void *msg);
 ACL_API void *acl_mbox_read(ACL_MBOX *mbox, int timeout, int *success);
 
 /**
- * õǰϢѾɹ͵Ϣ
+ * ԷʽϢжȡϢ¼ʽ acl_mbox_stream()
+ * صע¼( acl_event_enable_read)ɶʱѭñ
+ * ֱ NULLϢٴ¼
+ * @param mbox {ACL_MBOX*} Ϣж
+ * @return {void*}  NULL ʾǰûϢ
+ */
+ACL_API void *acl_mbox_read_nowait(ACL_MBOX *mbox);
+
+/**
+ * Ϣж˵֪ͨڽϢ¼ϣӦòӦֱ
+ * дҲӦر֮
+ * @param mbox {ACL_MBOX*} Ϣж
+ * @return {ACL_VSTREAM*}
+ */
+ACL_API ACL_VSTREAM *acl_mbox_stream(ACL_MBOX *mbox);
+
+/**
+ * õǰϢз֪ͨĴд֪ͨϵͳô
  * @param mbox {ACL_MBOX*} Ϣж
  * @return {size_t}
  */
 ACL_API size_t acl_mbox_nsend(ACL_MBOX *mbox);
 
 /**
- * õǰϢѾɹյϢ
+ * õǰϢжȡ֪ͨĴ֪ͨϵͳô
  * @param mbox {ACL_MBOX*} Ϣж
  * @return {size_t}
  */
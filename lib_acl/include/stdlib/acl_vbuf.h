@@ -44,6 +44,7 @@ struct ACL_VBUF {
 #define ACL_VBUF_FLAG_BAD \
 	(ACL_VBUF_FLAG_ERR | ACL_VBUF_FLAG_EOF | ACL_VBUF_FLAG_TIMEOUT)
 #define ACL_VBUF_FLAG_FIXED	(1<<3)		/* fixed-size buffer */
+#define ACL_VBUF_FLAG_EMBED	(1<<4)		/* caller-owned inline buffer */
 
 #define acl_vbuf_error(v)	((v)->flags & ACL_VBUF_FLAG_BAD)
 #define acl_vbuf_eof(v)		((v)->flags & ACL_VBUF_FLAG_EOF)
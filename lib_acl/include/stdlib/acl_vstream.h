@@ -120,6 +120,8 @@ struct ACL_VSTREAM {
 
 #define	ACL_VSTREAM_FLAG_CONNECTING     (1 << 18) /* ӹ */
 #define	ACL_VSTREAM_FLAG_PREREAD	(1 << 19) /*  acl_vstream_can_read ùǷԤ */
+#define	ACL_VSTREAM_FLAG_MMAP		(1 << 20) /* ļڴӳģʽ */
+#define	ACL_VSTREAM_FLAG_EDGE		(1 << 21) /* ɱԵʽ¼ */
 
 	char  errbuf[128];              /**< error info */
 	int   errnum;                   /**< record the system errno here */
@@ -173,6 +175,8 @@ struct ACL_VSTREAM {
 	pid_t pid;
 #endif
 	ACL_HTABLE *objs_table;
+	void *wchain;                   /**< output chain, see acl_vstream_chain_add */
+	void *fmap;                     /**< mapped view, see acl_vstream_mmap */
 };
 
 extern ACL_API ACL_VSTREAM acl_vstream_fstd[];  /**< pre-defined streams */
@@ -272,6 +276,49 @@ ACL_API char *acl_vstream_loadfile(const char *path);
  */
 ACL_API char *acl_vstream_loadfile2(const char *path, ssize_t *size);
 
+/**
+ * Ѵ򿪵ļлΪֻڴӳģʽ˺ӸʱֱӴӳ
+ * ȡپacl_vstream_gets_ref/acl_vstream_read_ref 
+ * صֱָָӳرǰһֱЧӳ󽫻ָͨ
+ * ʽԼȡļ׷ݣͬʱͨ madvise ֪ں˳
+ * @param fp {ACL_VSTREAM*} ļӳӵǰλÿʼ
+ * @return {int} 0 ʾɹ-1 ʾʧ(ļļ 2GB)ʧʱ
+ *  Կɰͨʽ
+ */
+ACL_API int acl_vstream_mmap(ACL_VSTREAM *fp);
+
+/**
+ * ֻʽļлΪڴӳģʽڿļӳʧʱԷ
+ * ͨʽļ
+ * @param path {const char*} ļ
+ * @return {ACL_VSTREAM*}  NULL ʾļʧ
+ */
+ACL_API ACL_VSTREAM *acl_vstream_mmap_open(const char *path);
+
+/**
+ * жļǰǷڴӳģʽ
+ * @param fp {const ACL_VSTREAM*}
+ * @return {int}  0 ʾ
+ */
+ACL_API int acl_vstream_mapped(const ACL_VSTREAM *fp);
+
+/**
+ * ļֻʽӳڴУ acl_vstream_loadfile ͬú
+ * ļݣصݲ \0 β
+ * @param path {const char*} ļ
+ * @param size {size_t*} ǿʱ洢ļ
+ * @return {const char*}  NULL ʾļʱؿմ
+ *  acl_vstream_unmapfile ͷ
+ */
+ACL_API const char *acl_vstream_mapfile(const char *path, size_t *size);
+
+/**
+ * ͷ acl_vstream_mapfile صӳ
+ * @param ptr {const char*} acl_vstream_mapfile ķֵ
+ * @param size {size_t} acl_vstream_mapfile صļ
+ */
+ACL_API void acl_vstream_unmapfile(const char *ptr, size_t size);
+
 /**
  * ĸ
  * @param fp {ACL_VSTREAM*} ָ
@@ -424,6 +471,39 @@ ACL_API int acl_vstream_gets(ACL_VSTREAM *fp, void *vptr, size_t maxlen);
  */
 ACL_API int acl_vstream_gets_nonl(ACL_VSTREAM *fp, void *vptr, size_t maxlen);
 
+/**
+ * жȡһݣ acl_vstream_gets ͬúݣ
+ * ָ(ڴӳ)иݵָ룻ӳģʽ¸ָ
+ * һζǰЧӳģʽرǰЧһݳ
+ * ֶηأͨ (fp->flag & ACL_VSTREAM_FLAG_TAGYES) жǷ
+ *  "\n"
+ * @param fp {ACL_VSTREAM*} 
+ * @param ptr {const char**} 洢ݵʼַݲ \0 β
+ * @return {int} ظݵĳ( "\n")ACL_VSTREAM_EOF ʾ
+ *  
+ */
+ACL_API int acl_vstream_gets_ref(ACL_VSTREAM *fp, const char **ptr);
+
+/**
+ * ͬ acl_vstream_gets_refصĳȲβ "\r\n"  "\n"
+ * @param fp {ACL_VSTREAM*} 
+ * @param ptr {const char**} 洢ݵʼַ
+ * @return {int} ظݵĳȣ0 ʾУACL_VSTREAM_EOF ʾ
+ *  
+ */
+ACL_API int acl_vstream_gets_nonl_ref(ACL_VSTREAM *fp, const char **ptr);
+
+/**
+ * жȡ maxlen ֽڵݣָ(ڴӳ
+ * )ݵָ룬ָЧͬ acl_vstream_gets_ref
+ * @param fp {ACL_VSTREAM*} 
+ * @param ptr {const void**} 洢ݵʼַ
+ * @param maxlen {size_t} ȡݳ
+ * @return {int} ݳȣACL_VSTREAM_EOF ʾ
+ */
+ACL_API int acl_vstream_read_ref(ACL_VSTREAM *fp, const void **ptr,
+	size_t maxlen);
+
 /**
  * лַΪ־λ
  * @param fp {ACL_VSTREAM*} ָ
@@ -565,6 +645,48 @@ ACL_API int acl_vstream_fflush(ACL_VSTREAM *fp);
 ACL_API int acl_vstream_buffed_writen(ACL_VSTREAM *fp, const void *vptr, size_t dlen);
 #define	acl_vstream_buffed_fwrite	acl_vstream_buffed_writen
 
+/**
+ * 㿽ʽ׷һݶΣݶνö
+ * ֱ acl_vstream_fflush ʱдеһ writev ʽ
+ * д(ÿ IOV_MAX ݶ)ݶд free_fn(ctx) ͷţ
+ * Сڿֵ(ȱʡΪ 1024 ֽ)ݶλᱻֱӿдУ
+ * ͬʱ free_fn(ctx) acl_vstream_buffed_xxx ʹãݵ
+ * Ⱥ˳򱣳ֲ
+ * @param fp {ACL_VSTREAM*} 
+ * @param ptr {const void*} ݶεַдǰ뱣Ч
+ * @param len {size_t} ݶγ
+ * @param free_fn {void (*)(void*)} ݶдرʱͷźΪ
+ * @param ctx {void*} ݸ free_fn Ĳ
+ * @return {int}  lenǷʱ ACL_VSTREAM_EOF
+ */
+ACL_API int acl_vstream_chain_add(ACL_VSTREAM *fp, const void *ptr,
+	size_t len, void (*free_fn)(void*), void *ctx);
+
+/**
+ * һݶ׷У뱣֤ acl_vstream_fflush
+ * ǰЧ
+ * @param fp {ACL_VSTREAM*} 
+ * @param vec {const struct iovec*}
+ * @param count {int} vec ĳ
+ * @return {int} ׷ӵܳȣʱ ACL_VSTREAM_EOF
+ */
+ACL_API int acl_vstream_chain_addv(ACL_VSTREAM *fp,
+	const struct iovec *vec, int count);
+
+/**
+ * ĿֵСڸֵݶνд
+ * @param fp {ACL_VSTREAM*} 
+ * @param limit {size_t} Ϊ 0 ʱʾݶξΪ 8192
+ */
+ACL_API void acl_vstream_chain_set_copy_limit(ACL_VSTREAM *fp, size_t limit);
+
+/**
+ * дδдܳ
+ * @param fp {const ACL_VSTREAM*} 
+ * @return {size_t}
+ */
+ACL_API size_t acl_vstream_chain_dlen(const ACL_VSTREAM *fp);
+
 /**
  * ʽ,  vfprintf()
  * @param fp {ACL_VSTREAM*}  
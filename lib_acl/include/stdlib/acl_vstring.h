@@ -40,6 +40,17 @@ ACL_API void acl_vstring_init(ACL_VSTRING *vp, size_t len);
  */
 ACL_API void acl_vstring_free_buf(ACL_VSTRING *vp);
 
+/**
+ * ԵṩǶջϻڵ飩ʼ ACL_VSTRING ṹ
+ * ݳδûʱκζ̬ڴ䣬ʱڲԶǨ
+ * ̬Ļ acl_vstring_glue ͬûչͬ
+ * acl_vstring_free_buf ͷſǨƺĶ̬buf ᱻͷ
+ * @param vp {ACL_VSTRING*} ַΪ
+ * @param buf {void*} Ƕ벻 vp
+ * @param len {size_t} buf ȣ > 0
+ */
+ACL_API void acl_vstring_embed(ACL_VSTRING *vp, void *buf, size_t len);
+
 /**
  * ̬һ ACL_VSTRING ָڲĳʼС
  * @param len {size_t} ʼʱС
@@ -44,6 +44,7 @@ typedef struct acl_pthread_pool_attr_t {
 	int   idle_timeout;                 /**< ߳̿гʱʱ() */
 #define ACL_PTHREAD_POOL_DEF_IDLE      0    /**< ȱʡռ䳬ʱʱΪ 0  */
 	size_t stack_size;                  /**< ̵߳ĶջС(ֽ) */
+	int   lockfree;                     /**< Ƿ */
 } acl_pthread_pool_attr_t;
 
 /**
@@ -249,6 +250,15 @@ ACL_API void acl_pthread_pool_set_qlen_warn(
  */
 ACL_API int acl_pthread_pool_qlen(acl_pthread_pool_t *thr_pool);
 
+/**
+ * ȡһʼִеڶеȴʱ䣬ʱֵɽ
+ * Ϊĵȴʱ䣬ڹʱĽ schedule_warn > 0 (ȱʡ
+ * Ϊ 100) ʱż¼ʱ
+ * @param thr_pool {acl_pthread_pool_t*} ̳߳ض󣬲Ϊ
+ * @return {acl_int64} ȴʱ()Ϊʱ 0
+ */
+ACL_API acl_int64 acl_pthread_pool_queue_wait(acl_pthread_pool_t *thr_pool);
+
 /**
  * ̵̳߳߳ĶջС
  * @param thr_pool {acl_pthread_pool_t*} ̳߳ض󣬲Ϊ
@@ -287,6 +297,18 @@ ACL_API void acl_pthread_pool_attr_set_threads_limit(
 ACL_API void acl_pthread_pool_attr_set_idle_timeout(
 		acl_pthread_pool_attr_t *attr, int idle_timeout);
 
+/**
+ * ̳߳ǷУн MPMC 
+ * (ʱ)У߳ӵ̵߳ıضУ
+ * ߳̿ɴ̵߳ıضȡ񣬿߳һʱ
+ *  futex ϣӶʱ̳߳ȫľ Linux ƽ̨Ч
+ * ƽ̨ºԸ
+ * @param attr {acl_pthread_pool_attr_t*}
+ * @param onoff {int}  0 ʾ
+ */
+ACL_API void acl_pthread_pool_attr_set_lockfree(
+		acl_pthread_pool_attr_t *attr, int onoff);
+
 #ifdef	__cplusplus
 }
 #endif
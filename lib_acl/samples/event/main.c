@@ -67,6 +67,67 @@ static void read_callback(int event_type acl_unused, ACL_EVENT *event,
 	}
 }
 
+static int __nfired = 0;
+
+static void churn_timer(int event_type acl_unused,
+	ACL_EVENT *event acl_unused, void *context acl_unused)
+{
+	__nfired++;
+}
+
+static double stamp_sub(const struct timeval *from, const struct timeval *sub)
+{
+	return (from->tv_sec - sub->tv_sec) * 1000.0
+		+ (from->tv_usec - sub->tv_usec) / 1000.0;
+}
+
+/*
+ * ʱѹԣΪ count һʱȻáȡ
+ * öʱģÿ IO ʱдʱĳ
+ */
+static void bench_timer(ACL_EVENT *eventp, int count, int rounds)
+{
+	struct timeval begin, end;
+	int   i, n;
+	double spent;
+
+	srand((unsigned int) time(NULL));
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < count; i++)
+		acl_event_request_timer(eventp, churn_timer, (char*) NULL + i + 1,
+			10000000 + (rand() % 1000) * 1000, 0);
+	gettimeofday(&end, NULL);
+	spent = stamp_sub(&end, &begin);
+	printf("add %d timers, spent: %.2f ms, speed: %.2f/s\r\n",
+		count, spent, spent > 0 ? count * 1000 / spent : 0);
+
+	gettimeofday(&begin, NULL);
+	for (i = 0; i < rounds; i++) {
+		n = rand() % count;
+		if (i % 4 == 0) {
+			acl_event_cancel_timer(eventp, churn_timer,
+				(char*) NULL + n + 1);
+		}
+		acl_event_request_timer(eventp, churn_timer, (char*) NULL + n + 1,
+			10000000 + (rand() % 1000) * 1000, 0);
+	}
+	gettimeofday(&end, NULL);
+	spent = stamp_sub(&end, &begin);
+	printf("reset/cancel %d times with %d timers, spent: %.2f ms, "
+		"speed: %.2f/s\r\n", rounds, count, spent,
+		spent > 0 ? rounds * 1000 / spent : 0);
+
+	/* жʱΪڣǷȫ */
+	for (i = 0; i < count; i++)
+		acl_event_request_timer(eventp, churn_timer,
+			(char*) NULL + i + 1, 0, 0);
+
+	while (__nfired < count)
+		acl_event_loop(eventp);
+	printf("fired %d timers\r\n", __nfired);
+}
+
 static void usage(const char *procname)
 {
 	printf("usage: %s -h [help]\r\n"
@@ -75,7 +136,10 @@ static void usage(const char *procname)
 		"	-s delay_sec [defaut: 1]\r\n"
 		"	-u delay_usec [default: 0]\r\n"
 		"	-m timer_delay [default: 100 microsecond, disable timer if < 0]\r\n"
-		"	-k [if timer keep on, default: 1]\r\n", procname);
+		"	-k [if timer keep on, default: 1]\r\n"
+		"	-b timers_count [benchmark timer churn, such as: -b 50000]\r\n"
+		"	-n rounds [reset/cancel times for -b, default: 1000000]\r\n",
+		procname);
 }
 
 int main(int argc acl_unused, char *argv[] acl_unused)
@@ -85,7 +149,7 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 	char  event_type[64];
 	int   ch, delay_sec = 1, delay_usec = 0;
 	int   timer_delay = 100, timer_keep = 0;
-	int   meter = 0;
+	int   meter = 0, nbench = 0, rounds = 1000000;
 
 	/* ʼ acl  */
 	acl_lib_init();
@@ -95,7 +159,7 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 
 	event_type[0] = 0;
 
-	while ((ch = getopt(argc, argv, "ht:s:u:m:kM")) > 0) {
+	while ((ch = getopt(argc, argv, "ht:s:u:m:kMb:n:")) > 0) {
 		switch (ch) {
 		case 'h':
 			usage(argv[0]);
@@ -122,6 +186,12 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 		case 'M':
 			meter = 1;
 			break;
+		case 'b':
+			nbench = atoi(optarg);
+			break;
+		case 'n':
+			rounds = atoi(optarg);
+			break;
 		default:
 			break;
 		}
@@ -135,6 +205,12 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 	else
 		eventp = acl_event_new_select(delay_sec, delay_usec);
 
+	if (nbench > 0) {
+		bench_timer(eventp, nbench, rounds > 0 ? rounds : 1);
+		acl_event_free(eventp);
+		return 0;
+	}
+
 	if (timer_delay >= 0)
 		acl_event_request_timer(eventp, trigger_event, NULL,
 			timer_delay, timer_keep);
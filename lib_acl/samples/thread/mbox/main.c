@@ -4,6 +4,7 @@
 static long long int __max = 100000000;
 static char __dummy[256];
 static int  __use_dummy = 0;
+static int  __use_event = 0;
 
 static void *thread_producer(void *arg)
 {
@@ -51,6 +52,44 @@ static void *thread_consumer(void *arg)
 	return NULL;
 }
 
+static long long int __nread = 0;
+
+static void read_callback(int event_type acl_unused,
+	ACL_EVENT *event acl_unused, ACL_VSTREAM *stream acl_unused, void *ctx)
+{
+	ACL_MBOX *mbox = (ACL_MBOX *) ctx;
+	char *ptr;
+
+	/* еϢϢʱٴ¼ */
+	while ((ptr = (char *) acl_mbox_read_nowait(mbox)) != NULL) {
+		if (__nread++ < 10)
+			printf(">>read: %s\r\n", ptr);
+		if (ptr != __dummy)
+			acl_myfree(ptr);
+	}
+}
+
+static void *thread_event_consumer(void *arg)
+{
+	ACL_MBOX *mbox = (ACL_MBOX *) arg;
+	ACL_EVENT *event = acl_event_new(ACL_EVENT_KERNEL, 0, 1, 0);
+
+	acl_event_enable_read(event, acl_mbox_stream(mbox), 0,
+		read_callback, mbox);
+
+	while (__nread < __max)
+		acl_event_loop(event);
+
+	acl_event_disable_readwrite(event, acl_mbox_stream(mbox));
+	acl_event_free(event);
+
+	printf("hit ratio: %.2f %%, n: %lld, io send: %d, io read: %d\r\n",
+		(double) (__nread - acl_mbox_nsend(mbox)) * 100
+		/ (__nread > 0 ? __nread : 1), __nread,
+		(int) acl_mbox_nsend(mbox), (int) acl_mbox_nread(mbox));
+	return NULL;
+}
+
 static void free_msg(void *ctx)
 {
 	char *ptr = (char *) ctx;
@@ -61,7 +100,8 @@ static void free_msg(void *ctx)
 
 static void usage(const char *procname)
 {
-	printf("usage: %s -h [help] -n max -s [use static buffer]\r\n", procname);
+	printf("usage: %s -h [help] -n max -s [use static buffer]"
+		" -e [read in event loop]\r\n", procname);
 }
 
 int main(int argc, char *argv[])
@@ -71,7 +111,7 @@ int main(int argc, char *argv[])
 	ACL_MBOX *mbox = acl_mbox_create();
 	int   ch;
 
-	while ((ch = getopt(argc, argv, "hn:s")) > 0) {
+	while ((ch = getopt(argc, argv, "hn:se")) > 0) {
 		switch (ch) {
 		case 'h':
 			usage(argv[0]);
@@ -82,6 +122,9 @@ int main(int argc, char *argv[])
 		case 's':
 			__use_dummy = 1;
 			break;
+		case 'e':
+			__use_event = 1;
+			break;
 		default:
 			break;
 		}
@@ -91,7 +134,8 @@ int main(int argc, char *argv[])
 	__dummy[sizeof(__dummy) - 1] = 0;
 
 	acl_pthread_attr_init(&attr);
-	acl_pthread_create(&t2, &attr, thread_consumer, mbox);
+	acl_pthread_create(&t2, &attr, __use_event ?
+		thread_event_consumer : thread_consumer, mbox);
 	acl_pthread_create(&t1, &attr, thread_producer, mbox);
 	acl_pthread_join(t2, NULL);
 	acl_pthread_join(t1, NULL);
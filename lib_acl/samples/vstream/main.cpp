@@ -136,9 +136,130 @@ END:
 	return (0);
 }
 
+static double stamp_sub(const struct timeval *from, const struct timeval *sub)
+{
+	return (from->tv_sec - sub->tv_sec) * 1000.0
+		+ (from->tv_usec - sub->tv_usec) / 1000.0;
+}
+
+/* ָСİ֯Ĳļ */
+static int make_lines_file(const char *path, long long size)
+{
+	const char *myname = "make_lines_file";
+	ACL_VSTREAM *fp;
+	char  line[256];
+	long long n = 0;
+	int   i = 0, len;
+
+	fp = acl_vstream_fopen(path, O_WRONLY | O_CREAT | O_TRUNC, 0600, 8192);
+	if (fp == NULL) {
+		printf("%s(%d): open %s error %s\r\n",
+			myname, __LINE__, path, acl_last_serror());
+		return -1;
+	}
+
+	while (n < size) {
+		/* г 16  200 ֽ֮仯ģһıЭ */
+		len = snprintf(line, sizeof(line), "%d: %.*s\r\n", i,
+			16 + (i * 37) % 184, "abcdefghijklmnopqrstuvwxyz"
+			"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+			"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+			"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+		if (acl_vstream_buffed_writen(fp, line, len) == ACL_VSTREAM_EOF) {
+			printf("%s(%d): write error %s\r\n",
+				myname, __LINE__, acl_last_serror());
+			acl_vstream_close(fp);
+			return -1;
+		}
+		n += len;
+		i++;
+	}
+
+	acl_vstream_fflush(fp);
+	acl_vstream_close(fp);
+	printf("%s: create %s ok, size: %lld, lines: %d\r\n",
+		myname, path, n, i);
+	return 0;
+}
+
+/* жȡļmode: gets/nonl/peek/ref/mmap */
+static int bench_gets(const char *path, const char *mode)
+{
+	const char *myname = "bench_gets";
+	ACL_VSTREAM *fp;
+	ACL_VSTRING *vbuf = NULL;
+	struct timeval begin, end;
+	char  buf[8192];
+	const char *ptr;
+	long long total = 0, lines = 0;
+	int   n, ready;
+	double spent;
+
+	/* mmap: ڴӳ䷽ʽֱӳ */
+	if (strcasecmp(mode, "mmap") == 0)
+		fp = acl_vstream_mmap_open(path);
+	else
+		fp = acl_vstream_fopen(path, O_RDONLY, 0600, 65536);
+	if (fp == NULL) {
+		printf("%s(%d): open %s error %s\r\n",
+			myname, __LINE__, path, acl_last_serror());
+		return -1;
+	}
+
+	if (strcasecmp(mode, "peek") == 0) {
+		vbuf = acl_vstring_alloc(256);
+		fp->read_ready = 1;
+	}
+
+	gettimeofday(&begin, NULL);
+
+	while (1) {
+		if (vbuf != NULL) {
+			n = acl_vstream_gets_peek(fp, vbuf, &ready);
+			if (n == ACL_VSTREAM_EOF || (n == 0 && !ready))
+				break;
+			total += n;
+			if (ready) {
+				ACL_VSTRING_RESET(vbuf);
+				lines++;
+			}
+			fp->read_ready = 1;
+			continue;
+		}
+
+		if (strcasecmp(mode, "ref") == 0 || strcasecmp(mode, "mmap") == 0)
+			n = acl_vstream_gets_ref(fp, &ptr);
+		else if (strcasecmp(mode, "nonl") == 0)
+			n = acl_vstream_gets_nonl(fp, buf, sizeof(buf));
+		else
+			n = acl_vstream_gets(fp, buf, sizeof(buf));
+		if (n == ACL_VSTREAM_EOF)
+			break;
+		total += n;
+		if (fp->flag & ACL_VSTREAM_FLAG_TAGYES)
+			lines++;
+	}
+
+	gettimeofday(&end, NULL);
+	spent = stamp_sub(&end, &begin);
+
+	printf("%s: mode: %s, lines: %lld, bytes: %lld, spent: %.2f ms, "
+		"speed: %.3f GB/s\r\n", myname, mode, lines, total, spent,
+		spent > 0 ? (double) fp->offset / (spent / 1000)
+			/ (1024 * 1024 * 1024) : 0);
+
+	if (vbuf)
+		acl_vstring_free(vbuf);
+	acl_vstream_close(fp);
+	return 0;
+}
+
 static void usage(const char *procname)
 {
-	printf("usage: %s -h [help] -a [addr] -s [server_mode] -c [client_mode] -t [timeout]\r\n", procname);
+	printf("usage: %s -h [help] -a [addr] -s [server_mode] -c [client_mode] -t [timeout]\r\n"
+		" -f file [benchmark reading lines from file]\r\n"
+		" -r gets|nonl|peek|ref|mmap [the reading mode for -f, default: gets]\r\n"
+		" -m size_mb [create the file for -f with size_mb MB lines, such as -m 1024]\r\n", procname);
 }
 
 #ifdef WIN32
@@ -147,10 +268,11 @@ static void usage(const char *procname)
 
 int main(int argc acl_unused, char *argv[] acl_unused)
 {
-	char  buf[256];
+	char  buf[256], path[256], mode[32] = "gets";
 	int   i, c;
 	ACL_VSTRING *sbuf;
 	int   flag = 0;
+	long long size = 0;
 
 	acl_lib_init();
 
@@ -174,6 +296,16 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 		case 't':
 			timeout = atoi(argv[i + 1]);
 			break;
+		case 'f':
+			flag = 3;
+			snprintf(path, sizeof(path), "%s", argv[i + 1]);
+			break;
+		case 'r':
+			snprintf(mode, sizeof(mode), "%s", argv[i + 1]);
+			break;
+		case 'm':
+			size = atoll(argv[i + 1]) * 1024 * 1024;
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit (0);
@@ -186,6 +318,11 @@ int main(int argc acl_unused, char *argv[] acl_unused)
 		return (vstream_server());
 	if (flag == 2)
 		return (vstream_client());
+	if (flag == 3) {
+		if (size > 0 && make_lines_file(path, size) < 0)
+			return (1);
+		return (bench_gets(path, mode));
+	}
 
 	sbuf = acl_vstring_alloc(256);
 	while (1) {
@@ -77,6 +77,7 @@ ACL_AIO *acl_aio_create2(int event_mode, unsigned int nMsg)
 		break;
 	}
 	aio->dead_streams = acl_array_create(aio->event->fdsize);
+	acl_ring_init(&aio->cork_ring);
 	return aio;
 }
 
@@ -140,6 +141,9 @@ void acl_aio_loop(ACL_AIO *aio)
 		return;
 
 	acl_event_loop(aio->event);
+
+	/* ͱ¼ѭдϲģʽ첽۵ */
+	aio_cork_flush(aio);
 	aio_delay_check(aio);
 }
 
@@ -91,6 +91,14 @@ ACL_ASTREAM *acl_aio_open(ACL_AIO *aio, ACL_VSTREAM *stream)
 
 	/* for write */
 	acl_fifo_init(&astream->write_fifo);
+	acl_ring_init(&astream->cork_entry);
+	astream->cork_limit = 0;
+	astream->write_low = 0;
+	astream->write_high = 0;
+	astream->write_limit = 0;
+	astream->write_peak = 0;
+	astream->water_fn = NULL;
+	astream->water_ctx = NULL;
 	astream->write_left = 0;
 	astream->write_offset = 0;
 	astream->write_nested = 0;
@@ -125,6 +133,7 @@ ACL_VSTREAM *acl_aio_cancel(ACL_ASTREAM *astream)
 
 	stream = astream->stream;
 	stream->flag = 0;
+	acl_ring_detach(&astream->cork_entry);
 	acl_aio_clean_hooks(astream);
 	acl_myfree(astream);
 	return (stream);
@@ -183,6 +192,7 @@ static void close_astream(ACL_ASTREAM *astream)
 		}
 		acl_vstream_close(astream->stream);
 	}
+	acl_ring_detach(&astream->cork_entry);
 	acl_aio_clean_hooks(astream);
 
 	/* bugfix:  acl_aio_clean_hooks вͷ --zsx, 2012.7.2 */
@@ -324,6 +334,11 @@ void acl_aio_iocp_close(ACL_ASTREAM *astream)
 
 	if ((astream->flag & ACL_AIO_FLAG_DELAY_CLOSE))
 		return;
+
+	/* дϲģʽδ͵ڹرǰ */
+	if (AIO_CORKED(astream) && !(astream->flag & ACL_AIO_FLAG_DEAD))
+		(void) aio_cork_drain(astream);
+
 	if (!(astream->flag & ACL_AIO_FLAG_DEAD)
 		&& (astream->flag & ACL_AIO_FLAG_ISWR))
 	{
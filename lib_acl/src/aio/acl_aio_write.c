@@ -86,21 +86,32 @@ static int write_complete_callback(ACL_ASTREAM *astream)
 
 /* ԷдݣֵΪдﻹʣݳȻдʧ */
 
+#define __AIO_WRITEV_MAX	64
+
 static int __try_fflush(ACL_ASTREAM *astream)
 {
 	const char *myname = "__try_fflush";
+	struct iovec vector[__AIO_WRITEV_MAX];
+	ACL_FIFO_INFO *info;
 	ACL_VSTRING *str;
-	const char *ptr;
-	int   n, dlen;
+	int   n, dlen, count, max;
 	int   i = 0;
 
-	/* дУҲ writev ãӦǸдЧʻЩ
-	 * --- zsx */
+	/* дӿڱ滻( SSL)ʱacl_vstream_writev ֻģд
+	 * дǰݿ EAGAIN ᷵سʧдȣӶ
+	 * ݱظͣԴʱÿνдһݿ
+	 */
+	if (astream->stream->type == ACL_VSTREAM_TYPE_FILE)
+		max = astream->stream->fwrite_fn == acl_file_write
+			? __AIO_WRITEV_MAX : 1;
+	else
+		max = astream->stream->write_fn == acl_socket_write
+			? __AIO_WRITEV_MAX : 1;
 
 	while (1) {
 		/* ȡдеͷ */
-		str = acl_fifo_head(&astream->write_fifo);
-		if (str == NULL) {
+		info = acl_fifo_head_info(&astream->write_fifo);
+		if (info == NULL) {
 			/* ˵дѾΪ */
 			if (astream->write_left != 0)
 				acl_msg_fatal("%s: write_left(%d) != 0",
@@ -108,18 +119,30 @@ static int __try_fflush(ACL_ASTREAM *astream)
 			return (astream->write_left);
 		}
 
-		/* 㱾ݿĳȼݿʼλ, write_offset Ǳݿ
-		 * λ, ݿʼλõԳȣ dlen
-		 * ǱݿڱдҪдݵĳȣ
-		 * write_left ȫԵģдеݳȣҪ
-		 * ֿҲӦý write_offset Ҳ趨Ϊȫ
-		 * Եġ--- zsx :)
+		/* деĶݿϲΪһ writev д, write_offset
+		 * ׸ݿдݵλ
 		 */
+		for (count = 0; info != NULL && count < max;
+			info = info->next, count++)
+		{
+			str = (ACL_VSTRING*) info->data;
+			if (count == 0) {
+				vector[0].iov_base = acl_vstring_str(str)
+					+ astream->write_offset;
+				vector[0].iov_len = ACL_VSTRING_LEN(str)
+					- astream->write_offset;
+			} else {
+				vector[count].iov_base = acl_vstring_str(str);
+				vector[count].iov_len = ACL_VSTRING_LEN(str);
+			}
+		}
 
-		dlen = (int) ACL_VSTRING_LEN(str) - astream->write_offset;
-		ptr = acl_vstring_str(str) + astream->write_offset;
 		/* ʼзʽд */
-		n = acl_vstream_write(astream->stream, ptr, dlen);
+		if (count == 1)
+			n = acl_vstream_write(astream->stream,
+				vector[0].iov_base, (int) vector[0].iov_len);
+		else
+			n = acl_vstream_writev(astream->stream, vector, count);
 		if (n == ACL_VSTREAM_EOF) {
 			if (acl_last_error() != ACL_EAGAIN) {
 				astream->flag |= ACL_AIO_FLAG_DEAD;
@@ -132,23 +155,23 @@ static int __try_fflush(ACL_ASTREAM *astream)
 		/* ¼дʣݵܳ */
 		astream->write_left -= n;
 
-		if (n < dlen) {
-			/* δܽݿĿдȫд룬Ҫ¼
-			 * ݿĿдݵƫλ
-			 */
-			astream->write_offset += n;
-			return (astream->write_left);
-		}
-
-		/* ݿд޳ͷŸݿռڴ */
-
-		str = acl_fifo_pop(&astream->write_fifo);
-		acl_vstring_free(str);
+		/* дݿд޳ͷռڴ */
+		while (n > 0) {
+			str = acl_fifo_head(&astream->write_fifo);
+			dlen = (int) ACL_VSTRING_LEN(str) - astream->write_offset;
+			if (n < dlen) {
+				/* δܽݿĿдȫд룬Ҫ
+				 * ¼ݿĿдݵƫλ
+				 */
+				astream->write_offset += n;
+				return (astream->write_left);
+			}
 
-		/*  write_offset Ϊдһݿ׼, ñ
-		 * ΪдеƫƱЩ. --- zsx
-		 */
-		astream->write_offset = 0;
+			n -= dlen;
+			str = acl_fifo_pop(&astream->write_fifo);
+			acl_vstring_free(str);
+			astream->write_offset = 0;
+		}
 
 		/* двѭ࣬ӦأԸ
 		 * ӿɶдĻ, ˣڵ߳½здʱ
@@ -163,6 +186,165 @@ static int __try_fflush(ACL_ASTREAM *astream)
 	}
 }
 
+/*--------------------------- дˮλ ---------------------------------*/
+
+static int write_water_notify(ACL_ASTREAM *astream, int high)
+{
+	int   ret;
+
+	/* ü1Էֹڻصбر */
+	astream->nrefer++;
+	ret = astream->water_fn(astream, astream->water_ctx, high);
+	astream->nrefer--;
+
+	if (ret < 0) {
+		/* ûϣرո */
+		WRITE_IOCP_CLOSE(astream);
+		return (-1);
+	}
+
+	/* ûпڻصйر˸ */
+	if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE | ACL_AIO_FLAG_DEAD)))
+		return (-1);
+	return (0);
+}
+
+/* ݼдкǷ񳬹޻ﵽ˸ˮλ -1 ʾѱر */
+
+static int write_water_high(ACL_ASTREAM *astream)
+{
+	const char *myname = "write_water_high";
+
+	if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE | ACL_AIO_FLAG_DEAD)))
+		return (-1);
+
+	if (astream->write_left > astream->write_peak)
+		astream->write_peak = astream->write_left;
+
+	if (astream->write_limit > 0
+		&& astream->write_left > astream->write_limit)
+	{
+		acl_msg_warn("%s(%d): write_left(%d) > write_limit(%d), close %s",
+			myname, __LINE__, astream->write_left,
+			astream->write_limit,
+			ACL_VSTREAM_PEER(astream->stream));
+		astream->flag |= ACL_AIO_FLAG_DEAD;
+		WRITE_IOCP_CLOSE(astream);
+		return (-1);
+	}
+
+	if (astream->water_fn == NULL
+		|| (astream->flag & ACL_AIO_FLAG_HIGH_WATER)
+		|| astream->write_left < astream->write_high)
+	{
+		return (0);
+	}
+
+	astream->flag |= ACL_AIO_FLAG_HIGH_WATER;
+	return (write_water_notify(astream, 1));
+}
+
+/* деݺǷˮλ -1 ʾѱر */
+
+static int write_water_low(ACL_ASTREAM *astream)
+{
+	if (!(astream->flag & ACL_AIO_FLAG_HIGH_WATER)
+		|| astream->write_left > astream->write_low)
+	{
+		return (0);
+	}
+
+	astream->flag &= ~ACL_AIO_FLAG_HIGH_WATER;
+	if (astream->water_fn == NULL)
+		return (0);
+	return (write_water_notify(astream, 0));
+}
+
+/* Էдеݲˮλֵͬ __try_fflush */
+
+static int try_fflush(ACL_ASTREAM *astream)
+{
+	int   nleft = __try_fflush(astream);
+
+	if (nleft >= 0 && write_water_low(astream) < 0)
+		return (-1);
+	return (nleft);
+}
+
+void acl_aio_set_water(ACL_ASTREAM *astream, int low, int high,
+	ACL_AIO_WATER_FN water_fn, void *context)
+{
+	if (high <= 0 || water_fn == NULL) {
+		astream->write_low = 0;
+		astream->write_high = 0;
+		astream->water_fn = NULL;
+		astream->water_ctx = NULL;
+		astream->flag &= ~ACL_AIO_FLAG_HIGH_WATER;
+		return;
+	}
+
+	if (low < 0)
+		low = 0;
+	if (low >= high)
+		low = high - 1;
+
+	astream->write_low = low;
+	astream->write_high = high;
+	astream->water_fn = water_fn;
+	astream->water_ctx = context;
+}
+
+void acl_aio_set_write_limit(ACL_ASTREAM *astream, int limit)
+{
+	astream->write_limit = limit > 0 ? limit : 0;
+}
+
+int acl_aio_write_left(ACL_ASTREAM *astream)
+{
+	return (astream->write_left);
+}
+
+int acl_aio_write_peak(ACL_ASTREAM *astream)
+{
+	return (astream->write_peak);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static void __writen_notify_callback(int event_type, ACL_EVENT *event,
+	ACL_VSTREAM *stream, void *context);
+
+/* деݣݷͽصдɺIOӳٹرչ̻
+ * д¼¼
+ */
+static void aio_fflush(ACL_ASTREAM *astream)
+{
+	int   nleft = try_fflush(astream);
+
+	if (nleft < 0) {
+		/* дʧIOӳٹ */
+		WRITE_IOCP_CLOSE(astream);
+	} else if (nleft == 0) {
+		/* ֮ǰдΪջѾɹд */
+		int   ret;
+
+		ret = write_complete_callback(astream);
+		if (ret < 0) {
+			/* ûϣرոIOӳٹرչ */
+			WRITE_IOCP_CLOSE(astream);
+		} else if (astream->flag & ACL_AIO_FLAG_IOCP_CLOSE) {
+			/* ֮ǰѾIOӳٹرձ־λ
+			 * ٴIOӳٹرչ
+			 */
+			WRITE_IOCP_CLOSE(astream);
+		}
+	} else {
+		/* ˵дδϣҪٴηͣԽд¼
+		 * ¼ */
+		WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+	}
+}
+
 /* дʱд¼ */
 
 static void __writen_notify_callback(int event_type, ACL_EVENT *event acl_unused,
@@ -170,7 +352,6 @@ static void __writen_notify_callback(int event_type, ACL_EVENT *event acl_unused
 {
 	const char *myname = "__write_notify_callback";
 	ACL_ASTREAM *astream = (ACL_ASTREAM *) context;
-	int   nleft;
 
 	WRITE_SAFE_DIABLE(astream);
 
@@ -199,32 +380,130 @@ static void __writen_notify_callback(int event_type, ACL_EVENT *event acl_unused
 		acl_msg_fatal("%s: unknown event: %d", myname, event_type);
 
 	/* Էд */
-	nleft = __try_fflush(astream);
+	aio_fflush(astream);
+}
 
-	if (nleft < 0) {
-		/* дʧIOӳٹ */
-		WRITE_IOCP_CLOSE(astream);
-	} else if (nleft == 0) {
-		/* ֮ǰдΪջѾɹд */
-		int   ret;
+/*--------------------------- дϲ(cork)ģʽ -------------------------------*/
 
-		ret = write_complete_callback(astream);
-		if (ret < 0) {
-			/* ûϣرոIOӳٹرչ */
-			WRITE_IOCP_CLOSE(astream);
-		} else if (astream->flag & ACL_AIO_FLAG_IOCP_CLOSE) {
-			/* ֮ǰѾIOӳٹرձ־λ
-			 * ٴIOӳٹرչ
-			 */
-			WRITE_IOCP_CLOSE(astream);
+#define __AIO_CORK_CHUNK	8192
+
+/* ׷дУСݾϲβݿԼڴ */
+
+static void cork_append(ACL_ASTREAM *astream, const char *data, int dlen)
+{
+	ACL_VSTRING *str = (ACL_VSTRING*) acl_fifo_tail(&astream->write_fifo);
+
+	if (str == NULL || (int) ACL_VSTRING_LEN(str) + dlen > __AIO_CORK_CHUNK) {
+		str = acl_vstring_alloc(dlen > __AIO_CORK_CHUNK
+			? dlen + 1 : __AIO_CORK_CHUNK);
+		acl_fifo_push(&astream->write_fifo, str);
+	}
+
+	acl_vstring_memcat(str, data, dlen);
+	ACL_VSTRING_TERMINATE(str);
+	astream->write_left += dlen;
+}
+
+/* деݴﵽֵʱͣͼϣ acl_aio_loop
+ * ڱ¼ѭʱͳһ
+ */
+
+static void cork_schedule(ACL_ASTREAM *astream)
+{
+	/* ѴдУд¼ص̸ */
+	if ((astream->flag & ACL_AIO_FLAG_ISWR))
+		return;
+
+	/* ͳһ͹дɻصдд¼ʱͣ
+	 * Էֹͬһ¼ѭз
+	 */
+	if (astream->aio->cork_flushing) {
+		WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+		return;
+	}
+
+	if (astream->write_left < astream->cork_limit) {
+		if (!AIO_CORKED(astream))
+			acl_ring_append(&astream->aio->cork_ring,
+				&astream->cork_entry);
+		return;
+	}
+
+	acl_ring_detach(&astream->cork_entry);
+
+	/* ǶײԷֹдɻصедʹջ */
+	if (++astream->write_nested >= astream->write_nested_limit) {
+		astream->write_nested--;
+		WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+		return;
+	}
+
+	aio_fflush(astream);
+	astream->write_nested--;
+}
+
+void aio_cork_flush(ACL_AIO *aio)
+{
+	ACL_RING *entry;
+	ACL_ASTREAM *astream;
+
+	aio->cork_flushing = 1;
+
+	while ((entry = acl_ring_pop_head(&aio->cork_ring)) != NULL) {
+		astream = ACL_RING_TO_APPL(entry, ACL_ASTREAM, cork_entry);
+		if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE
+			| ACL_AIO_FLAG_DEAD | ACL_AIO_FLAG_ISWR)))
+		{
+			continue;
 		}
-	} else {
-		/* ˵дδϣҪٴηͣԽд¼
-		 * ¼ */
+		aio_fflush(astream);
+	}
+
+	aio->cork_flushing = 0;
+}
+
+int aio_cork_drain(ACL_ASTREAM *astream)
+{
+	int   nleft;
+
+	acl_ring_detach(&astream->cork_entry);
+
+	if ((astream->flag & ACL_AIO_FLAG_ISWR))
+		return (astream->write_left);
+
+	nleft = __try_fflush(astream);
+	if (nleft > 0)
 		WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+	return (nleft);
+}
+
+void acl_aio_set_cork(ACL_ASTREAM *astream, int limit)
+{
+	/* дϲ acl_aio_loop ÿ¼ѭʱͳһ͹ */
+	if (astream->aio->event_mode == ACL_EVENT_WMSG)
+		return;
+
+	if (limit > 0) {
+		astream->cork_limit = limit;
+		return;
+	}
+
+	astream->cork_limit = 0;
+	if (AIO_CORKED(astream)) {
+		acl_ring_detach(&astream->cork_entry);
+		if (!(astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE
+			| ACL_AIO_FLAG_DEAD | ACL_AIO_FLAG_ISWR)))
+		{
+			aio_fflush(astream);
+		}
 	}
 }
 
+int acl_aio_get_cork(ACL_ASTREAM *astream)
+{
+	return (astream->cork_limit);
+}
+
 void acl_aio_writen(ACL_ASTREAM *astream, const char *data, int dlen)
 {
 	const char *myname = "acl_aio_writen";
@@ -234,6 +513,13 @@ void acl_aio_writen(ACL_ASTREAM *astream, const char *data, int dlen)
 	if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE | ACL_AIO_FLAG_DEAD)))
 		return;
 
+	if (astream->cork_limit > 0) {
+		cork_append(astream, data, dlen);
+		cork_schedule(astream);
+		(void) write_water_high(astream);
+		return;
+	}
+
 	/* Ƕ׼1ԷֹǶײ̫ʹջ */
 	astream->write_nested++;
 
@@ -248,7 +534,7 @@ void acl_aio_writen(ACL_ASTREAM *astream, const char *data, int dlen)
 
 	/* Ƕ׵ôСڷֵǶ׵ */
 	/* ȳдде */
-	else if ((n = __try_fflush(astream)) < 0) {
+	else if ((n = try_fflush(astream)) < 0) {
 		/* ˵дʧܣҪر */
 		astream->write_nested--;
 		WRITE_IOCP_CLOSE(astream);
@@ -310,6 +596,9 @@ void acl_aio_writen(ACL_ASTREAM *astream, const char *data, int dlen)
 
 	/* д¼¼ */
 	WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+
+	/* де޼ˮλ */
+	(void) write_water_high(astream);
 }
 
 void acl_aio_vfprintf(ACL_ASTREAM *astream, const char *fmt, va_list ap)
@@ -321,6 +610,17 @@ void acl_aio_vfprintf(ACL_ASTREAM *astream, const char *fmt, va_list ap)
 	if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE | ACL_AIO_FLAG_DEAD)))
 		return;
 
+	if (astream->cork_limit > 0) {
+		str = acl_vstring_alloc(__default_line_length);
+		acl_vstring_vsprintf(str, fmt, ap);
+		cork_append(astream, acl_vstring_str(str),
+			(int) ACL_VSTRING_LEN(str));
+		acl_vstring_free(str);
+		cork_schedule(astream);
+		(void) write_water_high(astream);
+		return;
+	}
+
 	str = acl_vstring_alloc(__default_line_length);
 	acl_vstring_vsprintf(str, fmt, ap);
 
@@ -339,7 +639,7 @@ void acl_aio_vfprintf(ACL_ASTREAM *astream, const char *fmt, va_list ap)
 
 	/* Ƕ׵ôСڷֵǶ׵ */
 	/* ȳдде */
-	else if ((n = __try_fflush(astream)) < 0) {
+	else if ((n = try_fflush(astream)) < 0) {
 		/* ˵дʧܣҪر */
 		astream->write_nested--;
 		WRITE_IOCP_CLOSE(astream);
@@ -405,6 +705,9 @@ void acl_aio_vfprintf(ACL_ASTREAM *astream, const char *fmt, va_list ap)
 
 	/* д¼¼ */
 	WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+
+	/* де޼ˮλ */
+	(void) write_water_high(astream);
 }
 
 void acl_aio_fprintf(ACL_ASTREAM *astream, const char *fmt, ...)
@@ -428,6 +731,15 @@ void acl_aio_writev(ACL_ASTREAM *astream, const struct iovec *vector, int count)
 	if ((astream->flag & (ACL_AIO_FLAG_DELAY_CLOSE | ACL_AIO_FLAG_DEAD)))
 		return;
 
+	if (astream->cork_limit > 0) {
+		for (i = 0; i < count; i++)
+			cork_append(astream, (const char*) vector[i].iov_base,
+				(int) vector[i].iov_len);
+		cork_schedule(astream);
+		(void) write_water_high(astream);
+		return;
+	}
+
 	/* Ƕ׼1ԷֹǶײ̫ʹջ */
 	astream->write_nested++;
 
@@ -444,7 +756,7 @@ void acl_aio_writev(ACL_ASTREAM *astream, const struct iovec *vector, int count)
 
 	/* Ƕ׵ôСڷֵǶ׵ */
 	/* ȳдде */
-	else if ((n = __try_fflush(astream)) < 0) {
+	else if ((n = try_fflush(astream)) < 0) {
 		/* ˵дʧܣҪر */
 		astream->write_nested--;
 		WRITE_IOCP_CLOSE(astream);
@@ -534,6 +846,9 @@ void acl_aio_writev(ACL_ASTREAM *astream, const struct iovec *vector, int count)
 
 	/* д¼¼ */
 	WRITE_SAFE_ENABLE(astream, __writen_notify_callback);
+
+	/* де޼ˮλ */
+	(void) write_water_high(astream);
 }
 
 static void can_write_callback(int event_type, ACL_EVENT *event acl_unused,
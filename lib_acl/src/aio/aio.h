@@ -19,6 +19,8 @@ struct ACL_AIO {
 	int   rbuf_size;
 	int   event_mode;
 	ACL_ARRAY *dead_streams;
+	ACL_RING cork_ring;	/* дϲģʽ´ݵ첽 */
+	int   cork_flushing;
 #if defined(_WIN32) || defined(_WIN64)
 	int   timer_active;
 	unsigned int tid;
@@ -65,6 +67,11 @@ void aio_close_callback(ACL_ASTREAM *astream);
 /* in acl_aio_stream.c */
 void aio_delay_check(ACL_AIO *aio);
 
+/* in acl_aio_write.c */
+#define AIO_CORKED(x) ((x)->cork_entry.parent != &(x)->cork_entry)
+void aio_cork_flush(ACL_AIO *aio);
+int  aio_cork_drain(ACL_ASTREAM *astream);
+
 #ifdef __cplusplus
 }
 #endif
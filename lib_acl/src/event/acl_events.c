@@ -46,7 +46,7 @@ static void event_init(ACL_EVENT *eventp, int fdsize,
 	eventp->delay_sec  = delay_sec + delay_usec / 1000000;
 	eventp->delay_usec = delay_usec % 1000000;
 
-	acl_ring_init(&eventp->timer_head);
+	event_timers_init(&eventp->timers);
 	eventp->timer_keep = 0;
 	SET_TIME(eventp->present);
 	SET_TIME(eventp->last_debug);
@@ -270,6 +270,28 @@ void acl_event_set_check_inter(ACL_EVENT *eventp, int n)
 		eventp->check_inter = ((acl_int64) n) * 1000;
 }
 
+void acl_event_set_edge_trigger(ACL_EVENT *eventp, int onoff)
+{
+	eventp->edge_trigger = onoff ? 1 : 0;
+}
+
+void acl_event_set_listen_exclusive(ACL_EVENT *eventp, int onoff)
+{
+	eventp->listen_exclusive = onoff ? 1 : 0;
+}
+
+void acl_event_get_stat(ACL_EVENT *eventp, ACL_EVENT_STAT *stat)
+{
+	memcpy(stat, &eventp->stat, sizeof(ACL_EVENT_STAT));
+}
+
+void acl_event_reset_stat(ACL_EVENT *eventp)
+{
+	eventp->stat.nctl    = 0;
+	eventp->stat.nwait   = 0;
+	eventp->stat.nevents = 0;
+}
+
 void acl_event_set_fire_hook(ACL_EVENT *eventp,
 	void (*fire_begin)(ACL_EVENT*, void*),
 	void (*fire_end)(ACL_EVENT*, void*), void* ctx)
@@ -287,13 +309,10 @@ void acl_event_add_dog(ACL_EVENT *eventp)
 void acl_event_free(ACL_EVENT *eventp)
 {
 	void (*free_fn)(ACL_EVENT *) = eventp->free_fn;
-	ACL_EVENT_TIMER *timer;
-
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
-		acl_ring_detach(&timer->ring);
-		acl_myfree(timer);
-	}
 
+	event_timers_free(&eventp->timers);
+	if (eventp->profile)
+		event_profile_free(eventp->profile);
 	acl_myfree(eventp->fdtabs);
 	acl_myfree(eventp->ready);
 	free_fn(eventp);
@@ -21,7 +21,12 @@ void event_check_fds(ACL_EVENT *ev)
 			ev->ready[ev->ready_cnt++] = fdp;
 		} else if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)) {
 			if (ACL_VSTREAM_BFRD_CNT(fdp->stream) > 0) {
-				fdp->stream->read_ready = 0;
+				/* edge-triggered streams keep read_ready until a
+				 * short read or EAGAIN, else the data left in the
+				 * kernel won't be notified again
+				 */
+				if (!(fdp->stream->flag & ACL_VSTREAM_FLAG_EDGE))
+					fdp->stream->read_ready = 0;
 				fdp->event_type |= ACL_EVENT_READ;
 				fdp->fdidx_ready = ev->ready_cnt;
 				ev->ready[ev->ready_cnt++] = fdp;
@@ -69,7 +74,8 @@ int event_prepare(ACL_EVENT *ev)
 				fdp->fdidx_ready = ev->ready_cnt;
 				ev->ready[ev->ready_cnt++] = fdp;
 			} else if (ACL_VSTREAM_BFRD_CNT(fdp->stream) > 0) {
-				fdp->stream->read_ready = 0;
+				if (!(fdp->stream->flag & ACL_VSTREAM_FLAG_EDGE))
+					fdp->stream->read_ready = 0;
 				fdp->event_type |= ACL_EVENT_READ;
 				fdp->fdidx_ready = ev->ready_cnt;
 				ev->ready[ev->ready_cnt++] = fdp;
@@ -119,12 +125,12 @@ void event_fire(ACL_EVENT *ev)
 			w_callback = fdp->w_callback;
 
 			if (r_callback)
-				r_callback(ACL_EVENT_XCPT, ev,
+				EVENT_CALL_RDWR(ev, r_callback, ACL_EVENT_XCPT,
 					fdp->stream, fdp->r_context);
 
 			/* ready[i] maybe been set NULL in r_callback */
 			if (w_callback && ready[i])
-				w_callback(ACL_EVENT_XCPT, ev,
+				EVENT_CALL_RDWR(ev, w_callback, ACL_EVENT_XCPT,
 					fdp->stream, fdp->w_context);
 			continue;
 		}
@@ -138,14 +144,16 @@ void event_fire(ACL_EVENT *ev)
 
 			if (r_timeout > 0 && r_callback) {
 				fdp->r_ttl = ev->present + fdp->r_timeout;
-				fdp->r_callback(ACL_EVENT_RW_TIMEOUT, ev,
+				EVENT_CALL_RDWR(ev, r_callback,
+					ACL_EVENT_RW_TIMEOUT,
 					fdp->stream, fdp->r_context);
 			}
 
 			/* ready[i] maybe been set NULL in r_callback */
 			if (w_timeout > 0 && w_callback && ready[i]) {
 				fdp->w_ttl = ev->present + fdp->w_timeout;
-				fdp->w_callback(ACL_EVENT_RW_TIMEOUT, ev,
+				EVENT_CALL_RDWR(ev, w_callback,
+					ACL_EVENT_RW_TIMEOUT,
 					fdp->stream, fdp->w_context);
 			}
 			continue;
@@ -155,7 +163,8 @@ void event_fire(ACL_EVENT *ev)
 			fdp->event_type &= ~(ACL_EVENT_READ | ACL_EVENT_ACCEPT);
 			if (fdp->r_timeout > 0)
 				fdp->r_ttl = ev->present + fdp->r_timeout;
-			fdp->r_callback(type, ev, fdp->stream, fdp->r_context);
+			EVENT_CALL_RDWR(ev, fdp->r_callback, type,
+				fdp->stream, fdp->r_context);
 
 			/* If there's some data lefting in stream's buf, then
 			 * increasing the eventp->read_ready to trigger the
@@ -178,7 +187,8 @@ void event_fire(ACL_EVENT *ev)
 			if (fdp->w_timeout > 0)
 				fdp->w_ttl = ev->present + fdp->w_timeout;
 			fdp->event_type &= ~(ACL_EVENT_WRITE | ACL_EVENT_CONNECT);
-			fdp->w_callback(type, ev, fdp->stream, fdp->w_context);
+			EVENT_CALL_RDWR(ev, fdp->w_callback, type,
+				fdp->stream, fdp->w_context);
 		}
 	}
 
@@ -215,7 +225,8 @@ int event_thr_prepare(ACL_EVENT *ev)
 				fdp->fdidx_ready = ev->ready_cnt;
 				ev->ready[ev->ready_cnt++] = fdp;
 			} else if (ACL_VSTREAM_BFRD_CNT(fdp->stream) > 0) {
-				fdp->stream->read_ready = 0;
+				if (!(fdp->stream->flag & ACL_VSTREAM_FLAG_EDGE))
+					fdp->stream->read_ready = 0;
 				fdp->event_type = ACL_EVENT_READ;
 				fdp->fdidx_ready = ev->ready_cnt;
 				ev->ready[ev->ready_cnt++] = fdp;
@@ -51,6 +51,7 @@ struct ACL_EVENT_FDTABLE {
 #define EVENT_FDTABLE_FLAG_DELAY_OPER   (1 << 8)
 #define EVENT_FDTABLE_FLAG_IOCP         (1 << 9)
 #define	EVENT_FDTABLE_FLAG_FIRE		(1 << 10)
+#define	EVENT_FDTABLE_FLAG_EDGE		(1 << 11)	/* ѰԵʽע */
 
 	int   fdidx;
 	int   fdidx_ready;
@@ -63,6 +64,20 @@ struct ACL_EVENT_FDTABLE {
 #endif
 };
 
+/*
+ * ʱϣ (when, seq) ΪСȡ絽ڵĶʱ
+ * (callback, context) ΪĹϣ O(1) ʱڲҶʱӶʹ
+ * ʱáüȡҪжʱ
+ */
+typedef struct EVENT_TIMERS {
+	ACL_EVENT_TIMER **heap;		/* С */
+	int   size;			/* heap  */
+	int   count;			/* ʱ */
+	ACL_EVENT_TIMER **table;	/* ϣ */
+	unsigned int tsize;		/* ϣͰΪ 2  */
+	acl_uint64 seq;			/* ͬһʱ̵Ķʱ˳򴥷 */
+} EVENT_TIMERS;
+
 struct	ACL_EVENT {
 	/* ¼Ʊʶ */
 	char  name[128];
@@ -89,8 +104,8 @@ struct	ACL_EVENT {
 	int   delay_usec;
 	/* ѭǰݿɶָ */
 	int   read_ready;
-	/* ʱбͷ */
-	ACL_RING timer_head;
+	/* ʱ񼯺 */
+	EVENT_TIMERS timers;
 
 	/* ׽ */
 	int   fdsize;
@@ -155,6 +170,15 @@ struct	ACL_EVENT {
 	void (*fire_end)(ACL_EVENT *, void *);
 	/* fire_begin/fire_finish ĵڶ */
 	void *fire_ctx;
+
+	/* ں¼ǷñԵʽ */
+	int   edge_trigger;
+	/* Ƿʹ EPOLLEXCLUSIVE */
+	int   listen_exclusive;
+	/* ¼ͳϢ */
+	ACL_EVENT_STAT stat;
+	/* ¼ѭܷδʱΪ NULL */
+	struct EVENT_PROFILE *profile;
 };
 
 /* 뱣ּʱǳ */
@@ -242,13 +266,16 @@ struct ACL_EVENT_TIMER {
 	int   nrefer;                   /* refered's count       */
 	int   ncount;                   /* timer callback count  */
 	int   keep;                     /* if timer call restart */
+	int   heap_idx;                 /* index in timers' heap */
+	acl_uint64 seq;                 /* order of same when    */
+	ACL_EVENT_TIMER *hnext;         /* next in hash bucket   */
 };
 
 #define ACL_RING_TO_TIMER(r) \
 	((ACL_EVENT_TIMER *) ((char *) (r) - offsetof(ACL_EVENT_TIMER, ring)))
 
-#define ACL_FIRST_TIMER(head) \
-	(acl_ring_succ(head) != (head) ? ACL_RING_TO_TIMER(acl_ring_succ(head)) : 0)
+#define ACL_FIRST_TIMER(timers) \
+	((timers)->count > 0 ? (timers)->heap[0] : NULL)
 
 #ifdef	EVENT_USE_SPINLOCK
 
@@ -320,7 +347,52 @@ struct ACL_EVENT_TIMER {
 	(x) = ((acl_int64) _tv.tv_sec) * 1000000 + ((acl_int64) _tv.tv_usec);  \
 }
 
+/* in events_profile.c */
+typedef struct EVENT_PROFILE EVENT_PROFILE;
+
+acl_int64 event_profile_now(void);
+void event_profile_free(EVENT_PROFILE *profile);
+void event_profile_callback(ACL_EVENT *ev, const void *callback,
+	acl_int64 begin);
+void event_profile_timer(ACL_EVENT *ev, acl_int64 when);
+void event_profile_wait(ACL_EVENT *ev, acl_int64 begin, int nready);
+void event_profile_loop(ACL_EVENT *ev, acl_int64 begin);
+
+/* öдصܷʱͳʱ */
+#define	EVENT_CALL_RDWR(ev, fn, type, stream, ctx) do {  \
+	ACL_EVENT_NOTIFY_RDWR _fn = (fn);  \
+	if ((ev)->profile == NULL)  \
+		_fn((type), (ev), (stream), (ctx));  \
+	else {  \
+		acl_int64 _begin = event_profile_now();  \
+		_fn((type), (ev), (stream), (ctx));  \
+		event_profile_callback((ev), (const void*) _fn, _begin);  \
+	}  \
+} while (0)
+
+/* öʱصܷʱͳ䴥ӳټʱ */
+#define	EVENT_CALL_TIMER(ev, fn, ctx, when) do {  \
+	ACL_EVENT_NOTIFY_TIME _fn = (fn);  \
+	if ((ev)->profile == NULL)  \
+		_fn(ACL_EVENT_TIME, (ev), (ctx));  \
+	else {  \
+		acl_int64 _begin;  \
+		event_profile_timer((ev), (when));  \
+		_begin = event_profile_now();  \
+		_fn(ACL_EVENT_TIME, (ev), (ctx));  \
+		event_profile_callback((ev), (const void*) _fn, _begin);  \
+	}  \
+} while (0)
+
 /* in events_timer.c */
+void event_timers_init(EVENT_TIMERS *timers);
+void event_timers_free(EVENT_TIMERS *timers);
+ACL_EVENT_TIMER *event_timers_find(EVENT_TIMERS *timers,
+	ACL_EVENT_NOTIFY_TIME callback, const void *context);
+void event_timers_add(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer);
+void event_timers_update(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer);
+void event_timers_del(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer);
+
 acl_int64 event_timer_request(ACL_EVENT *ev, ACL_EVENT_NOTIFY_TIME callback,
 	void *context, acl_int64 delay, int keep);
 acl_int64 event_timer_cancel(ACL_EVENT *ev, ACL_EVENT_NOTIFY_TIME callback,
@@ -65,6 +65,17 @@ extern "C" {
 	EVENT_REG_ADD_OP((er), (eh), (fh), (ctx), EPOLLIN | EPOLLOUT)
 #define	EVENT_REG_ADD_TEXT	"epoll_ctl EPOLL_CTL_ADD"
 
+/* Եʽһעд¼֮޸ */
+#define	EVENT_REG_ADD_EDGE(er, eh, fh, ctx) \
+	EVENT_REG_ADD_OP((er), (eh), (fh), (ctx), EPOLLIN | EPOLLOUT | EPOLLET)
+
+/*  epoll ͬһʱ⾪Ⱥ, Ҫ Linux 4.5 ϰ汾 */
+#ifndef	EPOLLEXCLUSIVE
+#define	EPOLLEXCLUSIVE	(1U << 28)
+#endif
+#define	EVENT_REG_ADD_EXCL(er, eh, fh, ctx) \
+	EVENT_REG_ADD_OP((er), (eh), (fh), (ctx), EPOLLIN | EPOLLEXCLUSIVE)
+
 #define	EVENT_REG_MOD_OP(er, eh, fh, ctx, ev) \
 	EVENT_REG_FD_OP((er), (eh), (fh), (ctx), (ev), EPOLL_CTL_MOD)
 #define	EVENT_REG_MOD_READ(er, eh, fh, ctx) \
@@ -736,7 +736,7 @@ static void event_loop(ACL_EVENT *eventp)
 	 * Find out when the next timer would go off. Timer requests are sorted.
 	 * If any timer is scheduled, adjust the delay appropriately.
 	 */
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		acl_int64 n = (timer->when - eventp->present) / 1000;
 
 		if (n <= 0)
@@ -768,7 +768,7 @@ TAG_DONE:
 	* the application.
 	*/
 	SET_TIME(eventp->present);
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 		timer_fn  = timer->callback;
@@ -782,7 +782,7 @@ TAG_DONE:
 			eventp->timer_request(eventp, timer->callback,
 				timer->context, timer->delay, timer->keep);
 		} else {
-			acl_ring_detach(&timer->ring);  /* first this */
+			event_timers_del(&eventp->timers, timer);  /* first this */
 			timer->nrefer--;
 			if (timer->nrefer != 0)
 				acl_msg_fatal("%s(%d): nrefer(%d) != 0",
@@ -60,6 +60,59 @@ typedef struct EVENT_KERNEL {
 
 #include "stdlib/acl_meter_time.h"
 
+/* ͳ޸ں¼صĴ */
+#define	CTL_STAT(ev)	((ev)->event.stat.nctl++)
+
+/* ÿεȴں¼ʱɷص¼ĳʼֵ */
+#define	MIN_EVENTS	1000
+#define	MAX_EVENTS	65536
+
+#ifdef	EVENT_REG_ADD_EDGE
+
+/* Եʽ½ּϣھ¼ͣ
+ * Ѵ쳣ʱ״̬ӦĻص̴
+ */
+
+static void edge_ready(ACL_EVENT *eventp, ACL_EVENT_FDTABLE *fdp, int type)
+{
+	if ((fdp->event_type & (ACL_EVENT_XCPT | ACL_EVENT_RW_TIMEOUT)))
+		return;
+	if ((fdp->event_type & (ACL_EVENT_READ | ACL_EVENT_WRITE)) == 0) {
+		fdp->fdidx_ready = eventp->ready_cnt;
+		eventp->ready[eventp->ready_cnt++] = fdp;
+	}
+	fdp->event_type |= type;
+}
+
+/* Եʽֽ״αʱһעд¼ */
+
+static void edge_register(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
+{
+	const char *myname = "edge_register";
+	ACL_SOCKET sockfd = ACL_VSTREAM_SOCK(fdp->stream);
+	int   err;
+
+	if ((fdp->flag & EVENT_FDTABLE_FLAG_EDGE))
+		return;
+
+	EVENT_REG_ADD_EDGE(err, ev->event_fd, sockfd, fdp);
+	CTL_STAT(ev);
+	if (err < 0) {
+		acl_msg_fatal("%s: %s: %s, err(%d), fd(%d)",
+			myname, EVENT_REG_ADD_TEXT,
+			acl_last_serror(), err, sockfd);
+	}
+
+	fdp->flag |= EVENT_FDTABLE_FLAG_EDGE;
+	fdp->stream->flag |= ACL_VSTREAM_FLAG_EDGE;
+}
+
+/* ǷñԵʽǲˮƽʽ */
+#define	EDGE_MODE(ev, fdp) (((fdp)->flag & EVENT_FDTABLE_FLAG_EDGE)  \
+	|| ((ev)->event.edge_trigger && !(fdp)->listener))
+
+#endif	/* EVENT_REG_ADD_EDGE */
+
 static void stream_on_close(ACL_VSTREAM *stream, void *arg)
 {
 	const char *myname = "stream_on_close";
@@ -73,10 +126,12 @@ static void stream_on_close(ACL_VSTREAM *stream, void *arg)
 
 #ifdef EVENT_REG_DEL_BOTH
 	if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)
-		|| (fdp->flag & EVENT_FDTABLE_FLAG_WRITE))
+		|| (fdp->flag & EVENT_FDTABLE_FLAG_WRITE)
+		|| (fdp->flag & EVENT_FDTABLE_FLAG_EDGE))
 	{
 # ifndef EVENT_AUTO_DEL
 		EVENT_REG_DEL_BOTH(err, ev->event_fd, sockfd);
+		CTL_STAT(ev);
 		ret = 1;
 # else
 		ret = 2;
@@ -89,6 +144,7 @@ static void stream_on_close(ACL_VSTREAM *stream, void *arg)
 # ifndef EVENT_AUTO_DEL
 		EVENT_REG_DEL_READ(err, ev->event_fd, sockfd);
 		EVENT_REG_DEL_WRITE(err, ev->event_fd, sockfd);
+		ev->event.stat.nctl += 2;
 		ret = 3;
 # else
 		ret = 4;
@@ -96,6 +152,7 @@ static void stream_on_close(ACL_VSTREAM *stream, void *arg)
 	} else if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)) {
 # ifndef EVENT_AUTO_DEL
 		EVENT_REG_DEL_READ(err, ev->event_fd, sockfd);
+		CTL_STAT(ev);
 		ret = 5;
 # else
 		ret = 6;
@@ -103,6 +160,7 @@ static void stream_on_close(ACL_VSTREAM *stream, void *arg)
 	} else if ((fdp->flag & EVENT_FDTABLE_FLAG_WRITE)) {
 # ifndef EVENT_AUTO_DEL
 		EVENT_REG_DEL_WRITE(err, ev->event_fd, sockfd);
+		CTL_STAT(ev);
 # else
 		ret = 7;
 # endif
@@ -458,14 +516,18 @@ static void event_disable_readwrite(ACL_EVENT *eventp, ACL_VSTREAM *stream)
 
 #ifdef	EVENT_REG_DEL_BOTH
 	EVENT_REG_DEL_BOTH(err, ev->event_fd, sockfd);
+	CTL_STAT(ev);
 #else
 	if (fdp->flag & EVENT_FDTABLE_FLAG_READ) {
 		EVENT_REG_DEL_READ(err, ev->event_fd, sockfd);
+		CTL_STAT(ev);
 	}
 	if (fdp->flag & EVENT_FDTABLE_FLAG_WRITE) {
 		EVENT_REG_DEL_WRITE(err, ev->event_fd, sockfd);
+		CTL_STAT(ev);
 	}
 #endif
+	stream->flag &= ~ACL_VSTREAM_FLAG_EDGE;
 
 	if (err < 0) {
 		acl_msg_fatal("%s: %s: %s", myname, EVENT_REG_DEL_TEXT,
@@ -495,6 +557,35 @@ static void enable_read(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	fdp->flag &= ~EVENT_FDTABLE_FLAG_ADD_READ;
 	fdp->flag |= EVENT_FDTABLE_FLAG_READ;
 
+#ifdef	EVENT_REG_ADD_EDGE
+	/* Եʽ½״עᣬֻ֮޸û̬־λֹ
+	 * ڼ䵽Ŀɶ¼Ѽ¼ϵͳɶ־Уֱ
+	 * ϣΪµĿɶ¼֪ͨ
+	 */
+	if (EDGE_MODE(ev, fdp)) {
+		edge_register(ev, fdp);
+		if (fdp->stream->read_ready
+			|| ACL_VSTREAM_BFRD_CNT(fdp->stream) > 0)
+		{
+			edge_ready(&ev->event, fdp, ACL_EVENT_READ);
+		}
+		return;
+	}
+
+	if (fdp->listener && ev->event.listen_exclusive
+		&& !(fdp->flag & EVENT_FDTABLE_FLAG_WRITE))
+	{
+		EVENT_REG_ADD_EXCL(err, ev->event_fd, sockfd, fdp);
+		CTL_STAT(ev);
+		if (err < 0) {
+			acl_msg_fatal("%s: %s: %s, err(%d), fd(%d)",
+				myname, EVENT_REG_ADD_TEXT,
+				acl_last_serror(), err, sockfd);
+		}
+		return;
+	}
+#endif
+
 	if ((fdp->flag & EVENT_FDTABLE_FLAG_WRITE)) {
 #if (ACL_EVENTS_KERNEL_STYLE == ACL_EVENTS_STYLE_KQUEUE)
 		EVENT_REG_ADD_READ(err, ev->event_fd, sockfd, fdp);
@@ -504,6 +595,7 @@ static void enable_read(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	} else {
 		EVENT_REG_ADD_READ(err, ev->event_fd, sockfd, fdp);
 	}
+	CTL_STAT(ev);
 	if (err < 0) {
 		acl_msg_fatal("%s: %s: %s, err(%d), fd(%d)",
 			myname, EVENT_REG_ADD_TEXT,
@@ -520,6 +612,25 @@ static void enable_write(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	fdp->flag &= ~EVENT_FDTABLE_FLAG_ADD_WRITE;
 	fdp->flag |= EVENT_FDTABLE_FLAG_WRITE;
 
+#ifdef	EVENT_REG_ADD_EDGE
+	if (EDGE_MODE(ev, fdp)) {
+		int registered = fdp->flag & EVENT_FDTABLE_FLAG_EDGE;
+
+		edge_register(ev, fdp);
+
+		/* ڽֹдڼ䵽Ŀд¼ѱԣд
+		 * ʱȼٶддʱں˻֮ں˻
+		 * пռʱµĿд¼֪ͨӹȴд¼
+		 */
+		if (registered && !(fdp->stream->flag
+			& ACL_VSTREAM_FLAG_CONNECTING))
+		{
+			edge_ready(&ev->event, fdp, ACL_EVENT_WRITE);
+		}
+		return;
+	}
+#endif
+
 	if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)) {
 #if (ACL_EVENTS_KERNEL_STYLE == ACL_EVENTS_STYLE_KQUEUE)
 		EVENT_REG_ADD_WRITE(err, ev->event_fd, sockfd, fdp);
@@ -529,6 +640,7 @@ static void enable_write(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	} else {
 		EVENT_REG_ADD_WRITE(err, ev->event_fd, sockfd, fdp);
 	}
+	CTL_STAT(ev);
 
 	if (err < 0) {
 		acl_msg_fatal("%s: %s: %s, err(%d), fd(%d)",
@@ -548,6 +660,12 @@ static int disable_read(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	fdp->flag &= ~EVENT_FDTABLE_FLAG_READ;
 	fdp->event_type &= ~(ACL_EVENT_READ | ACL_EVENT_ACCEPT);
 
+	/* Եʽֱע״ֱ̬ر */
+	if ((fdp->flag & EVENT_FDTABLE_FLAG_EDGE))
+		return ret;
+
+	CTL_STAT(ev);
+
 	if ((fdp->flag & EVENT_FDTABLE_FLAG_WRITE)) {
 #if (ACL_EVENTS_KERNEL_STYLE == ACL_EVENTS_STYLE_KQUEUE)
 		EVENT_REG_DEL_READ(err, ev->event_fd, sockfd);
@@ -584,6 +702,11 @@ static int disable_write(EVENT_KERNEL *ev, ACL_EVENT_FDTABLE *fdp)
 	fdp->flag &= ~EVENT_FDTABLE_FLAG_WRITE;
 	fdp->event_type &= ~(ACL_EVENT_WRITE | ACL_EVENT_CONNECT);
 
+	if ((fdp->flag & EVENT_FDTABLE_FLAG_EDGE))
+		return ret;
+
+	CTL_STAT(ev);
+
 	if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)) {
 #if (ACL_EVENTS_KERNEL_STYLE == ACL_EVENTS_STYLE_KQUEUE)
 		EVENT_REG_DEL_WRITE(err, ev->event_fd, sockfd);
@@ -651,6 +774,30 @@ static void event_set_all(ACL_EVENT *eventp)
 	}
 }
 
+#ifdef	EVENT_REG_ADD_EDGE
+
+/* Եʽں˷ص¼ɶ¼Ǽ¼ϵͳɶ־У
+ * Աڽֹڼ䵽öغܱʱ
+ */
+
+static void edge_check(ACL_EVENT *eventp, ACL_EVENT_FDTABLE *fdp,
+	EVENT_BUFFER *bp)
+{
+	if (EVENT_TEST_READ(bp) || EVENT_TEST_ERROR(bp)) {
+		fdp->stream->read_ready = 1;
+		if ((fdp->flag & EVENT_FDTABLE_FLAG_READ))
+			edge_ready(eventp, fdp, ACL_EVENT_READ);
+	}
+
+	if (EVENT_TEST_WRITE(bp) || EVENT_TEST_ERROR(bp)) {
+		fdp->stream->flag &= ~ACL_VSTREAM_FLAG_CONNECTING;
+		if ((fdp->flag & EVENT_FDTABLE_FLAG_WRITE))
+			edge_ready(eventp, fdp, ACL_EVENT_WRITE);
+	}
+}
+
+#endif	/* EVENT_REG_ADD_EDGE */
+
 static void event_loop(ACL_EVENT *eventp)
 {
 	const char *myname = "event_loop";
@@ -658,9 +805,13 @@ static void event_loop(ACL_EVENT *eventp)
 	ACL_EVENT_NOTIFY_TIME timer_fn;
 	void    *timer_arg;
 	ACL_EVENT_TIMER *timer;
-	int   delay, nready;
+	int   delay, nready = 0;
 	ACL_EVENT_FDTABLE *fdp;
 	EVENT_BUFFER *bp;
+	acl_int64 when, begin = 0, wait_begin = 0;
+
+	if (eventp->profile)
+		begin = event_profile_now();
 
 	delay = (int) (eventp->delay_sec * 1000 + eventp->delay_usec / 1000);
 	if (delay < 0)
@@ -672,7 +823,7 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/* ݶʱ epoll/kqueue/devpoll ļⳬʱ */
 
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		acl_int64 n = (timer->when - eventp->present) / 1000;
 
 		if (n <= 0)
@@ -701,8 +852,13 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/*  epoll/kquque/devpoll ϵͳü */
 
+	if (eventp->profile)
+		wait_begin = event_profile_now();
 	EVENT_BUFFER_READ(nready, ev->event_fd, ev->event_buf,
 		ev->event_fdslots, delay);
+	eventp->stat.nwait++;
+	if (eventp->profile)
+		event_profile_wait(eventp, wait_begin, nready);
 
 	if (eventp->nested++ > 0)
 		acl_msg_fatal("%s(%d): recursive call, nested: %d",
@@ -716,6 +872,8 @@ static void event_loop(ACL_EVENT *eventp)
 	} else if (nready == 0)
 		goto TAG_DONE;
 
+	eventp->stat.nevents += nready;
+
 	/*  */
 
 	for (bp = ev->event_buf; bp < ev->event_buf + nready; bp++) {
@@ -740,6 +898,13 @@ static void event_loop(ACL_EVENT *eventp)
 		if ((fdp->event_type & (ACL_EVENT_XCPT | ACL_EVENT_RW_TIMEOUT)))
 			continue;
 
+#ifdef	EVENT_REG_ADD_EDGE
+		if ((fdp->flag & EVENT_FDTABLE_FLAG_EDGE)) {
+			edge_check(eventp, fdp, bp);
+			continue;
+		}
+#endif
+
 		/* Ƿɶ */
 
 		if ((fdp->flag & EVENT_FDTABLE_FLAG_READ)
@@ -810,11 +975,12 @@ TAG_DONE:
 
 	SET_TIME(eventp->present);
 
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 		timer_fn  = timer->callback;
 		timer_arg = timer->context;
+		when      = timer->when;
 
 		/* ʱʱ > 0 ʱѭã趨ʱ */
 		if (timer->delay > 0 && timer->keep) {
@@ -822,14 +988,14 @@ TAG_DONE:
 			eventp->timer_request(eventp, timer->callback,
 				timer->context, timer->delay, timer->keep);
 		} else {
-			acl_ring_detach(&timer->ring);	/* first this */
+			event_timers_del(&eventp->timers, timer);  /* first this */
 			timer->nrefer--;
 			if (timer->nrefer != 0)
 				acl_msg_fatal("%s(%d): nrefer(%d) != 0",
 					myname, __LINE__, timer->nrefer);
 			acl_myfree(timer);
 		}
-		timer_fn(ACL_EVENT_TIME, eventp, timer_arg);
+		EVENT_CALL_TIMER(eventp, timer_fn, timer_arg, when);
 	}
 
 	/* ׼õ¼ */
@@ -838,6 +1004,21 @@ TAG_DONE:
 		event_fire(eventp);
 
 	eventp->nested--;
+
+	if (eventp->profile)
+		event_profile_loop(eventp, begin);
+
+	/* ¼ﵽʱ˵ؽϸߣ¼Լٵȴ */
+
+	if (nready == ev->event_fdslots && ev->event_fdslots < MAX_EVENTS) {
+		ev->event_fdslots *= 2;
+		if (ev->event_fdslots > MAX_EVENTS)
+			ev->event_fdslots = MAX_EVENTS;
+		acl_myfree(ev->event_buf);
+		ev->event_buf = (EVENT_BUFFER *) acl_mycalloc(
+			ev->event_fdslots + 1, sizeof(EVENT_BUFFER));
+		eventp->stat.nslots = ev->event_fdslots;
+	}
 }
 
 static int event_isrset(ACL_EVENT *eventp acl_unused, ACL_VSTREAM *stream)
@@ -878,7 +1059,7 @@ ACL_EVENT *event_new_kernel(int fdsize acl_unused)
 {
 	ACL_EVENT *eventp;
 	EVENT_KERNEL *ev;
-	static int __default_max_events = 1000;
+	static int __default_max_events = MIN_EVENTS;
 
 	eventp = event_alloc(sizeof(EVENT_KERNEL));
 
@@ -904,6 +1085,7 @@ ACL_EVENT *event_new_kernel(int fdsize acl_unused)
 	ev = (EVENT_KERNEL*) eventp;
 	EVENT_REG_INIT_HANDLE(ev->event_fd, fdsize);
 	ev->event_fdslots = __default_max_events;
+	eventp->stat.nslots = ev->event_fdslots;
 	ev->event_buf = (EVENT_BUFFER *)
 		acl_mycalloc(ev->event_fdslots + 1, sizeof(EVENT_BUFFER));
 	acl_ring_init(&ev->fdp_delay_list);
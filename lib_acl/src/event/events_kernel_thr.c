@@ -378,7 +378,7 @@ static void event_loop(ACL_EVENT *eventp)
 	 * Find out when the next timer would go off. Timer requests are sorted.
 	 * If any timer is scheduled, adjust the delay appropriately.
 	 */
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		acl_int64 n = (timer->when
 			- eventp->present + 1000000 - 1) / 1000000;
 		if (n <= 0) {
@@ -493,11 +493,11 @@ TAG_DONE:
 
 	THREAD_LOCK(&event_thr->event.tm_mutex);
 
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 
-		acl_ring_detach(&timer->ring);  /* first this */
+		event_timers_del(&eventp->timers, timer);  /* first this */
 		acl_ring_prepend(&timer_ring, &timer->ring);
 	}
 
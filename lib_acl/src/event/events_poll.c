@@ -370,6 +370,10 @@ static void event_loop(ACL_EVENT *eventp)
 	ACL_EVENT_TIMER *timer;
 	int   delay, nready, i, revents;
 	ACL_EVENT_FDTABLE *fdp;
+	acl_int64 when, begin = 0, wait_begin = 0;
+
+	if (eventp->profile)
+		begin = event_profile_now();
 
 	delay = eventp->delay_sec * 1000 + eventp->delay_usec / 1000;
 	if (delay < 0)
@@ -381,7 +385,7 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/* ݶʱ poll ļⳬʱ */
 
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		acl_int64 n = timer->when - eventp->present;
 		if (n <= 0)
 			delay = 0;
@@ -412,7 +416,11 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/*  poll ϵͳü */
 
+	if (eventp->profile)
+		wait_begin = event_profile_now();
 	nready = poll(ev->fds, eventp->fdcnt, delay);
+	if (eventp->profile)
+		event_profile_wait(eventp, wait_begin, nready);
 
 	if (eventp->nested++ > 0)
 		acl_msg_fatal("%s(%d): recursive call", myname, __LINE__);
@@ -498,11 +506,12 @@ TAG_DONE:
 
 	/* ȴʱе */
 
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 		timer_fn  = timer->callback;
 		timer_arg = timer->context;
+		when      = timer->when;
 
 		/* ʱʱ > 0 ʱѭã
 		 * 趨ʱ
@@ -512,14 +521,14 @@ TAG_DONE:
 			eventp->timer_request(eventp, timer->callback,
 				timer->context, timer->delay, timer->keep);
 		} else {
-			acl_ring_detach(&timer->ring);  /* first this */
+			event_timers_del(&eventp->timers, timer);  /* first this */
 			timer->nrefer--;
 			if (timer->nrefer != 0)
 				acl_msg_fatal("%s(%d): nrefer(%d) != 0",
 					myname, __LINE__, timer->nrefer);
 			acl_myfree(timer);
 		}
-		timer_fn(ACL_EVENT_TIME, eventp, timer_arg);
+		EVENT_CALL_TIMER(eventp, timer_fn, timer_arg, when);
 	}
 
 	/* ׼õ¼ */
@@ -528,6 +537,9 @@ TAG_DONE:
 		event_fire(eventp);
 
 	eventp->nested--;
+
+	if (eventp->profile)
+		event_profile_loop(eventp, begin);
 }
 
 static int event_isrset(ACL_EVENT *eventp acl_unused, ACL_VSTREAM *stream)
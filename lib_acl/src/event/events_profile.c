@@ -0,0 +1,330 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ACL_BCB_COMPILER
+#pragma hdrstop
+#endif
+
+#include "stdlib/acl_mymalloc.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_mystring.h"
+#include "stdlib/acl_vstring.h"
+#include "stdlib/acl_vsprintf.h"
+#include "event/acl_events.h"
+
+#endif
+
+#include "events.h"
+
+/*
+ * ¼ѭܷʱ 2 Ϊ׵Ķֱͼÿص
+ * ַ뿪ѰַĹϣзֱͳƣԱҳ¼ѭص
+ */
+
+#define	PROFILE_INIT_SIZE	64
+#define	PROFILE_TAG_SIZE	64
+
+typedef struct CALLBACK_STAT {
+	const void *callback;
+	char   tag[PROFILE_TAG_SIZE];
+	ACL_EVENT_HIST hist;
+} CALLBACK_STAT;
+
+struct EVENT_PROFILE {
+	ACL_EVENT_PROFILE  all;
+	CALLBACK_STAT     *slots;
+	unsigned int       size;	/* ϣĲΪ 2  */
+	unsigned int       used;	/* õĲ */
+	acl_int64          wait_cost;	/* ѭеȴѵʱ */
+};
+
+acl_int64 event_profile_now(void)
+{
+	acl_int64 now;
+
+	SET_TIME(now);
+	return now;
+}
+
+static void hist_add(ACL_EVENT_HIST *hist, acl_int64 value)
+{
+	acl_uint64 n;
+	int   i = 0;
+
+	if (value < 0)
+		value = 0;
+	n = (acl_uint64) value;
+
+	hist->count++;
+	hist->sum += n;
+	if (n > hist->max)
+		hist->max = n;
+
+	while (n > 0 && i < ACL_EVENT_HIST_BUCKETS - 1) {
+		n >>= 1;
+		i++;
+	}
+	hist->buckets[i]++;
+}
+
+acl_uint64 acl_event_hist_percentile(const ACL_EVENT_HIST *hist, double pct)
+{
+	acl_uint64 want, cnt = 0, low, high;
+	int   i;
+
+	if (hist->count == 0)
+		return 0;
+	if (pct <= 0)
+		pct = 0.0001;
+	else if (pct > 100)
+		pct = 100;
+
+	want = (acl_uint64) (hist->count * pct / 100);
+	if (want == 0)
+		want = 1;
+
+	for (i = 0; i < ACL_EVENT_HIST_BUCKETS; i++) {
+		cnt += hist->buckets[i];
+		if (cnt >= want)
+			break;
+	}
+
+	if (i == 0)
+		return 0;
+
+	/* Ͱ [2^(i-1), 2^i) ڰλԹ㣬Ҳֵ */
+	low  = (acl_uint64) 1 << (i - 1);
+	high = i == ACL_EVENT_HIST_BUCKETS - 1 ? hist->max : low * 2 - 1;
+	if (high > hist->max)
+		high = hist->max;
+	if (high <= low)
+		return high;
+	cnt -= hist->buckets[i];
+	return low + (high - low) * (want - cnt) / hist->buckets[i];
+}
+
+static unsigned int callback_hash(const void *callback, unsigned int size)
+{
+	size_t h = (size_t) callback;
+
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return (unsigned int) (h & (size - 1));
+}
+
+static CALLBACK_STAT *callback_find(EVENT_PROFILE *profile,
+	const void *callback)
+{
+	unsigned int i = callback_hash(callback, profile->size);
+
+	while (profile->slots[i].callback != NULL) {
+		if (profile->slots[i].callback == callback)
+			return &profile->slots[i];
+		i = (i + 1) & (profile->size - 1);
+	}
+	return &profile->slots[i];
+}
+
+static void callback_grow(EVENT_PROFILE *profile)
+{
+	CALLBACK_STAT *old = profile->slots, *stat;
+	unsigned int   size = profile->size, i;
+
+	profile->size *= 2;
+	profile->slots = (CALLBACK_STAT *)
+		acl_mycalloc(profile->size, sizeof(CALLBACK_STAT));
+
+	for (i = 0; i < size; i++) {
+		if (old[i].callback == NULL)
+			continue;
+		stat = callback_find(profile, old[i].callback);
+		memcpy(stat, &old[i], sizeof(CALLBACK_STAT));
+	}
+	acl_myfree(old);
+}
+
+static CALLBACK_STAT *callback_get(EVENT_PROFILE *profile,
+	const void *callback)
+{
+	CALLBACK_STAT *stat = callback_find(profile, callback);
+
+	if (stat->callback != NULL)
+		return stat;
+
+	/* װӲ 1/2 */
+	if ((profile->used + 1) * 2 > profile->size) {
+		callback_grow(profile);
+		stat = callback_find(profile, callback);
+	}
+	stat->callback = callback;
+	profile->used++;
+	return stat;
+}
+
+void event_profile_free(EVENT_PROFILE *profile)
+{
+	acl_myfree(profile->slots);
+	acl_myfree(profile);
+}
+
+void event_profile_callback(ACL_EVENT *ev, const void *callback,
+	acl_int64 begin)
+{
+	EVENT_PROFILE *profile = ev->profile;
+	acl_int64 cost = event_profile_now() - begin;
+
+	/* صпܹرܷ */
+	if (profile == NULL)
+		return;
+
+	hist_add(&profile->all.callback, cost);
+	if (callback != NULL)
+		hist_add(&callback_get(profile, callback)->hist, cost);
+}
+
+void event_profile_timer(ACL_EVENT *ev, acl_int64 when)
+{
+	hist_add(&ev->profile->all.timer_lag, event_profile_now() - when);
+}
+
+void event_profile_wait(ACL_EVENT *ev, acl_int64 begin, int nready)
+{
+	EVENT_PROFILE *profile = ev->profile;
+
+	profile->wait_cost += event_profile_now() - begin;
+	hist_add(&profile->all.nready, nready > 0 ? nready : 0);
+}
+
+void event_profile_loop(ACL_EVENT *ev, acl_int64 begin)
+{
+	EVENT_PROFILE *profile = ev->profile;
+
+	/* begin Ϊ 0 ˵ڱѭвſܷ */
+	if (begin > 0)
+		hist_add(&profile->all.loop,
+			event_profile_now() - begin - profile->wait_cost);
+	profile->wait_cost = 0;
+}
+
+void acl_event_set_profile(ACL_EVENT *eventp, int onoff)
+{
+	if (onoff) {
+		if (eventp->profile != NULL)
+			return;
+		eventp->profile = (EVENT_PROFILE *)
+			acl_mycalloc(1, sizeof(EVENT_PROFILE));
+		eventp->profile->size  = PROFILE_INIT_SIZE;
+		eventp->profile->slots = (CALLBACK_STAT *)
+			acl_mycalloc(PROFILE_INIT_SIZE, sizeof(CALLBACK_STAT));
+	} else if (eventp->profile != NULL) {
+		event_profile_free(eventp->profile);
+		eventp->profile = NULL;
+	}
+}
+
+void acl_event_profile_tag(ACL_EVENT *eventp, const void *callback,
+	const char *tag)
+{
+	CALLBACK_STAT *stat;
+
+	if (eventp->profile == NULL || callback == NULL || tag == NULL)
+		return;
+	stat = callback_get(eventp->profile, callback);
+	ACL_SAFE_STRNCPY(stat->tag, tag, sizeof(stat->tag));
+}
+
+int acl_event_profile_get(ACL_EVENT *eventp, ACL_EVENT_PROFILE *out)
+{
+	if (eventp->profile == NULL)
+		return -1;
+	memcpy(out, &eventp->profile->all, sizeof(ACL_EVENT_PROFILE));
+	return 0;
+}
+
+void acl_event_profile_reset(ACL_EVENT *eventp)
+{
+	EVENT_PROFILE *profile = eventp->profile;
+	unsigned int i;
+
+	if (profile == NULL)
+		return;
+
+	memset(&profile->all, 0, sizeof(profile->all));
+	/* صıǩ */
+	for (i = 0; i < profile->size; i++)
+		memset(&profile->slots[i].hist, 0, sizeof(ACL_EVENT_HIST));
+}
+
+static void hist_dump(ACL_VSTRING *buf, const char *name,
+	const ACL_EVENT_HIST *hist)
+{
+	acl_vstring_sprintf_append(buf, "%s: count=" ACL_FMT_I64U
+		", avg=%.2f, p50=" ACL_FMT_I64U ", p99=" ACL_FMT_I64U
+		", p999=" ACL_FMT_I64U ", max=" ACL_FMT_I64U "\r\n", name,
+		hist->count, hist->count > 0 ?
+			(double) hist->sum / hist->count : 0.0,
+		acl_event_hist_percentile(hist, 50),
+		acl_event_hist_percentile(hist, 99),
+		acl_event_hist_percentile(hist, 99.9), hist->max);
+}
+
+static int callback_cmp(const void *a, const void *b)
+{
+	const CALLBACK_STAT *s1 = *(const CALLBACK_STAT * const *) a;
+	const CALLBACK_STAT *s2 = *(const CALLBACK_STAT * const *) b;
+
+	if (s1->hist.sum == s2->hist.sum)
+		return 0;
+	return s1->hist.sum < s2->hist.sum ? 1 : -1;
+}
+
+const char *acl_event_profile_dump(ACL_EVENT *eventp, ACL_VSTRING *buf,
+	int max)
+{
+	EVENT_PROFILE *profile = eventp->profile;
+	CALLBACK_STAT **stats;
+	char  name[PROFILE_TAG_SIZE + 32];
+	unsigned int i, n = 0;
+
+	if (profile == NULL)
+		return acl_vstring_str(buf);
+
+	hist_dump(buf, "loop(us)", &profile->all.loop);
+	hist_dump(buf, "callback(us)", &profile->all.callback);
+	hist_dump(buf, "timer_lag(us)", &profile->all.timer_lag);
+	hist_dump(buf, "nready", &profile->all.nready);
+
+	if (profile->used == 0 || max <= 0)
+		return acl_vstring_str(buf);
+
+	stats = (CALLBACK_STAT **)
+		acl_mymalloc(profile->used * sizeof(CALLBACK_STAT *));
+	for (i = 0; i < profile->size; i++) {
+		if (profile->slots[i].callback != NULL
+			&& profile->slots[i].hist.count > 0)
+		{
+			stats[n++] = &profile->slots[i];
+		}
+	}
+
+	qsort(stats, n, sizeof(CALLBACK_STAT *), callback_cmp);
+
+	for (i = 0; i < n && i < (unsigned int) max; i++) {
+		if (stats[i]->tag[0])
+			acl_snprintf(name, sizeof(name), "  %s(us)",
+				stats[i]->tag);
+		else
+			acl_snprintf(name, sizeof(name), "  %p(us)",
+				stats[i]->callback);
+		hist_dump(buf, name, &stats[i]->hist);
+	}
+
+	acl_myfree(stats);
+	return acl_vstring_str(buf);
+}
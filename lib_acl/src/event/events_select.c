@@ -380,6 +380,10 @@ static void event_loop(ACL_EVENT *eventp)
 	fd_set rmask;  /* enabled read events */
 	fd_set wmask;  /* enabled write events */
 	fd_set xmask;  /* for bad news mostly */
+	acl_int64 when, begin = 0, wait_begin = 0;
+
+	if (eventp->profile)
+		begin = event_profile_now();
 
 	delay = eventp->delay_sec * 1000000 + eventp->delay_usec;
 
@@ -389,7 +393,7 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/* ݶʱ select ļⳬʱ */
 
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		acl_int64 n = timer->when - eventp->present;
 
 		if (n <= 0)
@@ -434,11 +438,15 @@ static void event_loop(ACL_EVENT *eventp)
 
 	/*  select ϵͳü */
 
+	if (eventp->profile)
+		wait_begin = event_profile_now();
 #ifdef ACL_WINDOWS
 	nready = select(0, &rmask, &wmask, &xmask, tvp);
 #else
 	nready = select(eventp->maxfd + 1, &rmask, &wmask, &xmask, tvp);
 #endif
+	if (eventp->profile)
+		event_profile_wait(eventp, wait_begin, nready);
 
 	if (eventp->nested++ > 0)
 		acl_msg_fatal("%s(%d): recursive call(%d)",
@@ -523,11 +531,12 @@ TAG_DONE:
 
 	/* ȴʱе */
 
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 		timer_fn  = timer->callback;
 		timer_arg = timer->context;
+		when      = timer->when;
 
 		/* ʱʱ > 0 ʱѭã
 		 * 趨ʱ
@@ -537,14 +546,14 @@ TAG_DONE:
 			eventp->timer_request(eventp, timer->callback,
 				timer->context, timer->delay, timer->keep);
 		} else {
-			acl_ring_detach(&timer->ring); /* first this */
+			event_timers_del(&eventp->timers, timer);  /* first this */
 			timer->nrefer--;
 			if (timer->nrefer != 0)
 				acl_msg_fatal("%s(%d): nrefer(%d) != 0",
 					myname, __LINE__, timer->nrefer);
 			acl_myfree(timer);
 		}
-		timer_fn(ACL_EVENT_TIME, eventp, timer_arg);
+		EVENT_CALL_TIMER(eventp, timer_fn, timer_arg, when);
 	}
 
 	/* ׼õ¼ */
@@ -553,6 +562,9 @@ TAG_DONE:
 		event_fire(eventp);
 
 	eventp->nested--;
+
+	if (eventp->profile)
+		event_profile_loop(eventp, begin);
 }
 
 static int event_isrset(ACL_EVENT *eventp, ACL_VSTREAM *stream)
@@ -21,14 +21,197 @@
 
 #include "events.h"
 
+/*
+ * ʱϵʵ֣СѰ (when, seq) ÿʱ¼ڶе
+ * ±꣬Աûȡʱֱӵϣ (callback, context) 
+ */
+
+#define TIMERS_INIT_SIZE	64
+
+#define TIMER_BEFORE(a, b) ((a)->when < (b)->when \
+	|| ((a)->when == (b)->when && (a)->seq < (b)->seq))
+
+static unsigned int timer_hash(ACL_EVENT_NOTIFY_TIME callback,
+	const void *context, unsigned int tsize)
+{
+	size_t h = (size_t) context ^ ((size_t) callback >> 4);
+
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return (unsigned int) h & (tsize - 1);
+}
+
+void event_timers_init(EVENT_TIMERS *timers)
+{
+	timers->size  = TIMERS_INIT_SIZE;
+	timers->count = 0;
+	timers->heap  = (ACL_EVENT_TIMER **)
+		acl_mymalloc(timers->size * sizeof(ACL_EVENT_TIMER *));
+	timers->tsize = TIMERS_INIT_SIZE;
+	timers->table = (ACL_EVENT_TIMER **)
+		acl_mycalloc(timers->tsize, sizeof(ACL_EVENT_TIMER *));
+	timers->seq   = 0;
+}
+
+void event_timers_free(EVENT_TIMERS *timers)
+{
+	int   i;
+
+	for (i = 0; i < timers->count; i++)
+		acl_myfree(timers->heap[i]);
+	timers->count = 0;
+	acl_myfree(timers->heap);
+	acl_myfree(timers->table);
+	timers->heap  = NULL;
+	timers->table = NULL;
+}
+
+static void heap_set(EVENT_TIMERS *timers, int idx, ACL_EVENT_TIMER *timer)
+{
+	timers->heap[idx] = timer;
+	timer->heap_idx = idx;
+}
+
+static void heap_up(EVENT_TIMERS *timers, int idx)
+{
+	ACL_EVENT_TIMER *timer = timers->heap[idx];
+	int   parent;
+
+	while (idx > 0) {
+		parent = (idx - 1) / 2;
+		if (!TIMER_BEFORE(timer, timers->heap[parent]))
+			break;
+		heap_set(timers, idx, timers->heap[parent]);
+		idx = parent;
+	}
+	heap_set(timers, idx, timer);
+}
+
+static void heap_down(EVENT_TIMERS *timers, int idx)
+{
+	ACL_EVENT_TIMER *timer = timers->heap[idx];
+	int   child;
+
+	while ((child = idx * 2 + 1) < timers->count) {
+		if (child + 1 < timers->count && TIMER_BEFORE(
+			timers->heap[child + 1], timers->heap[child]))
+		{
+			child++;
+		}
+		if (!TIMER_BEFORE(timers->heap[child], timer))
+			break;
+		heap_set(timers, idx, timers->heap[child]);
+		idx = child;
+	}
+	heap_set(timers, idx, timer);
+}
+
+static void table_rehash(EVENT_TIMERS *timers)
+{
+	unsigned int tsize = timers->tsize * 2, i, n;
+	ACL_EVENT_TIMER **table, *timer, *next;
+
+	table = (ACL_EVENT_TIMER **)
+		acl_mycalloc(tsize, sizeof(ACL_EVENT_TIMER *));
+
+	for (i = 0; i < timers->tsize; i++) {
+		for (timer = timers->table[i]; timer != NULL; timer = next) {
+			next = timer->hnext;
+			n = timer_hash(timer->callback, timer->context, tsize);
+			timer->hnext = table[n];
+			table[n] = timer;
+		}
+	}
+
+	acl_myfree(timers->table);
+	timers->table = table;
+	timers->tsize = tsize;
+}
+
+ACL_EVENT_TIMER *event_timers_find(EVENT_TIMERS *timers,
+	ACL_EVENT_NOTIFY_TIME callback, const void *context)
+{
+	ACL_EVENT_TIMER *timer;
+	unsigned int n = timer_hash(callback, context, timers->tsize);
+
+	for (timer = timers->table[n]; timer != NULL; timer = timer->hnext) {
+		if (timer->callback == callback && timer->context == context)
+			return timer;
+	}
+	return NULL;
+}
+
+void event_timers_add(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer)
+{
+	unsigned int n;
+
+	if (timers->count == timers->size) {
+		timers->size *= 2;
+		timers->heap  = (ACL_EVENT_TIMER **) acl_myrealloc(timers->heap,
+			timers->size * sizeof(ACL_EVENT_TIMER *));
+	}
+
+	timer->seq = timers->seq++;
+	timers->heap[timers->count] = timer;
+	timer->heap_idx = timers->count++;
+	heap_up(timers, timer->heap_idx);
+
+	if ((unsigned int) timers->count > timers->tsize)
+		table_rehash(timers);
+
+	n = timer_hash(timer->callback, timer->context, timers->tsize);
+	timer->hnext = timers->table[n];
+	timers->table[n] = timer;
+}
+
+static void heap_fix(EVENT_TIMERS *timers, int idx)
+{
+	if (idx > 0 && TIMER_BEFORE(timers->heap[idx],
+		timers->heap[(idx - 1) / 2]))
+	{
+		heap_up(timers, idx);
+	} else
+		heap_down(timers, idx);
+}
+
+void event_timers_update(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer)
+{
+	/* úĶʱͬһʱ̵ʱ֮ԭһ */
+	timer->seq = timers->seq++;
+	heap_fix(timers, timer->heap_idx);
+}
+
+void event_timers_del(EVENT_TIMERS *timers, ACL_EVENT_TIMER *timer)
+{
+	ACL_EVENT_TIMER **pp;
+	int   idx = timer->heap_idx;
+	unsigned int n;
+
+	n = timer_hash(timer->callback, timer->context, timers->tsize);
+	for (pp = &timers->table[n]; *pp != NULL; pp = &(*pp)->hnext) {
+		if (*pp == timer) {
+			*pp = timer->hnext;
+			break;
+		}
+	}
+	timer->hnext = NULL;
+
+	timers->count--;
+	if (idx < timers->count) {
+		heap_set(timers, idx, timers->heap[timers->count]);
+		heap_fix(timers, idx);
+	}
+	timer->heap_idx = -1;
+}
+
 /* event_timer_request - (re)set timer */
 
 acl_int64 event_timer_request(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	void *context, acl_int64 delay, int keep)
 {
 	const char *myname = "event_timer_request";
-	ACL_RING_ITER iter;
-	ACL_EVENT_TIMER *timer = NULL;
+	ACL_EVENT_TIMER *timer;
 
 	/*
 	 * Make sure we schedule this event at the right time.
@@ -36,53 +219,34 @@ acl_int64 event_timer_request(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	SET_TIME(eventp->present);
 
 	/*
-	 * See if they are resetting an existing timer request. If so, take the
-	 * request away from the timer queue so that it can be inserted at the
-	 * right place.
+	 * See if they are resetting an existing timer request. If so, just
+	 * move the request to the right place in the timer heap.
 	 */
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			timer->when = eventp->present + delay;
-			timer->keep = keep;
-			timer->nrefer++;
-			acl_ring_detach(iter.ptr);
-			timer->nrefer--;
-			break;
-		}
-	}
-
-	/*
-	 * If not found, schedule a new timer request.
-	 */
-	if (iter.ptr == &eventp->timer_head) {
-		timer = (ACL_EVENT_TIMER *) acl_mymalloc(sizeof(ACL_EVENT_TIMER));
-		if (timer == NULL)
-			acl_msg_panic("%s: can't mymalloc for timer", myname);
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL) {
 		timer->when = eventp->present + delay;
-		timer->delay = delay;
-		timer->callback = callback;
-		timer->context = context;
-		timer->event_type = ACL_EVENT_TIME;
-		timer->nrefer = 1;
-		timer->ncount = 0;
 		timer->keep = keep;
+		event_timers_update(&eventp->timers, timer);
+		return timer->when;
 	}
 
 	/*
-	 * Insert the request at the right place. Timer requests are kept sorted
-	 * to reduce lookup overhead in the event loop.
+	 * If not found, schedule a new timer request.
 	 */
+	timer = (ACL_EVENT_TIMER *) acl_mymalloc(sizeof(ACL_EVENT_TIMER));
+	if (timer == NULL)
+		acl_msg_panic("%s: can't mymalloc for timer", myname);
+	timer->when = eventp->present + delay;
+	timer->delay = delay;
+	timer->callback = callback;
+	timer->context = context;
+	timer->event_type = ACL_EVENT_TIME;
+	timer->nrefer = 1;
+	timer->ncount = 0;
+	timer->keep = keep;
 
-	acl_ring_foreach(iter, &eventp->timer_head)
-		if (timer->when < ACL_RING_TO_TIMER(iter.ptr)->when)
-			break;
-	if (iter.ptr == &timer->ring)
-		acl_msg_fatal("%s: ring invalid", myname);
-
-	acl_ring_prepend(iter.ptr, &timer->ring);
-
-	return (timer->when);
+	event_timers_add(&eventp->timers, timer);
+	return timer->when;
 }
 
 /* event_timer_cancel - cancel timer */
@@ -91,7 +255,6 @@ acl_int64 event_timer_cancel(ACL_EVENT *eventp,
 	ACL_EVENT_NOTIFY_TIME callback, void *context)
 {
 	const char *myname = "event_timer_cancel";
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
 	acl_int64  time_left = -1;
 
@@ -103,20 +266,18 @@ acl_int64 event_timer_cancel(ACL_EVENT *eventp,
 
 	SET_TIME(eventp->present);
 
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			if ((time_left = timer->when - eventp->present) < 0)
-				time_left = 0;
-			acl_ring_detach(&timer->ring);
-			timer->nrefer--;
-			if (timer->nrefer != 0)
-				acl_msg_fatal("%s(%d): timer's nrefer(%d) != 0",
-					myname, __LINE__, timer->nrefer);
-			acl_myfree(timer);
-			break;
-		}
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL) {
+		if ((time_left = timer->when - eventp->present) < 0)
+			time_left = 0;
+		event_timers_del(&eventp->timers, timer);
+		timer->nrefer--;
+		if (timer->nrefer != 0)
+			acl_msg_fatal("%s(%d): timer's nrefer(%d) != 0",
+				myname, __LINE__, timer->nrefer);
+		acl_myfree(timer);
 	}
+
 	if (acl_msg_verbose > 2)
 		acl_msg_info("%s: 0x%p 0x%p %lld", myname,
 			callback, context, time_left);
@@ -126,29 +287,18 @@ acl_int64 event_timer_cancel(ACL_EVENT *eventp,
 void event_timer_keep(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	void *context, int keep)
 {
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
 
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			timer->keep = keep;
-			break;
-		}
-	}
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL)
+		timer->keep = keep;
 }
 
 int  event_timer_ifkeep(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	void *context)
 {
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
 
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context)
-			return timer->keep;
-	}
-
-	return 0;
+	timer = event_timers_find(&eventp->timers, callback, context);
+	return timer != NULL ? timer->keep : 0;
 }
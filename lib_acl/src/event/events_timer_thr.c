@@ -28,8 +28,8 @@ acl_int64 event_timer_request_thr(ACL_EVENT *eventp,
 {
 	const char *myname = "event_timer_request_thr";
 	EVENT_THR *event_thr = (EVENT_THR *) eventp;
-	ACL_RING_ITER iter;
-	ACL_EVENT_TIMER *timer = NULL;
+	ACL_EVENT_TIMER *timer;
+	acl_int64 when;
 
 	if (delay < 0 || delay >= 4294963950LL)
 		acl_msg_panic("%s: invalid delay: %lld", myname, delay);
@@ -42,23 +42,17 @@ acl_int64 event_timer_request_thr(ACL_EVENT *eventp,
 	SET_TIME(eventp->present);
 
 	/*
-	 * See if they are resetting an existing timer request. If so, take the
-	 * request away from the timer queue so that it can be inserted at the
-	 * right place.
-	 */
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			timer->when = eventp->present + delay;
-			acl_ring_detach(iter.ptr);
-			break;
-		}
-	}
-
-	/*
-	 * If not found, schedule a new timer request.
+	 * See if they are resetting an existing timer request. If so, just
+	 * move the request to the right place in the timer heap.
 	 */
-	if (iter.ptr == &eventp->timer_head) {
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL) {
+		timer->when = eventp->present + delay;
+		event_timers_update(&eventp->timers, timer);
+	} else {
+		/*
+		 * If not found, schedule a new timer request.
+		 */
 		timer = (ACL_EVENT_TIMER *) acl_mymalloc(sizeof(ACL_EVENT_TIMER));
 		if (timer == NULL)
 			acl_msg_panic("%s: can't mymalloc for timer", myname);
@@ -66,19 +60,13 @@ acl_int64 event_timer_request_thr(ACL_EVENT *eventp,
 		timer->callback = callback;
 		timer->context = context;
 		timer->event_type = ACL_EVENT_TIME;
+		timer->keep = 0;
+		event_timers_add(&eventp->timers, timer);
 	}
 
-	/*
-	 * Insert the request at the right place. Timer requests are kept sorted
-	 * to reduce lookup overhead in the event loop.
-	 */
-	acl_ring_foreach(iter, &eventp->timer_head)
-		if (timer->when < ACL_RING_TO_TIMER(iter.ptr)->when)
-			break;
-	acl_ring_prepend(iter.ptr, &timer->ring);
-
+	when = timer->when;
 	THREAD_UNLOCK(&event_thr->tm_mutex);
-	return (timer->when);
+	return (when);
 }
 
 /* event_timer_cancel_thr - cancel timer */
@@ -87,7 +75,6 @@ acl_int64 event_timer_cancel_thr(ACL_EVENT *eventp,
 	ACL_EVENT_NOTIFY_TIME callback, void *context)
 {
 	EVENT_THR *event_thr = (EVENT_THR *) eventp;
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
 	acl_int64  time_left = -1;
 
@@ -101,15 +88,12 @@ acl_int64 event_timer_cancel_thr(ACL_EVENT *eventp,
 
 	SET_TIME(eventp->present);
 
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			if ((time_left = timer->when - eventp->present) < 0)
-				time_left = 0;
-			acl_ring_detach(&timer->ring);
-			acl_myfree(timer);
-			break;
-		}
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL) {
+		if ((time_left = timer->when - eventp->present) < 0)
+			time_left = 0;
+		event_timers_del(&eventp->timers, timer);
+		acl_myfree(timer);
 	}
 
 	THREAD_UNLOCK(&event_thr->tm_mutex);
@@ -121,17 +105,12 @@ void event_timer_keep_thr(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	void *context, int keep)
 {
 	EVENT_THR *event_thr = (EVENT_THR *) eventp;
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
 
 	THREAD_LOCK(&event_thr->tm_mutex);
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			timer->keep = keep;
-			break;
-		}
-	}
+	timer = event_timers_find(&eventp->timers, callback, context);
+	if (timer != NULL)
+		timer->keep = keep;
 	THREAD_UNLOCK(&event_thr->tm_mutex);
 }
 
@@ -139,17 +118,12 @@ int  event_timer_ifkeep_thr(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callback,
 	void *context)
 {
 	EVENT_THR *event_thr = (EVENT_THR *) eventp;
-	ACL_RING_ITER iter;
 	ACL_EVENT_TIMER *timer;
+	int   keep;
 
 	THREAD_LOCK(&event_thr->tm_mutex);
-	acl_ring_foreach(iter, &eventp->timer_head) {
-		timer = ACL_RING_TO_TIMER(iter.ptr);
-		if (timer->callback == callback && timer->context == context) {
-			THREAD_UNLOCK(&event_thr->tm_mutex);
-			return timer->keep;
-		}
-	}
+	timer = event_timers_find(&eventp->timers, callback, context);
+	keep = timer != NULL ? timer->keep : 0;
 	THREAD_UNLOCK(&event_thr->tm_mutex);
-	return 0;
+	return keep;
 }
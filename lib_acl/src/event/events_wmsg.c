@@ -729,7 +729,7 @@ static VOID CALLBACK event_timer_callback(HWND hwnd, UINT uMsg,
 	eventp = &ev->event;
 	SET_TIME(eventp->present);
 
-	while ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) != 0) {
+	while ((timer = ACL_FIRST_TIMER(&eventp->timers)) != 0) {
 		if (timer->when > eventp->present)
 			break;
 		timer_fn  = timer->callback;
@@ -741,7 +741,7 @@ static VOID CALLBACK event_timer_callback(HWND hwnd, UINT uMsg,
 			eventp->timer_request(eventp, timer->callback,
 				timer->context, timer->delay, timer->keep);
 		} else {
-			acl_ring_detach(&timer->ring);		/* first this */
+			event_timers_del(&eventp->timers, timer);  /* first this */
 			timer->nrefer--;
 			if (timer->nrefer != 0)
 				acl_msg_fatal("%s(%d): nrefer(%d) != 0",
@@ -751,7 +751,7 @@ static VOID CALLBACK event_timer_callback(HWND hwnd, UINT uMsg,
 		timer_fn(ACL_EVENT_TIME, eventp, timer_arg);
 	}
 
-	if ((timer = ACL_FIRST_TIMER(&eventp->timer_head)) == 0) {
+	if ((timer = ACL_FIRST_TIMER(&eventp->timers)) == 0) {
 		KillTimer(hwnd, idEvent);
 		ev->timer_active = 0;
 	} else {
@@ -779,7 +779,7 @@ static acl_int64 event_set_timer(ACL_EVENT *eventp, ACL_EVENT_NOTIFY_TIME callba
 	if (delay < 1000)
 		delay = 1000;
 
-	timer = ACL_FIRST_TIMER(&eventp->timer_head);
+	timer = ACL_FIRST_TIMER(&eventp->timers);
 	if (timer == NULL)
 		first_delay = -1;
 	else {
@@ -811,7 +811,7 @@ static acl_int64 event_del_timer(ACL_EVENT *eventp,
 	EVENT_WMSG *ev = (EVENT_WMSG*) eventp;
 	acl_int64 when = event_timer_cancel(eventp, callback, context);
 
-	if (ev->timer_active && ACL_FIRST_TIMER(&eventp->timer_head) == 0) {
+	if (ev->timer_active && ACL_FIRST_TIMER(&eventp->timers) == 0) {
 		KillTimer(ev->hWnd, ev->tid);
 		ev->timer_active = 0;
 	}
@@ -83,6 +83,9 @@ int   acl_var_aio_enable_core;
 int   acl_var_aio_accept_timer;
 int   acl_var_aio_max_debug;
 int   acl_var_aio_status_notify;
+int   acl_var_aio_edge_trigger;
+int   acl_var_aio_listen_exclusive;
+int   acl_var_aio_profile_inter;
 
 static ACL_CONFIG_INT_TABLE __conf_int_tab[] = {
         { ACL_VAR_AIO_BUF_SIZE, ACL_DEF_AIO_BUF_SIZE, &acl_var_aio_buf_size, 0, 0 },
@@ -103,6 +106,9 @@ static ACL_CONFIG_INT_TABLE __conf_int_tab[] = {
 	{ ACL_VAR_AIO_ACCEPT_TIMER, ACL_DEF_AIO_ACCEPT_TIMER, &acl_var_aio_accept_timer, 0, 0 },
 	{ ACL_VAR_AIO_MAX_DEBUG, ACL_DEF_AIO_MAX_DEBUG, &acl_var_aio_max_debug, 0, 0 },
 	{ ACL_VAR_AIO_STATUS_NOTIFY, ACL_DEF_AIO_STATUS_NOTIFY, &acl_var_aio_status_notify, 0, 0 },
+	{ ACL_VAR_AIO_EDGE_TRIGGER, ACL_DEF_AIO_EDGE_TRIGGER, &acl_var_aio_edge_trigger, 0, 0 },
+	{ ACL_VAR_AIO_LISTEN_EXCLUSIVE, ACL_DEF_AIO_LISTEN_EXCLUSIVE, &acl_var_aio_listen_exclusive, 0, 0 },
+	{ ACL_VAR_AIO_PROFILE_INTER, ACL_DEF_AIO_PROFILE_INTER, &acl_var_aio_profile_inter, 0, 0 },
 
         { 0, 0, 0, 0, 0 },
 };
@@ -1082,6 +1088,12 @@ static ACL_AIO *create_aio(int *event_mode)
 	acl_aio_set_delay_sec(aio, acl_var_aio_delay_sec);
 	acl_aio_set_delay_usec(aio, acl_var_aio_delay_usec);
 	acl_aio_set_keep_read(aio, 1);
+
+	/* ں¼ɲñԵʽԼ epoll_ctl ô */
+	acl_event_set_edge_trigger(acl_aio_event(aio),
+		acl_var_aio_edge_trigger);
+	acl_event_set_listen_exclusive(acl_aio_event(aio),
+		acl_var_aio_listen_exclusive);
 	return aio;
 }
 
@@ -1105,6 +1117,19 @@ static void log_event_mode(int event_mode)
 	}
 }
 
+/* ¼ѭܷ */
+
+static void aio_server_profile(int type acl_unused, ACL_EVENT *event,
+	void *context acl_unused)
+{
+	ACL_VSTRING *buf = acl_vstring_alloc(1024);
+
+	acl_event_profile_dump(event, buf, 16);
+	acl_msg_info("event loop profile:\r\n%s", acl_vstring_str(buf));
+	acl_vstring_free(buf);
+	acl_event_profile_reset(event);
+}
+
 /* ʱ */
 
 static void create_timer(ACL_AIO *aio, int use_limit_delay)
@@ -1121,6 +1146,11 @@ static void create_timer(ACL_AIO *aio, int use_limit_delay)
 	if (acl_var_aio_use_limit > 0)
 		acl_aio_request_timer(aio, aio_server_use_timer,
 			aio, (acl_int64) use_limit_delay * 1000000, 0);
+	if (acl_var_aio_profile_inter > 0) {
+		acl_event_set_profile(acl_aio_event(aio), 1);
+		acl_aio_request_timer(aio, aio_server_profile, aio,
+			(acl_int64) acl_var_aio_profile_inter * 1000000, 1);
+	}
 }
 
 /*  */
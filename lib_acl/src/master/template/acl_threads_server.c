@@ -87,6 +87,8 @@ int   acl_var_threads_enable_core;
 int   acl_var_threads_max_debug;
 int   acl_var_threads_status_notify;
 int   acl_var_threads_batadd;
+int   acl_var_threads_lockfree;
+int   acl_var_threads_shed_wait;
 int   acl_var_threads_check_inter;
 int   acl_var_threads_qlen_warn;
 int   acl_var_threads_schedule_warn;
@@ -111,6 +113,8 @@ static ACL_CONFIG_INT_TABLE __conf_int_tab[] = {
 	{ ACL_VAR_THREADS_MAX_DEBUG, ACL_DEF_THREADS_MAX_DEBUG, &acl_var_threads_max_debug, 0, 0 },
 	{ ACL_VAR_THREADS_STATUS_NOTIFY, ACL_DEF_THREADS_STATUS_NOTIFY, &acl_var_threads_status_notify, 0, 0 },
 	{ ACL_VAR_THREADS_BATADD, ACL_DEF_THREADS_BATADD, &acl_var_threads_batadd, 0, 0 },
+	{ ACL_VAR_THREADS_LOCKFREE, ACL_DEF_THREADS_LOCKFREE, &acl_var_threads_lockfree, 0, 0 },
+	{ ACL_VAR_THREADS_SHED_WAIT, ACL_DEF_THREADS_SHED_WAIT, &acl_var_threads_shed_wait, 0, 0 },
 	{ ACL_VAR_THREADS_QLEN_WARN, ACL_DEF_THREADS_QLEN_WARN, &acl_var_threads_qlen_warn, 0, 0 },
 	{ ACL_VAR_THREADS_SCHEDULE_WARN, ACL_DEF_THREADS_SCHEDULE_WARN, &acl_var_threads_schedule_warn, 0, 0 },
 	{ ACL_VAR_THREADS_SCHEDULE_WAIT, ACL_DEF_THREADS_SCHEDULE_WAIT, &acl_var_threads_schedule_wait, 0, 0 },
@@ -608,12 +612,45 @@ static READ_CTX *create_job(ACL_EVENT *event, acl_pthread_pool_t *threads,
 	return ctx;
 }
 
+/* when the jobs wait too long in the thread pool, reject the new client */
+
+static int client_shed(acl_pthread_pool_t *threads, ACL_SOCKET fd,
+	const char *remote)
+{
+	static time_t last_warn = 0;
+	static unsigned long nshed = 0;
+	acl_int64 wait;
+	time_t now;
+
+	if (acl_var_threads_shed_wait <= 0)
+		return 0;
+
+	wait = acl_pthread_pool_queue_wait(threads);
+	if (wait <= acl_var_threads_shed_wait)
+		return 0;
+
+	nshed++;
+	now = time(NULL);
+	if (now - last_warn >= 1) {
+		last_warn = now;
+		acl_msg_warn("%s(%d), %s: overloaded, queue wait: %lld ms, "
+			"shed clients: %lu, last: %s", __FILE__, __LINE__,
+			__FUNCTION__, wait, nshed, remote ? remote : "");
+	}
+
+	acl_socket_close(fd);
+	return 1;
+}
+
 static void client_open(ACL_EVENT *event, acl_pthread_pool_t *threads,
 	ACL_SOCKET fd, const char *remote, const char *local)
 {
 	ACL_VSTREAM *stream;
 	READ_CTX *ctx;
 
+	if (client_shed(threads, fd, remote))
+		return;
+
 #ifdef ACL_UNIX
 	acl_close_on_exec(fd, ACL_CLOSE_ON_EXEC);
 #endif
@@ -1076,9 +1113,16 @@ static acl_pthread_pool_t *threads_create(ACL_MASTER_SERVER_THREAD_INIT_FN init_
 	ACL_MASTER_SERVER_THREAD_EXIT_FN exit_fn, void *init_ctx, void *exit_ctx)
 {
 	acl_pthread_pool_t *threads;
+	acl_pthread_pool_attr_t attr;
+
+	acl_pthread_pool_attr_init(&attr);
+	acl_pthread_pool_attr_set_threads_limit(&attr,
+		acl_var_threads_pool_limit);
+	acl_pthread_pool_attr_set_idle_timeout(&attr,
+		acl_var_threads_thread_idle);
+	acl_pthread_pool_attr_set_lockfree(&attr, acl_var_threads_lockfree);
 
-	threads = acl_thread_pool_create(acl_var_threads_pool_limit,
-			acl_var_threads_thread_idle);
+	threads = acl_pthread_pool_create(&attr);
 
 	if (acl_var_threads_schedule_warn > 0)
 		acl_pthread_pool_set_schedule_warn(threads,
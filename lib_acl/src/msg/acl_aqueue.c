@@ -60,6 +60,8 @@ struct ACL_AQUEUE {
 	int   error;
 	int   quit;
 	int   nlink;
+	int   nwait;	/* ȴϵ߳ */
+	int   spin;	/* ߼ȴǰ */
 	char  check_owner;
 	unsigned long owner;
 	acl_pthread_mutex_t lock;
@@ -80,6 +82,8 @@ ACL_AQUEUE *acl_aqueue_new(void)
 	queue->error = ACL_AQUEUE_OK;
 	queue->quit = 0;
 	queue->nlink = 0;
+	queue->nwait = 0;
+	queue->spin = 0;
 	queue->owner = (unsigned long) acl_pthread_self();
 	queue->check_owner = 0;
 	
@@ -98,6 +102,12 @@ void acl_aqueue_set_owner(ACL_AQUEUE *queue, unsigned int owner)
 		queue->owner = owner;
 }
 
+void acl_aqueue_set_spin(ACL_AQUEUE *queue, int nspin)
+{
+	if (queue)
+		queue->spin = nspin > 0 ? nspin : 0;
+}
+
 void acl_aqueue_free(ACL_AQUEUE *queue, ACL_AQUEUE_FREE_FN free_fn)
 {
 	const char *myname = "acl_aqueue_free";
@@ -150,11 +160,13 @@ static int aqueue_wait(ACL_AQUEUE *queue, const struct  timespec *ptimeout)
 	int   status;
 
 	while (queue->first == NULL && queue->quit == 0) {
+		queue->nwait++;
 		if (ptimeout != NULL)
 			status = acl_pthread_cond_timedwait(&queue->cond,
 					&queue->lock, ptimeout);
 		else
 			status = acl_pthread_cond_wait(&queue->cond, &queue->lock);
+		queue->nwait--;
 
 		if (ptimeout && status == ACL_ETIMEDOUT) {
 			status = acl_pthread_mutex_unlock(&queue->lock);
@@ -181,11 +193,42 @@ static int aqueue_wait(ACL_AQUEUE *queue, const struct  timespec *ptimeout)
 	return 0;
 }
 
+static struct timespec *aqueue_timeout(int tmo_sec, int tmo_usec,
+	struct timespec *timeout)
+{
+	struct  timeval tv;
+	long long usec;
+
+	if (tmo_sec < 0 || tmo_usec < 0)
+		return NULL;
+
+	gettimeofday(&tv, NULL);
+	usec = (long long) tv.tv_usec + tmo_usec;
+	timeout->tv_sec  = tv.tv_sec + tmo_sec + (time_t) (usec / 1000000);
+	timeout->tv_nsec = (long) (usec % 1000000) * 1000;
+	return timeout;
+}
+
+/* ڼǰȴԱ߽ϿʱƵ뱻 */
+static void aqueue_spin(ACL_AQUEUE *queue)
+{
+	volatile ACL_AQUEUE_ITEM **first =
+		(volatile ACL_AQUEUE_ITEM **) &queue->first;
+	int   i;
+
+	for (i = 0; i < queue->spin; i++) {
+		if (*first != NULL || queue->quit)
+			break;
+#if	defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+		__asm__ __volatile__("pause");
+#endif
+	}
+}
+
 void *acl_aqueue_pop_timedwait(ACL_AQUEUE *queue, int tmo_sec, int tmo_usec)
 {
 	const char *myname = "acl_aqueue_pop_timedwait";
 	ACL_AQUEUE_ITEM *qi;
-	struct  timeval   tv;
 	struct	timespec  timeout, *ptimeout;
 	int   status;
 	void *data;
@@ -195,6 +238,9 @@ void *acl_aqueue_pop_timedwait(ACL_AQUEUE *queue, int tmo_sec, int tmo_usec)
 
 	queue->error = ACL_AQUEUE_OK;
 
+	if (queue->spin > 0)
+		aqueue_spin(queue);
+
 	status = acl_pthread_mutex_lock(&queue->lock);
 	if (status) {
 		__SET_ERRNO(status);
@@ -206,14 +252,7 @@ void *acl_aqueue_pop_timedwait(ACL_AQUEUE *queue, int tmo_sec, int tmo_usec)
 	qi = NULL;
 
 	while (1) {
-		if (tmo_sec < 0 || tmo_usec < 0)
-			ptimeout = NULL;
-		else {
-			gettimeofday(&tv, NULL);
-			timeout.tv_sec = tv.tv_sec + tmo_sec;
-			timeout.tv_nsec = tv.tv_usec * 1000 + tmo_usec * 1000;
-			ptimeout = &timeout;
-		}
+		ptimeout = aqueue_timeout(tmo_sec, tmo_usec, &timeout);
 
 		if (aqueue_wait(queue, ptimeout) < 0)
 			return NULL;
@@ -252,34 +291,28 @@ void *acl_aqueue_pop_timedwait(ACL_AQUEUE *queue, int tmo_sec, int tmo_usec)
 	return data;
 }
 
-int acl_aqueue_push(ACL_AQUEUE *queue, void *data)
+/* ӺõԪβߵȴʱ֪֮ͨ */
+static int aqueue_append(ACL_AQUEUE *queue, ACL_AQUEUE_ITEM *first,
+	ACL_AQUEUE_ITEM *last, int n, const char *myname)
 {
-	const char *myname = "acl_aqueue_push";
-	ACL_AQUEUE_ITEM *qi;
-	int   status;
-
-	if (queue == NULL)
-		acl_msg_fatal("%s: aqueue null", myname);
-
-	qi = acl_mycalloc(1, sizeof(ACL_AQUEUE_ITEM));
-	qi->data = data;
+	int   status, nwait;
 
 	status = acl_pthread_mutex_lock(&queue->lock);
 	if (status != 0) {
 		__SET_ERRNO(status);
 		acl_msg_error("%s: lock error(%s)", myname, acl_last_serror());
-		acl_myfree(qi);
 		queue->error = ACL_AQUEUE_ERR_LOCK;
 		return -1;
 	}
 
 	if (queue->first == NULL)
-		queue->first = qi;
+		queue->first = first;
 	else
-		queue->last->next = qi;
+		queue->last->next = first;
 
-	queue->last = qi;
-	queue->qlen++;
+	queue->last = last;
+	queue->qlen += n;
+	nwait = queue->nwait;
 
 	status = acl_pthread_mutex_unlock(&queue->lock);
 	if (status != 0) {
@@ -288,7 +321,13 @@ int acl_aqueue_push(ACL_AQUEUE *queue, void *data)
 		return -1;
 	}
 
-	status = acl_pthread_cond_signal(&queue->cond);
+	if (nwait == 0)
+		return 0;
+
+	if (n > 1 && nwait > 1)
+		status = acl_pthread_cond_broadcast(&queue->cond);
+	else
+		status = acl_pthread_cond_signal(&queue->cond);
 	if (status != 0) {
 		__SET_ERRNO(status);
 		acl_msg_error("%s: cond signal error(%s)",
@@ -299,6 +338,123 @@ int acl_aqueue_push(ACL_AQUEUE *queue, void *data)
 	return 0;
 }
 
+int acl_aqueue_push(ACL_AQUEUE *queue, void *data)
+{
+	const char *myname = "acl_aqueue_push";
+	ACL_AQUEUE_ITEM *qi;
+	int   ret;
+
+	if (queue == NULL)
+		acl_msg_fatal("%s: aqueue null", myname);
+
+	qi = acl_mycalloc(1, sizeof(ACL_AQUEUE_ITEM));
+	qi->data = data;
+
+	ret = aqueue_append(queue, qi, qi, 1, myname);
+	if (ret == -1 && queue->error == ACL_AQUEUE_ERR_LOCK)
+		acl_myfree(qi);
+	return ret;
+}
+
+int acl_aqueue_push_batch(ACL_AQUEUE *queue, void **data, int n)
+{
+	const char *myname = "acl_aqueue_push_batch";
+	ACL_AQUEUE_ITEM *first = NULL, *last = NULL, *qi;
+	int   i;
+
+	if (queue == NULL)
+		acl_msg_fatal("%s: aqueue null", myname);
+
+	if (n <= 0)
+		return 0;
+
+	/* ⴴԪ̳ʱ */
+	for (i = 0; i < n; i++) {
+		qi = acl_mycalloc(1, sizeof(ACL_AQUEUE_ITEM));
+		qi->data = data[i];
+		if (last == NULL)
+			first = qi;
+		else
+			last->next = qi;
+		last = qi;
+	}
+
+	if (aqueue_append(queue, first, last, n, myname) == 0)
+		return 0;
+
+	if (queue->error == ACL_AQUEUE_ERR_LOCK) {
+		while (first) {
+			qi = first;
+			first = qi->next;
+			acl_myfree(qi);
+		}
+	}
+	return -1;
+}
+
+int acl_aqueue_pop_batch(ACL_AQUEUE *queue, void **out, int max,
+	int tmo_sec, int tmo_usec)
+{
+	const char *myname = "acl_aqueue_pop_batch";
+	ACL_AQUEUE_ITEM *first, *last = NULL, *qi;
+	struct	timespec  timeout, *ptimeout;
+	int   status, n = 0;
+
+	if (queue == NULL)
+		acl_msg_fatal("%s: queue null", myname);
+
+	queue->error = ACL_AQUEUE_OK;
+
+	if (max <= 0)
+		return 0;
+
+	if (queue->spin > 0)
+		aqueue_spin(queue);
+
+	status = acl_pthread_mutex_lock(&queue->lock);
+	if (status) {
+		__SET_ERRNO(status);
+		queue->error = ACL_AQUEUE_ERR_LOCK;
+		acl_msg_error("%s: lock error(%s)", myname, acl_last_serror());
+		return -1;
+	}
+
+	ptimeout = aqueue_timeout(tmo_sec, tmo_usec, &timeout);
+
+	if (aqueue_wait(queue, ptimeout) < 0)
+		return queue->error == ACL_AQUEUE_ERR_TIMEOUT ? 0 : -1;
+
+	/* ڽժԪԪصͷ */
+	first = queue->first;
+	for (qi = first; qi != NULL && n < max; qi = qi->next) {
+		last = qi;
+		n++;
+	}
+
+	if (last != NULL) {
+		queue->first = last->next;
+		if (queue->first == NULL)
+			queue->last = NULL;
+		queue->qlen -= n;
+		last->next = NULL;
+	}
+
+	status = acl_pthread_mutex_unlock(&queue->lock);
+	if (status != 0)
+		acl_msg_error("%s(%d): unlock error(%s)",
+			myname, __LINE__, acl_last_serror());
+
+	n = 0;
+	while (first) {
+		qi = first;
+		first = qi->next;
+		out[n++] = qi->data;
+		acl_myfree(qi);
+	}
+
+	return n;
+}
+
 int acl_aqueue_qlen(ACL_AQUEUE* queue)
 {
 	const char *myname = "acl_aqueue_qlen";
@@ -0,0 +1,368 @@
+#include "StdAfx.h"
+#ifndef ACL_PREPARE_COMPILE
+
+#include "stdlib/acl_define.h"
+
+#ifdef ACL_BCB_COMPILER
+#pragma hdrstop
+#endif
+
+#include <errno.h>
+#ifdef	ACL_UNIX
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "stdlib/acl_sys_patch.h"
+#include "thread/acl_thread.h"
+#include "stdlib/acl_msg.h"
+#include "stdlib/acl_mymalloc.h"
+#include "msg/acl_lfqueue.h"
+
+#endif
+
+/*
+ * ֧ GCC ԭӲ UNIX ƽ̨ʹ㷨( Vyukov н)
+ * ֮ͨл
+ */
+#if	defined(ACL_UNIX) && (defined(__clang__) || (defined(__GNUC__) \
+	&& (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))))
+# define	LFQ_ATOMIC
+#endif
+
+#ifdef	LFQ_ATOMIC
+# define LFQ_LOAD(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define LFQ_STORE(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+# define LFQ_CAS(p, o, n)	__sync_bool_compare_and_swap((p), (o), (n))
+# define LFQ_FENCE()		__sync_synchronize()
+# define LFQ_PLOCK(q)		(void) 0
+# define LFQ_PUNLOCK(q)		(void) 0
+#else
+# define LFQ_LOAD(p)		(*(p))
+# define LFQ_STORE(p, v)	(*(p) = (v))
+# define LFQ_CAS(p, o, n)	(*(p) == (o) ? (*(p) = (n), 1) : 0)
+# define LFQ_FENCE()		(void) 0
+# define LFQ_PLOCK(q)		acl_pthread_mutex_lock(&(q)->plock)
+# define LFQ_PUNLOCK(q)		acl_pthread_mutex_unlock(&(q)->plock)
+#endif
+
+#if	defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+# define LFQ_PAUSE()	__asm__ __volatile__("pause")
+#elif	defined(ACL_UNIX)
+# define LFQ_PAUSE()	sched_yield()
+#else
+# define LFQ_PAUSE()	(void) 0
+#endif
+
+#define	LFQ_SPIN	4096	/* default max spin count                */
+#define	LFQ_SPIN_MIN	16	/* the spin count added when spin is ok  */
+#define	LFQ_SHORT_WAIT	50	/* us, a sleep shorter than it means that
+				 * spinning would have been useful       */
+
+typedef struct LFQ_CELL {
+	volatile size_t seq;
+	void *data;
+} LFQ_CELL;
+
+struct ACL_LFQUEUE {
+	LFQ_CELL *cells;
+	size_t    mask;
+	unsigned  flags;
+	int       spin_max;
+	char      pad0[64];
+
+	volatile size_t tail;		/* written by producers */
+	char      pad1[64];
+
+	volatile size_t head;		/* written by the consumer */
+	int       spin;			/* current adaptive spin count */
+	char      pad2[64];
+
+	volatile int sleeping;		/* the consumer is sleeping */
+	volatile int quit;
+	acl_pthread_mutex_t lock;
+	acl_pthread_cond_t  cond;
+#ifndef	LFQ_ATOMIC
+	acl_pthread_mutex_t plock;
+#endif
+};
+
+ACL_LFQUEUE *acl_lfqueue_create(unsigned size, unsigned flags)
+{
+	ACL_LFQUEUE *queue;
+	size_t n = 2, i;
+#ifdef	ACL_UNIX
+	long   ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	long   ncpu = 1;
+#endif
+
+	while (n < size)
+		n <<= 1;
+
+	queue = (ACL_LFQUEUE *) acl_mycalloc(1, sizeof(ACL_LFQUEUE));
+	queue->cells = (LFQ_CELL *) acl_mycalloc(n, sizeof(LFQ_CELL));
+	queue->mask  = n - 1;
+	queue->flags = flags;
+
+	for (i = 0; i < n; i++)
+		queue->cells[i].seq = i;
+
+	/* spinning is useless on single CPU */
+	queue->spin_max = ncpu > 1 ? LFQ_SPIN : 0;
+	queue->spin     = queue->spin_max;
+
+	acl_pthread_mutex_init(&queue->lock, NULL);
+	acl_pthread_cond_init(&queue->cond, NULL);
+#ifndef	LFQ_ATOMIC
+	acl_pthread_mutex_init(&queue->plock, NULL);
+#endif
+	return queue;
+}
+
+static void *lfq_get(ACL_LFQUEUE *queue);
+
+void acl_lfqueue_free(ACL_LFQUEUE *queue, ACL_LFQUEUE_FREE_FN free_fn)
+{
+	void *data;
+
+	if (queue == NULL)
+		return;
+
+	if (free_fn) {
+		while ((data = lfq_get(queue)) != NULL)
+			free_fn(data);
+	}
+
+	acl_pthread_mutex_destroy(&queue->lock);
+	acl_pthread_cond_destroy(&queue->cond);
+#ifndef	LFQ_ATOMIC
+	acl_pthread_mutex_destroy(&queue->plock);
+#endif
+	acl_myfree(queue->cells);
+	acl_myfree(queue);
+}
+
+void acl_lfqueue_set_spin(ACL_LFQUEUE *queue, int nspin)
+{
+	queue->spin_max = nspin > 0 ? nspin : 0;
+	queue->spin     = queue->spin_max;
+}
+
+/* ԪطУ */
+static int lfq_put(ACL_LFQUEUE *queue, void *data)
+{
+	LFQ_CELL *cell;
+	size_t pos, seq;
+
+	if (!(queue->flags & ACL_LFQUEUE_F_MPSC)) {
+		pos  = queue->tail;
+		cell = &queue->cells[pos & queue->mask];
+		if (LFQ_LOAD(&cell->seq) != pos)
+			return -1;
+		cell->data = data;
+		LFQ_STORE(&cell->seq, pos + 1);
+		LFQ_STORE(&queue->tail, pos + 1);
+		return 0;
+	}
+
+	LFQ_PLOCK(queue);
+	pos = LFQ_LOAD(&queue->tail);
+
+	while (1) {
+		cell = &queue->cells[pos & queue->mask];
+		seq  = LFQ_LOAD(&cell->seq);
+
+		if (seq == pos) {
+			if (LFQ_CAS(&queue->tail, pos, pos + 1))
+				break;
+		} else if ((long) (seq - pos) < 0) {
+			LFQ_PUNLOCK(queue);
+			return -1;
+		}
+		pos = LFQ_LOAD(&queue->tail);
+	}
+
+	LFQ_PUNLOCK(queue);
+
+	cell->data = data;
+	LFQ_STORE(&cell->seq, pos + 1);
+	return 0;
+}
+
+/* ʱŻ֮ԱÿԪضһϵͳ */
+static void lfq_wake(ACL_LFQUEUE *queue)
+{
+#ifdef	LFQ_ATOMIC
+	LFQ_FENCE();
+	if (!LFQ_LOAD(&queue->sleeping))
+		return;
+#endif
+	acl_pthread_mutex_lock(&queue->lock);
+	if (queue->sleeping)
+		acl_pthread_cond_signal(&queue->cond);
+	acl_pthread_mutex_unlock(&queue->lock);
+}
+
+int acl_lfqueue_push(ACL_LFQUEUE *queue, void *data)
+{
+	if (lfq_put(queue, data) == -1)
+		return -1;
+	lfq_wake(queue);
+	return 0;
+}
+
+int acl_lfqueue_push_batch(ACL_LFQUEUE *queue, void **data, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (lfq_put(queue, data[i]) == -1)
+			break;
+	}
+
+	if (i > 0)
+		lfq_wake(queue);
+	return i;
+}
+
+static int lfq_empty(ACL_LFQUEUE *queue)
+{
+	size_t pos = queue->head;
+	return LFQ_LOAD(&queue->cells[pos & queue->mask].seq) != pos + 1;
+}
+
+static void *lfq_get(ACL_LFQUEUE *queue)
+{
+	size_t pos = queue->head;
+	LFQ_CELL *cell = &queue->cells[pos & queue->mask];
+	void *data;
+
+	if (LFQ_LOAD(&cell->seq) != pos + 1)
+		return NULL;
+
+	data = cell->data;
+	LFQ_STORE(&cell->seq, pos + queue->mask + 1);
+	LFQ_STORE(&queue->head, pos + 1);
+	return data;
+}
+
+static acl_int64 lfq_now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (acl_int64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/**
+ * ȴзǿգʧܺϣϴεȴ
+ * Ӧɹߺܶʱ伴ӣ
+ * @return {int} 0 ʾзǿգ-1 ʾʱ˳
+ */
+static int lfq_wait(ACL_LFQUEUE *queue, int timeout)
+{
+	struct timespec ts;
+	acl_int64 begin, end;
+	int   i, status = 0;
+
+	if (timeout == 0)
+		return lfq_empty(queue) ? -1 : 0;
+
+	for (i = 0; i < queue->spin; i++) {
+		if (!lfq_empty(queue)) {
+			queue->spin += LFQ_SPIN_MIN;
+			if (queue->spin > queue->spin_max)
+				queue->spin = queue->spin_max;
+			return 0;
+		}
+		LFQ_PAUSE();
+	}
+
+	if (queue->quit)
+		return lfq_empty(queue) ? -1 : 0;
+
+	queue->spin >>= 1;
+	begin = lfq_now();
+
+	if (timeout > 0) {
+		end        = begin + (acl_int64) timeout * 1000;
+		ts.tv_sec  = (time_t) (end / 1000000);
+		ts.tv_nsec = (long) (end % 1000000) * 1000;
+	}
+
+	acl_pthread_mutex_lock(&queue->lock);
+	queue->sleeping = 1;
+	LFQ_FENCE();
+
+	while (lfq_empty(queue) && !queue->quit) {
+		if (timeout > 0)
+			status = acl_pthread_cond_timedwait(&queue->cond,
+					&queue->lock, &ts);
+		else
+			status = acl_pthread_cond_wait(&queue->cond,
+					&queue->lock);
+		if (status != 0)
+			break;
+	}
+
+	queue->sleeping = 0;
+	acl_pthread_mutex_unlock(&queue->lock);
+
+	if (status == 0 && queue->spin_max > 0
+		&& lfq_now() - begin < LFQ_SHORT_WAIT)
+	{
+		queue->spin = queue->spin * 2 + LFQ_SPIN_MIN;
+		if (queue->spin > queue->spin_max)
+			queue->spin = queue->spin_max;
+	}
+
+	return lfq_empty(queue) ? -1 : 0;
+}
+
+void *acl_lfqueue_pop(ACL_LFQUEUE *queue, int timeout)
+{
+	void *data = lfq_get(queue);
+
+	if (data != NULL)
+		return data;
+	if (lfq_wait(queue, timeout) == -1)
+		return NULL;
+	return lfq_get(queue);
+}
+
+int acl_lfqueue_pop_batch(ACL_LFQUEUE *queue, void **out, int max, int timeout)
+{
+	int   n = 0;
+
+	if (max <= 0)
+		return 0;
+
+	if (lfq_empty(queue) && lfq_wait(queue, timeout) == -1)
+		return 0;
+
+	while (n < max && (out[n] = lfq_get(queue)) != NULL)
+		n++;
+	return n;
+}
+
+int acl_lfqueue_qlen(ACL_LFQUEUE *queue)
+{
+	size_t tail = LFQ_LOAD(&queue->tail);
+	size_t head = LFQ_LOAD(&queue->head);
+
+	return tail > head ? (int) (tail - head) : 0;
+}
+
+void acl_lfqueue_set_quit(ACL_LFQUEUE *queue)
+{
+	acl_pthread_mutex_lock(&queue->lock);
+	queue->quit = 1;
+	acl_pthread_cond_broadcast(&queue->cond);
+	acl_pthread_mutex_unlock(&queue->lock);
+}
@@ -62,6 +62,35 @@ void acl_atomic_set(ACL_ATOMIC *self, void *value)
 #endif
 }
 
+void *acl_atomic_get(ACL_ATOMIC *self)
+{
+#ifndef HAS_ATOMIC
+	void *value;
+
+	acl_pthread_mutex_lock(&self->lock);
+	value = self->value;
+	acl_pthread_mutex_unlock(&self->lock);
+
+	return value;
+#elif	defined(ACL_WINDOWS)
+	/* VC ¶ volatile Ķ acquire  */
+	return *((void * volatile *) &self->value);
+#elif	defined(ACL_LINUX)
+# if defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+	return __atomic_load_n(&self->value, __ATOMIC_ACQUIRE);
+# elif defined(__GNUC__) && (__GNUC__ >= 4)
+	void *value = *((void * volatile *) &self->value);
+	__sync_synchronize();
+	return value;
+# else
+	(void) self;
+	acl_msg_error("%s(%d), %s: not support!",
+		 __FILE__, __LINE__, __FUNCTION__);
+	return NULL;
+# endif
+#endif
+}
+
 void *acl_atomic_cas(ACL_ATOMIC *self, void *cmp, void *value)
 {
 #ifndef HAS_ATOMIC
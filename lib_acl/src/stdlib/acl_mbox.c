@@ -15,37 +15,88 @@
 
 #endif
 
+/*
+ *  Linux ƽ̨ʹ eventfd Ϊ֪ͨռһҶ֪ͨ
+ * ۼͬһһζƽ̨ʹ socketpair
+ */
+#if defined(ACL_LINUX) && !defined(MINGW)
+# include <unistd.h>
+# include <sys/eventfd.h>
+# define HAS_EVENTFD
+#endif
+
 struct ACL_MBOX {
 	ACL_VSTREAM *in;
-	ACL_VSTREAM *out;
+	ACL_VSTREAM *out;	/* Ϊ NULL ʱʾʹ eventfd */
 	size_t nsend;
 	size_t nread;
+	int    notified;	/* ѷ֪ͨδȡ */
 	ACL_YPIPE *ypipe;
 	acl_pthread_mutex_t *lock;
 };
 
 static const char __key[] = "k";
 
-ACL_MBOX *acl_mbox_create(void)
+#ifdef HAS_EVENTFD
+static int mbox_eventfd_open(ACL_MBOX *mbox)
+{
+	int fd = eventfd(0, EFD_CLOEXEC);
+
+	if (fd < 0) {
+		acl_msg_warn("%s(%d), %s: eventfd error %s, use socketpair",
+			__FILE__, __LINE__, __FUNCTION__, acl_last_serror());
+		return -1;
+	}
+
+	mbox->in  = acl_vstream_fdopen(fd, O_RDONLY, sizeof(acl_uint64),
+			0, ACL_VSTREAM_TYPE_SOCK);
+	mbox->out = NULL;
+	return 0;
+}
+#endif
+
+static int mbox_sockpair_open(ACL_MBOX *mbox)
 {
-	ACL_MBOX *mbox;
 	ACL_SOCKET fds[2];
 
 	if (acl_sane_socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
 		acl_msg_error("%s(%d), %s: acl_duplex_pipe error %s",
 			__FILE__, __LINE__, __FUNCTION__, acl_last_serror());
-		return NULL;
+		return -1;
 	}
 
-	mbox        = (ACL_MBOX *) acl_mymalloc(sizeof(ACL_MBOX));
-	mbox->in    = acl_vstream_fdopen(fds[0], O_RDONLY, sizeof(__key),
+	mbox->in  = acl_vstream_fdopen(fds[0], O_RDONLY, sizeof(__key),
 			0, ACL_VSTREAM_TYPE_SOCK);
-	mbox->out   = acl_vstream_fdopen(fds[1], O_WRONLY, sizeof(__key),
+	mbox->out = acl_vstream_fdopen(fds[1], O_WRONLY, sizeof(__key),
 			0, ACL_VSTREAM_TYPE_SOCK);
-	mbox->nsend = 0;
-	mbox->nread = 0;
-	mbox->ypipe = acl_ypipe_new();
-	mbox->lock  = (acl_pthread_mutex_t *)
+	return 0;
+}
+
+ACL_MBOX *acl_mbox_create(void)
+{
+	ACL_MBOX *mbox;
+
+	mbox = (ACL_MBOX *) acl_mycalloc(1, sizeof(ACL_MBOX));
+
+#ifdef HAS_EVENTFD
+	if (mbox_eventfd_open(mbox) < 0 && mbox_sockpair_open(mbox) < 0) {
+#else
+	if (mbox_sockpair_open(mbox) < 0) {
+#endif
+		acl_myfree(mbox);
+		return NULL;
+	}
+
+	mbox->nsend    = 0;
+	mbox->nread    = 0;
+	mbox->notified = 0;
+	mbox->ypipe    = acl_ypipe_new();
+
+	/* ʹ˳ʼڵȴ״̬Ա֤һϢ֪ͨ¼
+	 * ʽȡʱԶղ¼
+	 */
+	(void) acl_ypipe_read(mbox->ypipe);
+	mbox->lock     = (acl_pthread_mutex_t *)
 		acl_mycalloc(1, sizeof(acl_pthread_mutex_t));
 	if (acl_pthread_mutex_init(mbox->lock, NULL) != 0)
 		acl_msg_fatal("%s(%d), %s: acl_pthread_mutex_init error",
@@ -57,39 +108,106 @@ ACL_MBOX *acl_mbox_create(void)
 void acl_mbox_free(ACL_MBOX *mbox, void (*free_fn)(void*))
 {
 	acl_vstream_close(mbox->in);
-	acl_vstream_close(mbox->out);
+	if (mbox->out)
+		acl_vstream_close(mbox->out);
 	acl_ypipe_free(mbox->ypipe, free_fn);
 	acl_pthread_mutex_destroy(mbox->lock);
 	acl_myfree(mbox->lock);
 	acl_myfree(mbox);
 }
 
-int acl_mbox_send(ACL_MBOX *mbox, void *msg)
+ACL_VSTREAM *acl_mbox_stream(ACL_MBOX *mbox)
 {
-	int ret;
-
-	acl_pthread_mutex_lock(mbox->lock);
-	acl_ypipe_write(mbox->ypipe, msg);
-	ret = acl_ypipe_flush(mbox->ypipe);
-	acl_pthread_mutex_unlock(mbox->lock);
-	if (ret == 0)
-		return 0;
+	return mbox->in;
+}
 
+static int mbox_notify(ACL_MBOX *mbox)
+{
 	mbox->nsend++;
 
+#ifdef HAS_EVENTFD
+	if (mbox->out == NULL) {
+		acl_uint64 n = 1;
+		ACL_SOCKET fd = ACL_VSTREAM_SOCK(mbox->in);
+
+		if (write(fd, &n, sizeof(n)) != (ssize_t) sizeof(n)) {
+			acl_msg_error("%s(%d), %s: write eventfd error %s",
+				__FILE__, __LINE__, __FUNCTION__,
+				acl_last_serror());
+			return -1;
+		}
+		return 0;
+	}
+#endif
+
 	if (acl_vstream_writen(mbox->out, __key, sizeof(__key) - 1)
 		== ACL_VSTREAM_EOF)
 	{
 		return -1;
 	} else
 		return 0;
+}
+
+int acl_mbox_send(ACL_MBOX *mbox, void *msg)
+{
+	int ret, notify;
+
+	acl_pthread_mutex_lock(mbox->lock);
+	acl_ypipe_write(mbox->ypipe, msg);
+	ret = acl_ypipe_flush(mbox->ypipe);
+
+	/* ֻж˴ڵȴ״̬δ֪ͨʱҪ֪ͨӶʹ
+	 * ֮Ķηһϵͳ
+	 */
+	notify = ret != 0 && !mbox->notified;
+	if (notify)
+		mbox->notified = 1;
+	acl_pthread_mutex_unlock(mbox->lock);
 
+	return notify ? mbox_notify(mbox) : 0;
 }
 
-void *acl_mbox_read(ACL_MBOX *mbox, int timeout, int *success)
+/**
+ * ȴȡ֪ͨ
+ * @param timeout {int} > 0 ʱΪȴ0 ʾһֱȴ< 0 ʾȴ
+ * @return {int} 1 ʾ֪ͨ0 ʾʱ-1 ʾ
+ */
+static int mbox_wait(ACL_MBOX *mbox, int timeout)
 {
+	ACL_SOCKET fd = ACL_VSTREAM_SOCK(mbox->in);
+	char  buf[64];
 	int   ret;
-	char  kbuf[sizeof(__key)];
+
+	if (timeout != 0 && acl_read_wait(fd, timeout > 0 ? timeout : 0) < 0)
+		return acl_last_error() == ACL_ETIMEDOUT ? 0 : -1;
+
+	mbox->nread++;
+
+#ifdef HAS_EVENTFD
+	if (mbox->out == NULL)
+		ret = (int) read(fd, buf, sizeof(acl_uint64));
+	else
+#endif
+	ret = acl_socket_read(fd, buf, sizeof(buf), 0, NULL, NULL);
+
+	if (ret <= 0) {
+		acl_msg_error("%s(%d), %s: read notify error %s",
+			__FILE__, __LINE__, __FUNCTION__, acl_last_serror());
+		return -1;
+	}
+
+	/* ڶ֪ͨ¼Ϣܵǰ־λǰϢ
+	 *  acl_ypipe_read ж˺ķ߻ٴη֪ͨ
+	 */
+	acl_pthread_mutex_lock(mbox->lock);
+	mbox->notified = 0;
+	acl_pthread_mutex_unlock(mbox->lock);
+
+	return 1;
+}
+
+void *acl_mbox_read(ACL_MBOX *mbox, int timeout, int *success)
+{
 	void *msg = acl_ypipe_read(mbox->ypipe);
 
 	if (msg != NULL) {
@@ -98,33 +216,43 @@ void *acl_mbox_read(ACL_MBOX *mbox, int timeout, int *success)
 		return msg;
 	}
 
-	mbox->nread++;
-	mbox->in->rw_timeout = timeout;
+	while (1) {
+		int ret = mbox_wait(mbox, timeout > 0 ? timeout : 0);
 
-	ret = acl_vstream_readn(mbox->in, kbuf, sizeof(kbuf) - 1);
-	if (ret == ACL_VSTREAM_EOF) {
-		if (mbox->in->errnum == ACL_ETIMEDOUT) {
+		if (ret < 0) {
 			if (success)
-				*success = 1;
+				*success = 0;
 			return NULL;
 		}
 
-		if (success)
-			*success = 0;
-		return NULL;
-	}
+		if (ret > 0)
+			msg = acl_ypipe_read(mbox->ypipe);
 
-	if (kbuf[0] != __key[0]) {
-		acl_msg_error("%s(%d), %s: read invalid: %c",
-			__FILE__, __LINE__, __FUNCTION__, kbuf[0]);
-		if (success)
-			*success = 0;
-		return NULL;
+		/* ޵ȴʱԹڵ֪ͨȴ */
+		if (msg != NULL || timeout > 0)
+			break;
 	}
 
 	if (success)
 		*success = 1;
-	return acl_ypipe_read(mbox->ypipe);
+	return msg;
+}
+
+void *acl_mbox_read_nowait(ACL_MBOX *mbox)
+{
+	void *msg;
+
+	while (1) {
+		msg = acl_ypipe_read(mbox->ypipe);
+		if (msg != NULL)
+			return msg;
+
+		/* ѽȴ״̬δ֪ͨȡ֮ԣ
+		 * ʧڴڼ䵽Ϣ
+		 */
+		if (mbox_wait(mbox, -1) <= 0)
+			return NULL;
+	}
 }
 
 size_t acl_mbox_nsend(ACL_MBOX *mbox)
@@ -21,6 +21,7 @@
 # include <sys/un.h>
 # include <sys/stat.h>
 # include <unistd.h>
+# include <sys/mman.h>
 #else
 # error "unknown OS type"
 #endif
@@ -57,6 +58,51 @@ static unsigned char __vstream_stderr_buf[ACL_VSTREAM_BUFSIZE];
 
 static int read_char(ACL_VSTREAM *fp);
 
+/* еһݶΣõߵڴ棬д free_fn ͷ */
+typedef struct WCHAIN_SEG {
+	const unsigned char *ptr;
+	size_t len;
+	void (*free_fn)(void*);
+	void *ctx;
+} WCHAIN_SEG;
+
+typedef struct WCHAIN {
+	WCHAIN_SEG *segs;
+	int    size;		/* segs  */
+	int    head;		/* һδдݶ */
+	int    count;		/* ݶεĸ( head ǰĿλ) */
+	size_t dlen;		/* δдܳ */
+	size_t copy_limit;	/* Сڸֵݿ wbuf  */
+} WCHAIN;
+
+#define CHAIN_COPY_LIMIT	1024
+#define CHAIN_SEGS_INIT		16
+
+#ifndef IOV_MAX
+# define IOV_MAX		1024
+#endif
+
+#define WCHAIN_EMPTY(fp) ((fp)->wchain == NULL \
+	|| ((WCHAIN*) (fp)->wchain)->head == ((WCHAIN*) (fp)->wchain)->count)
+
+/* дǷдд */
+#define WBUF_PENDING(fp) ((fp)->wbuf_dlen > 0 || !WCHAIN_EMPTY(fp))
+
+/* ļڴӳ䷽ʽʱӳϢ */
+typedef struct FMAP {
+	unsigned char *addr;		/* ӳַ */
+	size_t len;			/* ӳ */
+#ifdef ACL_WINDOWS
+	HANDLE hmap;
+#endif
+	unsigned char *read_buf;	/* ӳڼ䱣ԭ */
+	int   read_buf_len;
+} FMAP;
+
+#define READ_MAPPED(fp) ((fp)->flag & ACL_VSTREAM_FLAG_MMAP)
+
+static void fmap_leave(ACL_VSTREAM *fp);
+
 ACL_VSTREAM acl_vstream_fstd[] = {              
 	{       
 #ifdef ACL_UNIX
@@ -114,6 +160,8 @@ ACL_VSTREAM acl_vstream_fstd[] = {
 		ACL_SOCKET_INVALID,             /* iocp_sock */
 #endif
 		NULL,				/* objs_table */
+		NULL,				/* wchain */
+		NULL,				/* fmap */
 	},
 
 	{
@@ -172,6 +220,8 @@ ACL_VSTREAM acl_vstream_fstd[] = {
 		ACL_SOCKET_INVALID,             /* iocp_sock */
 #endif
 		NULL,				/* objs_table */
+		NULL,				/* wchain */
+		NULL,				/* fmap */
 	},
 	{
 #ifdef ACL_UNIX
@@ -229,6 +279,8 @@ ACL_VSTREAM acl_vstream_fstd[] = {
 		ACL_SOCKET_INVALID,             /* iocp_sock */
 #endif
 		NULL,				/* objs_table */
+		NULL,				/* wchain */
+		NULL,				/* fmap */
 	},
 };
 
@@ -296,6 +348,12 @@ AGAIN:
 		in->errbuf[0] = 0;
 		in->total_read_cnt += read_cnt;
 
+		/* Եʽ¶ʱںпܻݣ򲻻
+		 * µĿɶ¼֪ͨҪϵͳɶ־
+		 */
+		if ((in->flag & ACL_VSTREAM_FLAG_EDGE) && read_cnt == (int) size)
+			in->read_ready = 1;
+
 		return read_cnt;
 	} else if (read_cnt == 0) {
 		in->flag = ACL_VSTREAM_FLAG_EOF;
@@ -353,6 +411,10 @@ static int read_buffed(ACL_VSTREAM *fp)
 {
 	int  n;
 
+	/* ӳѶָ꣬ԭļӳ֮ */
+	if (READ_MAPPED(fp))
+		fmap_leave(fp);
+
 	fp->read_ptr = fp->read_buf;
 	n =  read_to_buffer(fp, fp->read_buf, (size_t) fp->read_buf_len);
 	if (n >= 0)
@@ -674,6 +736,10 @@ int acl_vstream_unread(ACL_VSTREAM *fp, const void *ptr, size_t length)
 		if (fp->read_cnt > 0)
 			memcpy((char*) pbuf + length, fp->read_ptr,
 				(size_t) fp->read_cnt);
+		/* ͷŵӦԭӳ */
+		n = (size_t) fp->read_buf_len;
+		fmap_leave(fp);
+		fp->read_buf_len = (int) n;
 		acl_myfree(fp->read_buf);
 
 		fp->read_buf = pbuf;
@@ -735,76 +801,61 @@ int acl_vstream_bfcp_some(ACL_VSTREAM *fp, void *vptr, size_t maxlen)
 	return n;
 }
 
-int acl_vstream_readtags(ACL_VSTREAM *fp, void *vptr, size_t maxlen,
-	const char *tag, size_t taglen)
+/* п n ֽ buf вƶָ */
+
+static void bfcp_consume(ACL_VSTREAM *fp, unsigned char *buf, int n)
 {
-	const char *myname = "acl_vstream_readtags";
-	int   n, ch, matched = 0;
-	unsigned char *ptr;
-	const unsigned char *haystack;
-	const unsigned char *needle, *needle_end;
+	memcpy(buf, fp->read_ptr, n);
+	fp->read_cnt -= n;
+	fp->read_ptr += n;
+	fp->offset += n;
+}
 
-	if (fp == NULL || vptr == NULL || maxlen <= 0
-	    || tag == NULL || taglen <= 0)
-	{
-		acl_msg_error("%s(%d), %s: fp %s, vptr %s, maxlen %d, tag %s,"
-			" taglen: %d", __FILE__, __LINE__, myname,
-			fp ? "not null" : "null", vptr ? "not null" : "null",
-			(int) maxlen, tag ? tag : "null", (int) taglen);
-		return ACL_VSTREAM_EOF;
-	}
+/**
+ * Կ鷽ʽжȡһݻǴΪֹзǴ memchr
+ * ڶҷָڲһ libc  SSE2/AVX2 ָ
+ * ʵֽ֣ڶȡȽ
+ * @param fp {ACL_VSTREAM*}
+ * @param vptr {void*} 洢Ļ
+ * @param maxlen {size_t} vptr ȣһֽ \0
+ * @param tag {const char*} ָǴ
+ * @param taglen {size_t} tag ĳ
+ * @return {int} ݳȣδκʱ ACL_VSTREAM_EOF
+ */
+static int bfgets_tag(ACL_VSTREAM *fp, void *vptr, size_t maxlen,
+	const char *tag, size_t taglen)
+{
+	unsigned char *ptr = (unsigned char *) vptr, *last;
+	unsigned char  ch = (unsigned char) tag[taglen - 1];
+	size_t left = maxlen - 1, n;
 
 	fp->flag &= ~ACL_VSTREAM_FLAG_TAGYES;
 
-	needle_end = (const unsigned char *) tag;
-
-	while(1) {
-		taglen--;
-		if (taglen == 0)
-			break;
-		needle_end++;
-	}
-	ptr = (unsigned char *) vptr;
-
-	for (n = 1; n < (int) maxlen; n++) {
-		/* left one byte for '\0' */
-
-#ifdef	_USE_FAST_MACRO
-		ch = ACL_VSTREAM_GETC(fp);
-#else
-		ch = acl_vstream_getc(fp);
-#endif
-		if (ch == ACL_VSTREAM_EOF) {
-			if (n == 1)  /* EOF, nodata read */
-				return ACL_VSTREAM_EOF;
-
+	while (left > 0) {
+		if (fp->read_cnt <= 0 && read_buffed(fp) <= 0) {
+			if (ptr == (unsigned char *) vptr)
+				return ACL_VSTREAM_EOF;  /* EOF, nodata read */
 			break;  /* EOF, some data was read */
 		}
 
-		*ptr = ch;
-		if (ch == *needle_end) {
-			haystack = ptr - 1;
-			needle = needle_end - 1;
-			matched = 0;
-			while(1) {
-				/* ѾɹȽ(ƥ) */
-				if (needle < (const unsigned char *) tag) {
-					matched = 1;
-					break;
-				}
-
-				/* ԭַƥ䴮ûбȽ(ƥ) */
-				if (haystack < (unsigned char *) vptr)
-					break;
-				/* (ƥ) */
-				if (*haystack != *needle)
-					break;
-				haystack--;
-				needle--;
-			}
+		n = (size_t) fp->read_cnt > left ? left : (size_t) fp->read_cnt;
+		last = (unsigned char *) memchr(fp->read_ptr, ch, n);
+		if (last == NULL) {
+			bfcp_consume(fp, ptr, (int) n);
+			ptr  += n;
+			left -= n;
+			continue;
 		}
-		ptr++;
-		if (matched) {
+
+		/* ǴһֽڣټβǷǴƥ */
+		n = last - fp->read_ptr + 1;
+		bfcp_consume(fp, ptr, (int) n);
+		ptr  += n;
+		left -= n;
+
+		if (taglen == 1 || ((size_t) (ptr - (unsigned char *) vptr)
+			>= taglen && memcmp(ptr - taglen, tag, taglen) == 0))
+		{
 			fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
 			break;
 		}
@@ -812,14 +863,30 @@ int acl_vstream_readtags(ACL_VSTREAM *fp, void *vptr, size_t maxlen,
 
 	*ptr = 0;  /* null terminate like fgets() */
 
-	return n;
+	return (int) (ptr - (unsigned char *) vptr);
+}
+
+int acl_vstream_readtags(ACL_VSTREAM *fp, void *vptr, size_t maxlen,
+	const char *tag, size_t taglen)
+{
+	const char *myname = "acl_vstream_readtags";
+
+	if (fp == NULL || vptr == NULL || maxlen <= 0
+	    || tag == NULL || taglen <= 0)
+	{
+		acl_msg_error("%s(%d), %s: fp %s, vptr %s, maxlen %d, tag %s,"
+			" taglen: %d", __FILE__, __LINE__, myname,
+			fp ? "not null" : "null", vptr ? "not null" : "null",
+			(int) maxlen, tag ? tag : "null", (int) taglen);
+		return ACL_VSTREAM_EOF;
+	}
+
+	return bfgets_tag(fp, vptr, maxlen, tag, taglen);
 }
 
 int acl_vstream_gets(ACL_VSTREAM *fp, void *vptr, size_t maxlen)
 {
 	const char *myname = "acl_vstream_gets";
-	int   n, ch;
-	unsigned char *ptr;
 
 	if (fp == NULL || vptr == NULL || maxlen <= 0) {
 		acl_msg_error("%s(%d), %s: fp %s, vptr %s, maxlen %d",
@@ -828,44 +895,15 @@ int acl_vstream_gets(ACL_VSTREAM *fp, void *vptr, size_t maxlen)
 		return ACL_VSTREAM_EOF;
 	}
 
-	fp->flag &= ~ACL_VSTREAM_FLAG_TAGYES;
-
-	ptr = (unsigned char *) vptr;
-	for (n = 1; n < (int) maxlen; n++) {
-		/* left one byte for '\0' */
-
-#ifdef	_USE_FAST_MACRO
-		ch = ACL_VSTREAM_GETC(fp);
-#else
-		ch = acl_vstream_getc(fp);
-#endif
-		if (ch == ACL_VSTREAM_EOF) {
-			if (n == 1)  /* EOF, nodata read */
-				return ACL_VSTREAM_EOF;
-
-			break;  /* EOF, some data was read */
-		}
-
-		*ptr++ = ch;
-		if (ch == '\n'){
-			/* newline is stored, like fgets() */
-
-			fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
-			break;
-		}
-	}
-
-	/* null terminate like fgets() */
-	*ptr = 0;
-
-	return n;
+	/* newline is stored, like fgets() */
+	return bfgets_tag(fp, vptr, maxlen, "\n", 1);
 }
 
 int acl_vstream_gets_nonl(ACL_VSTREAM *fp, void *vptr, size_t maxlen)
 {
 	const char *myname = "acl_vstream_gets_nonl";
-	int   n, ch;
 	unsigned char *ptr;
+	int   n;
 
 	if (fp == NULL || vptr == NULL || maxlen <= 0) {
 		acl_msg_error("%s(%d), %s: fp %s, vptr %s, maxlen %d",
@@ -874,39 +912,128 @@ int acl_vstream_gets_nonl(ACL_VSTREAM *fp, void *vptr, size_t maxlen)
 		return ACL_VSTREAM_EOF;
 	}
 
+	n = bfgets_tag(fp, vptr, maxlen, "\n", 1);
+	if (n == ACL_VSTREAM_EOF)
+		return n;
+
+	ptr = (unsigned char *) vptr + n - 1;
+	while (ptr >= (unsigned char *) vptr) {
+		if (*ptr != '\r' && *ptr != '\n')
+			break;
+
+		*ptr-- = 0;
+		n--;
+	}
+
+	return n;
+}
+
+/* ӶȡһݵãӳģʽµһݿԽβʱ
+ * 轫ʣͷٶһݳֶη
+ */
+static int bfgets_ref(ACL_VSTREAM *fp, const char **ptr)
+{
+	unsigned char *ln;
+	int   n, nscan = 0;
+
 	fp->flag &= ~ACL_VSTREAM_FLAG_TAGYES;
 
-	ptr = (unsigned char *) vptr;
-	for (n = 1; n < (int) maxlen; n++) {
-#ifdef	_USE_FAST_MACRO
-		ch = ACL_VSTREAM_GETC(fp);
-#else
-		ch = acl_vstream_getc(fp);
-#endif
-		if (ch == ACL_VSTREAM_EOF) {
-			if (n == 1)  /* EOF, nodata read */
-				return ACL_VSTREAM_EOF;
+	while (1) {
+		if (fp->read_cnt > nscan) {
+			ln = (unsigned char *) memchr(fp->read_ptr + nscan,
+				'\n', fp->read_cnt - nscan);
+			if (ln != NULL) {
+				fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
+				n = (int) (ln - fp->read_ptr) + 1;
+				break;
+			}
 
-			break;  /* EOF, some data was read */
+			nscan = fp->read_cnt;
+
+			/* ӳʣݼΪļһ */
+			if (READ_MAPPED(fp) || fp->read_cnt >= fp->read_buf_len) {
+				n = fp->read_cnt;
+				break;
+			}
+			if (fp->read_ptr > fp->read_buf) {
+				memmove(fp->read_buf, fp->read_ptr,
+					(size_t) fp->read_cnt);
+				fp->read_ptr = fp->read_buf;
+			}
+		} else if (fp->read_cnt <= 0) {
+			if (READ_MAPPED(fp))
+				fmap_leave(fp);
+			fp->read_ptr = fp->read_buf;
+			fp->read_cnt = 0;
 		}
 
-		*ptr++ = ch;
-		if (ch == '\n') {
-			fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
-			break;  /* newline is stored, like fgets() */
+		n = read_to_buffer(fp, fp->read_ptr + fp->read_cnt,
+			(size_t) (fp->read_buf_len - fp->read_cnt));
+		if (n <= 0) {
+			if (fp->read_cnt <= 0)
+				return ACL_VSTREAM_EOF;
+			n = fp->read_cnt;  /* EOF, the last line without '\n' */
+			break;
 		}
+		fp->read_cnt += n;
 	}
 
-	*ptr = 0;  /* null terminate like fgets() */
-	ptr--;
-	while (ptr >= (unsigned char *) vptr) {
-		if (*ptr != '\r' && *ptr != '\n')
-			break;
+	*ptr = (const char *) fp->read_ptr;
+	fp->read_ptr += n;
+	fp->read_cnt -= n;
+	fp->offset   += n;
+	return n;
+}
 
-		*ptr-- = 0;
+int acl_vstream_gets_ref(ACL_VSTREAM *fp, const char **ptr)
+{
+	if (fp == NULL || ptr == NULL) {
+		acl_msg_error("%s(%d), %s: fp %s, ptr %s", __FILE__, __LINE__,
+			__FUNCTION__, fp ? "not null" : "null",
+			ptr ? "not null" : "null");
+		return ACL_VSTREAM_EOF;
+	}
+
+	return bfgets_ref(fp, ptr);
+}
+
+int acl_vstream_gets_nonl_ref(ACL_VSTREAM *fp, const char **ptr)
+{
+	int   n;
+
+	if (fp == NULL || ptr == NULL) {
+		acl_msg_error("%s(%d), %s: fp %s, ptr %s", __FILE__, __LINE__,
+			__FUNCTION__, fp ? "not null" : "null",
+			ptr ? "not null" : "null");
+		return ACL_VSTREAM_EOF;
+	}
+
+	n = bfgets_ref(fp, ptr);
+	while (n > 0 && ((*ptr)[n - 1] == '\n' || (*ptr)[n - 1] == '\r'))
 		n--;
+	return n;
+}
+
+int acl_vstream_read_ref(ACL_VSTREAM *fp, const void **ptr, size_t maxlen)
+{
+	int   n;
+
+	if (fp == NULL || ptr == NULL || maxlen == 0) {
+		acl_msg_error("%s(%d), %s: fp %s, ptr %s, maxlen %d",
+			__FILE__, __LINE__, __FUNCTION__,
+			fp ? "not null" : "null", ptr ? "not null" : "null",
+			(int) maxlen);
+		return ACL_VSTREAM_EOF;
 	}
 
+	if (fp->read_cnt <= 0 && read_buffed(fp) <= 0)
+		return ACL_VSTREAM_EOF;
+
+	n = (size_t) fp->read_cnt > maxlen ? (int) maxlen : fp->read_cnt;
+	*ptr = fp->read_ptr;
+	fp->read_ptr += n;
+	fp->read_cnt -= n;
+	fp->offset   += n;
 	return n;
 }
 
@@ -1002,35 +1129,45 @@ int acl_vstream_read(ACL_VSTREAM *fp, void *buf, size_t size)
 static int bfgets_crlf_peek(ACL_VSTREAM *fp, ACL_VSTRING *buf, int *ready)
 {
 	const char *myname = "bfgets_crlf_peek";
-	int   ch = 0;
+	unsigned char *ln;
+	int   n, ch;
 
 	if (fp->read_cnt <= 0)   /* XXX: sanity check */
 		return 0;
 
-	while (fp->read_cnt > 0) {
-		ch = *(fp->read_ptr);
-		ACL_VSTRING_ADDCH(buf, ch);
+	n = (int) fp->read_cnt;
 
-		fp->read_ptr++;
-		fp->read_cnt--;
-		fp->offset++;
+	/* ˻󳤶ʱΪֹ */
+	if (buf->maxlen > 0) {
+		int left = (int) (buf->maxlen - LEN(buf));
+		if (left < 1)
+			left = 1;
+		if (n > left)
+			n = left;
+	}
 
-		/* when get '\n', set ready 1 */
-		if (ch == '\n') {
-			*ready = 1;
-			fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
+	ln = (unsigned char *) memchr(fp->read_ptr, '\n', n);
+	if (ln != NULL)
+		n = (int) (ln - fp->read_ptr) + 1;
 
-			break;
-		}
+	ch = fp->read_ptr[n - 1];
+	acl_vstring_memcat(buf, (const char *) fp->read_ptr, n);
+	fp->read_ptr += n;
+	fp->read_cnt -= n;
+	fp->offset   += n;
 
-		/* when reached the max limit, set ready 1 */
-		if (buf->maxlen > 0 && (int) LEN(buf) >= buf->maxlen) {
-			*ready = 1;
-			acl_msg_warn("%s(%d), %s: line too long: %d, %d",
-				__FILE__, __LINE__, myname,
-				(int) buf->maxlen, (int) LEN(buf));
-			break;
-		}
+	/* when get '\n', set ready 1 */
+	if (ln != NULL) {
+		*ready = 1;
+		fp->flag |= ACL_VSTREAM_FLAG_TAGYES;
+	}
+
+	/* when reached the max limit, set ready 1 */
+	else if (buf->maxlen > 0 && (int) LEN(buf) >= buf->maxlen) {
+		*ready = 1;
+		acl_msg_warn("%s(%d), %s: line too long: %d, %d",
+			__FILE__, __LINE__, myname,
+			(int) buf->maxlen, (int) LEN(buf));
 	}
 
 	/* set '\0' teminated */
@@ -1559,7 +1696,7 @@ int acl_vstream_write(ACL_VSTREAM *fp, const void *vptr, int dlen)
 		return ACL_VSTREAM_EOF;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
 			return ACL_VSTREAM_EOF;
 	}
@@ -1577,7 +1714,7 @@ int acl_vstream_writev(ACL_VSTREAM *fp, const struct iovec *vec, int count)
 		return ACL_VSTREAM_EOF;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
 			return ACL_VSTREAM_EOF;
 	}
@@ -1597,7 +1734,7 @@ int acl_vstream_writevn(ACL_VSTREAM *fp, const struct iovec *vec, int count)
 		return ACL_VSTREAM_EOF;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
 			return ACL_VSTREAM_EOF;
 	}
@@ -1814,7 +1951,7 @@ int acl_vstream_writen(ACL_VSTREAM *fp, const void *vptr, size_t dlen)
 		return ACL_VSTREAM_EOF;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
 			return ACL_VSTREAM_EOF;
 	}
@@ -2009,6 +2146,233 @@ void acl_vstream_buffed_space(ACL_VSTREAM *fp)
 	}
 }
 
+/*--------------------------------------------------------------------------*/
+
+static WCHAIN *chain_get(ACL_VSTREAM *fp)
+{
+	WCHAIN *chain = (WCHAIN*) fp->wchain;
+
+	if (chain == NULL) {
+		chain = (WCHAIN*) acl_mycalloc(1, sizeof(WCHAIN));
+		chain->size = CHAIN_SEGS_INIT;
+		chain->segs = (WCHAIN_SEG*)
+			acl_mymalloc(chain->size * sizeof(WCHAIN_SEG));
+		chain->copy_limit = CHAIN_COPY_LIMIT;
+		fp->wchain = chain;
+	}
+	return chain;
+}
+
+static void chain_push(WCHAIN *chain, const void *ptr, size_t len,
+	void (*free_fn)(void*), void *ctx)
+{
+	WCHAIN_SEG *seg;
+
+	if (chain->count == chain->size) {
+		if (chain->head > 0) {
+			/* δдݶͷԸÿλ */
+			chain->count -= chain->head;
+			memmove(chain->segs, chain->segs + chain->head,
+				chain->count * sizeof(WCHAIN_SEG));
+			chain->head = 0;
+		}
+		if (chain->count == chain->size) {
+			chain->size *= 2;
+			chain->segs = (WCHAIN_SEG*) acl_myrealloc(chain->segs,
+				chain->size * sizeof(WCHAIN_SEG));
+		}
+	}
+
+	seg = &chain->segs[chain->count++];
+	seg->ptr     = (const unsigned char*) ptr;
+	seg->len     = len;
+	seg->free_fn = free_fn;
+	seg->ctx     = ctx;
+	chain->dlen += len;
+}
+
+/* деУΪдеǱ
+ * £β׷ݶ֮ǰãԱ֤ݵȺ˳
+ */
+static void chain_take_wbuf(ACL_VSTREAM *fp, WCHAIN *chain)
+{
+	if (fp->wbuf == NULL || fp->wbuf_dlen <= 0)
+		return;
+
+	chain_push(chain, fp->wbuf, (size_t) fp->wbuf_dlen,
+		acl_myfree_fn, fp->wbuf);
+	fp->wbuf      = NULL;
+	fp->wbuf_size = 0;
+	fp->wbuf_dlen = 0;
+}
+
+static void chain_free(ACL_VSTREAM *fp)
+{
+	WCHAIN *chain = (WCHAIN*) fp->wchain;
+	int   i;
+
+	if (chain == NULL)
+		return;
+
+	for (i = chain->head; i < chain->count; i++) {
+		if (chain->segs[i].free_fn)
+			chain->segs[i].free_fn(chain->segs[i].ctx);
+	}
+	acl_myfree(chain->segs);
+	acl_myfree(chain);
+	fp->wchain = NULL;
+}
+
+/*  writev ʽдеȫд */
+static int chain_flush(ACL_VSTREAM *fp)
+{
+	WCHAIN *chain = (WCHAIN*) fp->wchain;
+	struct iovec iov[IOV_MAX < 1024 ? IOV_MAX : 1024];
+	int   max = (int) (sizeof(iov) / sizeof(iov[0])) - 1;
+	int   i, cnt, n, nwrite = 0, woff = 0;
+	WCHAIN_SEG *seg;
+
+	while (chain->head < chain->count || woff < fp->wbuf_dlen) {
+		cnt = 0;
+		for (i = chain->head; i < chain->count && cnt < max; i++) {
+			iov[cnt].iov_base = (void*) chain->segs[i].ptr;
+			iov[cnt].iov_len  = chain->segs[i].len;
+			cnt++;
+		}
+
+		/* де£ֻȫʱſ׷ */
+		if (i == chain->count && woff < fp->wbuf_dlen) {
+			iov[cnt].iov_base = (void*) (fp->wbuf + woff);
+			iov[cnt].iov_len  = fp->wbuf_dlen - woff;
+			cnt++;
+		}
+
+		n = writev_once(fp, iov, cnt);
+		if (n == ACL_VSTREAM_EOF)
+			break;
+
+		nwrite += n;
+
+		while (n > 0 && chain->head < chain->count) {
+			seg = &chain->segs[chain->head];
+			if ((size_t) n < seg->len) {
+				seg->ptr += n;
+				seg->len -= n;
+				chain->dlen -= n;
+				n = 0;
+				break;
+			}
+
+			n -= (int) seg->len;
+			chain->dlen -= seg->len;
+			chain->head++;
+			if (seg->free_fn)
+				seg->free_fn(seg->ctx);
+		}
+
+		woff += n;
+	}
+
+	if (chain->head == chain->count)
+		chain->head = chain->count = 0;
+
+	if (woff > 0) {
+		fp->wbuf_dlen -= woff;
+		if (fp->wbuf_dlen > 0)
+			memmove(fp->wbuf, fp->wbuf + woff, fp->wbuf_dlen);
+	}
+
+	return WBUF_PENDING(fp) ? ACL_VSTREAM_EOF : nwrite;
+}
+
+int acl_vstream_chain_add(ACL_VSTREAM *fp, const void *ptr, size_t len,
+	void (*free_fn)(void*), void *ctx)
+{
+	WCHAIN *chain;
+
+	if (fp == NULL || ptr == NULL || len == 0) {
+		acl_msg_error("%s(%d), %s: fp %s, ptr %s, len %d", __FILE__,
+			__LINE__, __FUNCTION__, fp ? "not null" : "null",
+			ptr ? "not null" : "null", (int) len);
+		return ACL_VSTREAM_EOF;
+	}
+
+	chain = chain_get(fp);
+
+	/* СֱӿдԱгֹݶ */
+	if (len < chain->copy_limit) {
+		if (fp->wbuf != NULL
+			&& len + (size_t) fp->wbuf_dlen > (size_t) fp->wbuf_size)
+		{
+			chain_take_wbuf(fp, chain);
+		}
+		if (fp->wbuf == NULL) {
+			fp->wbuf_size = 8192;
+			fp->wbuf_dlen = 0;
+			fp->wbuf = acl_mymalloc(fp->wbuf_size);
+		}
+
+		memcpy(fp->wbuf + (size_t) fp->wbuf_dlen, ptr, len);
+		fp->wbuf_dlen += (int) len;
+		if (free_fn)
+			free_fn(ctx);
+		return (int) len;
+	}
+
+	chain_take_wbuf(fp, chain);
+	chain_push(chain, ptr, len, free_fn, ctx);
+	return (int) len;
+}
+
+int acl_vstream_chain_addv(ACL_VSTREAM *fp, const struct iovec *vec, int count)
+{
+	int   i, n = 0;
+
+	if (fp == NULL || vec == NULL || count <= 0) {
+		acl_msg_error("%s(%d), %s: fp %s, vec %s, count %d", __FILE__,
+			__LINE__, __FUNCTION__, fp ? "not null" : "null",
+			vec ? "not null" : "null", count);
+		return ACL_VSTREAM_EOF;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (vec[i].iov_len == 0)
+			continue;
+		if (acl_vstream_chain_add(fp, vec[i].iov_base,
+			vec[i].iov_len, NULL, NULL) == ACL_VSTREAM_EOF)
+		{
+			return ACL_VSTREAM_EOF;
+		}
+		n += (int) vec[i].iov_len;
+	}
+	return n;
+}
+
+void acl_vstream_chain_set_copy_limit(ACL_VSTREAM *fp, size_t limit)
+{
+	if (fp == NULL) {
+		acl_msg_error("%s(%d): fp null", __FUNCTION__, __LINE__);
+		return;
+	}
+	/* ܷд */
+	if (limit > 8192)
+		limit = 8192;
+	chain_get(fp)->copy_limit = limit;
+}
+
+size_t acl_vstream_chain_dlen(const ACL_VSTREAM *fp)
+{
+	size_t n;
+
+	if (fp == NULL)
+		return 0;
+
+	n = fp->wbuf_dlen > 0 ? (size_t) fp->wbuf_dlen : 0;
+	if (fp->wchain)
+		n += ((const WCHAIN*) fp->wchain)->dlen;
+	return n;
+}
+
 int acl_vstream_fflush(ACL_VSTREAM *fp)
 {
 	const char *myname = "acl_vstream_fflush";
@@ -2017,7 +2381,9 @@ int acl_vstream_fflush(ACL_VSTREAM *fp)
 	if (fp == NULL) {
 		acl_msg_error("%s(%d): fp null", myname, __LINE__);
 		return ACL_VSTREAM_EOF;
-	} else if (fp->wbuf == NULL || fp->wbuf_dlen <= 0)
+	} else if (!WCHAIN_EMPTY(fp))
+		return chain_flush(fp);
+	else if (fp->wbuf == NULL || fp->wbuf_dlen <= 0)
 		return 0;
 
 	n = loop_writen(fp, fp->wbuf, fp->wbuf_dlen);
@@ -2272,6 +2638,9 @@ ACL_VSTREAM *acl_vstream_clone(const ACL_VSTREAM *from)
 	to->ioctl_read_ctx = NULL;
 	to->ioctl_write_ctx = NULL;
 	to->fdp = NULL;
+	to->wchain = NULL;
+	to->fmap = NULL;
+	to->flag &= ~ACL_VSTREAM_FLAG_MMAP;
 	to->context = from->context;
 	to->close_handle_lnk = acl_array_create(8);
 	to->oflags = from->oflags;
@@ -2358,6 +2727,267 @@ ACL_VSTREAM *acl_vstream_fopen(const char *path, unsigned int oflags,
 	return fp;
 }
 
+/*--------------------------------------------------------------------------*/
+
+/* ָԭ˺Ķļӳ֮ӳԱ
+ * رʱͷţԱ֤֮ǰصӳڵָȻЧ
+ */
+static void fmap_leave(ACL_VSTREAM *fp)
+{
+	FMAP *fm = (FMAP*) fp->fmap;
+
+	if (!READ_MAPPED(fp))
+		return;
+
+	fp->read_buf     = fm->read_buf;
+	fp->read_buf_len = fm->read_buf_len;
+	fp->read_ptr     = fp->read_buf;
+	fm->read_buf     = NULL;
+	fp->flag        &= ~ACL_VSTREAM_FLAG_MMAP;
+}
+
+static void fmap_free(ACL_VSTREAM *fp)
+{
+	FMAP *fm = (FMAP*) fp->fmap;
+
+	if (fm == NULL)
+		return;
+
+	if (READ_MAPPED(fp)) {
+		fmap_leave(fp);
+		fp->read_cnt = 0;
+	}
+
+#ifdef ACL_UNIX
+	munmap(fm->addr, fm->len);
+#elif defined(ACL_WINDOWS)
+	UnmapViewOfFile(fm->addr);
+	CloseHandle(fm->hmap);
+#endif
+	acl_myfree(fm);
+	fp->fmap = NULL;
+}
+
+int acl_vstream_mmap(ACL_VSTREAM *fp)
+{
+	const char *myname = "acl_vstream_mmap";
+	acl_int64 size;
+	acl_off_t off;
+	FMAP *fm;
+	void *addr;
+#ifdef ACL_WINDOWS
+	HANDLE hmap;
+#endif
+
+	if (fp == NULL || fp->type != ACL_VSTREAM_TYPE_FILE
+		|| ACL_VSTREAM_FILE(fp) == ACL_FILE_INVALID)
+	{
+		acl_msg_error("%s(%d): invalid file fp", myname, __LINE__);
+		return -1;
+	}
+
+	if (fp->fmap != NULL) {
+		acl_msg_error("%s(%d): %s already mapped",
+			myname, __LINE__, ACL_VSTREAM_PATH(fp));
+		return -1;
+	}
+
+	if (WBUF_PENDING(fp) && acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
+		return -1;
+
+	size = acl_file_fsize(ACL_VSTREAM_FILE(fp), fp, fp->context);
+	if (size < 0) {
+		acl_msg_error("%s(%d): fsize %s error %s", myname, __LINE__,
+			ACL_VSTREAM_PATH(fp), acl_last_serror());
+		return -1;
+	}
+
+	/*  read_cnt Ϊ int ͣԽӳС 2G ļ */
+	if (size == 0 || size >= 0x7fffffff)
+		return -1;
+
+	off = fp->offset;
+	if (off < 0 || off > size)
+		off = size;
+
+#ifdef ACL_UNIX
+	/* ˽дʱӳ䣬Լ acl_vstream_unread ȶԶд */
+	addr = mmap(NULL, (size_t) size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE, ACL_VSTREAM_FILE(fp), 0);
+	if (addr == MAP_FAILED) {
+		acl_msg_error("%s(%d): mmap %s error %s", myname, __LINE__,
+			ACL_VSTREAM_PATH(fp), acl_last_serror());
+		return -1;
+	}
+# ifdef MADV_SEQUENTIAL
+	(void) madvise(addr, (size_t) size, MADV_SEQUENTIAL);
+# endif
+#elif defined(ACL_WINDOWS)
+	hmap = CreateFileMapping(ACL_VSTREAM_FILE(fp), NULL,
+		PAGE_WRITECOPY, 0, 0, NULL);
+	if (hmap == NULL) {
+		acl_msg_error("%s(%d): CreateFileMapping %s error %s", myname,
+			__LINE__, ACL_VSTREAM_PATH(fp), acl_last_serror());
+		return -1;
+	}
+	addr = MapViewOfFile(hmap, FILE_MAP_COPY, 0, 0, 0);
+	if (addr == NULL) {
+		acl_msg_error("%s(%d): MapViewOfFile %s error %s", myname,
+			__LINE__, ACL_VSTREAM_PATH(fp), acl_last_serror());
+		CloseHandle(hmap);
+		return -1;
+	}
+#else
+	acl_msg_error("%s: not supported yet!", myname);
+	return -1;
+#endif
+
+	/* ϵͳļָӳβӳɼ׷ӵ */
+	if (acl_lseek(ACL_VSTREAM_FILE(fp), (acl_off_t) size, SEEK_SET) < 0) {
+		acl_msg_error("%s(%d): lseek %s error %s", myname, __LINE__,
+			ACL_VSTREAM_PATH(fp), acl_last_serror());
+#ifdef ACL_UNIX
+		munmap(addr, (size_t) size);
+#elif defined(ACL_WINDOWS)
+		UnmapViewOfFile(addr);
+		CloseHandle(hmap);
+#endif
+		return -1;
+	}
+
+	fm = (FMAP*) acl_mycalloc(1, sizeof(FMAP));
+	fm->addr         = (unsigned char*) addr;
+	fm->len          = (size_t) size;
+#ifdef ACL_WINDOWS
+	fm->hmap         = hmap;
+#endif
+	fm->read_buf     = fp->read_buf;
+	fm->read_buf_len = fp->read_buf_len;
+	fp->fmap         = fm;
+
+	fp->read_buf     = fm->addr;
+	fp->read_buf_len = (int) size;
+	fp->read_ptr     = fm->addr + off;
+	fp->read_cnt     = (int) (size - off);
+	fp->offset       = off;
+	fp->sys_offset   = size;
+	fp->flag        |= ACL_VSTREAM_FLAG_MMAP;
+	return 0;
+}
+
+ACL_VSTREAM *acl_vstream_mmap_open(const char *path)
+{
+	const char *myname = "acl_vstream_mmap_open";
+	ACL_VSTREAM *fp;
+#ifdef	ACL_WINDOWS
+	int   oflags = O_RDONLY | O_BINARY;
+#else
+	int   oflags = O_RDONLY;
+#endif
+
+	if (path == NULL || *path == 0) {
+		acl_msg_error("%s(%d): path invalid", myname, __LINE__);
+		return NULL;
+	}
+
+	fp = acl_vstream_fopen(path, oflags, 0600, 4096);
+	if (fp == NULL) {
+		acl_msg_error("%s(%d): open file(%s) error(%s)",
+			myname, __LINE__, path, acl_last_serror());
+		return NULL;
+	}
+
+	/* ļӳʧʱԲͨĻʽ */
+	(void) acl_vstream_mmap(fp);
+	return fp;
+}
+
+int acl_vstream_mapped(const ACL_VSTREAM *fp)
+{
+	return fp != NULL && READ_MAPPED(fp) ? 1 : 0;
+}
+
+const char *acl_vstream_mapfile(const char *path, size_t *size)
+{
+	const char *myname = "acl_vstream_mapfile";
+	ACL_FILE_HANDLE fh;
+	acl_int64 len;
+	void *addr;
+#ifdef	ACL_WINDOWS
+	int   oflags = O_RDONLY | O_BINARY;
+	HANDLE hmap;
+#else
+	int   oflags = O_RDONLY;
+#endif
+
+	if (size)
+		*size = 0;
+
+	if (path == NULL || *path == 0) {
+		acl_msg_error("%s(%d): path invalid", myname, __LINE__);
+		return NULL;
+	}
+
+	fh = acl_file_open(path, oflags, 0600);
+	if (fh == ACL_FILE_INVALID) {
+		acl_msg_error("%s(%d): open file(%s) error(%s)",
+			myname, __LINE__, path, acl_last_serror());
+		return NULL;
+	}
+
+	len = acl_file_fsize(fh, NULL, NULL);
+	if (len <= 0 || (acl_uint64) len > (acl_uint64) ((size_t) -1)) {
+		acl_file_close(fh);
+		if (len < 0) {
+			acl_msg_error("%s(%d): fsize(%s) error(%s)",
+				myname, __LINE__, path, acl_last_serror());
+			return NULL;
+		}
+		return __empty_string;  /* ļؿմ */
+	}
+
+#ifdef ACL_UNIX
+	addr = mmap(NULL, (size_t) len, PROT_READ, MAP_SHARED, fh, 0);
+	if (addr == MAP_FAILED)
+		addr = NULL;
+# ifdef MADV_SEQUENTIAL
+	else
+		(void) madvise(addr, (size_t) len, MADV_SEQUENTIAL);
+# endif
+#elif defined(ACL_WINDOWS)
+	hmap = CreateFileMapping(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hmap != NULL) {
+		/* ӳͼᱣֶӳãԿرվ */
+		addr = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(hmap);
+	} else
+		addr = NULL;
+#else
+	addr = NULL;
+#endif
+
+	if (addr == NULL)
+		acl_msg_error("%s(%d): map file(%s) error(%s)",
+			myname, __LINE__, path, acl_last_serror());
+	else if (size)
+		*size = (size_t) len;
+
+	acl_file_close(fh);
+	return (const char*) addr;
+}
+
+void acl_vstream_unmapfile(const char *ptr, size_t size)
+{
+	if (ptr == NULL || ptr == __empty_string || size == 0)
+		return;
+
+#ifdef ACL_UNIX
+	munmap((void*) ptr, size);
+#elif defined(ACL_WINDOWS)
+	UnmapViewOfFile(ptr);
+#endif
+}
+
 char *acl_vstream_loadfile(const char *path)
 {
 	return acl_vstream_loadfile2(path, NULL);
@@ -2491,7 +3121,7 @@ acl_off_t acl_vstream_fseek2(ACL_VSTREAM *fp, acl_off_t offset, int whence)
 		return -1;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF) {
 			acl_msg_error("%s, %s(%d): acl_vstream_fflush error",
 				myname, __FILE__, __LINE__);
@@ -2554,7 +3184,7 @@ acl_off_t acl_vstream_fseek(ACL_VSTREAM *fp, acl_off_t offset, int whence)
 		return -1;
 	}
 
-	if (fp->wbuf_dlen > 0) {
+	if (WBUF_PENDING(fp)) {
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF) {
 			acl_msg_error("%s, %s(%d): acl_vstream_fflush error",
 				myname, __FILE__, __LINE__);
@@ -2791,7 +3421,7 @@ acl_int64 acl_vstream_fsize(ACL_VSTREAM *fp)
 		return -1;
 	}
 	return acl_file_fsize(ACL_VSTREAM_FILE(fp), fp, fp->context)
-		+ fp->wbuf_dlen;
+		+ (acl_int64) acl_vstream_chain_dlen(fp);
 }
 
 void acl_vstream_reset(ACL_VSTREAM *fp)
@@ -2804,6 +3434,8 @@ void acl_vstream_reset(ACL_VSTREAM *fp)
 		fp->total_write_cnt = 0;
 		fp->read_ready = 0;
 		fp->wbuf_dlen = 0;
+		chain_free(fp);
+		fmap_free(fp);
 		fp->offset = 0;
 		fp->nrefer = 0;
 		fp->read_buf_len = 0;
@@ -2856,6 +3488,7 @@ void acl_vstream_free(ACL_VSTREAM *fp)
 
 	if (fp->fdp != NULL)
 		event_fdtable_free(fp->fdp);
+	fmap_free(fp);
 	if (fp->read_buf != NULL && fp->read_buf != __vstream_stdin_buf
 		&& fp->read_buf != __vstream_stdout_buf
 		&& fp->read_buf != __vstream_stderr_buf)
@@ -2864,6 +3497,7 @@ void acl_vstream_free(ACL_VSTREAM *fp)
 	}
 	if (fp->wbuf != NULL)
 		acl_myfree(fp->wbuf);
+	chain_free(fp);
 
 	if (fp->addr_peer && fp->addr_peer != __empty_string)
 		acl_myfree(fp->addr_peer);
@@ -2900,7 +3534,7 @@ int acl_vstream_close(ACL_VSTREAM *fp)
 		return 0;
 	}
 
-	if (fp->wbuf_dlen > 0)
+	if (WBUF_PENDING(fp))
 		if (acl_vstream_fflush(fp) == ACL_VSTREAM_EOF)
 			acl_msg_error("%s: fflush fp error", myname);
 
@@ -2967,10 +3601,12 @@ int acl_vstream_close(ACL_VSTREAM *fp)
 
 	if (fp->fdp != NULL)
 		event_fdtable_free(fp->fdp);
+	fmap_free(fp);
 	if (fp->read_buf != NULL)
 		acl_myfree(fp->read_buf);
 	if (fp->wbuf != NULL)
 		acl_myfree(fp->wbuf);
+	chain_free(fp);
 
 	if (fp->addr_local && fp->addr_local != __empty_string)
 		acl_myfree(fp->addr_local);
@@ -83,7 +83,13 @@ static int vstring_extend(ACL_VBUF *bp, ssize_t incr)
 	if (vp->maxlen > 0 && new_len > vp->maxlen)
 		new_len = vp->maxlen;
 
-	if (vp->slice)
+	if (bp->flags & ACL_VBUF_FLAG_EMBED) {
+		/* ǶʱǨ̬ڴ */
+		const unsigned char *data = bp->data;
+		bp->data = (unsigned char *) acl_mymalloc(new_len);
+		memcpy(bp->data, data, bp->len);
+		bp->flags &= ~ACL_VBUF_FLAG_EMBED;
+	} else if (vp->slice)
 		bp->data = (unsigned char *) acl_slice_pool_realloc(
 			__FILE__, __LINE__, vp->slice, bp->data, new_len);
 	else if (vp->dbuf) {
@@ -170,6 +176,12 @@ void acl_vstring_free_buf(ACL_VSTRING *vp)
 	if (vp->vbuf.data == NULL)
 		return;
 
+	if (vp->vbuf.flags & ACL_VBUF_FLAG_EMBED) {
+		vp->vbuf.flags &= ~ACL_VBUF_FLAG_EMBED;
+		vp->vbuf.data = NULL;
+		return;
+	}
+
 	if (vp->slice)
 		acl_slice_pool_free(__FILE__, __LINE__, vp->vbuf.data);
 #ifdef ACL_UNIX
@@ -190,6 +202,30 @@ void acl_vstring_free_buf(ACL_VSTRING *vp)
 	vp->vbuf.data = NULL;
 }
 
+void acl_vstring_embed(ACL_VSTRING *vp, void *buf, size_t len)
+{
+	if (buf == NULL || len < 1)
+		acl_msg_panic("acl_vstring_embed: bad input, len < 1");
+
+	vp->slice = NULL;
+	vp->dbuf = NULL;
+	vp->vbuf.data = (unsigned char *) buf;
+
+#if defined(_WIN32) || defined(_WIN64)
+	vp->hmap = NULL;
+#endif
+	vp->vbuf.flags = ACL_VBUF_FLAG_EMBED;
+	vp->vbuf.len = (int) len;
+	ACL_VSTRING_RESET(vp);
+	vp->vbuf.data[0] = 0;
+	vp->vbuf.get_ready = vstring_buf_get_ready;
+	vp->vbuf.put_ready = vstring_buf_put_ready;
+	vp->vbuf.space = vstring_buf_space;
+	vp->vbuf.ctx = NULL;
+	vp->maxlen = 0;
+	vp->fd = ACL_FILE_INVALID;
+}
+
 /* acl_vstring_alloc - create variable-length string */
 
 ACL_VSTRING *acl_vstring_alloc(size_t len)
@@ -24,6 +24,20 @@
 
 #endif
 
+/*
+ * ģʽн MPMC ζ(ʱ)߳
+ * ڳύıضУ߳̿ɴ̵߳ıضȡ
+ * 񣻿߳һʱ䣬Ȼ futex ϣ֧ Linux ƽ̨
+ */
+#if	defined(ACL_LINUX) && (defined(__clang__) || (defined(__GNUC__) \
+	&& (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))))
+# define	POOL_LOCKFREE
+# include <limits.h>
+# include <sched.h>
+# include <sys/syscall.h>
+# include <linux/futex.h>
+#endif
+
 #define	ACL_PTHREAD_POOL_VALID		0x0decca62
 #define	SEC_TO_NS			1000000000
 #define	SEC_TO_MS			1000
@@ -96,6 +110,7 @@ struct acl_pthread_pool_t {
 	int   idle_timeout;                   /* idle timeout second        */
 	acl_int64 schedule_warn;              /* schedule warn: millisecond */
 	acl_int64 schedule_wait;              /* schedule wait: millisecond */
+	volatile acl_int64 last_wait;         /* the last job's queue wait  */
 	int   overload_wait;                  /* when too busy, sleep time  */
 	time_t last_warn;                     /* last warn time             */
 	int  (*poller_fn)(void *arg);         /* worker poll function       */
@@ -104,6 +119,19 @@ struct acl_pthread_pool_t {
 	void *worker_init_arg;
 	void (*worker_free_fn)(void *arg);    /* the arg is worker_free_arg */
 	void *worker_free_arg;
+	int   lockfree;                       /* use the lock-free queues ? */
+#ifdef	POOL_LOCKFREE
+	struct lf_ring       *lf_queue;       /* the global job queue       */
+	struct lf_worker     *lf_workers;     /* slots of the workers       */
+	volatile int          lf_epoch;       /* the futex word             */
+	volatile int          lf_nsleep;      /* threads sleeping on futex  */
+	volatile int          lf_nwake;       /* wakeups not yet consumed   */
+	volatile int          lf_nidle;       /* threads spinning/sleeping  */
+	volatile int          lf_nspin;       /* threads spinning           */
+	int                   lf_max_spin;    /* max threads spinning       */
+	volatile int          lf_overflow;    /* jobs in overflow queue     */
+	volatile int          lf_nlocal;      /* jobs in the local queues   */
+#endif
 };
 
 #undef	SET_ERRNO
@@ -121,6 +149,557 @@ struct acl_pthread_pool_t {
 } while (0)
 #endif
 
+#ifdef	POOL_LOCKFREE
+
+#define	LF_QUEUE_SIZE	8192    /* cells of the global queue          */
+#define	LF_LOCAL_SIZE	256     /* cells of each worker's local queue */
+#define	LF_SPIN		2000    /* spin count before sleeping         */
+
+#define	LF_LOAD(p)	__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define	LF_STORE(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define	LF_CAS(p, o, n)	__sync_bool_compare_and_swap((p), (o), (n))
+#define	LF_ADD(p, n)	__sync_add_and_fetch((p), (n))
+#define	LF_FENCE()	__sync_synchronize()
+
+#if	defined(__i386__) || defined(__x86_64__)
+# define LF_PAUSE()	__asm__ __volatile__("pause")
+#else
+# define LF_PAUSE()	sched_yield()
+#endif
+
+#ifndef	FUTEX_WAIT_PRIVATE
+# define FUTEX_WAIT_PRIVATE	FUTEX_WAIT
+# define FUTEX_WAKE_PRIVATE	FUTEX_WAKE
+#endif
+
+typedef struct lf_cell {
+	volatile size_t seq;
+	void (*worker_fn)(void *arg);
+	void *worker_arg;
+	acl_pthread_job_t *job;               /* not NULL if added as job   */
+	acl_int64 start;
+} lf_cell;
+
+/* the bounded MPMC ring of Dmitry Vyukov */
+typedef struct lf_ring {
+	lf_cell *cells;
+	size_t   mask;
+	char     pad1[64];
+	volatile size_t head;                 /* the next position to push  */
+	char     pad2[64];
+	volatile size_t tail;                 /* the next position to pop   */
+	char     pad3[64];
+} lf_ring;
+
+typedef struct lf_worker {
+	lf_ring ring;                         /* the worker's local queue   */
+	volatile int used;                    /* the slot used by a thread  */
+} lf_worker;
+
+/* the worker slot and thread pool of the current thread */
+static __thread lf_worker *__lf_self = NULL;
+static __thread acl_pthread_pool_t *__lf_pool = NULL;
+
+static void lf_ring_init(lf_ring *ring, size_t size)
+{
+	size_t i;
+
+	ring->cells = (lf_cell*) acl_mycalloc(size, sizeof(lf_cell));
+	ring->mask  = size - 1;
+	ring->head  = 0;
+	ring->tail  = 0;
+	for (i = 0; i < size; i++)
+		ring->cells[i].seq = i;
+}
+
+static int lf_ring_push(lf_ring *ring, const lf_cell *in)
+{
+	size_t pos = LF_LOAD(&ring->head), seq;
+	lf_cell *cell;
+	long diff;
+
+	for (;;) {
+		cell = &ring->cells[pos & ring->mask];
+		seq  = LF_LOAD(&cell->seq);
+		diff = (long) seq - (long) pos;
+		if (diff == 0) {
+			if (LF_CAS(&ring->head, pos, pos + 1))
+				break;
+			pos = LF_LOAD(&ring->head);
+		} else if (diff < 0)
+			return -1;  /* the ring is full */
+		else
+			pos = LF_LOAD(&ring->head);
+	}
+
+	cell->worker_fn  = in->worker_fn;
+	cell->worker_arg = in->worker_arg;
+	cell->job        = in->job;
+	cell->start      = in->start;
+	LF_STORE(&cell->seq, pos + 1);
+	return 0;
+}
+
+static int lf_ring_pop(lf_ring *ring, lf_cell *out)
+{
+	size_t pos = LF_LOAD(&ring->tail), seq;
+	lf_cell *cell;
+	long diff;
+
+	for (;;) {
+		cell = &ring->cells[pos & ring->mask];
+		seq  = LF_LOAD(&cell->seq);
+		diff = (long) seq - (long) (pos + 1);
+		if (diff == 0) {
+			if (LF_CAS(&ring->tail, pos, pos + 1))
+				break;
+			pos = LF_LOAD(&ring->tail);
+		} else if (diff < 0)
+			return -1;  /* the ring is empty */
+		else
+			pos = LF_LOAD(&ring->tail);
+	}
+
+	out->worker_fn  = cell->worker_fn;
+	out->worker_arg = cell->worker_arg;
+	out->job        = cell->job;
+	out->start      = cell->start;
+	LF_STORE(&cell->seq, pos + ring->mask + 1);
+	return 0;
+}
+
+static void lf_init(acl_pthread_pool_t *thr_pool)
+{
+	long  ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+	int   i;
+
+	/* spinning is useless on single CPU, and at most half of the CPUs
+	 * are allowed to be used for spinning
+	 */
+	thr_pool->lf_max_spin = ncpu > 1 ? (int) ncpu / 2 : 0;
+
+	thr_pool->lf_queue = (lf_ring*) acl_mycalloc(1, sizeof(lf_ring));
+	lf_ring_init(thr_pool->lf_queue, LF_QUEUE_SIZE);
+
+	thr_pool->lf_workers = (lf_worker*) acl_mycalloc(
+		thr_pool->parallelism, sizeof(lf_worker));
+	for (i = 0; i < thr_pool->parallelism; i++)
+		lf_ring_init(&thr_pool->lf_workers[i].ring, LF_LOCAL_SIZE);
+}
+
+static void lf_free(acl_pthread_pool_t *thr_pool)
+{
+	int   i;
+
+	for (i = 0; i < thr_pool->parallelism; i++)
+		acl_myfree(thr_pool->lf_workers[i].ring.cells);
+	acl_myfree(thr_pool->lf_workers);
+	acl_myfree(thr_pool->lf_queue->cells);
+	acl_myfree(thr_pool->lf_queue);
+}
+
+static int lf_wake(acl_pthread_pool_t *thr_pool, int n)
+{
+	LF_ADD(&thr_pool->lf_epoch, 1);
+	return (int) syscall(SYS_futex, &thr_pool->lf_epoch,
+		FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+
+/* wake up one sleeping thread, the woken thread will consume the wakeup,
+ * so the other adders needn't wake up more threads before it runs
+ */
+static void lf_wake_one(acl_pthread_pool_t *thr_pool)
+{
+	LF_ADD(&thr_pool->lf_nwake, 1);
+	if (lf_wake(thr_pool, 1) <= 0)
+		LF_ADD(&thr_pool->lf_nwake, -1);
+}
+
+static void lf_wake_consume(acl_pthread_pool_t *thr_pool)
+{
+	int   n;
+
+	while ((n = LF_LOAD(&thr_pool->lf_nwake)) > 0) {
+		if (LF_CAS(&thr_pool->lf_nwake, n, n - 1))
+			break;
+	}
+}
+
+static int lf_has_job(acl_pthread_pool_t *thr_pool)
+{
+	return LF_LOAD(&thr_pool->qlen) > 0;
+}
+
+static int lf_job_pop(acl_pthread_pool_t *thr_pool, lf_worker *self,
+	lf_cell *out)
+{
+	acl_pthread_job_t *job;
+	int   i, n;
+
+	/* the worker's local queue first, then the global queue */
+	if (LF_LOAD(&thr_pool->lf_nlocal) > 0
+		&& lf_ring_pop(&self->ring, out) == 0)
+	{
+		LF_ADD(&thr_pool->lf_nlocal, -1);
+		LF_ADD(&thr_pool->qlen, -1);
+		return 0;
+	}
+
+	if (lf_ring_pop(thr_pool->lf_queue, out) == 0) {
+		LF_ADD(&thr_pool->qlen, -1);
+		return 0;
+	}
+
+	/* then the overflow queue when the global queue was full */
+	if (LF_LOAD(&thr_pool->lf_overflow) > 0) {
+		acl_pthread_mutex_lock(&thr_pool->worker_mutex);
+		job = thr_pool->job_first;
+		if (job != NULL) {
+			thr_pool->job_first = job->next;
+			if (thr_pool->job_last == job)
+				thr_pool->job_last = NULL;
+			LF_ADD(&thr_pool->lf_overflow, -1);
+		}
+		acl_pthread_mutex_unlock(&thr_pool->worker_mutex);
+
+		if (job != NULL) {
+			out->worker_fn  = job->worker_fn;
+			out->worker_arg = job->worker_arg;
+			out->job        = job;
+			out->start      = job->start;
+			LF_ADD(&thr_pool->qlen, -1);
+			return 0;
+		}
+	}
+
+	if (LF_LOAD(&thr_pool->lf_nlocal) <= 0)
+		return -1;
+
+	/* at last, steal one job from the other workers */
+	n = (int) (self - thr_pool->lf_workers);
+	for (i = 1; i < thr_pool->parallelism; i++) {
+		lf_worker *other = &thr_pool->lf_workers[
+			(n + i) % thr_pool->parallelism];
+
+		if (other->ring.head != other->ring.tail
+			&& lf_ring_pop(&other->ring, out) == 0)
+		{
+			LF_ADD(&thr_pool->lf_nlocal, -1);
+			LF_ADD(&thr_pool->qlen, -1);
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+static void lf_job_run(acl_pthread_pool_t *thr_pool, lf_cell *cell)
+{
+	const char *myname = "lf_job_run";
+
+	if (cell->start > 0) {
+		acl_int64 now;
+
+		SET_TIME(now);
+		now -= cell->start;
+		thr_pool->last_wait = now;
+		if (now >= thr_pool->schedule_warn) {
+			acl_msg_warn("%s(%d), %s: schedule: %lld >= %lld",
+				__FILE__, __LINE__, myname,
+				now, thr_pool->schedule_warn);
+		}
+	}
+
+	if (cell->job && !cell->job->fixed)
+		acl_myfree(cell->job);
+
+	cell->worker_fn(cell->worker_arg);
+}
+
+/* wait for jobs, return 0 if some jobs come, -1 if the thread should exit */
+
+static int lf_worker_wait(acl_pthread_pool_t *thr_pool)
+{
+	struct timespec timeout, *tp = NULL;
+	int   i, key, ret, timedout = 0;
+
+	if (thr_pool->idle_timeout > 0) {
+		timeout.tv_sec  = thr_pool->idle_timeout;
+		timeout.tv_nsec = 0;
+		tp = &timeout;
+	}
+
+	LF_ADD(&thr_pool->lf_nidle, 1);
+
+	for (;;) {
+		/* spin a while before sleeping if not too many spinners */
+		if (LF_ADD(&thr_pool->lf_nspin, 1) <= thr_pool->lf_max_spin) {
+			for (i = 0; i < LF_SPIN; i++) {
+				if (lf_has_job(thr_pool) || thr_pool->quit)
+					break;
+				LF_PAUSE();
+			}
+		}
+		LF_ADD(&thr_pool->lf_nspin, -1);
+
+		if (lf_has_job(thr_pool))
+			goto FOUND;
+		if (thr_pool->quit)
+			goto QUIT;
+
+		if (timedout)
+			goto QUIT;
+
+		key = LF_LOAD(&thr_pool->lf_epoch);
+		LF_ADD(&thr_pool->lf_nsleep, 1);
+
+		/* check again after registered as sleeper to avoid missing
+		 * the wakeup from the job adder
+		 */
+		if (lf_has_job(thr_pool) || thr_pool->quit) {
+			LF_ADD(&thr_pool->lf_nsleep, -1);
+			continue;
+		}
+
+		ret = (int) syscall(SYS_futex, &thr_pool->lf_epoch,
+			FUTEX_WAIT_PRIVATE, key, tp, NULL, 0);
+		if (ret == 0)
+			lf_wake_consume(thr_pool);
+		else if (errno == ETIMEDOUT)
+			timedout = 1;
+		LF_ADD(&thr_pool->lf_nsleep, -1);
+	}
+
+FOUND:
+	LF_ADD(&thr_pool->lf_nidle, -1);
+	return 0;
+
+QUIT:
+	LF_ADD(&thr_pool->lf_nidle, -1);
+	/* check again after leaving the idle threads */
+	if (lf_has_job(thr_pool))
+		return 0;
+	return -1;
+}
+
+static void *lf_worker_thread(void *arg);
+
+static void lf_spawn(acl_pthread_pool_t *thr_pool)
+{
+	const char *myname = "lf_spawn";
+	acl_pthread_t id;
+	int   n, status;
+
+	for (;;) {
+		n = LF_LOAD(&thr_pool->count);
+		if (n >= thr_pool->parallelism)
+			return;
+		if (LF_CAS(&thr_pool->count, n, n + 1))
+			break;
+	}
+
+	status = acl_pthread_create(&id, &thr_pool->attr,
+			lf_worker_thread, (void*) thr_pool);
+	if (status != 0) {
+		LF_ADD(&thr_pool->count, -1);
+		SET_ERRNO(status);
+		acl_msg_error("%s(%d), %s: pthread_create: %s",
+			__FILE__, __LINE__, myname, acl_last_serror());
+	}
+}
+
+static void lf_worker_exit(acl_pthread_pool_t *thr_pool)
+{
+	acl_pthread_mutex_lock(&thr_pool->worker_mutex);
+	LF_ADD(&thr_pool->count, -1);
+	if (thr_pool->quit)
+		acl_pthread_cond_signal(&thr_pool->cond);
+	acl_pthread_mutex_unlock(&thr_pool->worker_mutex);
+}
+
+static void *lf_worker_thread(void *arg)
+{
+	const char *myname = "lf_worker_thread";
+	acl_pthread_pool_t *thr_pool = (acl_pthread_pool_t*) arg;
+	lf_worker *self = NULL;
+	lf_cell cell;
+	int   i, nfail = 0;
+
+	if (thr_pool->worker_init_fn != NULL) {
+		if (thr_pool->worker_init_fn(thr_pool->worker_init_arg) < 0) {
+			acl_msg_error("%s(%d), %s: thread(%lu) init error",
+				__FILE__, __LINE__, myname,
+				(unsigned long) acl_pthread_self());
+			lf_worker_exit(thr_pool);
+			if (lf_has_job(thr_pool))
+				lf_spawn(thr_pool);
+			return NULL;
+		}
+	}
+
+	/* the count of threads never exceeds the count of slots */
+	for (i = 0; self == NULL; i = (i + 1) % thr_pool->parallelism) {
+		if (LF_CAS(&thr_pool->lf_workers[i].used, 0, 1))
+			self = &thr_pool->lf_workers[i];
+	}
+
+	__lf_self = self;
+	__lf_pool = thr_pool;
+
+	for (;;) {
+		if (lf_job_pop(thr_pool, self, &cell) == 0) {
+			nfail = 0;
+			lf_job_run(thr_pool, &cell);
+			continue;
+		}
+
+		/* the job counted was taken by the other thread which hasn't
+		 * decreased the count, so give up the CPU to it
+		 */
+		if (nfail++ > 0)
+			sched_yield();
+		if (lf_worker_wait(thr_pool) < 0)
+			break;
+	}
+
+	acl_debug(ACL_DEBUG_THR_POOL, 2) ("%s(%d): thread(%lu) exit now",
+		myname, __LINE__, (unsigned long) acl_pthread_self());
+
+	if (thr_pool->worker_free_fn != NULL)
+		thr_pool->worker_free_fn(thr_pool->worker_free_arg);
+
+	__lf_self = NULL;
+	__lf_pool = NULL;
+	LF_STORE(&self->used, 0);
+
+	lf_worker_exit(thr_pool);
+
+	/* some jobs maybe added after the last check, but the adder found
+	 * this idle thread and didn't create a new one
+	 */
+	if (lf_has_job(thr_pool))
+		lf_spawn(thr_pool);
+
+	return NULL;
+}
+
+static void lf_job_add(acl_pthread_pool_t *thr_pool, void (*run_fn)(void*),
+	void *run_arg, acl_pthread_job_t *job)
+{
+	const char *myname = "lf_job_add";
+	lf_cell cell;
+	int   qlen;
+
+	cell.worker_fn  = run_fn;
+	cell.worker_arg = run_arg;
+	cell.job        = job;
+	if (thr_pool->schedule_warn > 0)
+		SET_TIME(cell.start);
+	else
+		cell.start = 0;
+
+	/* the job added in the pool's worker goes into its local queue */
+	if (__lf_pool == thr_pool && lf_ring_push(&__lf_self->ring, &cell) == 0)
+		LF_ADD(&thr_pool->lf_nlocal, 1);
+	else if (lf_ring_push(thr_pool->lf_queue, &cell) == 0)
+		;
+	else {
+		if (job == NULL)
+			job = acl_pthread_pool_alloc_job(run_fn, run_arg, 0);
+		job->next  = NULL;
+		job->start = cell.start;
+
+		acl_pthread_mutex_lock(&thr_pool->worker_mutex);
+		if (thr_pool->job_first == NULL)
+			thr_pool->job_first = job;
+		else
+			thr_pool->job_last->next = job;
+		thr_pool->job_last = job;
+		LF_ADD(&thr_pool->lf_overflow, 1);
+		acl_pthread_mutex_unlock(&thr_pool->worker_mutex);
+	}
+
+	/* count the job after it was pushed, so the idle threads never wait
+	 * for a job which isn't in the queues yet; and the job must be
+	 * visible before checking the idle threads
+	 */
+	qlen = LF_ADD(&thr_pool->qlen, 1);
+
+	/* wake up one sleeping thread if the spinning threads are not
+	 * enough, or create one thread if no idle thread
+	 */
+	if (LF_LOAD(&thr_pool->lf_nsleep) > 0) {
+		int nwake = LF_LOAD(&thr_pool->lf_nwake);
+
+		if (LF_LOAD(&thr_pool->lf_nsleep) > nwake
+			&& qlen > LF_LOAD(&thr_pool->lf_nspin) + nwake)
+		{
+			lf_wake_one(thr_pool);
+		}
+	} else if (LF_LOAD(&thr_pool->lf_nidle) == 0)
+		lf_spawn(thr_pool);
+
+	if (qlen > thr_pool->qlen_warn
+		&& LF_LOAD(&thr_pool->count) >= thr_pool->parallelism)
+	{
+		time_t now = time(NULL);
+
+		if (now - thr_pool->last_warn >= 2) {
+			thr_pool->last_warn = now;
+			acl_msg_warn("%s(%d), %s: OVERLOADED! max_thread: %d,"
+				" qlen: %d, idle: %d", __FILE__, __LINE__,
+				myname, thr_pool->parallelism, qlen,
+				LF_LOAD(&thr_pool->lf_nidle));
+		}
+		if (thr_pool->overload_wait > 0) {
+			acl_msg_warn("%s(%d), %s: sleep %d seconds", __FILE__,
+				__LINE__, myname, thr_pool->overload_wait);
+			sleep(thr_pool->overload_wait);
+		}
+	}
+}
+
+static int lf_wait_worker_exit(acl_pthread_pool_t *thr_pool)
+{
+	const char *myname = "lf_wait_worker_exit";
+	int   status;
+
+	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
+	if (status != 0) {
+		SET_ERRNO(status);
+		acl_msg_error("%s(%d), %s: pthread_mutex_lock: %s",
+			__FILE__, __LINE__, myname, acl_last_serror());
+		return status;
+	}
+
+	thr_pool->quit = 1;
+	LF_FENCE();
+	(void) lf_wake(thr_pool, INT_MAX);
+
+	while (LF_LOAD(&thr_pool->count) > 0) {
+		status = acl_pthread_cond_wait(&thr_pool->cond,
+				&thr_pool->worker_mutex);
+		if (status != 0) {
+			SET_ERRNO(status);
+			acl_pthread_mutex_unlock(&thr_pool->worker_mutex);
+			acl_msg_error("%s(%d), %s: pthread_cond_wait: %s",
+				__FILE__, __LINE__, myname, acl_last_serror());
+			return status;
+		}
+	}
+
+	status = acl_pthread_mutex_unlock(&thr_pool->worker_mutex);
+	if (status != 0) {
+		SET_ERRNO(status);
+		acl_msg_error("%s(%d), %s: pthread_mutex_unlock err: %s",
+			__FILE__, __LINE__, myname, acl_last_serror());
+	}
+
+	return status;
+}
+
+#endif	/* POOL_LOCKFREE */
+
 static void *poller_thread(void *arg)
 {
 	const char *myname = "poller_thread";
@@ -260,6 +839,7 @@ static void worker_run(acl_pthread_pool_t *thr_pool,
 
 		SET_TIME(now);
 		now -= job->start;
+		thr_pool->last_wait = now;
 		if (now >= thr_pool->schedule_warn) {
 			acl_msg_warn("%s(%d), %s: schedule: %lld >= %lld",
 				__FILE__, __LINE__, myname,
@@ -650,6 +1230,13 @@ void acl_pthread_pool_add_one(acl_pthread_pool_t *thr_pool,
 		acl_msg_fatal("%s(%d), %s: run_fn null",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree) {
+		lf_job_add(thr_pool, run_fn, run_arg, NULL);
+		return;
+	}
+#endif
+
 #ifdef	USE_SLOT
 	status = acl_pthread_mutex_trylock(&thr_pool->slot_mutex);
 	if (status == 0) {
@@ -694,6 +1281,13 @@ void acl_pthread_pool_add_job(acl_pthread_pool_t *thr_pool,
 		acl_msg_fatal("%s(%d), %s: job null",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree) {
+		lf_job_add(thr_pool, job->worker_fn, job->worker_arg, job);
+		return;
+	}
+#endif
+
 	job_add(thr_pool, job);
 }
 
@@ -706,6 +1300,12 @@ void acl_pthread_pool_bat_add_begin(acl_pthread_pool_t *thr_pool)
 		acl_msg_fatal("%s(%d), %s: invalid thr_pool->valid",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	/* the jobs are added one by one without the lock */
+	if (thr_pool->lockfree)
+		return;
+#endif
+
 	thr_pool->thr_iter = thr_pool->thr_first;
 
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
@@ -814,6 +1414,13 @@ void acl_pthread_pool_bat_add_one(acl_pthread_pool_t *thr_pool,
 		acl_msg_fatal("%s(%d), %s: invalid thr_pool or run_fn",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree) {
+		lf_job_add(thr_pool, run_fn, run_arg, NULL);
+		return;
+	}
+#endif
+
 #ifdef	USE_SLOT
 	status = acl_pthread_mutex_trylock(&thr_pool->slot_mutex);
 	if (status == 0) {
@@ -856,6 +1463,13 @@ void acl_pthread_pool_bat_add_job(acl_pthread_pool_t *thr_pool,
 		acl_msg_fatal("%s(%d), %s: invalid thr_pool->valid",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree) {
+		lf_job_add(thr_pool, job->worker_fn, job->worker_arg, job);
+		return;
+	}
+#endif
+
 	job_append(thr_pool, job);
 }
 
@@ -869,6 +1483,11 @@ void acl_pthread_pool_bat_add_end(acl_pthread_pool_t *thr_pool)
 		acl_msg_fatal("%s(%d), %s: invalid thr_pool->valid",
 			__FILE__, __LINE__, myname);
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return;
+#endif
+
 	qlen = thr_pool->qlen;
 	thr_iter = thr_pool->thr_first;
 
@@ -1062,6 +1681,13 @@ acl_pthread_pool_t *acl_pthread_pool_create(const acl_pthread_pool_attr_t *attr)
 	thr_pool->worker_free_fn = NULL;
 	thr_pool->worker_free_arg = NULL;
 
+#ifdef	POOL_LOCKFREE
+	if (attr && attr->lockfree) {
+		thr_pool->lockfree = 1;
+		lf_init(thr_pool);
+	}
+#endif
+
 	thr_pool->valid = ACL_PTHREAD_POOL_VALID;
 
 	return thr_pool;
@@ -1181,6 +1807,11 @@ static int wait_worker_exit(acl_pthread_pool_t *thr_pool)
 	const char *myname = "wait_worker_exit";
 	int   status, nwait = 0;
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return lf_wait_worker_exit(thr_pool);
+#endif
+
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
 	if (status != 0) {
 		SET_ERRNO(status);
@@ -1319,6 +1950,11 @@ int acl_pthread_pool_destroy(acl_pthread_pool_t *thr_pool)
 	s6 = acl_pthread_mutex_destroy(&thr_pool->slot_mutex);
 #endif
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		lf_free(thr_pool);
+#endif
+
 	acl_myfree(thr_pool);
 
 #ifdef	USE_SLOT
@@ -1484,6 +2120,11 @@ int acl_pthread_pool_size(acl_pthread_pool_t *thr_pool)
 	const char *myname = "acl_pthread_pool_size";
 	int   status, n;
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return LF_LOAD(&thr_pool->count);
+#endif
+
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
 	if (status) {
 		acl_msg_error("%s(%d), %s: pthread_mutex_lock error(%s)",
@@ -1507,6 +2148,11 @@ int acl_pthread_pool_idle(acl_pthread_pool_t *thr_pool)
 	const char *myname = "acl_pthread_pool_idle";
 	int   status, n;
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return LF_LOAD(&thr_pool->lf_nidle);
+#endif
+
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
 	if (status) {
 		acl_msg_error("%s(%d), %s: pthread_mutex_lock error(%s)",
@@ -1531,6 +2177,13 @@ int acl_pthread_pool_busy(acl_pthread_pool_t *thr_pool)
 	const char *myname = "acl_pthread_pool_busy";
 	int   status, n;
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree) {
+		n = LF_LOAD(&thr_pool->count) - LF_LOAD(&thr_pool->lf_nidle);
+		return n > 0 ? n : 0;
+	}
+#endif
+
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
 	if (status) {
 		acl_msg_error("%s(%d), %s: pthread_mutex_lock error(%s)",
@@ -1559,6 +2212,11 @@ int acl_pthread_pool_qlen(acl_pthread_pool_t *thr_pool)
 	const char *myname = "acl_pthread_pool_qlen";
 	int   status, n;
 
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return LF_LOAD(&thr_pool->qlen);
+#endif
+
 	status = acl_pthread_mutex_lock(&thr_pool->worker_mutex);
 	if (status) {
 		acl_msg_error("%s(%d), %s: pthread_mutex_lock error(%s)",
@@ -1582,6 +2240,16 @@ int acl_pthread_pool_qlen(acl_pthread_pool_t *thr_pool)
 	return n;
 }
 
+acl_int64 acl_pthread_pool_queue_wait(acl_pthread_pool_t *thr_pool)
+{
+	/* the queue maybe drained after the last job started */
+#ifdef	POOL_LOCKFREE
+	if (thr_pool->lockfree)
+		return LF_LOAD(&thr_pool->qlen) > 0 ? thr_pool->last_wait : 0;
+#endif
+	return thr_pool->qlen > 0 ? thr_pool->last_wait : 0;
+}
+
 void acl_pthread_pool_set_stacksize(acl_pthread_pool_t *thr_pool, size_t size)
 {
 	if (thr_pool && size > 0)
@@ -1615,6 +2283,13 @@ void acl_pthread_pool_attr_set_idle_timeout(
 		attr->idle_timeout = idle_timeout;
 }
 
+void acl_pthread_pool_attr_set_lockfree(
+	acl_pthread_pool_attr_t *attr, int onoff)
+{
+	if (attr)
+		attr->lockfree = onoff ? 1 : 0;
+}
+
 acl_pthread_job_t *acl_pthread_pool_alloc_job(void (*run_fn)(void*),
 	void *run_arg, int fixed)
 {
@@ -73,10 +73,11 @@ public:
 
 	/**
 	 * ӳؼȺɾĳַӳأúڳй
-	 * ãΪڲԶ
+	 * ãΪڲԶش麯Ըӳ
+	 * ãñ෽
 	 * @param addr {const char*} ַ(ip:port)
 	 */
-	void remove(const char* addr);
+	virtual void remove(const char* addr);
 
 	/**
 	 * ݷ˵ַø÷ӳ
@@ -14,6 +14,7 @@
 #include "stdlib/log.hpp"
 #include "stdlib/pipe_stream.hpp"
 #include "stdlib/string.hpp"
+#include "stdlib/string_view.hpp"
 #include "stdlib/util.hpp"
 #include "stdlib/xml.hpp"
 #include "stdlib/xml1.hpp"
@@ -52,6 +53,7 @@
 #include "stream/server_socket.hpp"
 
 #include "stream/aio_handle.hpp"
+#include "stream/aio_handle_group.hpp"
 #include "stream/aio_delay_free.hpp"
 #include "stream/aio_timer_callback.hpp"
 #include "stream/aio_stream.hpp"
@@ -176,6 +178,11 @@
 #include "redis/redis_slot.hpp"
 #include "redis/redis_node.hpp"
 #include "redis/redis_geo.hpp"
+#include "redis/redis_pipeline.hpp"
+#include "redis/redis_parser.hpp"
+#include "redis/redis_client_cache.hpp"
+#include "redis/redis_client_mux.hpp"
+#include "redis/redis_script_registry.hpp"
 #include "redis/redis.hpp"
 
 #include "disque/disque.hpp"
@@ -14,6 +14,11 @@
 #include "redis_zset.hpp"
 #include "redis_cluster.hpp"
 #include "redis_geo.hpp"
+#include "redis_pipeline.hpp"
+#include "redis_parser.hpp"
+#include "redis_client_cache.hpp"
+#include "redis_client_mux.hpp"
+#include "redis_script_registry.hpp"
 
 namespace acl
 {
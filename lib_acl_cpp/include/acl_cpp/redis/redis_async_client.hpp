@@ -0,0 +1,157 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <vector>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+
+namespace acl
+{
+
+class aio_handle;
+class redis_result;
+class redis_request;
+class redis_async_conn;
+
+/**
+ * redis 첽Ľص࣬ʵ on_result 麯
+ * the result callback class of the redis asynchronous command, the
+ * subclass should implement the virtual function on_result
+ */
+class ACL_CPP_API redis_async_callback
+{
+public:
+	redis_async_callback(void) {}
+	virtual ~redis_async_callback(void) {}
+
+	/**
+	 * յӦʱãÿһ
+	 * called when the response of the command was got or some error
+	 * happened, and only once for every command
+	 * @param result {const redis_result*}  NULL ʾӳʱ
+	 *  ͻ˶ͷţýڱЧ
+	 *  NULL will be returned when the connection was broken, or timeout,
+	 *  or the client object was freed; the result object is valid only
+	 *  in this function
+	 */
+	virtual void on_result(const redis_result* result) = 0;
+};
+
+/**
+ *  aio_handle ¼ķ redis ͻˣߵ
+ * ϣÿϵصȴǰһӦ(Զܵ)
+ * ͬһ¼ѭз͵Ķͨдϲ(cork)һ writev 
+ * Ӧ redis_parser ˳صκ redis_command
+ *  redis_stringredis_hash ȣͨ set_async 뱾
+ * 󼴿첽ʽصֻ aio_handle ڵ
+ * ߳ʹ
+ * the non-blocking redis client based on aio_handle event engine, the
+ * commands of many callers are multiplexed over a few connections; on
+ * every connection, the commands are sent without waiting the responses
+ * of the previous commands (automatic pipelining), and the commands sent
+ * in one event loop are merged by cork mode and written by one writev;
+ * the responses are parsed by the incremental parser redis_parser and
+ * called back in order; any object of redis_command's subclass (such as
+ * redis_string, redis_hash, etc.) can send commands asynchronously after
+ * binding with this class's object by set_async; the object and its
+ * callbacks can only be used in the thread of the aio_handle.
+ */
+class ACL_CPP_API redis_async_client : public noncopyable
+{
+public:
+	/**
+	 * 캯
+	 * constructor
+	 * @param handle {aio_handle&} 첽¼
+	 *  the asynchronous event engine
+	 * @param addr {const char*} redis-server ַʽip:port
+	 *  the redis-server listening addr, format: ip:port
+	 * @param max_conns {size_t} õΪ 0 ʱڲԶΪ 1
+	 *  the max connections multiplexed, 1 will be used if it's 0
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout in seconds to connect the redis-server
+	 * @param rw_timeout {int} ȴӦʱĶʱʱ()ʱ
+	 *  ӱرգδɵ NULL ص
+	 *  the read timeout in seconds when some commands are waiting for
+	 *  responses; the connection will be closed when timeout, and all
+	 *  the unfinished commands on it will be called back with NULL.
+	 */
+	redis_async_client(aio_handle& handle, const char* addr,
+		size_t max_conns = 1, int conn_timeout = 10,
+		int rw_timeout = 10);
+
+	/**
+	 * ʱرӣδɵ NULL ص
+	 * all the connections will be closed when destructing, and all the
+	 * unfinished commands will be called back with NULL
+	 */
+	~redis_async_client(void);
+
+	/**
+	 *  redis 룬ÿӽȷ AUTH 
+	 * set the password, and AUTH will be sent after connected
+	 * @param pass {const char*}
+	 */
+	void set_password(const char* pass);
+
+	/**
+	 * 첽һװõ redis һ redis_command 
+	 * send one redis command asynchronously, usually called by redis_command
+	 * @param req {const string&} 
+	 *  the request data
+	 * @param nchildren {size_t} ͬ redis_client::run е nchildren 
+	 *  the same as nchildren in redis_client::run
+	 * @param callback {redis_async_callback*} ص󣬿Ϊ NULL
+	 *  the result callback object, which can be NULL
+	 * @return {bool}  false ʾӷʧܣʱڷǰ NULL
+	 *  ص callback
+	 *  false will be returned if connecting the server failed, and the
+	 *  callback has been called with NULL before returning.
+	 */
+	bool send(const string& req, size_t nchildren,
+		redis_async_callback* callback);
+
+	/**
+	 * ڷƬʽ
+	 * just for slice request mode
+	 * @param req {const redis_request&} ݶ
+	 *  the request object
+	 */
+	bool send(const redis_request& req, size_t nchildren,
+		redis_async_callback* callback);
+
+	/**
+	 * δյӦ
+	 * get the number of commands waiting for responses on all connections
+	 * @return {size_t}
+	 */
+	size_t get_pending(void) const;
+
+	/**
+	 * 첽¼
+	 * get the asynchronous event engine
+	 * @return {aio_handle&}
+	 */
+	aio_handle& get_handle(void) const
+	{
+		return handle_;
+	}
+
+	const char* get_addr(void) const
+	{
+		return addr_.c_str();
+	}
+
+private:
+	friend class redis_async_conn;
+
+	aio_handle& handle_;
+	string addr_;
+	string pass_;
+	int    conn_timeout_;
+	int    rw_timeout_;
+	std::vector<redis_async_conn*> conns_;
+
+	redis_async_conn* peek_conn(void);
+};
+
+} // namespace acl
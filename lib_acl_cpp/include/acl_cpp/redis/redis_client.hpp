@@ -4,6 +4,7 @@
 #include "../stream/socket_stream.hpp"
 #include "../stdlib/string.hpp"
 #include "../connpool/connect_client.hpp"
+#include "redis_parser.hpp"
 
 namespace acl
 {
@@ -11,6 +12,8 @@ namespace acl
 class dbuf_pool;
 class redis_result;
 class redis_request;
+class redis_client_cache;
+class redis_script_registry;
 
 /**
  * redis ͻ˶ͨ࣬ͨཫ֯õ redis  redis ˣ
@@ -135,30 +138,227 @@ public:
 	const redis_result* run(dbuf_pool* pool, const redis_request& req,
 		size_t nchildren, int* rw_timeout = NULL);
 
+	/**
+	 * ڹܵʽһԷ͸ redis-serverȻ˳ȡ
+	 * ӦдʧܻδκӦʱŻԣظִ
+	 * ѱ˴
+	 * just for pipeline mode, send multiple commands to redis-server at
+	 * once, and read the responses in order; retry only when writing
+	 * failed or no response was read, to avoid executing the commands
+	 * handled by the server repeatedly
+	 * @param pool {dbuf_pool*} ڴع
+	 *  memory pool manager
+	 * @param iov {const struct iovec*} 
+	 *  the request data of all commands
+	 * @param count {int} iov ĳ
+	 *  the length of iov array
+	 * @param nchildren {const size_t*} ÿӦݶ
+	 *  the data object number in every command's response
+	 * @param results {const redis_result**} ŸӦ
+	 *  store the result objects of all commands
+	 * @param n {size_t}  nchildren  results ĳ
+	 *  the number of commands, the length of nchildren and results
+	 * @return {size_t} ذ˳ӦС n ʾ
+	 *  the number of results read in order, less than n means error
+	 */
+	size_t run(dbuf_pool* pool, const struct iovec* iov, int count,
+		const size_t* nchildren, const redis_result** results,
+		size_t n, int* rw_timeout = NULL);
+
+	/**
+	 * ͹ܵʽݶȡӦ read ʹãԱ
+	 *  redis-server ζȡӦӶʹ˲д
+	 * дʧʱŻ
+	 * just send the request data in pipeline mode without reading the
+	 * responses, used with read, so that the commands can be sent to
+	 * multiple redis-servers before reading their responses, and the
+	 * servers can handle them in parallel; retry only when writing the
+	 * first batch of data failed
+	 * @param iov {const struct iovec*} 
+	 *  the request data of all commands
+	 * @param count {int} iov ĳ
+	 *  the length of iov array
+	 * @return {int} رд iov ݿС count ʱʾдʧ
+	 *  ѱرգ 0 ʱ˵δյκ԰ȫط
+	 *  the number of iov blocks written completely, if it's less than
+	 *  count the connection has been closed, and 0 means that no command
+	 *  has reached the server so it's safe to resend them
+	 */
+	int send(const struct iovec* iov, int count);
+
+	/**
+	 * ˳ȡ send ͵ĸӦʱӱر
+	 * read the responses of the commands sent by send in order, and the
+	 * connection will be closed when some error happens
+	 * @param pool {dbuf_pool*} ڴع
+	 *  memory pool manager
+	 * @param nchildren {const size_t*} ÿӦݶ
+	 *  the data object number in every command's response
+	 * @param results {const redis_result**} ŸӦ
+	 *  store the result objects of all commands
+	 * @param n {size_t} 
+	 *  the number of commands
+	 * @return {size_t} ذ˳ӦС n ʾ
+	 *  the number of results read in order, less than n means error
+	 */
+	size_t read(dbuf_pool* pool, const size_t* nchildren,
+		const redis_result** results, size_t n);
+
+	/**
+	 *  redis-server ͨŵЭ汾Ϊ 3 ʱӽ HELLO 3
+	 * ʹ RESP3 Э飬˲֧(redis 6.0 )ʹ RESP2 Э飻
+	 * ע⣺RESP3 ²Ľṹ RESP2 ͬӦ෽޷
+	 * ȷ WITHSCORES  ZRANGE/ZRANGEBYSCORE/ZREVRANGE ȡ
+	 * ZPOPMIN/ZPOPMAX  WITHVALUES  HRANDFIELD Ƕ׵ĳɶ飬
+	 * XREAD/XREADGROUP Ϊ MAPʹ RESP3 ʱӦЩ
+	 * set the protocol version with redis-server, HELLO 3 will be sent
+	 * after connected for using RESP3 when it's 3, and RESP2 will still be
+	 * used if redis-server doesn't support it (less than redis 6.0); NOTE:
+	 * the results of some commands have different shapes in RESP3 and
+	 * can't be parsed by the command classes, such as ZRANGE/ZRANGEBYSCORE/
+	 * ZREVRANGE with WITHSCORES, ZPOPMIN/ZPOPMAX and HRANDFIELD with
+	 * WITHVALUES which return nested pairs, and XREAD/XREADGROUP which
+	 * return a MAP keyed by the stream names, so avoid them with RESP3
+	 * @param version {int} 2  3ȱʡΪ 2
+	 *  2 or 3, the default is 2
+	 */
+	void set_protocol(int version);
+
+	/**
+	 * õǰʵʹõЭ汾
+	 * get the protocol version used by the current connection
+	 * @return {int} 2  3
+	 */
+	int get_protocol(void) const
+	{
+		return resp3_ ? 3 : 2;
+	}
+
+	/**
+	 * RESP3 ЭǷĽ( MAP/SET/DOUBLE )ȱʡΪ
+	 * falseתΪӦ RESP2 ͣԱڸ redis ʹã
+	 * μ redis_parser::set_resp3_types
+	 * if keeping the result types added in RESP3 (such as MAP/SET/DOUBLE),
+	 * the default is false, and they'll be converted to the associated
+	 * RESP2 types, so that the redis command classes can work normally,
+	 * see redis_parser::set_resp3_types
+	 * @param on {bool}
+	 */
+	void set_resp3_types(bool on);
+
+	/**
+	 * ÿͻ˻󣬿ͻ˻ RESP3 Э飬Ի
+	 * set_protocol(3)֮ڽʱʹ RESP3 Э鲢 CLIENT
+	 * TRACKINGμ redis_client_cache  set_protocolӦӽǰ
+	 * set the client side caching object, which depends on RESP3, so
+	 * set_protocol(3) must be called too, then the connection will use
+	 * RESP3 and turn on CLIENT TRACKING when being established, see
+	 * redis_client_cache and set_protocol; it should be called before
+	 * connecting
+	 * @param cache {redis_client_cache*} Ϊ NULL ʱʹÿͻ˻
+	 *  no client side caching if NULL
+	 */
+	void set_cache(redis_client_cache* cache);
+
+	redis_client_cache* get_cache(void) const
+	{
+		return cache_;
+	}
+
+	/**
+	 * õǰӵĻʶѳɹ CLIENT TRACKING ʱ > 0
+	 * get the cache id of the current connection, which is > 0 only when
+	 * CLIENT TRACKING has been turned on successfully
+	 * @return {unsigned long long}
+	 */
+	unsigned long long get_cache_id(void) const
+	{
+		return cache_id_;
+	}
+
+	/**
+	 * ȡӿʱյʧЧ֪ͨݿɶʱŻӣ
+	 * ʹÿͻ˻ǰ
+	 * read and handle the invalidations received when the connection was
+	 * idle, the connection will be read only when there's data readable,
+	 * which is called before using the client side caching
+	 * @return {bool} ʱӱرղ false
+	 *  false will be returned and the connection will be closed if error
+	 */
+	bool read_pushes(void);
+
+	/**
+	 * ӽǷ READONLY Աڴ redis ȺĴӽ
+	 * ȡݣμ redis_client_cluster::set_read_policy
+	 * if sending READONLY after the connection is established, so that
+	 * the data can be read from the replicas of redis cluster, see
+	 * redis_client_cluster::set_read_policy
+	 * @param on {bool}
+	 */
+	void set_readonly(bool on);
+
+	/**
+	 *  Lua űעμ redis_script_registryú redis_script
+	 *  eval ϵзִͨʱֻ EVALSHA 
+	 * set the Lua script registry, see redis_script_registry; the eval
+	 * methods of redis_script will only send EVALSHA when running by the
+	 * connection after being set
+	 * @param scripts {redis_script_registry*} Ϊ NULL ʱʹýűע
+	 *  no script registry if NULL
+	 * @param preload {bool} ǷӽʱעĽűԤý㣬
+	 *  ÿһ
+	 *  if preloading the registered scripts to the node when the
+	 *  connection is established, each node will be loaded only once
+	 */
+	void set_script_registry(redis_script_registry* scripts,
+		bool preload = true);
+
+	redis_script_registry* get_script_registry(void) const
+	{
+		return scripts_;
+	}
+
 protected:
 	// 麯
 	virtual bool open();
 
 private:
+	// ·ÿͻ˵Ķдֱ߳ʹӵ׽ּ
+	friend class redis_mux_conn;
+
 	socket_stream conn_;
 	bool  check_addr_;
 	char* addr_;
 	char* pass_;
 	bool  retry_;
-	string  buf_;
 	bool slice_req_;
 	bool slice_res_;
 
-	redis_result* get_redis_objects(dbuf_pool* pool, size_t nobjs);
-	redis_result* get_redis_object(dbuf_pool* pool);
-	redis_result* get_redis_error(dbuf_pool* pool);
-	redis_result* get_redis_status(dbuf_pool* pool);
-	redis_result* get_redis_integer(dbuf_pool* pool);
-	redis_result* get_redis_string(dbuf_pool* pool);
-	redis_result* get_redis_array(dbuf_pool* pool);
+	// ӦݱֱӶڴϷĽջУ parser_ 
+	// ʽֱе
+	redis_parser parser_;
+	char*  rbuf_;		// ǰջ
+	size_t rbuf_size_;	// ջС
+	size_t rbuf_off_;	// ѱλ
+	size_t rbuf_len_;	// Ѷݳ
+
+	int   protocol_;	// ʹõЭ汾
+	bool  resp3_;		// ǰǷʹ RESP3 Э
+	bool  resp3_types_;
+	redis_client_cache* cache_;
+	unsigned long long  cache_id_;
+	bool  readonly_;
+	redis_script_registry* scripts_;
+	bool  preload_;
 
-	void put_data(dbuf_pool* pool, redis_result* rr,
-		const char* data, size_t len);
+	redis_result* get_redis_result(dbuf_pool* pool, size_t nchildren);
+	bool parse_left(void);
+	bool read_more(dbuf_pool* pool);
+	void handle_pushes(void);
+	bool hello(void);
+	bool readonly(void);
+	void unread_left(void);
+	int  writev_all(const struct iovec* iov, int count);
 	bool check_connection(socket_stream& conn);
 };
 
@@ -0,0 +1,162 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <map>
+#include <list>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+#include "../stdlib/locker.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+
+/**
+ * redis ͻ˻࣬ redis 6.0  CLIENT TRACKING ܣڱ
+ * LRU ʽ GET  HGET Ľͨ redis_client/redis_client_pool/
+ * redis_client_cluster  set_cache ò set_protocol(3) 
+ * ڽʱʹ RESP3 Э鲢 CLIENT TRACKING֮ redis_string::get  redis_hash::hget 
+ * Ȳѯ棬ʱ罻ͻ޸˱ļʱredis
+ * ˻ȡüʧЧ֪ͨ´αʹǰȶȡ
+ * Щ֪ͨеÿֵɶȡʹãԱ֤յʧЧ
+ * ֪ͨɱ̼߳ӹ
+ * the redis client side caching class, which is based on CLIENT TRACKING
+ * of redis 6.0, and caches the results of GET and HGET in process in LRU
+ * way: after being set by set_cache of redis_client/redis_client_pool/
+ * redis_client_cluster and calling set_protocol(3), the connections will
+ * use RESP3 and turn on CLIENT TRACKING when being established, and redis_string::get/redis_hash::hget
+ * will look up the cache first, no network IO is needed when hitting; when
+ * the cached keys are modified by other clients, redis-server will push
+ * the invalidation to the connections which have read the keys, and the
+ * connections will read and handle them before being used next time; each
+ * value in the cache can only be used by the connections which have read
+ * it, to ensure that the connection can receive its invalidation; the
+ * object can be shared by multiple threads and connections.
+ */
+class ACL_CPP_API redis_client_cache : public noncopyable
+{
+public:
+	/**
+	 * 캯
+	 * constructor
+	 * @param max_count {size_t} ֵʱ̭δ
+	 *  ļÿ GET  HGET ÿΪһ
+	 *  the max number of cached values, the least recently used keys will
+	 *  be evicted when exceeding, each result of GET or each field of HGET
+	 *  counts one
+	 */
+	redis_client_cache(size_t max_count = 10000);
+	~redis_client_cache(void);
+
+	/**
+	 * ѯ棬ڲʹ
+	 * look up the cache, used internally
+	 * @param id {unsigned long long} ǰӵĻʶ
+	 *  the cache id of the current connection
+	 * @param key {const char*} 
+	 * @param klen {size_t} 
+	 * @param field {const char*} HGET GET ʱΪ NULL
+	 *  the field of HGET, NULL for GET
+	 * @param flen {size_t} 򳤶
+	 * @param dbuf {dbuf_pool*} ڴŽݵڴ
+	 *  the memory pool for storing the result data
+	 * @param data {const char**} ŽݣֵʱΪ NULL
+	 *  store the result data, NULL if the value doesn't exist
+	 * @param len {size_t*} Žݵĳ
+	 *  store the length of the result data
+	 * @return {bool} Ƿ
+	 *  if hit
+	 */
+	bool get(unsigned long long id, const char* key, size_t klen,
+		const char* field, size_t flen, dbuf_pool* dbuf,
+		const char** data, size_t* len);
+
+	/**
+	 * ӶĽ棬ڲʹ
+	 * add the result read by the connection into cache, used internally
+	 * @param data {const char*} ݣΪ NULL ʾֵ
+	 *  the result data, NULL means the value doesn't exist
+	 * ͬ get; the other parameters are the same as get
+	 */
+	void put(unsigned long long id, const char* key, size_t klen,
+		const char* field, size_t flen, const char* data, size_t len);
+
+	/**
+	 * ʹĳлֵʧЧ
+	 * invalidate all the cached values of one key
+	 * @param key {const char*}
+	 * @param len {size_t}
+	 */
+	void invalidate(const char* key, size_t len);
+
+	/**
+	 * ʹлֵʧЧ統 redis ִ FLUSHALL ʱ
+	 * invalidate all the cached values, such as when FLUSHALL executed
+	 */
+	void invalidate_all(void);
+
+	/**
+	 * Ϊ´ CLIENT TRACKING ӷΨһĻʶڲʹ
+	 * alloc unique cache id for the connection which has just turned on
+	 * CLIENT TRACKING, used internally
+	 * @return {unsigned long long}  > 0
+	 *  always > 0
+	 */
+	unsigned long long make_id(void);
+
+	/**
+	 * õǰֵĸ
+	 * get the number of the cached values
+	 * @return {size_t}
+	 */
+	size_t size(void) const
+	{
+		return count_;
+	}
+
+	/**
+	 * СδмʧЧĴ
+	 * get the times of hits, misses and invalidations
+	 * @return {long long}
+	 */
+	long long get_hits(void) const
+	{
+		return hits_;
+	}
+
+	long long get_misses(void) const
+	{
+		return misses_;
+	}
+
+	long long get_invalidations(void) const
+	{
+		return invalidations_;
+	}
+
+	/**
+	 * ͳƼ
+	 * reset the counters
+	 */
+	void reset_statistics(void);
+
+private:
+	struct cache_value;
+	struct cache_item;
+
+	size_t max_count_;
+	size_t count_;
+	unsigned long long id_;
+	long long hits_;
+	long long misses_;
+	long long invalidations_;
+	locker lock_;
+
+	std::map<string, cache_item*> items_;
+	std::list<cache_item*> lru_;		// ͷΪʵļ
+
+	void remove(std::map<string, cache_item*>::iterator it);
+	void evict(void);
+};
+
+} // namespace acl
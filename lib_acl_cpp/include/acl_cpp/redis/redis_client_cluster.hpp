@@ -2,13 +2,33 @@
 #include "../acl_cpp_define.hpp"
 #include <vector>
 #include <map>
+#include <list>
 #include "../stdlib/string.hpp"
+#include "../stdlib/locker.hpp"
 #include "../connpool/connect_manager.hpp"
 
+struct ACL_ATOMIC;
+
 namespace acl
 {
 
 class redis_client_pool;
+class redis_client_cache;
+class redis_script_registry;
+class redis_slot;
+class redis_slots_refresher;
+
+/**
+ * ȺģʽֻĽѡ
+ * the node choosing policy for the readonly commands in cluster mode
+ */
+typedef enum
+{
+	REDIS_READ_MASTER,	// ; read from master only
+	REDIS_READ_ROUND_ROBIN,	// ѯӽ; round robin on replicas
+	REDIS_READ_LATENCY,	// ƽӦʱ̵Ĵӽ; lowest EWMA latency
+	REDIS_READ_ZONE,	// ѯͬĴӽ; prefer the same zone
+} redis_read_policy_t;
 
 /**
  * redis ͻ˼Ⱥ࣬ͨע redis ͻ(redis_command)
@@ -29,8 +49,14 @@ public:
 	virtual ~redis_client_cluster(void);
 
 	/**
-	 * ݹϣֵöӦӳ;
-	 * get one connection pool with the given slot
+	 * ݹϣֵöӦӳأϣӳΪֻ˱仯ʱ
+	 * 滻ԱڲΪһԭָȡ±ʣͨ
+	 * ԭӵĶ߼ǼǷʣԱڰȫձ滻ľɱ;
+	 * get one connection pool with the given slot; the slot table is
+	 * read only and replaced as a whole when the topology changes, so
+	 * there is no lock here, only one atomic pointer load and array index,
+	 * and the access is registered in an atomic readers counter so that
+	 * the replaced tables can be reclaimed safely
 	 * @param slot {int} ϣֵ;
 	 *  the hash-slot value of key
 	 * @return {redis_client_pool*} ӦĹϣ۲򷵻 NULL;
@@ -40,10 +66,18 @@ public:
 	redis_client_pool* peek_slot(int slot);
 
 	/**
-	 * ̬ùϣֵӦ redis ַúʱڲ߳;
+	 * ̬ùϣֵӦ redis ַúʱڲ߳
+	 * ڲḴһµĹϣӳԭԵ滻ɱõַӳ
+	 * вùϣ۱Ϊ MOVED 籩ʱƵƣ±ÿ
+	 * 滻һΣͬһڵĺ޸´滻ˢӳʱЧ;
 	 * dynamicly set redis-server addr with one slot, which is protected
 	 * by thread mutex internal, no one will be set if the slot were
-	 * beyyond the max hash-slot
+	 * beyyond the max hash-slot; a new copy of the slot table will be
+	 * published atomically, and the slot will be cleared if no
+	 * connection pool exists for the addr; to avoid copying too often
+	 * during MOVED storms, the table is published at most once a second,
+	 * and the later changes in the same second take effect when the table
+	 * is published or refreshed next time
 	 * @param slot {int} ϣֵ;
 	 *  the hash-slot
 	 * @param addr {const char*} redis ַ;
@@ -52,9 +86,10 @@ public:
 	void set_slot(int slot, const char* addr);
 
 	/**
-	 *  redis Ⱥеһ㣬ԶеĹϣ۶ӦĽַ
+	 *  redis Ⱥеһ㣬ԶеĹϣ۶ӦĽַ
+	 * йϣ۵ӳϵһ滻
 	 * according one node of the cluster, auto find all nodes with all
-	 * slots range
+	 * slots range, and all the slots will be replaced at once
 	 * @param addr {const char*} Ⱥеһַʽ ip:port
 	 *  on server node's addr of the cluster, addr format is "ip:port"
 	 * @param max_conns {int} Ⱥÿӳص
@@ -63,14 +98,173 @@ public:
 	void set_all_slot(const char* addr, int max_conns);
 
 	/**
-	 * ̬ϣ۶Ӧ redis ַԱ¼λãڲ߳;
+	 * ӼȺһýȡ CLUSTER SLOTS 뵱ǰĹϣӳȽϣ
+	 * Ϊ³ֵĽ㴴ӳزԤȽӣ˷仯ʱһ
+	 * 滻ӳ̨ˢ̼߳ñӦҲֱӵ
+	 * get CLUSTER SLOTS from any available node of the cluster and diff it
+	 * with the current slot table, the pools of the new nodes will be
+	 * created and connected first, and the table will be replaced at once
+	 * only when the topology has changed; it's called by the background
+	 * refresher, and can also be called by the application directly
+	 * @return {int} ӳϵ仯Ĺϣ۸-1 ʾûн
+	 *  return the number of the changed slots, -1 if no node available
+	 */
+	int refresh_slots(void);
+
+	/**
+	 * ̶̨߳ˢ¹ϣӳ MOVED ضƵʹʱ(缯Ⱥ
+	 * Ǩƹϣ)ˢ£Ӷ󱻶ضӦڵ
+	 * set_all_slot ֮
+	 * start a background thread refreshing the slot table periodically,
+	 * and it'll refresh at once when the MOVED redirects happen too
+	 * frequently (such as resharding), which can reduce the requests
+	 * being redirected many times; it should be called after set_all_slot
+	 * @param inter {int} ˢµʱ()
+	 *  the interval of refreshing periodically in seconds
+	 * @param moved_limit {int} һ MOVED ضĴﵽֵʱˢ£
+	 *  <= 0 ʱֹ MOVED Ƶˢ
+	 *  refresh at once when the MOVED redirects reach the limit in one
+	 *  second, and it's disabled when <= 0
+	 * @return {bool}  false ʾˢ߳Ѿ
+	 *  false will be returned if the refresher has been started
+	 */
+	bool start_refresher(int inter = 60, int moved_limit = 10);
+
+	/**
+	 * ֹ̨ͣˢ̣߳ʱԶ
+	 * stop the background refresher, which will be called when destroying
+	 */
+	void stop_refresher(void);
+
+	/**
+	 *  redis_command յ MOVED/ASK ضʱͳض
+	 * Ȼ public ģڲʹ
+	 * called by redis_command when getting MOVED/ASK for counting, it's
+	 * public but only for internal use
+	 * @param moved {bool} Ϊ true ʾ MOVEDʾ ASK
+	 *  true means MOVED, or ASK
+	 */
+	void on_redirect(bool moved);
+
+	/**
+	 *  MOVED ضܴ
+	 * get the total number of MOVED redirects
+	 * @return {long long}
+	 */
+	long long get_moved_count(void) const
+	{
+		return moved_count_;
+	}
+
+	/**
+	 *  ASK ضܴ
+	 * get the total number of ASK redirects
+	 * @return {long long}
+	 */
+	long long get_ask_count(void) const
+	{
+		return ask_count_;
+	}
+
+	/**
+	 * óɹˢ¹ϣӳĴ
+	 * get the number of refreshing the slot table successfully
+	 * @return {long long}
+	 */
+	long long get_refresh_count(void) const
+	{
+		return refresh_count_;
+	}
+
+	/**
+	 * ˢʱ˷仯Ĵ
+	 * get the number of the refreshes which found topology changes
+	 * @return {long long}
+	 */
+	long long get_change_count(void) const
+	{
+		return change_count_;
+	}
+
+	/**
+	 * ̬ϣ۶Ӧ redis ַԱ¼λãڲ߳ƣ
+	 *  set_slot һӳÿ滻һ;
 	 * dynamicly remove one slot and redis-server addr mapping, which is
-	 * protected by thread mutex
+	 * protected by thread mutex; as with set_slot, the slot table is
+	 * published at most once a second
 	 * @param slot {int} ϣֵ;
 	 *  hash-slot value
 	 */
 	void clear_slot(int slot);
 
+	/**
+	 * ֻ( GET/HGET/ZRANGE )ĽѡԣΪ
+	 * REDIS_READ_MASTER ʱֻԷϣ۶Ӧĳ
+	 * 㣬ӽڽᷢ READONLY ûпõĴӽʱ
+	 * Զ㣻ȱʡΪ REDIS_READ_MASTER
+	 * set the node choosing policy for the readonly commands (such as
+	 * GET/HGET/ZRANGE), if it isn't REDIS_READ_MASTER, the readonly
+	 * commands will be sent to one replica of the slot's master according
+	 * the policy, and READONLY will be sent after the replica's connection
+	 * is established; the master will still be used if no replica is
+	 * available; the default is REDIS_READ_MASTER
+	 * @param policy {redis_read_policy_t}
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_read_policy(redis_read_policy_t policy);
+
+	redis_read_policy_t get_read_policy(void) const
+	{
+		return read_policy_;
+	}
+
+	/**
+	 * ñͻڵ REDIS_READ_ZONE 
+	 * set the zone of the client, used by REDIS_READ_ZONE policy
+	 * @param zone {const char*}
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_local_zone(const char* zone);
+
+	/**
+	 * ĳ redis ڵ REDIS_READ_ZONE 
+	 * set the zone of one redis node, used by REDIS_READ_ZONE policy
+	 * @param addr {const char*} redis ַ(ip:port)
+	 *  the redis node's addr
+	 * @param zone {const char*}
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_zone(const char* addr, const char* zone);
+
+	/**
+	 * ̬ĳдӽ㣬set_all_slot Զñڲ
+	 * ߳ӽ㼯ϱ滻
+	 * dynamicly set all the replicas of one master, which is called by
+	 * set_all_slot automatically, it's protected by thread mutex, and the
+	 * replicas will be replaced as a whole
+	 * @param master {const char*} ַ(ip:port)ӳѴ
+	 *  the master's addr, whose connection pool must have existed
+	 * @param replicas {const std::vector<string>&} ӽַ
+	 *  the replicas' addrs
+	 * @param max_conns {int} ӽӳص
+	 *  the max connections limit for the replicas' pools
+	 */
+	void set_replicas(const char* master,
+		const std::vector<string>& replicas, int max_conns);
+
+	/**
+	 * ݹϣֵ set_read_policy õĲԻֻʹõӳأ
+	 *  peek_slot һڲ
+	 * get the connection pool used by readonly commands according the
+	 * hash-slot and the policy set by set_read_policy, there's no lock
+	 * the same as peek_slot
+	 * @param slot {int} ϣֵ
+	 *  the hash-slot value of key
+	 * @return {redis_client_pool*} ӦĹϣ۲򷵻 NULL
+	 *  NULL will be returned when the slot not exists
+	 */
+	redis_client_pool* peek_read_slot(int slot);
+
 	/**
 	 * ùϣֵ;
 	 * get the max hash-slot
@@ -139,6 +333,61 @@ public:
 	 */
 	redis_client_cluster& set_password(const char* addr, const char* pass);
 
+	/**
+	 * üȺõĿͻ˻ӦڷʼȺǰã
+	 * μ redis_client::set_cache
+	 * set the client side caching object shared by all the connections of
+	 * the cluster, which should be called before accessing the cluster,
+	 * see redis_client::set_cache
+	 * @param cache {redis_client_cache*}
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_cache(redis_client_cache* cache);
+
+	/**
+	 * üȺ redis-server ͨŵЭ汾ӦڷʼȺǰ
+	 * ãμ redis_client::set_protocol
+	 * set the protocol version of all the connections of the cluster,
+	 * which should be called before accessing the cluster, see
+	 * redis_client::set_protocol
+	 * @param version {int} 2  3ȱʡΪ 2
+	 *  2 or 3, the default is 2
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_protocol(int version);
+
+	/**
+	 * üȺõ Lua űעú redis_script 
+	 * eval ϵзڼȺģʽֻ EVALSHA μ
+	 * redis_client::set_script_registry preload Ϊ true ʱע
+	 * űڵÿӽ״νʱԤý
+	 * set the Lua script registry shared by all the connections of the
+	 * cluster, the eval methods of redis_script will only send EVALSHA in
+	 * cluster mode after being set, see redis_client::set_script_registry;
+	 * when preload is true, the registered scripts will be preloaded to
+	 * each master and replica node when the first connection to it is
+	 * established
+	 * @param scripts {redis_script_registry*}
+	 * @param preload {bool}
+	 * @return {redis_client_cluster&}
+	 */
+	redis_client_cluster& set_script_registry(redis_script_registry* scripts,
+		bool preload = true);
+
+	redis_script_registry* get_script_registry(void) const
+	{
+		return scripts_;
+	}
+
+	/**
+	 * 麯ɾĳַӳ֮ǰϣӳж
+	 * virtual function of base class, the slots mapping to the
+	 * connection pool will be cleared before the pool is removed
+	 * @param addr {const char*} ַ(ip:port)
+	 *  the server addr
+	 */
+	void remove(const char* addr);
+
 protected:
 	/**
 	 * ി麯ӳض󣬸úغɻӼIO ʱʱ
@@ -156,11 +405,51 @@ protected:
 
 private:
 	int   max_slot_;
-	const char**  slot_addrs_;
-	std::vector<char*> addrs_;
+	int   nsegs_;
+	struct retired_table;		// 滻Ĺϣӳ
+	ACL_ATOMIC* slots_;		// ǰĹϣӳ: redis_client_pool***
+	redis_client_pool*** pending_;	// δĹϣӳ
+	time_t publish_when_;		// MOVED ϴηʱ
+	std::list<retired_table*> retired_;
+	ACL_ATOMIC* epoch_;		// ߵǼü±: 0  1
+	ACL_ATOMIC* readers_[2];	// ӳĶ߸: size_t
+
 	int   redirect_max_;
 	int   redirect_sleep_;
 	std::map<string, string> passwds_;
+	redis_client_cache* cache_;
+	int   protocol_;
+	redis_script_registry* scripts_;
+	bool  preload_;
+	redis_read_policy_t read_policy_;
+	string zone_;
+	std::map<string, string> zones_;
+
+	string addr_;			// set_all_slot ʱӽ
+	int   max_conns_;
+	redis_slots_refresher* refresher_;
+	locker stat_lock_;
+	int   moved_limit_;
+	time_t moved_when_;
+	int   moved_recent_;
+	long long moved_count_;
+	long long ask_count_;
+	long long refresh_count_;
+	long long change_count_;
+
+	int apply_slots(const std::vector<redis_slot*>& slots, int max_conns);
+	redis_client_pool* peek_pending(int slot) const;
+	redis_client_pool*** copy_slots(void);
+	void set_slot_pool(redis_client_pool*** top, int slot,
+		redis_client_pool* conns) const;
+	void publish_slots(redis_client_pool*** top);
+	void publish_pending(void);
+	void retire(redis_client_pool*** top,
+		const std::vector<redis_client_pool**>& segs);
+	void reclaim(void);
+	void synchronize(void);
+	void remove_replica(redis_client_pool* conns);
+	static void free_retired(retired_table* table);
 };
 
 } // namespace acl
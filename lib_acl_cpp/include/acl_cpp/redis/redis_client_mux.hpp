@@ -0,0 +1,169 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <vector>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+#include "../stdlib/locker.hpp"
+#include "../stdlib/thread_queue.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+class redis_result;
+class redis_request;
+class redis_mux_conn;
+
+/**
+ * redis ·ÿͻ̹࣬߳ͬһ redis-server ֮ӣ
+ * ÿһд̼߳һ̣߳д̵߳̽߳ϲΪһ
+ * writev Թܵʽ̰߳Ƚȳ˳ȡӦѵȴĵ
+ * ߣڴ̷߳ͬһ redis-server ޵ĳ
+ * redis_client_pool::set_multiplex ͨ redis_command::set_mux ʹã
+ * ӱ߹ı״̬(MULTI/EXEC/WATCHSELECT
+ * SUBSCRIBE )ӵ(BLPOP BLOCK  XREAD )
+ * ÷ʽִУredis_command ֱӷʧ
+ * redis multiplexed client class, many threads share a few connections
+ * with the same redis-server: every connection has a writer thread and a
+ * reader thread, the writer coalesces the requests from many threads into
+ * one writev in pipeline mode, and the reader reads the responses in FIFO
+ * order and wakes up the waiting callers; it's fit for the case that lots
+ * of threads access the same node while the connections of redis-server
+ * are limited, and it can be created by redis_client_pool::set_multiplex
+ * and used by redis_command::set_mux; because the connections are shared,
+ * the stateful commands (MULTI/EXEC/WATCH, SELECT, SUBSCRIBE, etc.) and
+ * the blocking commands (BLPOP, XREAD with BLOCK, etc.) can't be run in
+ * this mode, and redis_command will fail them at once
+ */
+class ACL_CPP_API redis_client_mux : public noncopyable
+{
+public:
+	/**
+	 * 캯Ӽд߳ڵһִʱŴ
+	 * constructor, the connections and threads will be created when
+	 * running the first command
+	 * @param addr {const char*} redis-server ַ(ip:port)
+	 *  the redis-server's addr
+	 * @param nconns {size_t} Ӹ
+	 *  the number of the shared connections
+	 * @param conn_timeout {int} ӳʱʱ()
+	 *  the timeout in seconds for connecting
+	 * @param rw_timeout {int} дʱʱ()
+	 *  the timeout in seconds for IO
+	 */
+	redis_client_mux(const char* addr, size_t nconns = 2,
+		int conn_timeout = 10, int rw_timeout = 10);
+
+	~redis_client_mux(void);
+
+	/**
+	 * 룬Ӧִǰ
+	 * set the password, which should be called before running commands
+	 * @param pass {const char*}
+	 * @return {redis_client_mux&}
+	 */
+	redis_client_mux& set_password(const char* pass);
+
+	/**
+	 * ӽǷ READONLYӦִǰ
+	 * set if sending READONLY after connected, which should be called
+	 * before running commands
+	 * @param on {bool}
+	 * @return {redis_client_mux&}
+	 */
+	redis_client_mux& set_readonly(bool on);
+
+	/**
+	 * д߳һκϲȱʡΪ 128
+	 * set the max requests coalesced by the writer at once, default: 128
+	 * @param max {size_t}
+	 * @return {redis_client_mux&}
+	 */
+	redis_client_mux& set_batch_max(size_t max);
+
+	/**
+	 * ÿѷͶδӦޣﵽ޺д̵߳ȴ
+	 * µڴڼԱϲΪΣȱʡΪ 1
+	 * set the max batches sent but not responded on each connection, the
+	 * writer will wait when reaching it, so that the new requests can be
+	 * accumulated and coalesced into a bigger batch, default: 1
+	 * @param max {size_t}
+	 * @return {redis_client_mux&}
+	 */
+	redis_client_mux& set_inflight_max(size_t max);
+
+	/**
+	 * 󲢵ȴӦɱ߳ͬʱ
+	 * send the request and wait for its response, which can be called
+	 * by many threads at the same time
+	 * @param pool {dbuf_pool*} ߵڴأӦϷ
+	 *  the caller's memory pool, the result will be created in it
+	 * @param req {const string&} 
+	 *  the request data
+	 * @param nchildren {size_t} Ӧݶĸ
+	 *  the data object number in the response
+	 * @return {const redis_result*}  NULL ʾ
+	 *  NULL will be returned if some error happens
+	 */
+	const redis_result* run(dbuf_pool* pool, const string& req,
+		size_t nchildren);
+
+	/**
+	 * ڷƬʽ
+	 * just for sending proccess in slice request mode
+	 */
+	const redis_result* run(dbuf_pool* pool, const redis_request& req,
+		size_t nchildren);
+
+	const char* get_addr(void) const
+	{
+		return addr_.c_str();
+	}
+
+	/**
+	 * ѷ͵
+	 * get the number of the requests sent
+	 * @return {long long}
+	 */
+	long long get_requests(void) const
+	{
+		return requests_;
+	}
+
+	/**
+	 * д߳ writev Ĵget_requests() / get_batches() Ϊƽ
+	 * ÿκϲ
+	 * get the number of the writers' writev, and get_requests() /
+	 * get_batches() is the average number of the requests coalesced
+	 * @return {long long}
+	 */
+	long long get_batches(void) const
+	{
+		return batches_;
+	}
+
+private:
+	friend class redis_mux_conn;
+
+	string addr_;
+	string pass_;
+	bool   readonly_;
+	int    conn_timeout_;
+	int    rw_timeout_;
+	size_t nconns_;
+	size_t batch_max_;
+	size_t inflight_max_;
+	thread_queue reqs_;		// еߵ
+	std::vector<redis_mux_conn*> conns_;
+	locker lock_;
+	bool   started_;		// Ƿӵ߳
+	long long requests_;
+	long long batches_;
+
+	bool start(void);
+	const redis_result* run(dbuf_pool* pool, const struct iovec* iov,
+		size_t count, size_t nchildren);
+	void add_batch(size_t n);
+};
+
+} // namespace acl
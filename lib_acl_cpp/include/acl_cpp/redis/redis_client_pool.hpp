@@ -1,10 +1,17 @@
 #pragma once
 #include "../acl_cpp_define.hpp"
+#include "../stdlib/string.hpp"
 #include "../connpool/connect_pool.hpp"
 
+struct ACL_ATOMIC;
+
 namespace acl
 {
 
+class redis_client_cache;
+class redis_client_mux;
+class redis_script_registry;
+
 /**
  * redis ӳ̳࣬ connect_pool connect_pool ͨõй
  * TCP ӳصͨ÷
@@ -37,6 +44,137 @@ public:
 	 */
 	redis_client_pool& set_password(const char* pass);
 
+	/**
+	 * ӳиʹõĿͻ˻󣬲μ redis_client::set_cache
+	 * set the client side caching object used by the connections in the
+	 * pool, see redis_client::set_cache
+	 * @param cache {redis_client_cache*}
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_cache(redis_client_cache* cache);
+
+	/**
+	 * ӳи redis-server ͨŵЭ汾μ
+	 * redis_client::set_protocol
+	 * set the protocol version of the connections in the pool, see
+	 * redis_client::set_protocol
+	 * @param version {int} 2  3ȱʡΪ 2
+	 *  2 or 3, the default is 2
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_protocol(int version);
+
+	/**
+	 * ӳиʹõ Lua űעμ
+	 * redis_client::set_script_registry
+	 * set the Lua script registry used by the connections in the pool,
+	 * see redis_client::set_script_registry
+	 * @param scripts {redis_script_registry*}
+	 * @param preload {bool}
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_script_registry(redis_script_registry* scripts,
+		bool preload = true);
+
+	/**
+	 * ӳеڽǷ READONLY ڴ redis Ⱥ
+	 * Ĵӽȡ
+	 * if sending READONLY after the connections in the pool are established,
+	 * which is used for reading from the replicas of redis cluster
+	 * @param on {bool}
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_readonly(bool on);
+
+	/**
+	 * üøýڵ()ڶӽʱѡ
+	 * ͬĽ㣬μ redis_client_cluster::set_read_policy
+	 * set and get the zone of the node (such as IDC or availability zone),
+	 * used for preferring the replicas in the same zone when reading from
+	 * replicas, see redis_client_cluster::set_read_policy
+	 */
+	redis_client_pool& set_zone(const char* zone);
+	const char* get_zone(void) const
+	{
+		return zone_.c_str();
+	}
+
+	/**
+	 * һӦʱ䣬ڲָȨƶƽ(EWMA)ķʽý
+	 * ƽӦʱ
+	 * add the response time of one command, the average response time of
+	 * the node is calculated in EWMA way internally
+	 * @param ms {double} Ӧʱ()
+	 *  the response time in milliseconds
+	 */
+	void add_latency(double ms);
+
+	/**
+	 * øýƽӦʱ()δͳʱ 0
+	 * get the average response time of the node in milliseconds, 0 will
+	 * be returned if not having been counted
+	 * @return {double}
+	 */
+	double get_latency(void);
+
+	/**
+	 * øĴӽӳؼϣڲʹã NULL ֻ
+	 *  redis_client_cluster ˱仯ʱ滻
+	 * get the replicas' pools of the master node, used internally, the
+	 * array is ended with NULL, which is readonly and will be replaced
+	 * by redis_client_cluster when the topology changes
+	 * @return {redis_client_pool**} ûдӽʱ NULL
+	 *  NULL if there is no replica
+	 */
+	redis_client_pool** get_replicas(void) const;
+
+	/**
+	 * 滻ӽӳؼϣڲʹã߸ӳͷŷصľ
+	 * replace the replicas' pools, used internally, the caller should
+	 * free the old array returned later
+	 * @param replicas {redis_client_pool**}  NULL 
+	 *  the array ended with NULL
+	 * @return {redis_client_pool**} 
+	 *  the old array
+	 */
+	redis_client_pool** set_replicas(redis_client_pool** replicas);
+
+	/**
+	 * ѯѡӽʱһ
+	 * get the next index when choosing the replicas in round robin
+	 * @return {unsigned int}
+	 */
+	unsigned int next_replica(void);
+
+	/**
+	 * Ӷ·÷ʽ̹߳ý nconns ӣ̵߳
+	 * 󱻺ϲԹܵʽ̸ͣ߳ԶռһӶľ
+	 * redis-server Ӧͨ get_mux ö·ÿͻ
+	 *  redis_command::set_mux ʹãӦڷǰҽһ
+	 * enable the connection multiplexing mode: many threads share nconns
+	 * connections of the node, and the requests from the threads are
+	 * coalesced and sent in pipeline mode, to avoid exhausting the max
+	 * clients of redis-server by lots of threads owning a connection each;
+	 * the multiplexed client should be got by get_mux and be used by
+	 * redis_command::set_mux, and it should be called only once before
+	 * accessing
+	 * @param nconns {size_t} Ӹ
+	 *  the number of the shared connections
+	 * @return {redis_client_pool&}
+	 */
+	redis_client_pool& set_multiplex(size_t nconns);
+
+	/**
+	 *  set_multiplex Ķ·ÿͻ
+	 * get the multiplexed client created by set_multiplex
+	 * @return {redis_client_mux*} δ·÷ʽʱ NULL
+	 *  NULL if the multiplexing mode isn't enabled
+	 */
+	redis_client_mux* get_mux(void) const
+	{
+		return mux_;
+	}
+
 protected:
 	/**
 	 * ി麯: ô˺һµ
@@ -47,6 +185,16 @@ protected:
 
 private:
 	char* pass_;
+	redis_client_cache* cache_;
+	int    protocol_;
+	redis_script_registry* scripts_;
+	bool   preload_;
+	bool   readonly_;
+	string zone_;
+	ACL_ATOMIC* latency_;		// ƽӦʱ(΢): size_t
+	ACL_ATOMIC* rr_;		// ѯѡӽ: size_t
+	ACL_ATOMIC* replicas_;		// ӽӳؼ: redis_client_pool**
+	redis_client_mux* mux_;
 };
 
 } // namespace acl
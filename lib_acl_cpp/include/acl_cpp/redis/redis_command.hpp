@@ -11,6 +11,10 @@ namespace acl
 class redis_client;
 class redis_client_cluster;
 class redis_request;
+class redis_pipeline;
+class redis_async_client;
+class redis_async_callback;
+class redis_client_mux;
 
 /**
  * redis ͻĴ鸸;
@@ -134,6 +138,85 @@ public:
 		return cluster_;
 	}
 
+	/**
+	 * ùܵú󱾶ͣǱ׷ܵУ
+	 * ʧܣֱ redis_pipeline::exec ͣ
+	 * Ľͨ redis_pipeline::get_result ã NULL ȡܵʽ
+	 * set the pipeline object, the commands will be appended to the
+	 * pipeline instead of being sent immediately, and all the command
+	 * methods will return failure until redis_pipeline::exec is called;
+	 * the results should be got by redis_pipeline::get_result; if NULL
+	 * is set, the pipeline mode will be canceled
+	 * @param pipeline {redis_pipeline*}
+	 */
+	void set_pipeline(redis_pipeline* pipeline);
+
+	/**
+	 * õĹܵ
+	 * get the pipeline object set by set_pipeline
+	 * @return {redis_pipeline*}
+	 */
+	redis_pipeline* get_pipeline() const
+	{
+		return pipeline_;
+	}
+
+	/**
+	 * 첽ͻ˶󼰽صú󱾶ͨ첽ͻ
+	 * ԷʽͣʧܣĽ¼ѭ
+	 * ͨ callback صӷʧܶδܷ NULL
+	 * ص callback֮ eof()  trueÿηǰñ
+	 * òͬĻصclient Ϊ NULL ʱȡ첽ʽ
+	 * set the asynchronous client and the result callback object, the
+	 * commands will be sent by the asynchronous client in non-blocking
+	 * mode, all the command methods will return failure immediately, and
+	 * the results will be given to the callback in the event loop; if the
+	 * command couldn't be sent because connecting the server failed, the
+	 * callback will be called with NULL at once and eof() will return
+	 * true; this function can be called before every command to set a
+	 * different callback; the asynchronous mode will be canceled if client
+	 * is NULL.
+	 * @param client {redis_async_client*}
+	 * @param callback {redis_async_callback*} Ϊ NULL
+	 *  can be NULL
+	 */
+	void set_async(redis_async_client* client,
+		redis_async_callback* callback);
+
+	/**
+	 * õ첽ͻ˶
+	 * get the asynchronous client set by set_async
+	 * @return {redis_async_client*}
+	 */
+	redis_async_client* get_async() const
+	{
+		return async_;
+	}
+
+	/**
+	 * ö·ÿͻˣú󱾶̹ͨ߳ӷͣ
+	 * ӦΪֹμ redis_client_pool::set_multiplex
+	 * set the multiplexed client, the commands will be sent by the
+	 * connections shared with other threads, and all the command methods
+	 * still block until the responses were read, see
+	 * redis_client_pool::set_multiplex; ״̬ڶ·
+	 * ʽִУμ redis_client_mux
+	 * the stateful or blocking commands can't be run in mux mode, see
+	 * redis_client_mux
+	 * @param mux {redis_client_mux*}
+	 */
+	void set_mux(redis_client_mux* mux);
+
+	/**
+	 * õĶ·ÿͻ
+	 * get the multiplexed client set by set_mux
+	 * @return {redis_client_mux*}
+	 */
+	redis_client_mux* get_mux() const
+	{
+		return mux_;
+	}
+
 	/**
 	 * ڴؾڴ redis_command ڲ;
 	 * get memory pool handle be set
@@ -169,6 +252,26 @@ public:
 	 */
 	const char* result_error() const;
 
+	/**
+	 * Ⱥģʽ£ϣ۵Ķ(MGET/MSET/DEL/EXISTS)ϣ۲
+	 * ΪзִУִʧܵ
+	 * ԭʼе±()MGET ʧʱԷسɹʧܼ
+	 * ֵΪգʧʱʧ
+	 * in cluster mode, the multi-key commands (MGET/MSET/DEL/EXISTS) across
+	 * hash slots will be split by hash slot into sub-commands which will be
+	 * sent to the nodes in parallel; this function returns the indexes (in
+	 * ascending order) in the original key sequence of the keys contained
+	 * in the failed sub-commands; MGET still succeeds when partially failed
+	 * and the values of the failed keys are empty, the other commands will
+	 * fail when partially failed
+	 * @return {const std::vector<size_t>&} ûʧܵļʱΪ
+	 *  empty when no key failed
+	 */
+	const std::vector<size_t>& get_failed_keys(void) const
+	{
+		return failed_keys_;
+	}
+
 	/**
 	 * õǰ洢Ķĸ, ÷ԻýΪ
 	 * (result_child/result_value) ҪԪصĸ;
@@ -221,9 +324,11 @@ public:
 
 	/**
 	 * жϵǰ󶨵 redis (redis_client) ǷѾرգ
-	 * ֻڲ conn_ ǿʱô˺;
+	 * ֻڲ conn_ ǿʱô˺壻첽ʽ±ʾһ
+	 * Ƿʧܶδܷ;
 	 * to judge if the redis connection was be closed, only redis_client
-	 * object be set internal
+	 * object be set internal; in asynchronous mode, it tells if the last
+	 * command couldn't be sent because connecting the server failed
 	 * @return {bool}
 	 */
 	bool eof() const;
@@ -385,6 +490,16 @@ protected:
 	int get_strings(std::vector<const char*>& names,
 		std::vector<const char*>& values);
 
+	/**
+	 * ƬηʽеĸַݣƬһ
+	 * ִл clear ǰЧڣ
+	 * get the strings of array result as views without copying, which
+	 * are valid until the next command running or calling clear
+	 */
+	int get_strings(std::vector<string_view>& result);
+	int get_strings(std::vector<string_view>& names,
+		std::vector<string_view>& values);
+
 	/************************** common *********************************/
 protected:
 	dbuf_pool* dbuf_;
@@ -393,22 +508,50 @@ protected:
 	void hash_slot(const char* key);
 	void hash_slot(const char* key, size_t len);
 
+	// Ⱥģʽ½մĶΪɰϣ۲ִУstep Ϊÿ
+	// ռĲMGET/DEL/EXISTS Ϊ 1MSET Ϊ 2
+	void split_keys(size_t step);
+
+	// մĶΪʹÿͻ˻(μ redis_client_cache)
+	// field Ϊ NULL ʱӦ GET keyӦ HGET key fieldԱЧ
+	void set_cache_key(const char* key, size_t klen,
+		const char* field = NULL, size_t flen = 0);
+
 private:
 	bool check_addr_;
 	char addr_[32];
 	redis_client* conn_;
 	redis_client_cluster* cluster_;
+	redis_pipeline* pipeline_;
+	redis_async_client* async_;
+	redis_async_callback* async_callback_;
+	bool async_failed_;
+	redis_client_mux* mux_;
 	size_t max_conns_;
 	unsigned long long used_;
 	int  slot_;
+	size_t split_step_;
+	redis_pipeline* splitter_;
+	std::vector<size_t> failed_keys_;
 	int  redirect_max_;
 	int  redirect_sleep_;
-
+	const char* cache_key_;
+	size_t cache_klen_;
+	const char* cache_field_;
+	size_t cache_flen_;
+	bool readonly_;		// ǰǷΪֻ
+	bool mux_unsafe_;	// ǰǷڶ·÷ʽִ
+
+	const redis_result* run_conn(redis_client* conn, size_t nchild,
+		int* timeout);
 	redis_client* peek_conn(redis_client_cluster* cluster, int slot);
 	redis_client* redirect(redis_client_cluster* cluster, const char* addr);
 	const char* get_addr(const char* info);
 	void set_client_addr(const char* addr);
 	void set_client_addr(redis_client& conn);
+	const redis_result* run_split(size_t step, size_t nchild, int* timeout);
+	const redis_result* merge_split(size_t step,
+		const std::vector<std::vector<size_t> >& groups);
 
 private:
 	/************************** request ********************************/
@@ -423,6 +566,8 @@ private:
 	void argv_space(size_t n);
 	void build_request1(size_t argc, const char* argv[], size_t lens[]);
 	void build_request2(size_t argc, const char* argv[], size_t lens[]);
+	static void build_request_buf(string& out, size_t argc,
+		const char* argv[], const size_t lens[]);
 
 private:
 	/************************** respond ********************************/
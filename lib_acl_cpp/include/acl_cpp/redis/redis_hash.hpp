@@ -174,6 +174,10 @@ public:
 	 *  false -- ֶβڻʧܻ key ǹϣ
 	 *           the field not exists, or error happened,
 	 *           or the key isn't a hash key
+	 * ע˿ͻ˻ʱ(μ redis_client::set_cache)
+	 *  ֱȡԱػ
+	 *  the value may be got from the local cache directly when the client
+	 *  side caching was set, see redis_client::set_cache
 	 */
 	bool hget(const char* key, const char* name, string& result);
 	bool hget(const char* key, const char* name,
@@ -200,6 +204,15 @@ public:
 	bool hgetall(const char* key, std::vector<const char*>& names,
 		std::vector<const char*>& values);
 
+	/**
+	 * ͬϣֵֶƬηʽڽڴУݣ
+	 * һִл clear ǰЧ
+	 * same as above, but the names and values are views into the result
+	 * without copying, which are valid until the next command or clear
+	 */
+	bool hgetall(const char* key, std::vector<string_view>& names,
+		std::vector<string_view>& values);
+
 	/**
 	 *  redis ϣɾĳ key ĳЩֶ
 	 * remove one or more fields from hash stored at key
@@ -54,6 +54,11 @@ public:
 	 *  0: none key be deleted
 	 * -1: error happened
 	 *  >0: the number of keys been deleted
+	 * Ⱥģʽ¿ϣ۵Ķ KEY ϣ۲ֺɾʧʱ
+	 *  -1ʧܵ KEY  get_failed_keys 
+	 * in cluster mode, the keys across hash slots will be split by hash
+	 * slot and deleted in parallel, -1 will be returned when partially
+	 * failed, and the failed keys can be got by get_failed_keys
 	 *
 	 */
 	int del_one(const char* key);
@@ -94,6 +99,26 @@ public:
 	 */
 	bool exists(const char* key);
 
+	/**
+	 * жһ KEY дڵĸȺģʽ¿ϣ۵Ķ KEY ϣ
+	 * ֺвѯ
+	 * get the number of the existing keys, in cluster mode, the keys across
+	 * hash slots will be split by hash slot and checked in parallel
+	 * @param keys {const std::vector<string>&} KEY 
+	 *  the keys
+	 * @return {int} ڵ KEY ĸͬһ KEY ֶʱᱻظ
+	 *  -1 ʾ(Ⱥģʽ²ʧʱʧܵ KEY  get_failed_keys
+	 *  )
+	 *  the number of the existing keys, the same key will be counted
+	 *  repeatedly when appearing multiple times, -1 for error (in cluster
+	 *  mode, the failed keys can be got by get_failed_keys when partially
+	 *  failed)
+	 */
+	int exists_keys(const std::vector<string>& keys);
+	int exists_keys(const std::vector<const char*>& keys);
+	int exists_keys(const char* keys[], size_t argc);
+	int exists_keys(const char* keys[], const size_t lens[], size_t argc);
+
 	/**
 	 *  KEY ڣλ룩
 	 * set a key's time to live in seconds
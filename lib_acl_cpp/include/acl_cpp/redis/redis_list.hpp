@@ -282,6 +282,15 @@ public:
 	bool lrange(const char* key, int start, int end,
 		std::vector<string>* result);
 
+	/**
+	 * ͬϣƬηʽڽڴУݣһ
+	 * ִл clear ǰЧ
+	 * same as above, but the elements are views into the result object
+	 * without copying, which are valid until the next command or clear
+	 */
+	bool lrange(const char* key, int start, int end,
+		std::vector<string_view>& result);
+
 	/**
 	 * ԪֵбƳָԪ
 	 * remove the first count occurrences of elements equal to value
@@ -0,0 +1,231 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <vector>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+#include "redis_result.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+class redis_result;
+
+/**
+ * redis Ӧ(RESP Э)״̬ʽԷֶ
+ * ⳤȵƬΣ̿λжϲݵ
+ * ڷ첽 IO ̣ͬʱ֧ RESP2  RESP3 Э飬 RESP3 
+ * Ϣ invalidate Ϣ(ͻ˻ʧЧ֪ͨ)Ϊ
+ * ӦǱ get_pushes ص
+ * the incremental parser of redis response (RESP protocol) by a state
+ * machine, the data can be input in pieces of any length, and the parsing
+ * can be interrupted at any position and be resumed when new data arrives,
+ * so it's suitable for the non-blocking asynchronous IO; both RESP2 and
+ * RESP3 are supported, the RESP3 attributes will be discarded, and the
+ * top level invalidate push messages (the invalidation of client side
+ * caching) won't be taken as the response, but will be put in the array
+ * returned by get_pushes.
+ */
+class ACL_CPP_API redis_parser : public noncopyable
+{
+public:
+	redis_parser(void);
+	~redis_parser(void);
+
+	/**
+	 * ʼһµӦÿӦʼǰ
+	 * begin parsing a new response, must be called before every response
+	 * @param dbuf {dbuf_pool*} ڴڴ
+	 *  the memory pool for creating the result objects
+	 * @param nchildren {size_t}  >= 1 ʱ nchildren Ӧϲ
+	 *  Ϊһͬ redis_client::run е nchildren 
+	 *  when >= 1, nchildren response objects will be combined into one
+	 *  array result object, the same as nchildren in redis_client::run
+	 */
+	void reset(dbuf_pool* dbuf, size_t nchildren = 0);
+
+	/**
+	 * ݲн
+	 * input data to be parsed
+	 * @param data {const char*} ݵַ
+	 *  the data address
+	 * @param len {size_t} ݳ
+	 *  the data length
+	 * @return {int} رѵݳȣ-1 ʾЭ󣻵 finished
+	 *   true ʱʣδѵһӦ
+	 *  return the length of data consumed, -1 for protocol error; when
+	 *  finished returns true, the data left belong to the next response.
+	 */
+	int update(const char* data, size_t len);
+
+	/**
+	 * 㿽ʽݲнλ data емݿ鲻ٱ
+	 * ֱ data е(βݿ \r дΪ
+	 * \0) data дڲܶڽһӦ
+	 *  reset õڴϣлݿ鲻ᱻѣӦ
+	 * ͬһ룬ɵ get_want ü
+	 * ݳȣͬһӦĽвӦ update 
+	 * input data to be parsed in zero-copy mode: the lines and data blocks
+	 * lying in data completely won't be copied, and the result objects will
+	 * refer to them directly (the \r after the line or the data block will
+	 * be overwritten with \0), so data must be writable and must live no
+	 * shorter than the result objects, which should usually be allocated
+	 * in the dbuf of reset; the incomplete line or data block won't be
+	 * consumed, and the caller should input it again with the following
+	 * data, the contiguous data length needed for going on can be got by
+	 * get_want; don't mix it with update when parsing one response.
+	 * @param data {char*} дݵַ
+	 *  the writable data address
+	 * @param len {size_t} ݳ
+	 *  the data length
+	 * @return {int} رѵݳȣ-1 ʾЭ
+	 *  return the length of data consumed, -1 for protocol error
+	 */
+	int update_inplace(char* data, size_t len);
+
+	/**
+	 *  update_inplace δȫʱΪ㿽ʽ
+	 * ӵһδѵֽڿʼݳȣ0 ʾδ֪
+	 * when update_inplace didn't consume all the data, return the contiguous
+	 * length needed from the first byte not consumed for going on in
+	 * zero-copy mode, 0 means unknown
+	 * @return {size_t}
+	 */
+	size_t get_want(void) const
+	{
+		return want_;
+	}
+
+	/**
+	 * Ƿ񽫴ݿֲɶСݿ洢ڴ棬
+	 * ͬ redis_client::set_slice_respond
+	 * if splitting the large data block into multiple little blocks, to
+	 * avoid allocating large continuous memory, the same as
+	 * redis_client::set_slice_respond
+	 * @param on {bool}
+	 */
+	void set_slice(bool on)
+	{
+		slice_ = on;
+	}
+
+	/**
+	 * Ƿ RESP3 ЭĽͣȱʡΪ falseתΪӦ
+	 * RESP2 (μ redis_result_t)Ա redis Э汾
+	 * if keeping the result types added in RESP3, the default is false,
+	 * and they'll be converted to the associated RESP2 types (see
+	 * redis_result_t), so that the redis command classes needn't care about
+	 * the protocol version
+	 * @param on {bool}
+	 */
+	void set_resp3_types(bool on)
+	{
+		resp3_types_ = on;
+	}
+
+	/**
+	 * ýĶ invalidate Ϣ reset õ
+	 * ڴϴ reset  clear_pushes 
+	 * get the top level invalidate push messages met when parsing, which
+	 * were created in the dbuf of reset, and will be cleared after calling
+	 * reset or clear_pushes
+	 * @return {const std::vector<redis_result*>&}
+	 */
+	const std::vector<redis_result*>& get_pushes(void) const
+	{
+		return pushes_;
+	}
+
+	void clear_pushes(void)
+	{
+		pushes_.clear();
+	}
+
+	/**
+	 * Ƿ֮䣬ݶѱҵǰ
+	 * ӦδʼڶȡӿʱյϢ
+	 * if being between two top level objects, that's all the data input
+	 * have been parsed completely and the current response hasn't begun,
+	 * which is used for reading the push messages received when the
+	 * connection is idle
+	 * @return {bool}
+	 */
+	bool idle(void) const
+	{
+		return status_ == PARSE_TYPE && frames_.empty();
+	}
+
+	/**
+	 * ǰӦǷѾ
+	 * if the current response has been parsed completely
+	 * @return {bool}
+	 */
+	bool finished(void) const
+	{
+		return status_ == PARSE_DONE;
+	}
+
+	/**
+	 * ýϵĽ󣬸ö reset õڴϴ
+	 * get the result object parsed, which was created in the dbuf of reset
+	 * @return {redis_result*}  finished Ϊ false ʱ NULL
+	 *  NULL will be returned if finished returns false
+	 */
+	redis_result* get_result(void) const
+	{
+		return status_ == PARSE_DONE ? result_ : NULL;
+	}
+
+private:
+	typedef enum
+	{
+		PARSE_TYPE,		// ȡַ
+		PARSE_LINE,		// ȡͷ
+		PARSE_BULK,		// ȡݿ
+		PARSE_BULK_END,		// ȡݿ \r\n
+		PARSE_DONE,		// 
+		PARSE_ERR,		// Э
+	} parse_status_t;
+
+	struct parse_frame
+	{
+		redis_result* rr;	// 
+		size_t count;		// Ԫظ
+		size_t idx;		// ѽԪظ
+		char   type;		// ַϲӦʱΪ 0
+	};
+
+	dbuf_pool* dbuf_;
+	parse_status_t status_;
+	char   type_;
+	string line_;
+	std::vector<parse_frame> frames_;
+	redis_result* result_;
+	redis_result* bulk_rr_;
+	char*  bulk_;		// ǰݿ(Ƭ)Ĵ洢ַ
+	size_t bulk_len_;	// ݿܳ
+	size_t bulk_off_;	// ݿѶ
+	size_t piece_len_;	// ǰƬĳ
+	size_t piece_off_;	// ǰƬѶ
+	bool   sliced_;		// ǰݿǷ񱻷Ƭ洢
+	bool   slice_;
+	bool   inplace_;
+	size_t want_;
+	bool   verbatim_;	// ǰݿǷΪ RESP3  = 
+	bool   resp3_types_;
+	std::vector<redis_result*> pushes_;
+
+	int  parse(char* data, size_t len);
+	bool on_line(const char* line, size_t len, bool copy);
+	bool on_aggregate(redis_result* rr, const char* line);
+	void on_object(redis_result* rr);
+	void put_data(redis_result* rr, const char* data, size_t len);
+	void put_piece(void);
+	redis_result_t result_type(redis_result_t resp3,
+		redis_result_t resp2) const
+	{
+		return resp3_types_ ? resp3 : resp2;
+	}
+};
+
+} // namespace acl
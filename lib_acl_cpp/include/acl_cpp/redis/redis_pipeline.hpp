@@ -0,0 +1,149 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <vector>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+class redis_client;
+class redis_client_cluster;
+class redis_request;
+class redis_result;
+class connect_pool;
+
+/**
+ * redis ܵ࣬ redis κ redis_command 
+ * redis_stringredis_hashredis_key ȣͨ set_pipeline 뱾󶨺
+ * ͣǱ׷У exec ʱǼȺģʽ½
+ * һдӣȺģʽ°ϣ۽㣬Ƚÿͨ
+ * һ writev д㣬ζȡӦʹ㲢д
+ *  MOVED/ASK ض
+ * the redis pipeline class, for sending redis commands in batch: after
+ * binding with any sub-class object of redis_command (such as redis_string,
+ * redis_hash, redis_key, etc.) by set_pipeline, the commands will be appended
+ * to the pipeline instead of being sent immediately; when exec is called,
+ * all the commands will be written to the connection at once in no-cluster
+ * mode, and in cluster mode, the commands will be grouped by the nodes of
+ * the hash slots, every group will be written to its node by one writev
+ * before reading the results from the nodes one by one, so that the nodes
+ * can handle the commands in parallel, and the MOVED/ASK redirection will
+ * be handled for every command.
+ */
+class ACL_CPP_API redis_pipeline : public noncopyable
+{
+public:
+	/**
+	 * ǼȺģʽµĹ캯
+	 * constructor in no-cluster mode
+	 * @param conn {redis_client*} redis Ӷ
+	 *  the redis connection
+	 */
+	redis_pipeline(redis_client* conn);
+
+	/**
+	 * ȺģʽµĹ캯
+	 * constructor in cluster mode
+	 * @param cluster {redis_client_cluster*} redis ȺӶ
+	 *  the redis cluster object
+	 * @param max_conns {size_t} ضʱ̬ӳص
+	 *  the max connections of the pool created when redirecting
+	 */
+	redis_pipeline(redis_client_cluster* cluster, size_t max_conns = 0);
+
+	~redis_pipeline(void);
+
+	/**
+	 * ŶӵȡӦ´ε
+	 * exec  clear ǰЧ
+	 * send all the queued commands and read their results, the result
+	 * objects are valid until the next exec or clear being called
+	 * @return {bool} Ӧ()ʱ true
+	 *  򷵻 falseʱͨ get_result жЩûн
+	 *  return true if all the commands got results (including error
+	 *  results), or return false, and get_result can be used to check
+	 *  which commands got no result.
+	 */
+	bool exec(void);
+
+	/**
+	 * ŶӵϴִеĽ
+	 * clear all the queued commands and the results of the last exec
+	 */
+	void clear(void);
+
+	/**
+	 * Ŷӵ
+	 * get the number of the queued commands
+	 * @return {size_t}
+	 */
+	size_t size(void) const
+	{
+		return cmds_.size();
+	}
+
+	/**
+	 * ð˳ĵ i Ӧ
+	 * get the result of the ith command in the queued order
+	 * @param i {size_t} ±ֵ
+	 *  the subscript
+	 * @return {const redis_result*}  NULL ʾ±Խûн
+	 *  NULL will be returned if i is out of bounds or no result
+	 */
+	const redis_result* get_result(size_t i) const;
+
+	/**
+	 * üȺģʽµļȺӶ
+	 * get the redis cluster object in cluster mode
+	 * @return {redis_client_cluster*} ǼȺģʽ· NULL
+	 *  NULL will be returned in no-cluster mode
+	 */
+	redis_client_cluster* get_cluster(void) const
+	{
+		return cluster_;
+	}
+
+private:
+	friend class redis_command;
+
+	//  redis_command ãһ׷ܵ
+	void push(const string& req, int slot, size_t nchild);
+	void push(const redis_request& req, int slot, size_t nchild);
+
+private:
+	struct pipeline_cmd
+	{
+		size_t off;		//  buf_ еƫλ
+		size_t len;		// ݵĳ
+		int    slot;		// ϣֵ-1 ʾδ֪
+		size_t nchild;		// Ӧݶ
+		const char* addr;	// ضĽַ
+		bool   asking;		// ǷҪȷ ASKING 
+		bool   sent;		// Ƿѱд
+		const redis_result* result;
+	};
+
+	redis_client* conn_;
+	redis_client_cluster* cluster_;
+	size_t max_conns_;
+	int    redirect_max_;
+	int    redirect_sleep_;
+	dbuf_pool* dbuf_;
+	string buf_;
+	std::vector<pipeline_cmd> cmds_;
+
+	// ͬһһ
+	struct pipeline_group;
+
+	bool exec_client(void);
+	bool exec_cluster(void);
+	connect_pool* get_pool(const pipeline_cmd& cmd);
+	bool send(pipeline_group& group);
+	size_t read(pipeline_group& group);
+	bool redirect(pipeline_cmd& cmd);
+	const char* get_addr(const char* info);
+};
+
+} // namespace acl
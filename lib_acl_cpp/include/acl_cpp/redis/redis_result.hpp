@@ -1,6 +1,7 @@
 #pragma once
 #include "../acl_cpp_define.hpp"
 #include <vector>
+#include "../stdlib/string_view.hpp"
 
 namespace acl
 {
@@ -14,6 +15,18 @@ typedef enum
 	REDIS_RESULT_INTEGER,
 	REDIS_RESULT_STRING,
 	REDIS_RESULT_ARRAY,
+
+	// Ϊ RESP3 Эͣ redis_client::set_resp3_types
+	//  RESP3 ʱŻ֣תΪӦ RESP2 
+	// the types below are added in RESP3, which appear only when the RESP3
+	// types are kept by redis_client::set_resp3_types, or else they will
+	// be converted to the RESP2 types above
+	REDIS_RESULT_DOUBLE,	// ,  -> REDIS_RESULT_STRING
+	REDIS_RESULT_BOOL,	// #  -> REDIS_RESULT_INTEGER, ֵΪ 1  0
+	REDIS_RESULT_BIGNUM,	// (  -> REDIS_RESULT_STRING
+	REDIS_RESULT_MAP,	// %  -> REDIS_RESULT_ARRAY, ֵ
+	REDIS_RESULT_SET,	// ~  -> REDIS_RESULT_ARRAY
+	REDIS_RESULT_PUSH,	// >  -> REDIS_RESULT_ARRAY
 } redis_result_t;
 
 class string;
@@ -60,11 +73,26 @@ public:
 	 *  REDIS_RESULT_INTEGER: 1
 	 *  REDIS_RESULT_STRING: > 0 ʱʾַݱзֳɷڴĸ
 	 *  REDIS_RESULT_ARRAY: children_->size()
+	 *  REDIS_RESULT_MAP/REDIS_RESULT_SET/REDIS_RESULT_PUSH: ͬ ARRAY
 	 */
 	size_t get_size(void) const;
 
+	/**
+	 * ǷΪȺӽľۺ
+	 * if the result is an aggregate type containing children, such as array
+	 * @return {bool}
+	 */
+	bool is_aggregate(void) const
+	{
+		return result_type_ == REDIS_RESULT_ARRAY
+			|| result_type_ == REDIS_RESULT_MAP
+			|| result_type_ == REDIS_RESULT_SET
+			|| result_type_ == REDIS_RESULT_PUSH;
+	}
+
 	/**
 	 * ֵΪ REDIS_RESULT_INTEGER ʱضӦ 32 λֵ
+	 * (REDIS_RESULT_BOOL ͷ 1  0)
 	 * get the 32 bits integer for REDIS_RESULT_INTEGER result
 	 * @param success {bool*} ָ NULL ʱ¼Ƿɹ
 	 *  when not NULL, storing the status of success
@@ -82,7 +110,8 @@ public:
 	long long int get_integer64(bool* success = NULL) const;
 
 	/**
-	 * ֵΪ REDIS_RESULT_STRING ʱضӦ double ֵ
+	 * ֵΪ REDIS_RESULT_STRING  REDIS_RESULT_DOUBLE ʱ
+	 * ضӦ double ֵ
 	 * get the double value for REDIS_RESULT_STRING result
 	 * @param success {bool*} ָ NULL ʱ¼Ƿɹ
 	 *  when not NULL, storing the status of success
@@ -158,6 +187,19 @@ public:
 	int argv_to_string(string& buf) const;
 	int argv_to_string(char* buf, size_t size) const;
 
+	/**
+	 * Ϊ REDIS_RESULT_STRING ȷʱýݵ
+	 * ƬζݲᱻƣڸýڴرͷǰһֱЧ
+	 * ݱֳɶڴ洢ʱμ redis_client::set_slice_respond
+	 * ڲŻڴϽϲһڴ
+	 * get the non-owning view of the data, which is valid until the dbuf
+	 * pool of the result is freed; the data won't be copied except that
+	 * it was stored in several slicing chunks
+	 * @return {string_view} ʱؿƬ
+	 *  an empty view will be returned if no data
+	 */
+	string_view argv_view(void) const;
+
 	/**
 	 * Ϊ REDIS_RESULT_ARRAY ʱúе
 	 * return the objects array when result type is REDIS_RESULT_ARRAY
@@ -198,6 +240,8 @@ private:
 	~redis_result(void);
 
 	friend class redis_client;
+	friend class redis_parser;
+	friend class redis_command;
 	void clear(void);
 
 	redis_result& set_type(redis_result_t type);
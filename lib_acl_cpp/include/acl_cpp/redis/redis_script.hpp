@@ -9,6 +9,7 @@ namespace acl
 
 class redis_client;
 class redis_result;
+class redis_script_registry;
 
 class ACL_CPP_API redis_script : virtual public redis_command
 {
@@ -30,6 +31,23 @@ public:
 
 	virtual ~redis_script(void);
 
+	/**
+	 *  Lua űעδʱʹ redis_client_cluster  redis_client
+	 *  set_script_registry õעʹעʱeval ϵз
+	 * עűֻ EVALSHA evalsha ϵзժҪӦע
+	 * űʱյ NOSCRIPT  EVAL űͬһ㲢
+	 * ܵ첽ʽ²ʹע
+	 * set the Lua script registry, the registry set by set_script_registry
+	 * of redis_client_cluster or redis_client will be used if not set;
+	 * when using the registry, the eval methods will register the script
+	 * and only send EVALSHA, and if the digest of the evalsha methods is
+	 * of a registered script, EVAL will be used to send the script to the
+	 * same node after receiving NOSCRIPT error, and its result will be
+	 * returned; the registry isn't used in pipeline or asynchronous mode
+	 * @param scripts {redis_script_registry*}
+	 */
+	void set_script_registry(redis_script_registry* scripts);
+
 	/////////////////////////////////////////////////////////////////////
 
 	const redis_result* eval(const char* script,
@@ -132,6 +150,10 @@ public:
 		std::vector<string>& out);
 
 private:
+	redis_script_registry* scripts_;
+
+	redis_script_registry* get_script_registry(void) const;
+
 	int eval_status(const char* cmd, const char* script,
 		const std::vector<string>& keys,
 		const std::vector<string>& args,
@@ -158,6 +180,13 @@ private:
 	const redis_result* eval_cmd(const char* cmd, const char* script,
 		const std::vector<const char*>& keys,
 		const std::vector<const char*>& args);
+
+	const redis_result* eval_request(const char* cmd, const char* script,
+		const std::vector<string>& keys,
+		const std::vector<string>& args);
+	const redis_result* eval_request(const char* cmd, const char* script,
+		const std::vector<const char*>& keys,
+		const std::vector<const char*>& args);
 };
 
 } // namespace acl
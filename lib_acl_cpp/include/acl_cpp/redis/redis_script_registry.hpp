@@ -0,0 +1,98 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <map>
+#include <vector>
+#include "../stdlib/noncopyable.hpp"
+#include "../stdlib/string.hpp"
+#include "../stdlib/locker.hpp"
+
+namespace acl
+{
+
+class redis_client;
+
+/**
+ * redis Lua űעÿű״עʱһ SHA1 ժҪͨ
+ * redis_script::set_script_registry  redis_client/redis_client_pool/
+ * redis_client_cluster  set_script_registry úredis_script 
+ * eval ϵзֻ EVALSHA  redis ˷ NOSCRIPT ʱ
+ * Զ EVAL űͬһ(˻Ỻýű)
+ * ĽűǷѱأ⻹ӽʱעĽűԤ
+ * ÿ redis 㣻ɱ̼߳ӹ
+ * the redis Lua script registry, the SHA1 digest of each script is
+ * computed only once when being registered: after being set by
+ * redis_script::set_script_registry or set_script_registry of redis_client/
+ * redis_client_pool/redis_client_cluster, the eval methods of redis_script
+ * will only send EVALSHA, and when redis-server returns NOSCRIPT error,
+ * the script will be sent to the same node by EVAL automatically(which
+ * will be cached by the server) and its result will be returned, so the
+ * caller needn't care if the script has been loaded; all the registered
+ * scripts can also be preloaded to each redis node when the connections
+ * are established; the object can be shared by multiple threads and
+ * connections.
+ */
+class ACL_CPP_API redis_script_registry : public noncopyable
+{
+public:
+	redis_script_registry(void);
+	~redis_script_registry(void);
+
+	/**
+	 * עű SHA1 ժҪעĽűֱӷ֮ǰժҪ
+	 * register the script and return its SHA1 digest, the digest computed
+	 * before will be returned if the script has been registered
+	 * @param script {const char*} Lua ű
+	 *  the Lua script
+	 * @return {const char*} 40 ֽڵʮժҪڱЧ
+	 *  the 40 bytes hex digest, which is valid in the object's lifetime
+	 */
+	const char* add(const char* script);
+
+	/**
+	 *  SHA1 ժҪעĽű
+	 * look up the registered script by the SHA1 digest
+	 * @param sha1 {const char*}
+	 * @return {const char*} δעʱ NULL
+	 *  NULL will be returned if not registered
+	 */
+	const char* get_script(const char* sha1) const;
+
+	/**
+	 * δӦĽűͨ SCRIPT LOAD أÿ
+	 * һΣӽʱԶ
+	 * load the scripts which haven't been loaded to the node of the
+	 * connection by SCRIPT LOAD, each node will be loaded only once, and
+	 * it's called automatically when the connection is established
+	 * @param conn {redis_client&} ѽ
+	 *  the established connection
+	 * @return {bool} Ƿȫسɹ
+	 *  if all the scripts have been loaded successfully
+	 */
+	bool preload(redis_client& conn);
+
+	/**
+	 * עűĸ
+	 * get the number of the registered scripts
+	 * @return {size_t}
+	 */
+	size_t size(void) const;
+
+	/**
+	 * ݵ SHA1 ժҪ
+	 * compute the SHA1 digest of the data
+	 * @param data {const char*}
+	 * @param len {size_t}
+	 * @param out {string&}  40 ֽڵʮժҪ
+	 *  store the 40 bytes hex digest
+	 */
+	static void sha1_hex(const char* data, size_t len, string& out);
+
+private:
+	mutable locker lock_;
+	std::map<string, string> scripts_;	// ű --> ժҪ
+	std::map<string, const char*> shas_;	// ժҪ --> scripts_ еĽű
+	std::vector<const char*> order_;	// ע˳еĽű
+	std::map<string, size_t> loaded_;	// ַ --> ѼصĽű
+};
+
+} // namespace acl
@@ -137,6 +137,10 @@ public:
 	 * @return {bool} Ƿɹ false ʾ key ַ
 	 *  if the GET was executed correctly, false if error happened or
 	 *  is is not a string of the key
+	 * ע˿ͻ˻ʱ(μ redis_client::set_cache)
+	 *  ֱȡԱػ
+	 *  the value may be got from the local cache directly when the client
+	 *  side caching was set, see redis_client::set_cache
 	 */
 	bool get(const char* key, string& buf);
 	bool get(const char* key, size_t len, string& buf);
@@ -326,8 +330,13 @@ public:
 	/////////////////////////////////////////////////////////////////////
 
 	/**
-	 * ͬʱһ key-value 
-	 * set multiple key-value pair
+	 * ͬʱһ key-value ԣȺģʽ¿ϣ۵ key ϣ
+	 * ۲ֺãʱԭӲʧʱ falseʧܵ
+	 * key  get_failed_keys 
+	 * set multiple key-value pair; in cluster mode, the keys across hash
+	 * slots will be split by hash slot and set in parallel, which isn't
+	 * atomic any more, false will be returned when partially failed, and
+	 * the failed keys can be got by get_failed_keys
 	 * @param objs key-value Լ
 	 *  the collection of multiple key-value pair
 	 * @return {bool} Ƿɹ
@@ -367,8 +376,14 @@ public:
 
 	/**
 	 * (һ) key ֵ key 棬ĳ key ڣ
-	 * ô key ؿմӽ
-	 * get the values of the given keys
+	 * ô key ؿմӽУȺģʽ¿ϣ۵ key 
+	 * ϣ۲ֺвѯԭʼ˳ϲʧʱԷ true
+	 * ʧܵ key ؿմ get_failed_keys 
+	 * get the values of the given keys; in cluster mode, the keys across
+	 * hash slots will be split by hash slot, queried in parallel and the
+	 * results will be merged in the original order, true will still be
+	 * returned when partially failed, the values of the failed keys are
+	 * empty and the failed keys can be got by get_failed_keys
 	 * @param keys {const std::vector<string>&} ַ key 
 	 *  the given keys
 	 * @param out {std::vector<acl::string>*} ǿʱ洢ֵַ飬
@@ -417,6 +432,18 @@ public:
 	bool mget(const char* keys[], const size_t keys_len[], size_t argc,
 		std::vector<string>* out = NULL);
 
+	/**
+	 * ͬϣƬηʽڽڴУݣһ
+	 * ִл clear ǰЧڵ key ӦƬ
+	 * same as above, but the values are views into the result without
+	 * copying, which are valid until the next command or clear, and the
+	 * value of the key not existing is an empty view
+	 */
+	bool mget(const std::vector<string>& keys,
+		std::vector<string_view>& out);
+	bool mget(const std::vector<const char*>& keys,
+		std::vector<string_view>& out);
+
 	/////////////////////////////////////////////////////////////////////
 
 	/**
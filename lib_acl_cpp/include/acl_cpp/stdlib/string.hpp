@@ -51,6 +51,16 @@ public:
 	 */
 	string(const void* s, size_t n);
 
+#ifdef	ACL_USE_CPP11
+	/**
+	 * ƶ캯ֱӽӹԴĻݣ
+	 * ACL_CPP_STRING_SSO ԴΪַʱǶԴ
+	 * ֮ΪʹõĿմ
+	 * @param s {string&&} Դַ
+	 */
+	string(string&& s);
+#endif
+
 #if defined(_WIN32) || defined(_WIN64)
 	/**
 	 * ڴӳļʽ
@@ -149,6 +159,16 @@ public:
 	 */
 	string& operator=(const string* s);
 
+#ifdef	ACL_USE_CPP11
+	/**
+	 * ƶֵǰԭеĻͷţӹԴĻ
+	 * ԴΪմ
+	 * @param s {string&&} Դַ
+	 * @return {string&} صǰãڶԸв
+	 */
+	string& operator=(string&& s);
+#endif
+
 #if defined(_WIN32) || defined(_WIN64)
 	/**
 	 * Ŀֵַ
@@ -1194,7 +1214,45 @@ private:
 	ACL_LINE_STATE* line_state_;
 	int   line_state_offset_;
 
+#ifdef	ACL_CPP_STRING_SSO
+	/**
+	 * ʱ ACL_CPP_STRING_SSO ACL_VSTRING ṹַĻ
+	 * ǶڱУȲ SSO_SIZE - 1 ַ趯̬ڴ棬
+	 * ʱԶǨϣ󲼾б仯ʹͬĺ
+	 */
+	enum
+	{
+		VBF_SIZE = 128,
+		SSO_SIZE = 32
+	};
+
+	union
+	{
+		void*     align_;
+		long long align64_;
+		char      data_[VBF_SIZE];
+	} vbf_obj_;
+	char sso_buf_[SSO_SIZE];
+#endif
+
 	void init(size_t len);
+	void reset_vbf(ACL_VSTRING* vbf);
 };
 
+/**
+ * ַ㣬µַ
+ */
+ACL_CPP_API string operator+(const string& l, const string& r);
+ACL_CPP_API string operator+(const string& l, const char* r);
+ACL_CPP_API string operator+(const char* l, const string& r);
+
+#ifdef	ACL_USE_CPP11
+/**
+ * Ϊֵʱֱ仺׷Ӳƶأθƣ
+ * 磺s = a + b + c + d ֻḴһ a
+ */
+ACL_CPP_API string operator+(string&& l, const string& r);
+ACL_CPP_API string operator+(string&& l, const char* r);
+#endif
+
 } // namespce acl
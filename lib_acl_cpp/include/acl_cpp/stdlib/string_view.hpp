@@ -0,0 +1,134 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <string.h>
+#include "string.hpp"
+
+namespace acl {
+
+/**
+ * ӵ͵ַƬ࣬ⲿڴеһݣַ + ȣ
+ * κڴ븴ƣõڱʹڼ䱣Ч redis_result
+ * е dbuf_pool ͷǰһֱЧ
+ * the non-owning string slice, which just refers to the data in other's
+ * memory without any copying, the data referred must be valid when using it
+ */
+class string_view
+{
+public:
+	string_view(void) : ptr_(""), len_(0) {}
+
+	string_view(const char* s) : ptr_(s ? s : ""), len_(s ? strlen(s) : 0) {}
+
+	string_view(const char* s, size_t n) : ptr_(s ? s : ""), len_(s ? n : 0) {}
+
+	string_view(const string& s) : ptr_(s.c_str()), len_(s.length()) {}
+
+	/**
+	 * ݵĵַע⣺ݲһ \0 β
+	 * get the address of the data referred, which maybe not end with \0
+	 * @return {const char*}
+	 */
+	const char* data(void) const
+	{
+		return ptr_;
+	}
+
+	/**
+	 * ݵĳ
+	 * get the length of the data referred
+	 * @return {size_t}
+	 */
+	size_t size(void) const
+	{
+		return len_;
+	}
+
+	size_t length(void) const
+	{
+		return len_;
+	}
+
+	bool empty(void) const
+	{
+		return len_ == 0;
+	}
+
+	const char* begin(void) const
+	{
+		return ptr_;
+	}
+
+	const char* end(void) const
+	{
+		return ptr_ + len_;
+	}
+
+	char operator[](size_t n) const
+	{
+		return ptr_[n];
+	}
+
+	/**
+	 * ش pos ʼΪ n ƬΣ
+	 * get the sub slice from pos with no more than n bytes, no copying
+	 * @param pos {size_t} ʼλãʱؿƬ
+	 * @param n {size_t} Ƭε󳤶
+	 * @return {string_view}
+	 */
+	string_view substr(size_t pos, size_t n = (size_t) -1) const
+	{
+		if (pos >= len_)
+			return string_view(ptr_ + len_, 0);
+		if (n > len_ - pos)
+			n = len_ - pos;
+		return string_view(ptr_ + pos, n);
+	}
+
+	/**
+	 * ȽƬεݣִСд
+	 * compare with another slice
+	 * @return {int} 0 ʾȣ< 0 ʾС s> 0 ʾ s
+	 */
+	int compare(const string_view& s) const
+	{
+		size_t n = len_ < s.len_ ? len_ : s.len_;
+		int ret = n > 0 ? memcmp(ptr_, s.ptr_, n) : 0;
+		if (ret != 0)
+			return ret;
+		return len_ == s.len_ ? 0 : (len_ < s.len_ ? -1 : 1);
+	}
+
+	bool operator==(const string_view& s) const
+	{
+		return len_ == s.len_ && (len_ == 0
+			|| memcmp(ptr_, s.ptr_, len_) == 0);
+	}
+
+	bool operator!=(const string_view& s) const
+	{
+		return !(*this == s);
+	}
+
+	bool operator<(const string_view& s) const
+	{
+		return compare(s) < 0;
+	}
+
+	/**
+	 * õݸ string У׷ӷʽ
+	 * append the data referred to the string object
+	 * @param out {string&}
+	 * @return {string&}
+	 */
+	string& to_string(string& out) const
+	{
+		out.append(ptr_, len_);
+		return out;
+	}
+
+private:
+	const char* ptr_;
+	size_t len_;
+};
+
+} // namespace acl
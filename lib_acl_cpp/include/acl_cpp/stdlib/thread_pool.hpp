@@ -1,4 +1,7 @@
 #pragma once
+#include "../acl_cpp_define.hpp"
+#include <list>
+#include "locker.hpp"
 
 struct acl_pthread_pool_t;
 struct acl_pthread_pool_attr_t;
@@ -8,6 +11,19 @@ namespace acl
 
 class thread_job;
 
+/**
+ * ̳߳ĳȼͳϢʱ䵥λΪ
+ */
+struct thread_pool_stat
+{
+	long long njobs;	// ִе
+	long long nexpired;	// 򳬹ֹʱ
+	long long nshed;	// Ŷӹöڵʱ
+	long long nreject;	// ضʱܾ
+	long long wait_total;	// ִŶʱܺ
+	long long wait_max;	// ִŶʱ
+};
+
 /**
  * ̳߳ع࣬ڹ̳߳е߳ǰפ(߳̿һʱ
  * Զ˳)Ǵ麯thread_on_init(̳߳еĳ̵߳һ
@@ -44,6 +60,40 @@ public:
 	 */
 	bool run(thread_job* job);
 
+	/**
+	 * ȼֵԽСȼԽ
+	 */
+	enum
+	{
+		PRIO_HIGH = 0,		// 񣬲ᱻؽ
+		PRIO_NORMAL,		// ͨ
+		PRIO_LOW,		// Ⱥʱ
+		PRIO_MAX,
+	};
+
+	/**
+	 * 񱻶ԭ򣬲μ job_on_drop
+	 */
+	enum
+	{
+		DROP_EXPIRED,		// ִǰѳֹʱ
+		DROP_SHED,		// ʱŶӹ
+	};
+
+	/**
+	 * ȼһ񽻸ִ̳߳У̳߳пеִ߳
+	 * ȼߵִǰѳֹʱ䣬ڹؽʱ
+	 *  PRIO_HIGH Ŷʱ䳬 set_shed_wait õֵ
+	 * ᱻִУǵ job_on_drop ֪ͨʹߣȼ run 
+	 * 񲻲ȼ
+	 * @param job {thread_job*} ߳
+	 * @param prio {int} ȼȡֵΪ PRIO_HIGH/PRIO_NORMAL/PRIO_LOW
+	 * @param timeout {int} ʱĽֹʱ()<= 0 ʾ
+	 * @return {bool} Ƿɹؽʱӷ PRIO_HIGH ᱻܾ
+	 *   falseʱ job_on_drop
+	 */
+	bool run(thread_job* job, int prio, int timeout = 0);
+
 	/**
 	 * һ񽻸̳߳еһ߳ȥִУ̳߳е
 	 * ִ̻߳ие run ú run ȫֻͬΪ
@@ -75,6 +125,31 @@ public:
 	 */
 	thread_pool& set_idle(int ttl);
 
+	/**
+	 * ̳߳ǷУԼʱ̳߳ȫ
+	 *  start ǰã Linux ƽ̨Ч
+	 * @param yes {bool} ô˺ڲȱʡΪ false
+	 * @return {thread_pool&}
+	 */
+	thread_pool& set_lockfree(bool yes);
+
+	/**
+	 * ùؽֵŶõȼĵȴʱ䳬ֵʱܾ
+	 * µķ PRIO_HIGH Ŷʱ䳬ֵķ PRIO_HIGH ڵ
+	 * ʱӶʹڹʱƽȽ󶼳ʱ
+	 * @param ms {int} ֵ()<= 0 ʾȱʡΪ 0
+	 * @return {thread_pool&}
+	 */
+	thread_pool& set_shed_wait(int ms);
+
+	/**
+	 * ĳȼͳϢ
+	 * @param prio {int} ȼ
+	 * @param out {thread_pool_stat&} Ž
+	 * @return {bool} ȼǷʱ false
+	 */
+	bool get_stat(int prio, thread_pool_stat& out);
+
 	/**
 	 * õǰ̵̳߳߳
 	 * @return {int} ̵̳߳߳δͨ start
@@ -102,10 +177,39 @@ protected:
 	 */
 	virtual void thread_on_exit() {}
 
+	/**
+	 * ȼӵδִжʱ麯߳бã
+	 * ûԼʵͷŸ򷵻شϢ
+	 * @param job {thread_job*} 
+	 * @param reason {int} ԭDROP_EXPIRED/DROP_SHED
+	 */
+	virtual void job_on_drop(thread_job* job, int reason)
+	{
+		(void) job;
+		(void) reason;
+	}
+
 private:
 	size_t stack_size_;
 	size_t threads_limit_;
 	int    thread_idle_;
+	bool   lockfree_;
+	int    shed_wait_;
+
+	struct sched_job
+	{
+		thread_job* job;
+		long long stamp;
+		long long deadline;
+	};
+
+	locker lock_;
+	std::list<sched_job> queues_[PRIO_MAX];
+	thread_pool_stat stats_[PRIO_MAX];
+
+	bool overloaded(long long now) const;
+	void sched_one();
+	static void thread_sched(void* arg);
 
 	acl_pthread_pool_t* thr_pool_;
 	acl_pthread_pool_attr_t* thr_attr_;
@@ -2,6 +2,7 @@
 #include "../acl_cpp_define.hpp"
 
 struct ACL_AQUEUE;
+struct ACL_LFQUEUE;
 
 namespace acl
 {
@@ -16,15 +17,54 @@ public:
 class ACL_CPP_API thread_queue
 {
 public:
+	/**
+	 * ڻ޽У߼
+	 */
 	thread_queue();
+
+	/**
+	 * нζеĶУһ̣߳ʱ
+	 * ߻ȴֱпλ
+	 * @param size {size_t} ڲΪ 2  N η
+	 * @param mpsc {bool} Ƿ̣߳Ϊ false ʱһ
+	 *  ߳(SPSC)
+	 */
+	thread_queue(size_t size, bool mpsc = true);
+
 	~thread_queue();
 
 	bool push(thread_qitem* item);
+
+	/**
+	 * һӶԪأ໽һ
+	 * @param items {thread_qitem**} Ԫ
+	 * @param n {size_t} Ԫظ
+	 * @return {bool}
+	 */
+	bool push_batch(thread_qitem** items, size_t n);
+
 	thread_qitem* pop(int wait_ms = -1);
+
+	/**
+	 * һȡԪأΪʱȴ
+	 * @param items {thread_qitem**} Ž
+	 * @param max {size_t} 
+	 * @param wait_ms {int} ȴĺ< 0 ʾһֱȴ
+	 * @return {size_t} ȡԪظ0 ʾʱ
+	 */
+	size_t pop_batch(thread_qitem** items, size_t max, int wait_ms = -1);
+
+	/**
+	 * ǰΪӦ
+	 * @param nspin {int} 0 ʾ
+	 */
+	void set_spin(int nspin);
+
 	int qlen() const;
 
 private:
 	ACL_AQUEUE* queue_;
+	ACL_LFQUEUE* ring_;
 };
 
 } // namespace acl
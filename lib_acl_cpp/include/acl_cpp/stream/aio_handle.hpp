@@ -24,6 +24,36 @@ typedef enum
 class aio_timer_callback;
 class aio_delay_free;
 class aio_timer_delay_free;
+class aio_post_channel;
+class locker;
+
+/**
+ * ͨ aio_handle::post Ͷݸ¼ص࣬صڸ
+ * ¼ڵ߳б
+ * the task callback posted to the aio engine by aio_handle::post, which
+ * will be called in the thread running the aio engine
+ */
+class ACL_CPP_API aio_post_callback
+{
+public:
+	aio_post_callback() {}
+	virtual ~aio_post_callback() {}
+
+	/**
+	 * ¼߳бõ麯ڸú
+	 * called in the aio engine's thread, the subclass can delete itself
+	 * in this function
+	 */
+	virtual void post_callback() = 0;
+
+	/**
+	 * ¼汻ʱδִеô麯
+	 * ڸúͷȱʡκδ
+	 * called when the aio engine is destroyed before the task was run,
+	 * the subclass can delete itself in this function
+	 */
+	virtual void post_cancel() {}
+};
 
 class ACL_CPP_API aio_handle : private noncopyable
 {
@@ -113,6 +143,35 @@ public:
 	 */
 	void delay_free(aio_delay_free* callback);
 
+	/**
+	 * ̰߳ȫ¼Ͷһ񣬸Ļص̽¼
+	 * ڵ߳бã¼ڵȴ IO ¼ͨڲ
+	 * ֪ͨ(Linux Ϊ eventfdƽ̨Ϊ socketpair)份ѣ
+	 * ֪ͨ״Ͷʱű¼߳´ε check()
+	 * ʱעᣬ׸ӳһ¼ѭȴڲűִУ
+	 * ӳ٣¼߳Ԥȵ open_post_channel()
+	 * ڵ post_callback  post_cancel ǰ뱣֤ callback
+	 * һֱЧ
+	 * post one task to the engine thread safely, the task will be called
+	 * in the engine's thread; the engine will be waked up by the notifying
+	 * handle (eventfd on Linux, socketpair on others) if it is waiting;
+	 * the handle is created by the first post and registered by the next
+	 * check() in the engine's thread
+	 * @param callback {aio_post_callback*} ǿն
+	 * @return {bool}  false ʾڲ֪ͨʧ
+	 */
+	bool post(aio_post_callback* callback);
+
+	/**
+	 * ¼߳дעͶõ֪ͨʹ˺Ͷݵ
+	 * ִܱУͨ check() е acl_aio_loop ¼ѭ
+	 * Ӧñ״ post ǰñ
+	 * create and register the notifying handle in the engine's thread,
+	 * which must be called before posting if check() isn't used
+	 * @return {bool}  false ʾ֪ͨʧ
+	 */
+	bool open_post_channel();
+
 	/**
 	 *  ACL_AIO 
 	 * @return {ACL_AIO*}
@@ -204,7 +263,12 @@ private:
 	int  nstream_;
 	aio_handle_type engine_type_;
 	aio_timer_delay_free* delay_free_timer_;
+	aio_post_channel* post_channel_;
+	locker* post_lock_;
+	bool post_enabled_;
 
+	aio_post_channel* get_post_channel();
+	void enable_post_channel();
 	void destroy_timer(aio_timer_callback* callback);
 	static void on_timer_callback(int event_type, ACL_EVENT*,
 		aio_timer_callback *callback);
@@ -0,0 +1,111 @@
+#pragma once
+#include "../acl_cpp_define.hpp"
+#include <vector>
+#include <list>
+#include "../stdlib/noncopyable.hpp"
+#include "aio_handle.hpp"
+
+struct ACL_VSTREAM;
+
+namespace acl
+{
+
+class aio_accept_callback;
+class aio_group_loop;
+
+// ¼еķַʽ
+typedef enum
+{
+	AIO_DISPATCH_ROUND_ROBIN,	// ѭַ
+	AIO_DISPATCH_LEAST_LOAD		// ַǰ첽ٵ¼
+} aio_dispatch_type;
+
+/**
+ * ¼飺ÿ¼ڸԶ߳Уһڼ
+ *  CPU ˣͨ aio_listen_stream::set_group Ӱѭ
+ * Сطʽַڸ¼棬˺ϵ IO 
+ * ¼߳ɣ̵߳ĽӦͨ aio_handle::post 
+ * the group of aio engines, each engine runs in its own thread, and the
+ * listener can dispatch the accepted connections to them by round robin
+ * or least load; the IO of one connection is always handled in the thread
+ * of the engine it belongs to
+ */
+class ACL_CPP_API aio_handle_group : private noncopyable
+{
+public:
+	/**
+	 * 캯
+	 * @param nloops {size_t} ¼(߳) > 0
+	 * @param engine_type {aio_handle_type} ¼
+	 */
+	aio_handle_group(size_t nloops, aio_handle_type engine_type = ENGINE_KERNEL);
+	~aio_handle_group();
+
+	/**
+	 * ӵķַʽȱʡΪ AIO_DISPATCH_ROUND_ROBIN
+	 * @param type {aio_dispatch_type}
+	 * @return {aio_handle_group&}
+	 */
+	aio_handle_group& set_dispatch(aio_dispatch_type type);
+
+	/**
+	 * ¼߳
+	 * @return {bool} Ƿɹ
+	 */
+	bool start();
+
+	/**
+	 * ֪ͨ¼߳˳ȴʱԶ
+	 */
+	void stop();
+
+	/**
+	 * ¼
+	 * @return {size_t}
+	 */
+	size_t size() const;
+
+	/**
+	 * ָ±¼
+	 * @param i {size_t} ±꣬С size()
+	 * @return {aio_handle&}
+	 */
+	aio_handle& get(size_t i) const;
+
+	/**
+	 * ָ¼浱ǰĸأ첽δĴַ֮
+	 * @param i {size_t} ±꣬С size()
+	 * @return {int}
+	 */
+	int load(size_t i) const;
+
+	/**
+	 * ǰַʽѡһ¼棬ṵ́߳ȫһڼ
+	 * ڵ߳е
+	 * @return {aio_handle&}
+	 */
+	aio_handle& peek();
+
+	/**
+	 * һѽյĿͻӷַ peek() ѡ¼棬ڸ¼
+	 * ߳д aio_socket_stream  callback->accept_callback
+	 *  accept_callback  false ʱӽر
+	 * @param client {ACL_VSTREAM*} ͻӣɹʧܺɱӹ
+	 * @param callback {aio_accept_callback*} ǿջص̰߳ȫ
+	 * @return {bool} ͶǷɹ
+	 */
+	bool dispatch(ACL_VSTREAM* client, aio_accept_callback* callback);
+
+private:
+	friend class aio_listen_stream;
+
+	std::vector<aio_group_loop*> loops_;
+	aio_dispatch_type dispatch_type_;
+	size_t next_;
+	size_t nstarted_;
+
+	bool dispatch(ACL_VSTREAM* client,
+		const std::list<aio_accept_callback*>& callbacks);
+};
+
+} // namespace acl
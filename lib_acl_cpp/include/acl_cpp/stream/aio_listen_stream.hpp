@@ -6,6 +6,7 @@ namespace acl
 {
 
 class aio_socket_stream;
+class aio_handle_group;
 
 /**
  * 첽յµĿͻʱô˻صеĻص
@@ -50,6 +51,18 @@ public:
 	 */
 	void add_accept_callback(aio_accept_callback* callback);
 
+	/**
+	 * ¼飬ú󱾼յӽ¼ķַ
+	 * ʽڵĳ¼洦accept_callback Ҳڸ¼
+	 * ߳бã˻ص̰߳ȫú open ǰ
+	 * set the aio engine group, the accepted connections will be
+	 * dispatched to the engines in the group, and accept_callback will
+	 * be called in the engine's thread; must be called before open
+	 * @param group {aio_handle_group*} Ϊ NULL ʱʾڱڵ
+	 *  ¼д
+	 */
+	void set_group(aio_handle_group* group);
+
 	/**
 	 * ʼĳַָΪ׽ӿڣҲΪ׽ӿڣ
 	 * @param addr {const char*} ַTCPַַ
@@ -73,9 +86,11 @@ private:
 	bool accept_hooked_;
 	char  addr_[256];
 	std::list<aio_accept_callback*> accept_callbacks_;
+	aio_handle_group* group_;
 
 	void hook_accept();
 	static int accept_callback(ACL_ASTREAM*,  void*);
+	static int listen_callback(ACL_ASTREAM*,  void*);
 };
 
 }  // namespace acl
@@ -145,6 +145,58 @@ public:
 	 * д״̬(ʱ±첽)
 	 */
 	void disable_write();
+
+	/**
+	 * дϲ(cork)ģʽһ¼صжд
+	 * ڲдлۣ¼ѭʱͨһ writev ͳһͣ
+	 * ۵ﵽ limit ʱͣӶСݰϵͳ
+	 * дɻصͺűãرǰȷͻ۵
+	 * set the cork mode, the data written during one event dispatch will
+	 * be sent by one writev at the end of the event loop, or be sent at
+	 * once when the queued data reaches limit
+	 * @param on {bool} Ƿдϲģʽرʱͻ۵
+	 * @param limit {int} ͵ֵ(ֽ) > 0
+	 */
+	void set_cork(bool on, int limit = 65536);
+
+	/**
+	 * Ƿдϲģʽ
+	 * @return {bool}
+	 */
+	bool get_cork() const;
+
+	/**
+	 * деĸߵˮλдд͵ﵽ high ʱص
+	 * дص write_water_callback(true)֮ low ʱص
+	 * write_water_callback(false)
+	 * set the low and high watermarks of the write queue, and
+	 * aio_callback::write_water_callback will be called when crossing them
+	 * @param low {int} ˮλ(ֽ)
+	 * @param high {int} ˮλ(ֽ)<= 0 ʱȡˮλص
+	 */
+	void set_water(int low, int high);
+
+	/**
+	 * ддޣʱֱӹرո첽
+	 * set the hard limit of the write queue, the stream will be closed
+	 * when the queued data exceeds it
+	 * @param limit {int} (ֽ)<= 0 ʱʾ
+	 */
+	void set_write_limit(int limit);
+
+	/**
+	 * дδ͵
+	 * get the length of the data queued but not sent yet
+	 * @return {int}
+	 */
+	int get_write_left() const;
+
+	/**
+	 * ддʷֵ
+	 * get the peak length of the queued data
+	 * @return {int}
+	 */
+	int get_write_peak() const;
 protected:
 	virtual ~aio_ostream();
 
@@ -166,6 +218,7 @@ private:
 
 	static int write_callback(ACL_ASTREAM*, void*);
 	static int write_wakup(ACL_ASTREAM*, void*);
+	static int write_water(ACL_ASTREAM*, void*, int);
 };
 
 }  // namespace acl
@@ -69,6 +69,21 @@ public:
 	{
 		return true;
 	}
+
+	/**
+	 * дˮλص麯ͨ aio_ostream::set_water ˸ߵˮλ
+	 * дд͵ﵽˮλˮλʱãӦÿɾݴ
+	 * ָͣȡݣӶֹٵĶԶʹд
+	 * called when the queued data of aio_ostream reaches the high
+	 * watermark or drops to the low watermark
+	 * @param high {bool} true ʾﵽˮλfalse ʾˮλ
+	 * @return {bool} ú false ֪ͨ첽رո첽
+	 */
+	virtual bool write_water_callback(bool high)
+	{
+		(void) high;
+		return true;
+	}
 protected:
 private:
 };
@@ -19,6 +19,21 @@ public:
 	 */
 	bool open_read(const char* path);
 
+	/**
+	 * ֻڴӳ䷽ʽѾڵļ˺ʱֱӴӳлȡ
+	 *  gets_ref/read_ref ʹÿɱݿڿļӳʧʱ
+	 * ԰ͨʽ
+	 * @param path {const char*} ļ
+	 * @return {bool} ļǷɹ
+	 */
+	bool open_mmap(const char* path);
+
+	/**
+	 * ǰļǷڴӳģʽ
+	 * @return {bool}
+	 */
+	bool mapped(void) const;
+
 	/**
 	 * Ӵ򿪵ļмظļеݵûָ
 	 * @param s {string*} û
@@ -6,6 +6,7 @@
 namespace acl {
 
 class string;
+class string_view;
 
 /**
  * ࣬ȷ֪Ƿرջļ
@@ -126,6 +127,26 @@ public:
 	bool gets(string& s, bool nonl = true, size_t max = 0);
 	bool gets(string* s, bool nonl = true, size_t max = 0);
 
+	/**
+	 * жһݣݲline ֱеݣ
+	 * ´ζǰЧڲڴӳ䷽ʽ򿪵ļ(
+	 * ifstream::open_mmap)line ӳеݣرǰһֱЧ
+	 * @param line {string_view&} 洢е
+	 * @param nonl {bool} Ƿȥβ "\r\n"  "\n"
+	 * @return {bool} ǷݣһݳȻļ
+	 *  һв "\n" ʱҲ trueͨ line ĳжǷΪ
+	 */
+	bool gets_ref(string_view& line, bool nonl = true);
+
+	/**
+	 * жȡ max ֽڵݣݲõЧͬ
+	 * gets_ref
+	 * @param data {string_view&} 洢ݵ
+	 * @param max {size_t} ȡֽ
+	 * @return {bool} Ƿ
+	 */
+	bool read_ref(string_view& data, size_t max);
+
 	/**
 	 * жֱҪַΪָݣ
 	 * ȡݵ󲿷ӦǸַ
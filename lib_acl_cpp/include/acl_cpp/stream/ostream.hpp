@@ -52,6 +52,19 @@ public:
 	 */
 	int writev(const struct iovec *v, int count, bool loop = true);
 
+	/**
+	 * 㿽ʽ׷Уڵ fflush ʱд
+	 * еһ writev ʽдСݻᱻд
+	 * @param data {const void*} ݵַдǰ뱣Ч
+	 * @param size {size_t} data ݳ(ֽ)
+	 * @param free_fn {void (*)(void*)} дͷźǿʱ
+	 *  ctx Ϊ
+	 * @param ctx {void*} ݸ free_fn Ĳ
+	 * @return {int}  size -1 ʾ
+	 */
+	int chain_write(const void* data, size_t size,
+		void (*free_fn)(void*) = NULL, void* ctx = NULL);
+
 	/**
 	 * ʽʽдݣ vfprintf֤ȫд
 	 * @param fmt {const char*} ʽַ
@@ -2,12 +2,17 @@
 #include <assert.h>
 #include "lib_acl.h"
 #include "acl_cpp/stream/aio_handle.hpp"
+#include "acl_cpp/stream/aio_handle_group.hpp"
 #include "acl_cpp/stream/aio_istream.hpp"
 #include "acl_cpp/stream/aio_listen_stream.hpp"
 #include "acl_cpp/stream/aio_socket_stream.hpp"
 
 using namespace acl;
 
+static bool __use_cork = false;
+static int  __water_high = 0;
+static int  __write_limit = 0;
+
 /**
  * 첽ͻĻص
  */
@@ -32,6 +37,14 @@ public:
 	 */
 	bool read_callback(char* data, int len)
 	{
+		// дϲģʽ·ֶдݽڱ¼ѭʱһη
+		if (__use_cork)
+		{
+			client_->write(data, len);
+			client_->write("\r\n", 2);
+			return true;
+		}
+
 		string buf;
 		buf.copy(data, len);
 
@@ -53,6 +66,21 @@ public:
 		return true;
 	}
 
+	/**
+	 * ʵָе麯ддﵽˮλʱͣͻݣˮλ
+	 * ʱָӶֹݵĿͻʹд
+	 * @param high {bool} Ƿﵽˮλ
+	 * @return {bool}  true ʾϣرո첽
+	 */
+	bool write_water_callback(bool high)
+	{
+		if (high)
+			client_->disable_read();
+		else
+			client_->read(6);
+		return true;
+	}
+
 	/**
 	 * ʵָе麯ͻĳʱص
 	 */
@@ -111,6 +139,15 @@ public:
 		client->add_timeout_callback(callback);
 
 		// 첽
+		if (__use_cork)
+			client->set_cork(true);
+
+		// деĸߵˮλ
+		if (__water_high > 0)
+			client->set_water(__water_high / 2, __water_high);
+		if (__write_limit > 0)
+			client->set_write_limit(__write_limit);
+
 		client->read(6);
 		return true;
 	}
@@ -118,15 +155,21 @@ public:
 
 static void usage(const char* procname)
 {
-	printf("usage: %s -h[help] -k[use kernel event: epoll/iocp/kqueue/devpool]\n", procname);
+	printf("usage: %s -h[help] -k[use kernel event: epoll/iocp/kqueue/devpool]\n"
+		" -t threads[handle connections in N aio threads, default: 0]\n"
+		" -L[dispatch connections by least load, default: round robin]\n"
+		" -C[enable cork mode to coalesce the writes]\n"
+		" -W high_water[pause reading when the queued data reaches it]\n"
+		" -M write_limit[close the client when the queued data exceeds it]\n",
+		procname);
 }
 
 int main(int argc, char* argv[])
 {
-	bool use_kernel = true;
-	int  ch;
+	bool use_kernel = true, least_load = false;
+	int  ch, nthreads = 0;
 
-	while ((ch = getopt(argc, argv, "hk")) > 0)
+	while ((ch = getopt(argc, argv, "hkt:LCW:M:")) > 0)
 	{
 		switch (ch)
 		{
@@ -136,6 +179,21 @@ int main(int argc, char* argv[])
 		case 'k':
 			use_kernel = true;
 			break;
+		case 't':
+			nthreads = atoi(optarg);
+			break;
+		case 'L':
+			least_load = true;
+			break;
+		case 'C':
+			__use_cork = true;
+			break;
+		case 'W':
+			__water_high = atoi(optarg);
+			break;
+		case 'M':
+			__write_limit = atoi(optarg);
+			break;
 		default:
 			break;
 		}
@@ -146,6 +204,18 @@ int main(int argc, char* argv[])
 
 	// 첽
 	aio_listen_stream* sstream = new aio_listen_stream(&handle);
+
+	// ߳ģʽ£¼еĸ̴߳
+	aio_handle_group* group = NULL;
+	if (nthreads > 0)
+	{
+		group = new aio_handle_group(nthreads,
+			use_kernel ? ENGINE_KERNEL : ENGINE_SELECT);
+		if (least_load)
+			group->set_dispatch(AIO_DISPATCH_LEAST_LOAD);
+		group->start();
+		sstream->set_group(group);
+	}
 	const char* addr = "127.0.0.1:9001";
 
 	// ʼACL(WIN32һҪô˺UNIXƽ̨¿ɲ)
@@ -184,5 +254,6 @@ int main(int argc, char* argv[])
 	// XXX: Ϊ˱֤ܹرռӦڴ˴ check һ
 	handle.check();
 
+	delete group;
 	return 0;
 }
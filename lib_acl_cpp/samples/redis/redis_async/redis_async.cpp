@@ -0,0 +1,214 @@
+#include "stdafx.h"
+
+static acl::string __keypre("test_key");
+static int __nresult = 0;
+static int __nerror  = 0;
+
+// SET Ľص󣬿ɱ
+class set_callback : public acl::redis_async_callback
+{
+public:
+	set_callback(void) {}
+	~set_callback(void) {}
+
+protected:
+	// @override
+	void on_result(const acl::redis_result* result)
+	{
+		__nresult++;
+
+		const char* status = result ? result->get_status() : NULL;
+		if (status == NULL || strcasecmp(status, "OK") != 0)
+		{
+			__nerror++;
+			printf("set error: %s\r\n",
+				result ? result->get_error() : "null");
+		}
+	}
+};
+
+// GET Ľصÿһڼ
+class get_callback : public acl::redis_async_callback
+{
+public:
+	get_callback(int i) : i_(i) {}
+	~get_callback(void) {}
+
+protected:
+	// @override
+	void on_result(const acl::redis_result* result)
+	{
+		__nresult++;
+
+		acl::string key, value, buf;
+		key.format("%s_%d", __keypre.c_str(), i_);
+		value.format("value_%s", key.c_str());
+
+		if (result != NULL)
+			result->argv_to_string(buf);
+		if (buf != value)
+		{
+			__nerror++;
+			printf("get %s error: %s\r\n", key.c_str(), buf.c_str());
+		}
+		else if (i_ < 10)
+			printf("get %s: %s\r\n", key.c_str(), buf.c_str());
+
+		delete this;
+	}
+
+private:
+	int i_;
+};
+
+static void wait_results(acl::aio_handle& handle,
+	acl::redis_async_client& client, int n)
+{
+	// ûеȴӦʱ˵ʧܶδ
+	while (__nresult < n && client.get_pending() > 0)
+		handle.check();
+}
+
+static bool test_set(acl::aio_handle& handle,
+	acl::redis_async_client& client, int n)
+{
+	acl::redis_string redis;
+	set_callback callback;
+	redis.set_async(&client, &callback);
+
+	acl::string key, value;
+	__nresult = __nerror = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		key.format("%s_%d", __keypre.c_str(), i);
+		value.format("value_%s", key.c_str());
+		redis.set(key.c_str(), value.c_str());
+	}
+
+	printf("pending: %d\r\n", (int) client.get_pending());
+	wait_results(handle, client, n);
+	printf("set %d keys, result: %d, error: %d\r\n",
+		n, __nresult, __nerror);
+	return __nresult == n && __nerror == 0;
+}
+
+static bool test_get(acl::aio_handle& handle,
+	acl::redis_async_client& client, int n)
+{
+	acl::redis_string redis;
+	acl::string key, buf;
+	__nresult = __nerror = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		key.format("%s_%d", __keypre.c_str(), i);
+		redis.set_async(&client, new get_callback(i));
+		redis.get(key.c_str(), buf);
+	}
+
+	wait_results(handle, client, n);
+	printf("get %d keys, result: %d, error: %d\r\n",
+		n, __nresult, __nerror);
+	return __nresult == n && __nerror == 0;
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379]\r\n"
+		"-n count[default: 10000]\r\n"
+		"-m max connections[default: 2]\r\n"
+		"-C connect_timeout[default: 10]\r\n"
+		"-I rw_timeout[default: 10]\r\n"
+		"-P password\r\n"
+		"-a cmd[set|get|all]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 10000, max_conns = 2, conn_timeout = 10, rw_timeout = 10;
+	acl::string addr("127.0.0.1:6379"), cmd("all"), passwd;
+
+	while ((ch = getopt(argc, argv, "hs:n:m:C:I:P:a:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'm':
+			max_conns = atoi(optarg);
+			break;
+		case 'C':
+			conn_timeout = atoi(optarg);
+			break;
+		case 'I':
+			rw_timeout = atoi(optarg);
+			break;
+		case 'P':
+			passwd = optarg;
+			break;
+		case 'a':
+			cmd = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::aio_handle handle(acl::ENGINE_KERNEL);
+	acl::redis_async_client* client = new acl::redis_async_client(handle,
+		addr, (size_t) max_conns, conn_timeout, rw_timeout);
+	if (!passwd.empty())
+		client->set_password(passwd);
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	bool ret;
+
+	if (cmd == "set")
+		ret = test_set(handle, *client, n);
+	else if (cmd == "get")
+		ret = test_get(handle, *client, n);
+	else if (cmd == "all")
+		ret = test_set(handle, *client, n)
+			&& test_get(handle, *client, n);
+	else
+	{
+		ret = false;
+		printf("unknown cmd: %s\r\n", cmd.c_str());
+	}
+
+	gettimeofday(&end, NULL);
+	double spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+	printf("spent: %.2f ms\r\n", spent);
+
+	if (ret == true)
+		printf("test OK!\r\n");
+	else
+		printf("test failed!\r\n");
+
+	delete client;
+
+	// 첽¼ѭбͷ
+	handle.check();
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return 0;
+}
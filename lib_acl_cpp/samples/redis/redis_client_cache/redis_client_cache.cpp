@@ -0,0 +1,174 @@
+#include "stdafx.h"
+
+// ʹÿͻ˻ȡ redis ݣ redis_client_cache ظȡ
+// ͬļֱбػ棻һԵ޸Щredis-server 
+// ʧЧ֪ͨʹܶµֵ
+
+static double stamp_sub(const struct timeval& end, const struct timeval& begin)
+{
+	return (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+}
+
+static bool test(acl::redis_client& reader, acl::redis_client& writer,
+	int nkeys, int loop, int inter)
+{
+	acl::redis_string rstr(&reader), wstr(&writer);
+	acl::redis_hash rhash(&reader), whash(&writer);
+	std::vector<int> versions(nkeys, 0);
+	acl::string key, value, expect;
+
+	for (int i = 0; i < nkeys; i++)
+	{
+		key.format("cache_key_%d", i);
+		value.format("value_%d_0", i);
+		wstr.clear();
+		if (wstr.set(key, value) == false)
+		{
+			printf("set %s error: %s\r\n", key.c_str(),
+				wstr.result_error());
+			return false;
+		}
+	}
+
+	whash.clear();
+	if (whash.hset("cache_hash", "name", "value_0") < 0)
+	{
+		printf("hset error: %s\r\n", whash.result_error());
+		return false;
+	}
+
+	for (int i = 0; i < loop; i++)
+	{
+		int n = i % nkeys;
+		key.format("cache_key_%d", n);
+
+		// Եһ޸ļֵӽյʧЧ֪ͨ
+		if (inter > 0 && i > 0 && i % inter == 0)
+		{
+			value.format("value_%d_%d", n, ++versions[n]);
+			wstr.clear();
+			if (wstr.set(key, value) == false)
+			{
+				printf("set %s error: %s\r\n", key.c_str(),
+					wstr.result_error());
+				return false;
+			}
+		}
+
+		value.clear();
+		rstr.clear();
+		if (rstr.get(key, value) == false)
+		{
+			printf("get %s error: %s\r\n", key.c_str(),
+				rstr.result_error());
+			return false;
+		}
+
+		expect.format("value_%d_%d", n, versions[n]);
+		if (value != expect)
+		{
+			printf("get %s: %s, expect: %s\r\n", key.c_str(),
+				value.c_str(), expect.c_str());
+			return false;
+		}
+
+		value.clear();
+		rhash.clear();
+		if (rhash.hget("cache_hash", "name", value) == false)
+		{
+			printf("hget error: %s\r\n", rhash.result_error());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[default: 127.0.0.1:6379]\r\n"
+		"-n loop count[default: 10000]\r\n"
+		"-k key count[default: 100]\r\n"
+		"-m max cached values[default: 10000]\r\n"
+		"-i modify one key every i loops, 0 means never[default: 100]\r\n"
+		"-N [without client side caching]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, loop = 10000, nkeys = 100, max_count = 10000, inter = 100;
+	bool use_cache = true;
+	acl::string addr("127.0.0.1:6379");
+
+	while ((ch = getopt(argc, argv, "hs:n:k:m:i:N")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			loop = atoi(optarg);
+			break;
+		case 'k':
+			nkeys = atoi(optarg);
+			if (nkeys <= 0)
+				nkeys = 1;
+			break;
+		case 'm':
+			max_count = atoi(optarg);
+			break;
+		case 'i':
+			inter = atoi(optarg);
+			break;
+		case 'N':
+			use_cache = false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::redis_client_cache cache((size_t) max_count);
+	acl::redis_client reader(addr.c_str(), 10, 10);
+	acl::redis_client writer(addr.c_str(), 10, 10);
+
+	// ڽʱʹ RESP3 Э鲢 CLIENT TRACKING
+	if (use_cache)
+	{
+		reader.set_protocol(3);
+		reader.set_cache(&cache);
+	}
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	bool ret = test(reader, writer, nkeys, loop, inter);
+
+	gettimeofday(&end, NULL);
+	double spent = stamp_sub(end, begin);
+
+	printf("cache: %s, protocol: %d, loop: %d, spent: %.2f ms, "
+		"speed: %.2f/s\r\n", use_cache ? "on" : "off",
+		reader.get_protocol(), loop, spent,
+		loop * 1000 / (spent > 0 ? spent : 1));
+	printf("hits: %lld, misses: %lld, invalidations: %lld, cached: %d\r\n",
+		cache.get_hits(), cache.get_misses(),
+		cache.get_invalidations(), (int) cache.size());
+	printf("test %s!\r\n", ret ? "OK" : "failed");
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return ret ? 0 : 1;
+}
@@ -236,6 +236,11 @@ static void usage(const char* procname)
 		"-r retry_for_cluster_resnum[default: 10]\r\n"
 		"-p [preset all hash-slots of the cluster]\r\n"
 		"-P password [set the password of redis cluster]\r\n"
+		"-R read_policy[master|rr|latency|zone, default: master, used with -p]\r\n"
+		"-Z local_zone[used with -R zone]\r\n"
+		"-z node_addr:zone[such as 127.0.0.1:6380:z1, used with -R zone]\r\n"
+		"-F refresh_inter[refresh hash-slots in background, default: 0 means never, used with -p]\r\n"
+		"-M moved_limit[refresh at once when MOVED reach it in one second, default: 10]\r\n"
 		"-a cmd[set|get|expire|ttl|exists|type|del]\r\n",
 		procname);
 }
@@ -245,9 +250,12 @@ int main(int argc, char* argv[])
 	int  ch, n = 1, conn_timeout = 10, rw_timeout = 10;
 	int  max_threads = 10, nsleep = 500, nretry = 10;
 	acl::string addrs("127.0.0.1:6379"), cmd, passwd;
+	acl::string policy("master"), zone;
+	std::vector<acl::string> zones;
 	bool preset = false;
+	int  refresh_inter = 0, moved_limit = 10;
 
-	while ((ch = getopt(argc, argv, "hs:n:C:I:c:a:w:r:pP:")) > 0)
+	while ((ch = getopt(argc, argv, "hs:n:C:I:c:a:w:r:pP:R:Z:z:F:M:")) > 0)
 	{
 		switch (ch)
 		{
@@ -284,6 +292,21 @@ int main(int argc, char* argv[])
 		case 'P':
 			passwd = optarg;
 			break;;
+		case 'R':
+			policy = optarg;
+			break;
+		case 'Z':
+			zone = optarg;
+			break;
+		case 'z':
+			zones.push_back(optarg);
+			break;
+		case 'F':
+			refresh_inter = atoi(optarg);
+			break;
+		case 'M':
+			moved_limit = atoi(optarg);
+			break;
 		default:
 			break;
 		}
@@ -311,12 +334,38 @@ int main(int argc, char* argv[])
 	if (passwd.empty() == false)
 		cluster.set_password("default", passwd.c_str());
 
+	// ֻĽѡԣ set_all_slot ǰãԱΪӽ
+	// ӳأӽӽᷢ READONLY 
+	if (policy == "rr")
+		cluster.set_read_policy(acl::REDIS_READ_ROUND_ROBIN);
+	else if (policy == "latency")
+		cluster.set_read_policy(acl::REDIS_READ_LATENCY);
+	else if (policy == "zone")
+		cluster.set_read_policy(acl::REDIS_READ_ZONE);
+
+	// ȶ뱾ͻͬĴӽ
+	if (!zone.empty())
+		cluster.set_local_zone(zone);
+	for (std::vector<acl::string>::iterator it = zones.begin();
+		it != zones.end(); ++it)
+	{
+		char* ptr = strrchr(it->c_str(), ':');
+		if (ptr == NULL || ptr == it->c_str())
+			continue;
+		*ptr++ = 0;
+		cluster.set_zone(it->c_str(), ptr);
+	}
+
 	// ǷҪйϣ۵ĶӦϵǰúãȥʱ̬
 	// ϣ۵Ḷ́ӶʱЧ
 	if (preset)
 	{
 		const std::vector<acl::string>& token = addrs.split2(",; \t");
 		cluster.set_all_slot(token[0], max_threads);
+
+		// ̶̨߳ˢ¹ϣӳMOVED ʱˢ
+		if (refresh_inter > 0)
+			cluster.start_refresher(refresh_inter, moved_limit);
 	}
 
 	struct timeval begin;
@@ -364,6 +413,9 @@ int main(int argc, char* argv[])
 	double inter = util::stamp_sub(&end, &begin);
 	printf("total %s: %lld, spent: %0.2f ms, speed: %0.2f\r\n", cmd.c_str(),
 		total, inter, (total * 1000) /(inter > 0 ? inter : 1));
+	printf("moved: %lld, ask: %lld, refresh: %lld, changed: %lld\r\n",
+		cluster.get_moved_count(), cluster.get_ask_count(),
+		cluster.get_refresh_count(), cluster.get_change_count());
 
 #ifdef WIN32
 	printf("enter any key to exit\r\n");
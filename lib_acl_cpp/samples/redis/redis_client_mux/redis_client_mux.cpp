@@ -0,0 +1,235 @@
+#include "stdafx.h"
+#include <algorithm>
+
+// Ƚַʽ´̷߳ͬһ redis ʱӳټ
+// 1ӳطʽÿִ߳ʱռӳеһ
+// 2·÷ʽ̹߳ӣ󱻺ϲԹܵʽ
+
+static double stamp_sub(const struct timeval& end, const struct timeval& begin)
+{
+	return (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+}
+
+class test_thread : public acl::thread
+{
+public:
+	test_thread(acl::redis_client_pool& pool, bool use_mux, int id, int n)
+	: pool_(pool), use_mux_(use_mux), id_(id), n_(n), failed_(0)
+	{
+		latencies_.reserve(n);
+	}
+
+	~test_thread(void) {}
+
+	const std::vector<double>& get_latencies(void) const
+	{
+		return latencies_;
+	}
+
+	int get_failed(void) const
+	{
+		return failed_;
+	}
+
+protected:
+	// @override
+	void* run(void)
+	{
+		acl::redis_string cmd;
+		acl::string key, value, buf;
+		struct timeval begin, end;
+
+		if (use_mux_)
+			cmd.set_mux(pool_.get_mux());
+
+		for (int i = 0; i < n_; i++)
+		{
+			key.format("mux_key_%d_%d", id_, i % 100);
+			value.format("value_%d", i);
+
+			gettimeofday(&begin, NULL);
+
+			// ӳطʽÿӳȡһ
+			acl::redis_client* conn = NULL;
+			if (!use_mux_)
+			{
+				conn = (acl::redis_client*) pool_.peek();
+				if (conn == NULL)
+				{
+					failed_++;
+					continue;
+				}
+				cmd.set_client(conn);
+			}
+
+			cmd.clear();
+			bool ok = (i & 1) ? cmd.get(key, buf) : cmd.set(key, value);
+
+			if (conn != NULL)
+				pool_.put(conn, !cmd.eof());
+
+			gettimeofday(&end, NULL);
+
+			if (ok)
+				latencies_.push_back(stamp_sub(end, begin));
+			else
+				failed_++;
+			buf.clear();
+		}
+
+		return NULL;
+	}
+
+private:
+	acl::redis_client_pool& pool_;
+	bool use_mux_;
+	int  id_;
+	int  n_;
+	int  failed_;
+	std::vector<double> latencies_;
+};
+
+static void test(const char* addr, bool use_mux, int nthreads, int n,
+	int nconns, int batch_max, int inflight_max)
+{
+	// ӳطʽƣÿ̸߳Զռһ
+	acl::redis_client_pool pool(addr, use_mux ? 1 : nthreads);
+	pool.set_timeout(10, 10);
+
+	if (use_mux)
+	{
+		pool.set_multiplex((size_t) nconns);
+		pool.get_mux()->set_batch_max((size_t) batch_max)
+			.set_inflight_max((size_t) inflight_max);
+	}
+
+	std::vector<test_thread*> threads;
+	for (int i = 0; i < nthreads; i++)
+	{
+		test_thread* thread = new test_thread(pool, use_mux, i, n);
+		thread->set_detachable(false);
+		threads.push_back(thread);
+	}
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	for (std::vector<test_thread*>::iterator it = threads.begin();
+		it != threads.end(); ++it)
+	{
+		(*it)->start();
+	}
+
+	std::vector<double> all;
+	int failed = 0;
+
+	for (std::vector<test_thread*>::iterator it = threads.begin();
+		it != threads.end(); ++it)
+	{
+		(*it)->wait();
+		const std::vector<double>& lat = (*it)->get_latencies();
+		all.insert(all.end(), lat.begin(), lat.end());
+		failed += (*it)->get_failed();
+		delete *it;
+	}
+
+	gettimeofday(&end, NULL);
+	double spent = stamp_sub(end, begin);
+
+	std::sort(all.begin(), all.end());
+	double avg = 0;
+	for (size_t i = 0; i < all.size(); i++)
+		avg += all[i];
+	if (!all.empty())
+		avg /= all.size();
+
+#define	PCT(p) (all.empty() ? 0 : all[(size_t) ((all.size() - 1) * (p))])
+
+	printf("%-5s conns: %d, threads: %d, ok: %d, failed: %d, "
+		"spent: %.2f ms, speed: %.2f/s\r\n", use_mux ? "mux" : "pool",
+		use_mux ? nconns : (int) pool.get_count(), nthreads,
+		(int) all.size(), failed, spent,
+		all.size() * 1000 / (spent > 0 ? spent : 1));
+	printf("      latency(ms) avg: %.3f, p50: %.3f, p99: %.3f, "
+		"max: %.3f\r\n", avg, PCT(0.5), PCT(0.99), PCT(1.0));
+
+	if (use_mux)
+	{
+		acl::redis_client_mux* mux = pool.get_mux();
+		printf("      requests: %lld, batches: %lld, "
+			"requests per batch: %.2f\r\n",
+			mux->get_requests(), mux->get_batches(),
+			mux->get_batches() > 0 ? (double) mux->get_requests()
+				/ mux->get_batches() : 0.0);
+	}
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[default: 127.0.0.1:6379]\r\n"
+		"-c max_threads[default: 100]\r\n"
+		"-n loop count of each thread[default: 1000]\r\n"
+		"-m shared connections in multiplexing mode[default: 2]\r\n"
+		"-b max requests coalesced in one write[default: 128]\r\n"
+		"-i max batches in flight on one connection[default: 1]\r\n"
+		"-M mode[pool|mux|both, default: both]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, nthreads = 100, n = 1000, nconns = 2, batch_max = 128;
+	int  inflight_max = 1;
+	acl::string addr("127.0.0.1:6379"), mode("both");
+
+	while ((ch = getopt(argc, argv, "hs:c:n:m:b:i:M:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'c':
+			nthreads = atoi(optarg);
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'm':
+			nconns = atoi(optarg);
+			break;
+		case 'b':
+			batch_max = atoi(optarg);
+			break;
+		case 'i':
+			inflight_max = atoi(optarg);
+			break;
+		case 'M':
+			mode = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	if (mode == "pool" || mode == "both")
+		test(addr, false, nthreads, n, nconns, batch_max,
+			inflight_max);
+	if (mode == "mux" || mode == "both")
+		test(addr, true, nthreads, n, nconns, batch_max,
+			inflight_max);
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return 0;
+}
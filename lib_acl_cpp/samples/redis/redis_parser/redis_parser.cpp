@@ -0,0 +1,313 @@
+#include "stdafx.h"
+
+// ջСʣռ䣬ͬ redis_client ڲ
+#define RBUF_MIN	1024
+
+static void append_bulk(acl::string& out, const acl::string& data)
+{
+	out.format_append("$%d\r\n", (int) data.size());
+	out.append(data);
+	out.append("\r\n");
+}
+
+//  LRANGE Ӧ n Ϊ len ݿ
+static void build_lrange(acl::string& out, int n, int len)
+{
+	acl::string value;
+	out.format("*%d\r\n", n);
+	for (int i = 0; i < n; i++)
+	{
+		value.format("value_%d_", i);
+		while ((int) value.size() < len)
+			value.append("x");
+		append_bulk(out, value);
+	}
+}
+
+//  HGETALL Ӧ n ֵֶֶ
+static void build_hgetall(acl::string& out, int n, int len)
+{
+	acl::string name, value;
+	out.format("*%d\r\n", n * 2);
+	for (int i = 0; i < n; i++)
+	{
+		name.format("field_%d", i);
+		append_bulk(out, name);
+		value.format("value_%d_", i);
+		while ((int) value.size() < len)
+			value.append("x");
+		append_bulk(out, value);
+	}
+}
+
+static double stamp_sub(const struct timeval& end, const struct timeval& begin)
+{
+	return (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+}
+
+// ʽÿα̶Ļемݿ鿽
+// ڴ
+static size_t parse_copy(acl::dbuf_pool* dbuf, const acl::string& data,
+	size_t chunk)
+{
+	char* buf = (char*) dbuf->dbuf_alloc(chunk);
+	const char* ptr = data.c_str();
+	size_t left = data.size();
+	acl::redis_parser parser;
+
+	parser.reset(dbuf);
+
+	while (left > 0 && !parser.finished())
+	{
+		size_t n = left > chunk ? chunk : left;
+		memcpy(buf, ptr, n);	// ģ
+		ptr  += n;
+		left -= n;
+
+		if (parser.update(buf, n) < 0)
+			return 0;
+	}
+
+	const acl::redis_result* result = parser.get_result();
+	return result ? result->get_size() : 0;
+}
+
+// 㿽ʽͬ redis_clientݱڴϷĽջУ
+// ֱемݿ
+static size_t parse_inplace(acl::dbuf_pool* dbuf, const acl::string& data,
+	size_t chunk)
+{
+	const char* ptr = data.c_str();
+	size_t left = data.size();
+	char*  rbuf = NULL;
+	size_t rbuf_size = 0, rbuf_off = 0, rbuf_len = 0;
+	acl::redis_parser parser;
+
+	parser.reset(dbuf);
+
+	while (true)
+	{
+		if (rbuf_off < rbuf_len)
+		{
+			int n = parser.update_inplace(rbuf + rbuf_off,
+					rbuf_len - rbuf_off);
+			if (n < 0)
+				return 0;
+			rbuf_off += (size_t) n;
+			if (parser.finished())
+				break;
+		}
+
+		if (left == 0)
+			return 0;
+
+		size_t remain = rbuf_len - rbuf_off;
+		size_t want = parser.get_want();
+		if (want < remain + RBUF_MIN)
+			want = remain + RBUF_MIN;
+
+		if (rbuf == NULL || rbuf_size - rbuf_off < want)
+		{
+			size_t size = want > chunk ? want : chunk;
+			char* buf = (char*) dbuf->dbuf_alloc(size);
+			if (remain > 0)
+				memcpy(buf, rbuf + rbuf_off, remain);
+			rbuf      = buf;
+			rbuf_size = size;
+			rbuf_off  = 0;
+			rbuf_len  = remain;
+		}
+
+		size_t n = rbuf_size - rbuf_len;
+		if (n > left)
+			n = left;
+		memcpy(rbuf + rbuf_len, ptr, n);	// ģ
+		rbuf_len += n;
+		ptr      += n;
+		left     -= n;
+	}
+
+	const acl::redis_result* result = parser.get_result();
+	return result ? result->get_size() : 0;
+}
+
+static void bench_parser(const char* name, const acl::string& data,
+	size_t chunk, int loop)
+{
+	struct timeval begin, end;
+	size_t n1 = 0, n2 = 0;
+	acl::dbuf_pool* dbuf = new acl::dbuf_pool;
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < loop; i++)
+	{
+		n1 = parse_copy(dbuf, data, chunk);
+		dbuf->dbuf_reset();
+	}
+	gettimeofday(&end, NULL);
+	double copy_spent = stamp_sub(end, begin);
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < loop; i++)
+	{
+		n2 = parse_inplace(dbuf, data, chunk);
+		dbuf->dbuf_reset();
+	}
+	gettimeofday(&end, NULL);
+	double inplace_spent = stamp_sub(end, begin);
+
+	dbuf->destroy();
+
+	double mb = (double) data.size() * loop / (1024 * 1024);
+	printf("%s: %d bytes, %d elements, loop: %d\r\n", name,
+		(int) data.size(), (int) n1, loop);
+	printf("  copy:    %.2f ms, %.2f MB/s\r\n", copy_spent,
+		copy_spent > 0 ? mb * 1000 / copy_spent : 0);
+	printf("  inplace: %.2f ms, %.2f MB/s%s\r\n", inplace_spent,
+		inplace_spent > 0 ? mb * 1000 / inplace_spent : 0,
+		n1 == n2 ? "" : ", result mismatched!");
+}
+
+// ͨ redis_client ȡʵ redis-server ĴӦ
+static void bench_server(const char* addr, int n, int len, int loop)
+{
+	acl::redis_client client(addr, 10, 10);
+	acl::redis cmd(&client);
+	const char* lkey = "redis_parser_list", *hkey = "redis_parser_hash";
+	acl::string value;
+
+	cmd.del_one(lkey);
+	cmd.del_one(hkey);
+
+	for (int i = 0; i < n; i++)
+	{
+		value.format("value_%d_", i);
+		while ((int) value.size() < len)
+			value.append("x");
+
+		acl::string name;
+		name.format("field_%d", i);
+
+		cmd.clear();
+		cmd.rpush(lkey, value.c_str(), NULL);
+		cmd.clear();
+		cmd.hset(hkey, name.c_str(), value.c_str());
+	}
+
+	struct timeval begin, end;
+	std::vector<acl::string> list;
+	std::map<acl::string, acl::string> hash;
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < loop; i++)
+	{
+		list.clear();
+		cmd.clear();
+		if (cmd.lrange(lkey, 0, -1, &list) == false)
+		{
+			printf("lrange error: %s\r\n", cmd.result_error());
+			break;
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("server lrange: %d elements, loop: %d, spent: %.2f ms\r\n",
+		(int) list.size(), loop, stamp_sub(end, begin));
+
+	gettimeofday(&begin, NULL);
+	for (int i = 0; i < loop; i++)
+	{
+		hash.clear();
+		cmd.clear();
+		if (cmd.hgetall(hkey, hash) == false)
+		{
+			printf("hgetall error: %s\r\n", cmd.result_error());
+			break;
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("server hgetall: %d fields, loop: %d, spent: %.2f ms\r\n",
+		(int) hash.size(), loop, stamp_sub(end, begin));
+
+	cmd.clear();
+	cmd.del_one(lkey);
+	cmd.clear();
+	cmd.del_one(hkey);
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-n elements count[default: 10000]\r\n"
+		"-l value length[default: 64]\r\n"
+		"-c read chunk size[default: 16384]\r\n"
+		"-k loop count[default: 100]\r\n"
+		"-s redis_addr[if set, also read from redis-server]\r\n"
+		"-a cmd[lrange|hgetall|all]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 10000, len = 64, chunk = 16384, loop = 100;
+	acl::string addr, cmd("all");
+
+	while ((ch = getopt(argc, argv, "hn:l:c:k:s:a:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'l':
+			len = atoi(optarg);
+			break;
+		case 'c':
+			chunk = atoi(optarg);
+			break;
+		case 'k':
+			loop = atoi(optarg);
+			break;
+		case 's':
+			addr = optarg;
+			break;
+		case 'a':
+			cmd = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (chunk < RBUF_MIN * 2)
+		chunk = RBUF_MIN * 2;
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::string data;
+
+	if (cmd == "lrange" || cmd == "all")
+	{
+		build_lrange(data, n, len);
+		bench_parser("lrange", data, (size_t) chunk, loop);
+	}
+
+	if (cmd == "hgetall" || cmd == "all")
+	{
+		build_hgetall(data, n, len);
+		bench_parser("hgetall", data, (size_t) chunk, loop);
+	}
+
+	if (!addr.empty())
+		bench_server(addr, n, len, loop);
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return 0;
+}
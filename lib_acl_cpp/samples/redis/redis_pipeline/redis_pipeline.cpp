@@ -0,0 +1,242 @@
+#include "stdafx.h"
+
+static acl::string __keypre("test_key");
+
+// Թܵʽÿ batch  SET 
+static bool test_set(acl::redis_pipeline& pipeline, int n, int batch)
+{
+	acl::redis_string redis;
+	redis.set_pipeline(&pipeline);
+
+	acl::string key, value;
+
+	for (int i = 0; i < n;)
+	{
+		pipeline.clear();
+		for (int j = 0; j < batch && i < n; j++, i++)
+		{
+			key.format("%s_%d", __keypre.c_str(), i);
+			value.format("value_%s", key.c_str());
+			redis.set(key.c_str(), value.c_str());
+		}
+
+		if (pipeline.exec() == false)
+		{
+			printf("exec error, i: %d\r\n", i);
+			return false;
+		}
+
+		for (size_t k = 0; k < pipeline.size(); k++)
+		{
+			const acl::redis_result* result = pipeline.get_result(k);
+			const char* status = result->get_status();
+			if (status == NULL || strcasecmp(status, "OK") != 0)
+			{
+				printf("set error: %s\r\n", result->get_error());
+				return false;
+			}
+		}
+	}
+
+	printf("set %d keys ok\r\n", n);
+	return true;
+}
+
+// Թܵʽÿ batch  GET 
+static bool test_get(acl::redis_pipeline& pipeline, int n, int batch)
+{
+	acl::redis_string redis;
+	redis.set_pipeline(&pipeline);
+
+	acl::string key, value, buf;
+
+	for (int i = 0; i < n;)
+	{
+		int begin = i;
+
+		pipeline.clear();
+		for (int j = 0; j < batch && i < n; j++, i++)
+		{
+			key.format("%s_%d", __keypre.c_str(), i);
+			redis.get(key.c_str(), buf);
+		}
+
+		if (pipeline.exec() == false)
+		{
+			printf("exec error, i: %d\r\n", i);
+			return false;
+		}
+
+		for (size_t k = 0; k < pipeline.size(); k++)
+		{
+			const acl::redis_result* result = pipeline.get_result(k);
+			key.format("%s_%d", __keypre.c_str(), begin + (int) k);
+			value.format("value_%s", key.c_str());
+			buf.clear();
+			result->argv_to_string(buf);
+			if (buf != value)
+			{
+				printf("get %s error: %s\r\n", key.c_str(),
+					buf.c_str());
+				return false;
+			}
+			if (begin + k < 10)
+				printf("get %s: %s\r\n", key.c_str(), buf.c_str());
+		}
+	}
+
+	printf("get %d keys ok\r\n", n);
+	return true;
+}
+
+// ϶Ķһܵ
+static bool test_mix(acl::redis_pipeline& pipeline, int n)
+{
+	acl::redis_string string_cmd;
+	acl::redis_hash hash_cmd;
+	acl::redis_key key_cmd;
+
+	string_cmd.set_pipeline(&pipeline);
+	hash_cmd.set_pipeline(&pipeline);
+	key_cmd.set_pipeline(&pipeline);
+
+	acl::string key;
+	pipeline.clear();
+
+	for (int i = 0; i < n; i++)
+	{
+		key.format("%s_hash_%d", __keypre.c_str(), i);
+		hash_cmd.hset(key.c_str(), "name", "value");
+		string_cmd.incr("test_counter");
+		key_cmd.del_one(key.c_str());
+	}
+
+	if (pipeline.exec() == false)
+	{
+		printf("exec error\r\n");
+		return false;
+	}
+
+	acl::string buf;
+	for (size_t k = 0; k < pipeline.size(); k++)
+	{
+		const acl::redis_result* result = pipeline.get_result(k);
+		buf.clear();
+		result->to_string(buf);
+		if (k < 12)
+			printf("result %d: type: %d, %s\r\n",
+				(int) k, result->get_type(), buf.c_str());
+	}
+
+	printf("mix %d commands ok\r\n", (int) pipeline.size());
+	return true;
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[127.0.0.1:6379]\r\n"
+		"-n count[default: 1000]\r\n"
+		"-b batch size of one pipeline[default: 100]\r\n"
+		"-C connect_timeout[default: 10]\r\n"
+		"-I rw_timeout[default: 10]\r\n"
+		"-c [use cluster mode]\r\n"
+		"-a cmd[set|get|mix|all]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, n = 1000, batch = 100, conn_timeout = 10, rw_timeout = 10;
+	acl::string addr("127.0.0.1:6379"), cmd("all");
+	bool cluster_mode = false;
+
+	while ((ch = getopt(argc, argv, "hs:n:b:C:I:a:c")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 'C':
+			conn_timeout = atoi(optarg);
+			break;
+		case 'I':
+			rw_timeout = atoi(optarg);
+			break;
+		case 'a':
+			cmd = optarg;
+			break;
+		case 'c':
+			cluster_mode = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (batch <= 0)
+		batch = 1;
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::redis_client_cluster cluster;
+	cluster.set(addr.c_str(), 100, conn_timeout, rw_timeout);
+
+	acl::redis_client client(addr.c_str(), conn_timeout, rw_timeout);
+
+	acl::redis_pipeline* pipeline;
+	if (cluster_mode)
+		pipeline = new acl::redis_pipeline(&cluster, 100);
+	else
+		pipeline = new acl::redis_pipeline(&client);
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	bool ret;
+
+	if (cmd == "set")
+		ret = test_set(*pipeline, n, batch);
+	else if (cmd == "get")
+		ret = test_get(*pipeline, n, batch);
+	else if (cmd == "mix")
+		ret = test_mix(*pipeline, batch);
+	else if (cmd == "all")
+		ret = test_set(*pipeline, n, batch)
+			&& test_get(*pipeline, n, batch)
+			&& test_mix(*pipeline, batch);
+	else
+	{
+		ret = false;
+		printf("unknown cmd: %s\r\n", cmd.c_str());
+	}
+
+	gettimeofday(&end, NULL);
+	double spent = (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+	printf("spent: %.2f ms\r\n", spent);
+
+	if (ret == true)
+		printf("test OK!\r\n");
+	else
+		printf("test failed!\r\n");
+
+	delete pipeline;
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "stdafx.h"
+
+// ʹ Lua űעִнű redis_script_registry eval ֻ
+// EVALSHA  40 ֽڵժҪÿζĽűûиýűʱ
+// (类 SCRIPT FLUSH )Զ EVAL ط봦 NOSCRIPT 
+
+static double stamp_sub(const struct timeval& end, const struct timeval& begin)
+{
+	return (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+}
+
+// һָȵĽű Lua עͲ볤ȣģϴĽű
+static void make_script(size_t len, acl::string& out)
+{
+	out = "-- ";
+	while (out.size() + 64 < len)
+		out << "padding of the script to simulate a large one ........ \n-- ";
+	out << "\nredis.call('SET', KEYS[1], ARGV[1])\n"
+		<< "return redis.call('GET', KEYS[1])\n";
+}
+
+static bool test(acl::redis_script& cmd, const char* script, int loop,
+	int nkeys, int flush, int& nflush)
+{
+	std::vector<acl::string> keys, args;
+	acl::string key, value, out;
+
+	keys.push_back(key);
+	args.push_back(value);
+
+	for (int i = 0; i < loop; i++)
+	{
+		// ԵϻĽűһ EVALSHA յ NOSCRIPT
+		if (flush > 0 && i > 0 && i % flush == 0)
+		{
+			cmd.clear();
+			if (cmd.script_flush() == false)
+			{
+				printf("script flush error: %s\r\n",
+					cmd.result_error());
+				return false;
+			}
+			nflush++;
+		}
+
+		keys[0].format("script_key_%d", i % nkeys);
+		args[0].format("value_%d", i);
+
+		out.clear();
+		cmd.clear();
+		if (cmd.eval_string(script, keys, args, out) < 0)
+		{
+			printf("eval error: %s\r\n", cmd.result_error());
+			return false;
+		}
+
+		if (i < 3)
+			printf("key: %s, result: %s\r\n", keys[0].c_str(),
+				out.c_str());
+	}
+
+	return true;
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addr[default: 127.0.0.1:6379]\r\n"
+		"-C [redis cluster mode, redis_addr is one of the nodes]\r\n"
+		"-n loop count[default: 10000]\r\n"
+		"-l script length[default: 4096]\r\n"
+		"-k key count[default: 100]\r\n"
+		"-f flush the scripts every f loops, 0 means never[default: 0]\r\n"
+		"-P [don't preload the registered scripts]\r\n"
+		"-N [without script registry, send EVAL every time]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, loop = 10000, len = 4096, nkeys = 100, flush = 0;
+	bool cluster_mode = false, use_registry = true, preload = true;
+	acl::string addr("127.0.0.1:6379");
+
+	while ((ch = getopt(argc, argv, "hs:Cn:l:k:f:PN")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addr = optarg;
+			break;
+		case 'C':
+			cluster_mode = true;
+			break;
+		case 'n':
+			loop = atoi(optarg);
+			break;
+		case 'l':
+			len = atoi(optarg);
+			break;
+		case 'k':
+			nkeys = atoi(optarg);
+			if (nkeys <= 0)
+				nkeys = 1;
+			break;
+		case 'f':
+			flush = atoi(optarg);
+			break;
+		case 'P':
+			preload = false;
+			break;
+		case 'N':
+			use_registry = false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	acl::string script;
+	make_script((size_t) len, script);
+
+	// עűԱӽʱԤÿ
+	acl::redis_script_registry scripts;
+	const char* sha1 = scripts.add(script.c_str());
+	printf("script length: %d, sha1: %s\r\n", (int) script.size(), sha1);
+
+	acl::redis_client_cluster cluster;
+	acl::redis_client conn(addr.c_str(), 10, 10);
+	acl::redis_script cmd;
+
+	if (cluster_mode)
+	{
+		if (use_registry)
+			cluster.set_script_registry(&scripts, preload);
+		cluster.set_all_slot(addr.c_str(), 0);
+		cmd.set_cluster(&cluster, 0);
+		flush = 0;
+	}
+	else
+	{
+		if (use_registry)
+			conn.set_script_registry(&scripts, preload);
+		cmd.set_client(&conn);
+	}
+
+	struct timeval begin, end;
+	gettimeofday(&begin, NULL);
+
+	int nflush = 0;
+	bool ret = test(cmd, script.c_str(), loop, nkeys, flush, nflush);
+
+	gettimeofday(&end, NULL);
+	double spent = stamp_sub(end, begin);
+
+	printf("registry: %s, preload: %s, loop: %d, flushed: %d, "
+		"spent: %.2f ms, speed: %.2f/s\r\n",
+		use_registry ? "on" : "off", preload ? "on" : "off", loop,
+		nflush, spent, loop * 1000 / (spent > 0 ? spent : 1));
+	printf("test %s!\r\n", ret ? "OK" : "failed");
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return ret ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+#include "stdafx.h"
+
+// ̲߳ѯϣ۶ӦӳأȽ peek_slot 󰴵ַ
+// ӳ(ǰ peek_slot ʵַʽ)ܲ죻ͬʱһ߳
+// ޸Ĺϣ۵ӳϵģ MOVED ضʱ˱仯
+
+static int __max_slot = 16384;
+static std::vector<acl::string> __addrs;
+
+static double stamp_sub(const struct timeval& end, const struct timeval& begin)
+{
+	return (end.tv_sec - begin.tv_sec) * 1000.0
+		+ (end.tv_usec - begin.tv_usec) / 1000.0;
+}
+
+class reader_thread : public acl::thread
+{
+public:
+	reader_thread(acl::redis_client_cluster& cluster, const char** slot_addrs,
+		long long loop, bool use_lock)
+	: cluster_(cluster)
+	, slot_addrs_(slot_addrs)
+	, loop_(loop)
+	, use_lock_(use_lock)
+	, nfound_(0)
+	{
+	}
+
+	~reader_thread() {}
+
+	long long get_found() const
+	{
+		return nfound_;
+	}
+
+protected:
+	void* run()
+	{
+		unsigned int seed = (unsigned int) thread_self();
+
+		for (long long i = 0; i < loop_; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			int slot = (int) ((seed >> 8) % __max_slot);
+
+			if (use_lock_)
+			{
+				// ǰʵַʽݵַӳ
+				cluster_.lock();
+				const char* addr = slot_addrs_[slot];
+				if (addr != NULL && cluster_.get(addr, false))
+					nfound_++;
+				cluster_.unlock();
+			}
+			else if (cluster_.peek_slot(slot) != NULL)
+				nfound_++;
+		}
+
+		return NULL;
+	}
+
+private:
+	acl::redis_client_cluster& cluster_;
+	const char** slot_addrs_;
+	long long loop_;
+	bool use_lock_;
+	long long nfound_;
+};
+
+class writer_thread : public acl::thread
+{
+public:
+	writer_thread(acl::redis_client_cluster& cluster, const char** slot_addrs,
+		int inter)
+	: cluster_(cluster)
+	, slot_addrs_(slot_addrs)
+	, inter_(inter)
+	, stop_(false)
+	, nchanged_(0)
+	{
+	}
+
+	~writer_thread() {}
+
+	void stop()
+	{
+		stop_ = true;
+	}
+
+	int get_changed() const
+	{
+		return nchanged_;
+	}
+
+protected:
+	void* run()
+	{
+		int i = 0;
+
+		while (!stop_)
+		{
+			int slot = i++ % __max_slot;
+			const char* addr = __addrs[i % __addrs.size()].c_str();
+
+			// ģ MOVED ض޸һϣ۶Ӧķַ
+			cluster_.lock();
+			slot_addrs_[slot] = addr;
+			cluster_.unlock();
+			cluster_.set_slot(slot, addr);
+
+			nchanged_++;
+			if (inter_ > 0)
+				acl_doze(inter_);
+		}
+
+		return NULL;
+	}
+
+private:
+	acl::redis_client_cluster& cluster_;
+	const char** slot_addrs_;
+	int inter_;
+	volatile bool stop_;
+	int nchanged_;
+};
+
+static void bench(acl::redis_client_cluster& cluster, const char** slot_addrs,
+	int nthreads, long long loop, bool use_lock, int inter)
+{
+	std::vector<reader_thread*> threads;
+	writer_thread* writer = NULL;
+	struct timeval begin, end;
+
+	if (inter >= 0)
+	{
+		writer = new writer_thread(cluster, slot_addrs, inter);
+		writer->set_detachable(false);
+		writer->start();
+	}
+
+	gettimeofday(&begin, NULL);
+
+	for (int i = 0; i < nthreads; i++)
+	{
+		reader_thread* thread = new reader_thread(cluster, slot_addrs,
+			loop, use_lock);
+		thread->set_detachable(false);
+		threads.push_back(thread);
+		thread->start();
+	}
+
+	long long nfound = 0;
+	for (std::vector<reader_thread*>::iterator it = threads.begin();
+		it != threads.end(); ++it)
+	{
+		(*it)->wait();
+		nfound += (*it)->get_found();
+		delete *it;
+	}
+
+	gettimeofday(&end, NULL);
+
+	int nchanged = 0;
+	if (writer)
+	{
+		writer->stop();
+		writer->wait();
+		nchanged = writer->get_changed();
+		delete writer;
+	}
+
+	double spent = stamp_sub(end, begin);
+	long long total = loop * nthreads;
+	printf("%s: threads: %d, total: %lld, found: %lld, changed: %d, "
+		"spent: %.2f ms, speed: %.2f/s\r\n",
+		use_lock ? "lock  " : "atomic", nthreads, total, nfound,
+		nchanged, spent, total * 1000 / (spent > 0 ? spent : 1));
+}
+
+static void usage(const char* procname)
+{
+	printf("usage: %s -h[help]\r\n"
+		"-s redis_addrs[default: 127.0.0.1:6379,127.0.0.1:6380,127.0.0.1:6381]\r\n"
+		"-c max_threads[default: 8]\r\n"
+		"-n loop count of each thread[default: 10000000]\r\n"
+		"-w writer interval in ms, -1 means no writer[default: -1]\r\n"
+		"-a mode[atomic|lock|all, default: all]\r\n",
+		procname);
+}
+
+int main(int argc, char* argv[])
+{
+	int  ch, nthreads = 8, inter = -1;
+	long long loop = 10000000;
+	acl::string addrs("127.0.0.1:6379,127.0.0.1:6380,127.0.0.1:6381");
+	acl::string mode("all");
+
+	while ((ch = getopt(argc, argv, "hs:c:n:w:a:")) > 0)
+	{
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 's':
+			addrs = optarg;
+			break;
+		case 'c':
+			nthreads = atoi(optarg);
+			break;
+		case 'n':
+			loop = atoll(optarg);
+			break;
+		case 'w':
+			inter = atoi(optarg);
+			break;
+		case 'a':
+			mode = optarg;
+			break;
+		default:
+			break;
+		}
+	}
+
+	acl::acl_cpp_init();
+	acl::log::stdout_open(true);
+
+	// ӳزùϣӳϵ redis 
+	acl::redis_client_cluster cluster(__max_slot);
+	cluster.init(NULL, addrs.c_str(), nthreads, 10, 10);
+
+	std::vector<acl::connect_pool*>& pools = cluster.get_pools();
+	for (std::vector<acl::connect_pool*>::iterator it = pools.begin();
+		it != pools.end(); ++it)
+	{
+		__addrs.push_back((*it)->get_addr());
+	}
+
+	const char** slot_addrs = (const char**)
+		acl_mycalloc(__max_slot, sizeof(char*));
+	for (int i = 0; i < __max_slot; i++)
+	{
+		slot_addrs[i] = __addrs[i % __addrs.size()].c_str();
+		cluster.set_slot(i, slot_addrs[i]);
+	}
+
+	if (mode == "atomic" || mode == "all")
+		bench(cluster, slot_addrs, nthreads, loop, false, inter);
+	if (mode == "lock" || mode == "all")
+		bench(cluster, slot_addrs, nthreads, loop, true, inter);
+
+	acl_myfree(slot_addrs);
+
+#ifdef WIN32
+	printf("enter any key to exit\r\n");
+	getchar();
+#endif
+	return 0;
+}
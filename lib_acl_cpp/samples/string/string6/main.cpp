@@ -0,0 +1,82 @@
+#include "lib_acl.h"
+#include "acl_cpp/lib_acl.hpp"
+#include <stdio.h>
+#include <map>
+
+//  acl::string  operator <  operator >رһַΪһ
+// ǰ׺ΣȽʱӦȡ϶ַ֮
+
+static int __nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+	printf("%s: %s\r\n", ok ? "ok    " : "FAILED", what);
+	if (!ok)
+		__nfailed++;
+}
+
+static void test_prefix(void)
+{
+	acl::string a("abc"), b("abcd"), e;
+
+	check(a < b, "\"abc\" < \"abcd\"");
+	check(!(b < a), "!(\"abcd\" < \"abc\")");
+	check(b > a, "\"abcd\" > \"abc\"");
+	check(!(a > b), "!(\"abc\" > \"abcd\")");
+	check(e < a && a > e, "\"\" < \"abc\"");
+	check(!(a < a) && !(a > a), "!(\"abc\" < \"abc\")");
+
+	acl::string c("abd");
+	check(b < c && c > b, "\"abcd\" < \"abd\"");
+}
+
+static void test_stale(void)
+{
+	// ض̺󻺳н֮Բԭ "d"
+	acl::string left("abcd");
+	left.truncate(2);
+
+	// ұΪ "ab"  '\0'ǰ׺
+	acl::string right("ab\0\0", 4);
+
+	check(left.length() == 2 && right.length() == 4, "lengths");
+	check(left < right, "\"ab\" < \"ab\\0\\0\"");
+	check(right > left, "\"ab\\0\\0\" > \"ab\"");
+	check(!(right < left), "!(\"ab\\0\\0\" < \"ab\")");
+	check(!(left > right), "!(\"ab\" > \"ab\\0\\0\")");
+}
+
+static void test_map(void)
+{
+	const char* keys[] = { "key", "key1", "ke", "key10", "k", "key0" };
+	const char* sorted[] = { "k", "ke", "key", "key0", "key1", "key10" };
+	std::map<acl::string, int> m;
+
+	for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+		m[keys[i]] = (int) i;
+	for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+		m[keys[i]]++;
+
+	check(m.size() == sizeof(keys) / sizeof(keys[0]), "map size");
+
+	size_t i = 0;
+	bool ordered = true;
+	for (std::map<acl::string, int>::const_iterator cit = m.begin();
+		cit != m.end(); ++cit, ++i)
+	{
+		if (cit->first != sorted[i])
+			ordered = false;
+	}
+	check(ordered, "map order");
+}
+
+int main(void)
+{
+	test_prefix();
+	test_stale();
+	test_map();
+
+	printf("%s, failed: %d\r\n", __nfailed == 0 ? "all ok" : "error",
+		__nfailed);
+	return __nfailed == 0 ? 0 : 1;
+}
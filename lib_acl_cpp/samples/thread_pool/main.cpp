@@ -29,10 +29,15 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 
+static bool __lockfree = false;
+
 class mythread_pool : public acl::thread_pool
 {
 public:
-	mythread_pool() {}
+	mythread_pool()
+	{
+		set_lockfree(__lockfree);
+	}
 	~mythread_pool()
 	{
 		printf("thread pool destroy now, tid: %lu\r\n",
@@ -60,6 +65,80 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 
+class prio_job : public acl::thread_job
+{
+public:
+	prio_job(int prio, int i) : prio_(prio), i_(i) {}
+	~prio_job() {}
+
+	int get_prio() const
+	{
+		return prio_;
+	}
+
+protected:
+	virtual void* run()
+	{
+		printf("run job: prio=%d, i=%d\r\n", prio_, i_);
+		acl_doze(100);
+		delete this;
+		return NULL;
+	}
+
+private:
+	int prio_;
+	int i_;
+};
+
+class prio_thread_pool : public acl::thread_pool
+{
+public:
+	prio_thread_pool() {}
+	~prio_thread_pool() {}
+
+protected:
+	// ڻ򱻶񲻻ٱִУڴ˴ͷ
+	virtual void job_on_drop(acl::thread_job* job, int reason)
+	{
+		prio_job* pj = (prio_job*) job;
+		printf("drop job: prio=%d, reason=%s\r\n", pj->get_prio(),
+			reason == DROP_EXPIRED ? "expired" : "shed");
+		delete job;
+	}
+};
+
+static void test_prio_pool(void)
+{
+	prio_thread_pool threads;
+	threads.set_limit(1);
+	threads.set_shed_wait(500);
+	threads.start();
+
+	// ̳߳УȼᱻִУȼŶӹ
+	// ʱᱻ˽ֹʱʱᱻ
+	for (int i = 0; i < 5; i++)
+	{
+		threads.run(new prio_job(acl::thread_pool::PRIO_LOW, i),
+			acl::thread_pool::PRIO_LOW);
+		threads.run(new prio_job(acl::thread_pool::PRIO_NORMAL, i),
+			acl::thread_pool::PRIO_NORMAL, 300);
+		threads.run(new prio_job(acl::thread_pool::PRIO_HIGH, i),
+			acl::thread_pool::PRIO_HIGH);
+	}
+
+	threads.stop();
+
+	for (int i = 0; i < acl::thread_pool::PRIO_MAX; i++)
+	{
+		acl::thread_pool_stat stat;
+		threads.get_stat(i, stat);
+		printf("prio=%d, njobs=%lld, expired=%lld, shed=%lld, "
+			"reject=%lld, wait_max=%lld ms\r\n", i,
+			stat.njobs, stat.nexpired, stat.nshed,
+			stat.nreject, stat.wait_max);
+	}
+}
+
 static void test_thread_pool(int n)
 {
 	if (n == 0)
@@ -145,6 +224,7 @@ static void test_thread_pool(int n)
 		// ֱʹû
 		static acl::thread_pool threads;
 		threads.set_idle(1);
+		threads.set_lockfree(__lockfree);
 		threads.start();
 
 		mythread *thread1 = new mythread(true);
@@ -159,6 +239,8 @@ static void test_thread_pool(int n)
 			threads.stop();
 		}
 	}
+	else if (n == 6)
+		test_prio_pool();
 	else
 	{
 		mythread_pool threads;
@@ -178,7 +260,8 @@ static void test_thread_pool(int n)
 static void usage(const char* proc)
 {
 	printf("usage: %s -h [help]\r\n"
-		"	-c which_case [0, 1, 2, 3, 4, 5]\r\n",
+		"	-c which_case [0, 1, 2, 3, 4, 5, 6]\r\n"
+		"	-l [use lock-free job queue]\r\n",
 		proc);
 }
 
@@ -189,7 +272,7 @@ int main(int argc, char* argv[])
 	// ʼ acl 
 	acl::acl_cpp_init();
 
-	while ((ch = getopt(argc, argv, "hc:")) > 0)
+	while ((ch = getopt(argc, argv, "hc:l")) > 0)
 	{
 		switch (ch)
 		{
@@ -199,6 +282,9 @@ int main(int argc, char* argv[])
 		case 'c':
 			n = atoi(optarg);
 			break;
+		case 'l':
+			__lockfree = true;
+			break;
 		default:
 			break;
 		}
@@ -32,22 +32,39 @@ private:
 class consumer : public acl::thread
 {
 public:
-	consumer(acl::thread_queue& queue) : queue_(queue) {}
+	consumer(acl::thread_queue& queue, int nproducers, int batch)
+		: queue_(queue), nproducers_(nproducers), batch_(batch) {}
 	~consumer() {}
 
 protected:
 	void* run()
 	{
 		long long int  n = 0;
+		int nstop = 0, nitems = 0, pos = 0;
+		std::vector<acl::thread_qitem*> items(batch_);
 
 		struct timeval begin;
 		gettimeofday(&begin, NULL);
 
 		while (true)
 		{
-			queue_item* item = (queue_item*) queue_.pop();
-			if (item == NULL)
-				break;
+			// ģʽһȡԪ
+			if (pos >= nitems)
+			{
+				pos = 0;
+				if (batch_ > 1)
+					nitems = (int) queue_.pop_batch(
+						&items[0], items.size());
+				else
+				{
+					items[0] = queue_.pop();
+					nitems = items[0] ? 1 : 0;
+				}
+				if (nitems == 0)
+					break;
+			}
+
+			queue_item* item = (queue_item*) items[pos++];
 
 			n++;
 
@@ -56,6 +73,8 @@ protected:
 
 			if (type == MSG_STOP)
 			{
+				if (++nstop < nproducers_)
+					continue;
 				printf("stop now, max: %lld\r\n", n);
 				break;
 			}
@@ -92,23 +111,41 @@ protected:
 
 private:
 	acl::thread_queue& queue_;
+	int nproducers_;
+	int batch_;
 };
 
 class producer : public acl::thread
 {
 public:
-	producer(acl::thread_queue& queue, int max)
-		: queue_(queue), max_(max) {}
+	producer(acl::thread_queue& queue, int max, int batch)
+		: queue_(queue), max_(max), batch_(batch) {}
 	~producer() {}
 
 protected:
 	void* run()
 	{
+		std::vector<acl::thread_qitem*> items;
+
 		for (int i = 0; i < max_; i++)
 		{
 			queue_item* item = new queue_item(MSG_ECHO);
-			queue_.push(item);
+			if (batch_ <= 1)
+			{
+				queue_.push(item);
+				continue;
+			}
+
+			// ģʽܹһһԷ
+			items.push_back(item);
+			if ((int) items.size() >= batch_)
+			{
+				queue_.push_batch(&items[0], items.size());
+				items.clear();
+			}
 		}
+		if (!items.empty())
+			queue_.push_batch(&items[0], items.size());
 		printf("push msg ok\r\n");
 
 		queue_item* item = new queue_item(MSG_STOP);
@@ -119,38 +156,112 @@ protected:
 private:
 	acl::thread_queue& queue_;
 	int max_;
+	int batch_;
 };
 
 //////////////////////////////////////////////////////////////////////////
 
+static void usage(const char* procname)
+{
+	printf("usage: %s -h [help]\r\n"
+		"	-n max_count [default: 10]\r\n"
+		"	-p producers_count [default: 1]\r\n"
+		"	-b batch_size [default: 1]\r\n"
+		"	-t queue_type [lock|mpsc|spsc, default: lock]\r\n"
+		"	-r ring_size [default: 65536]\r\n"
+		"	-s spin_count [default: 0 for lock, auto for ring]\r\n",
+		procname);
+}
+
 int main(int argc, char* argv[])
 {
-	int max = 10;
-	if (argc >= 2)
+	int  ch, max = 10, nproducers = 1, batch = 1, ring_size = 65536;
+	int  spin = -1;
+	acl::string type("lock");
+
+	while ((ch = getopt(argc, argv, "hn:p:b:t:r:s:")) > 0)
 	{
-		max = atoi(argv[1]);
-		if (max <= 0)
-			max = 10;
+		switch (ch)
+		{
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		case 'n':
+			max = atoi(optarg);
+			break;
+		case 'p':
+			nproducers = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 't':
+			type = optarg;
+			break;
+		case 'r':
+			ring_size = atoi(optarg);
+			break;
+		case 's':
+			spin = atoi(optarg);
+			break;
+		default:
+			break;
+		}
 	}
 
+	if (max <= 0)
+		max = 10;
+	if (nproducers <= 0)
+		nproducers = 1;
+	if (batch <= 0)
+		batch = 1;
+
+	// SPSC ģʽһ
+	if (type == "spsc")
+		nproducers = 1;
+
 	// ʼ acl 
 	acl::acl_cpp_init();
 
-	acl::thread_queue queue;
+	acl::thread_queue* queue;
+	if (type == "mpsc" || type == "spsc")
+		queue = new acl::thread_queue(ring_size, type == "mpsc");
+	else
+		queue = new acl::thread_queue;
+
+	if (spin >= 0)
+		queue->set_spin(spin);
 
-	producer producer(queue, max);
-	producer.set_detachable(false);
-	producer.start();
+	printf("type: %s, producers: %d, max: %d, batch: %d\r\n",
+		type.c_str(), nproducers, max, batch);
 
-	consumer consumer(queue);
+	std::vector<producer*> producers;
+	for (int i = 0; i < nproducers; i++)
+	{
+		producer* p = new producer(*queue, max, batch);
+		p->set_detachable(false);
+		p->start();
+		producers.push_back(p);
+	}
+
+	consumer consumer(*queue, nproducers, batch);
 	consumer.set_detachable(false);
 	consumer.start();
 
-	producer.wait();
+	for (std::vector<producer*>::iterator it = producers.begin();
+		it != producers.end(); ++it)
+	{
+		(*it)->wait();
+		delete *it;
+	}
 	consumer.wait();
 
+	delete queue;
+
+#ifdef WIN32
 	printf("enter any key to exit ...\r\n");
 	getchar();
+#endif
 
 	return 0;
 }
@@ -11,6 +11,7 @@
 // TODO: ڴ˴óҪĸͷļ
 
 #include "acl_cpp/lib_acl.hpp"
+#include "lib_acl.h"
 
 #ifdef	WIN32
 #define	snprintf _snprintf
@@ -0,0 +1,85 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stream/aio_handle.hpp"
+#include "acl_cpp/redis/redis_async_client.hpp"
+#endif
+#include "redis_request.hpp"
+#include "redis_async_conn.hpp"
+
+namespace acl
+{
+
+redis_async_client::redis_async_client(aio_handle& handle, const char* addr,
+	size_t max_conns /* = 1 */, int conn_timeout /* = 10 */,
+	int rw_timeout /* = 10 */)
+: handle_(handle)
+, addr_(addr)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+{
+	if (max_conns == 0)
+		max_conns = 1;
+
+	for (size_t i = 0; i < max_conns; i++)
+		conns_.push_back(new redis_async_conn(*this));
+}
+
+redis_async_client::~redis_async_client(void)
+{
+	for (std::vector<redis_async_conn*>::iterator it = conns_.begin();
+		it != conns_.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+void redis_async_client::set_password(const char* pass)
+{
+	if (pass && *pass)
+		pass_ = pass;
+	else
+		pass_.clear();
+}
+
+redis_async_conn* redis_async_client::peek_conn(void)
+{
+	// ѡȴӦٵ
+	redis_async_conn* conn = conns_[0];
+
+	for (size_t i = 1; i < conns_.size(); i++)
+	{
+		if (conns_[i]->get_pending() < conn->get_pending())
+			conn = conns_[i];
+	}
+
+	return conn;
+}
+
+bool redis_async_client::send(const string& req, size_t nchildren,
+	redis_async_callback* callback)
+{
+	return peek_conn()->send(req.c_str(), req.size(), nchildren, callback);
+}
+
+bool redis_async_client::send(const redis_request& req, size_t nchildren,
+	redis_async_callback* callback)
+{
+	return peek_conn()->send(req.get_iovec(), req.get_size(),
+			nchildren, callback);
+}
+
+size_t redis_async_client::get_pending(void) const
+{
+	size_t n = 0;
+
+	for (std::vector<redis_async_conn*>::const_iterator it = conns_.begin();
+		it != conns_.end(); ++it)
+	{
+		n += (*it)->get_pending();
+	}
+
+	return n;
+}
+
+} // namespace acl
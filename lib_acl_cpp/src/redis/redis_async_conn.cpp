@@ -0,0 +1,225 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/stream/aio_handle.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_async_client.hpp"
+#endif
+#include "redis_async_conn.hpp"
+
+namespace acl
+{
+
+redis_async_conn::redis_async_conn(redis_async_client& client)
+: client_(client)
+, conn_(NULL)
+, parsing_(false)
+{
+	dbuf_ = new dbuf_pool();
+}
+
+redis_async_conn::~redis_async_conn(void)
+{
+	close();
+	fail_all();
+	dbuf_->destroy();
+}
+
+void redis_async_conn::close(void)
+{
+	if (conn_ == NULL)
+		return;
+
+	// ȽлصΪ첽¼ѭбӳͷŵ
+	conn_->del_open_callback(this);
+	conn_->del_read_callback(this);
+	conn_->del_close_callback(this);
+	conn_->del_timeout_callback(this);
+	conn_->close();
+	conn_ = NULL;
+}
+
+bool redis_async_conn::open(void)
+{
+	conn_ = aio_socket_stream::open(&client_.get_handle(),
+			client_.get_addr(), client_.conn_timeout_);
+	if (conn_ == NULL)
+	{
+		logger_error("connect %s error: %s",
+			client_.get_addr(), last_serror());
+		return false;
+	}
+
+	conn_->add_open_callback(this);
+	conn_->add_close_callback(this);
+	conn_->add_timeout_callback(this);
+
+	parsing_ = false;
+	wbuf_.clear();
+
+	// ӽȷ AUTH ԣ֤ʧʱ
+	// õ˵ĴӦ
+	if (!client_.pass_.empty())
+	{
+		wbuf_.format("*2\r\n$4\r\nAUTH\r\n$%d\r\n",
+			(int) client_.pass_.size());
+		wbuf_.append(client_.pass_);
+		wbuf_.append("\r\n");
+		put(0, NULL);
+	}
+
+	return true;
+}
+
+void redis_async_conn::put(size_t nchildren, redis_async_callback* callback)
+{
+	async_req req;
+	req.nchildren = nchildren;
+	req.callback  = callback;
+	pending_.push_back(req);
+}
+
+bool redis_async_conn::send(const char* data, size_t len, size_t nchildren,
+	redis_async_callback* callback)
+{
+	if (conn_ == NULL && !open())
+	{
+		fail(callback);
+		return false;
+	}
+
+	// ӳɹǰȻݣӺдϲģʽͬһ¼ѭ
+	// дĶᱻϲΪһ writev
+	if (conn_->is_opened())
+		conn_->write(data, (int) len);
+	else
+		wbuf_.append(data, len);
+
+	put(nchildren, callback);
+	return true;
+}
+
+bool redis_async_conn::send(const struct iovec* iov, size_t count,
+	size_t nchildren, redis_async_callback* callback)
+{
+	if (conn_ == NULL && !open())
+	{
+		fail(callback);
+		return false;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (conn_->is_opened())
+			conn_->write(iov[i].iov_base, (int) iov[i].iov_len);
+		else
+			wbuf_.append((const char*) iov[i].iov_base,
+				iov[i].iov_len);
+	}
+
+	put(nchildren, callback);
+	return true;
+}
+
+bool redis_async_conn::open_callback(void)
+{
+	conn_->add_read_callback(this);
+	conn_->set_cork(true);
+
+	if (!wbuf_.empty())
+	{
+		conn_->write(wbuf_.c_str(), (int) wbuf_.size());
+		wbuf_.clear();
+	}
+
+	// 첽ÿζݺص read_callback
+	conn_->read(0, client_.rw_timeout_);
+	return true;
+}
+
+bool redis_async_conn::read_callback(char* data, int len)
+{
+	while (len > 0)
+	{
+		if (pending_.empty())
+		{
+			logger_error("unexpected data from %s, len: %d",
+				client_.get_addr(), len);
+			return false;
+		}
+
+		if (!parsing_)
+		{
+			parser_.reset(dbuf_, pending_.front().nchildren);
+			parsing_ = true;
+		}
+
+		int n = parser_.update(data, (size_t) len);
+		if (n < 0)
+		{
+			logger_error("invalid data from %s", client_.get_addr());
+			return false;
+		}
+
+		data += n;
+		len  -= n;
+
+		if (!parser_.finished())
+			break;
+
+		// ȽӶȡٻصΪصпܻᷢµ
+		parsing_ = false;
+		async_req req = pending_.front();
+		pending_.pop_front();
+
+		if (req.callback != NULL)
+			req.callback->on_result(parser_.get_result());
+		dbuf_->dbuf_reset();
+	}
+
+	return true;
+}
+
+bool redis_async_conn::timeout_callback(void)
+{
+	// ûеȴӦʱڿӣȴ
+	if (pending_.empty())
+		return true;
+
+	logger_error("read from %s timeout, pending: %d",
+		client_.get_addr(), (int) pending_.size());
+	return false;
+}
+
+void redis_async_conn::close_callback(void)
+{
+	// 첽ڱغ¼ͷ
+	conn_ = NULL;
+	fail_all();
+}
+
+void redis_async_conn::fail(redis_async_callback* callback)
+{
+	// δܷӶϿʱһ NULL ֪ͨ
+	if (callback != NULL)
+		callback->on_result(NULL);
+}
+
+void redis_async_conn::fail_all(void)
+{
+	// ȸƴУΪصпܻ·Ӷؽ
+	std::list<async_req> pending;
+	pending.swap(pending_);
+	parsing_ = false;
+	dbuf_->dbuf_reset();
+
+	for (std::list<async_req>::iterator it = pending.begin();
+		it != pending.end(); ++it)
+	{
+		if ((*it).callback != NULL)
+			(*it).callback->on_result(NULL);
+	}
+}
+
+} // namespace acl
@@ -0,0 +1,68 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <list>
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stream/aio_socket_stream.hpp"
+#include "acl_cpp/redis/redis_parser.hpp"
+
+namespace acl
+{
+
+class dbuf_pool;
+class redis_async_client;
+class redis_async_callback;
+
+/**
+ * redis_async_client ڲʹõĵ첽ӣӶϿ´ηʱ
+ * Զѷ͵˳ȴӦ
+ */
+class redis_async_conn : public aio_open_callback
+{
+public:
+	redis_async_conn(redis_async_client& client);
+	~redis_async_conn(void);
+
+	// ݷδʱȻӳɹͣʧʱ
+	//  NULL ص callback 󷵻 false
+	bool send(const char* data, size_t len, size_t nchildren,
+		redis_async_callback* callback);
+	bool send(const struct iovec* iov, size_t count, size_t nchildren,
+		redis_async_callback* callback);
+
+	size_t get_pending(void) const
+	{
+		return pending_.size();
+	}
+
+protected:
+	// @override aio_open_callback
+	bool open_callback(void);
+
+	// @override aio_callback
+	bool read_callback(char* data, int len);
+	bool timeout_callback(void);
+	void close_callback(void);
+
+private:
+	struct async_req
+	{
+		size_t nchildren;
+		redis_async_callback* callback;
+	};
+
+	redis_async_client& client_;
+	aio_socket_stream* conn_;
+	dbuf_pool* dbuf_;
+	redis_parser parser_;
+	bool   parsing_;
+	string wbuf_;
+	std::list<async_req> pending_;
+
+	bool open(void);
+	void close(void);
+	void put(size_t nchildren, redis_async_callback* callback);
+	void fail(redis_async_callback* callback);
+	void fail_all(void);
+};
+
+} // namespace acl
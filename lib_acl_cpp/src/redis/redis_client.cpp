@@ -7,6 +7,8 @@
 #include "acl_cpp/stream/socket_stream.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_connection.hpp"
+#include "acl_cpp/redis/redis_client_cache.hpp"
+#include "acl_cpp/redis/redis_script_registry.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
 #endif
 #include "redis_request.hpp"
@@ -22,6 +24,18 @@ redis_client::redis_client(const char* addr, int conn_timeout /* = 60 */,
 , retry_(retry)
 , slice_req_(false)
 , slice_res_(false)
+, rbuf_(NULL)
+, rbuf_size_(0)
+, rbuf_off_(0)
+, rbuf_len_(0)
+, protocol_(2)
+, resp3_(false)
+, resp3_types_(false)
+, cache_(NULL)
+, cache_id_(0)
+, readonly_(false)
+, scripts_(NULL)
+, preload_(false)
 {
 	addr_ = acl_mystrdup(addr);
 	pass_ = NULL;
@@ -111,13 +125,118 @@ bool redis_client::open()
 		}
 	}
 
+	// ͻ˻ RESP3 ЭʧЧͣ RESP3 ²Ľṹ
+	//  RESP2 ͬԽڵʽЭ汾Ϊ 3 лЭ
+	if (protocol_ >= 3)
+		(void) hello();
+	else if (cache_ != NULL)
+		logger_warn("client cache needs set_protocol(3), addr: %s",
+			addr_);
+
+	if (readonly_)
+		(void) readonly();
+
+	// ԤʧʱԷ trueִнűʱ NOSCRIPT  EVAL
+	if (scripts_ && preload_)
+		(void) scripts_->preload(*this);
+
 	return true;
 }
 
+bool redis_client::readonly(void)
+{
+	redis_command cmd(this);
+
+	// ڼȺĴӽִжʧʱض
+	const char* argv[1] = { "READONLY" };
+	size_t lens[1] = { sizeof("READONLY") - 1 };
+	const redis_result* result = cmd.request(1, argv, lens);
+	if (result == NULL || result->get_type() != REDIS_RESULT_STATUS)
+	{
+		logger_warn("READONLY error: %s, addr: %s",
+			result ? result->get_error() : "null", addr_);
+		return false;
+	}
+	return true;
+}
+
+void redis_client::set_readonly(bool on)
+{
+	readonly_ = on;
+}
+
+bool redis_client::hello(void)
+{
+	redis_command cmd(this);
+
+	// Эʹ RESP3 Э飬ʧʱʹ RESP2 Э
+	const char* argv[2] = { "HELLO", "3" };
+	size_t lens[2] = { sizeof("HELLO") - 1, sizeof("3") - 1 };
+	const redis_result* result = cmd.request(2, argv, lens);
+	if (result == NULL || result->get_type() == REDIS_RESULT_ERROR)
+	{
+		logger_warn("HELLO 3 error: %s, addr: %s, use RESP2",
+			result ? result->get_error() : "null", addr_);
+		return false;
+	}
+	resp3_ = true;
+
+	if (cache_ == NULL)
+		return true;
+
+	//  CLIENT TRACKING 󣬱Ӷļ޸ʱredis-server 
+	// ͨʧЧ֪ͨ
+	const char* argv2[3] = { "CLIENT", "TRACKING", "on" };
+	size_t lens2[3] = { sizeof("CLIENT") - 1, sizeof("TRACKING") - 1,
+		sizeof("on") - 1 };
+	cmd.clear();
+	result = cmd.request(3, argv2, lens2);
+	if (result == NULL || result->get_type() != REDIS_RESULT_STATUS)
+	{
+		logger_warn("CLIENT TRACKING error: %s, addr: %s",
+			result ? result->get_error() : "null", addr_);
+		return false;
+	}
+
+	cache_id_ = cache_->make_id();
+	return true;
+}
+
+void redis_client::set_protocol(int version)
+{
+	protocol_ = version;
+}
+
+void redis_client::set_resp3_types(bool on)
+{
+	resp3_types_ = on;
+}
+
+void redis_client::set_cache(redis_client_cache* cache)
+{
+	cache_ = cache;
+}
+
+void redis_client::set_script_registry(redis_script_registry* scripts,
+	bool preload /* = true */)
+{
+	scripts_ = scripts;
+	preload_ = preload;
+}
+
 void redis_client::close()
 {
 	if (conn_.opened())
 		conn_.close();
+
+	rbuf_      = NULL;
+	rbuf_size_ = 0;
+	rbuf_off_  = 0;
+	rbuf_len_  = 0;
+
+	// ½ЭЭ飬֮ǰʧЧ֪ͨѶʧ
+	resp3_     = false;
+	cache_id_  = 0;
 }
 
 bool redis_client::eof() const
@@ -137,207 +256,194 @@ void redis_client::set_slice_respond(bool on)
 
 /////////////////////////////////////////////////////////////////////////////
 
-void redis_client::put_data(dbuf_pool* pool, redis_result* rr,
-	const char* data, size_t len)
-{
-	char* buf = (char*) pool->dbuf_alloc(len + 1);
-	if (len > 0)
-		memcpy(buf, data, len);
-	buf[len] = 0;
-	rr->put(buf, len);
-}
+// ׸ջĴССڴصĿС(ȱʡԼ 8 KB)Աڴص
+// з䣬صڴ棻Ҵ 1/4Աݱֱ
+// ջ
+#define RBUF_SIZE	4096
 
-redis_result* redis_client::get_redis_error(dbuf_pool* pool)
+// һӦݽ϶ʱջαֵ(ǵݸ)
+#define RBUF_MAX	65536
+
+// ջʣռСڸֵʱµĽջ
+#define RBUF_MIN	1024
+
+redis_result* redis_client::get_redis_result(dbuf_pool* pool, size_t nchildren)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
-	}
+	parser_.reset(pool, nchildren);
+	parser_.set_slice(slice_res_);
+	parser_.set_resp3_types(resp3_types_);
 
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_ERROR);
-	rr->set_size(1);
+	while (true)
+	{
+		if (rbuf_off_ < rbuf_len_)
+		{
+			if (!parse_left())
+				return NULL;
+			if (parser_.finished())
+				return parser_.get_result();
+		}
 
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
+		if (!read_more(pool))
+			return NULL;
+	}
 }
 
-redis_result* redis_client::get_redis_status(dbuf_pool* pool)
+bool redis_client::parse_left(void)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
+	int n = parser_.update_inplace(rbuf_ + rbuf_off_, rbuf_len_ - rbuf_off_);
+	if (n < 0)
 	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
+		logger_error("invalid data, server: %s", addr_);
+		return false;
 	}
 
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_STATUS);
-	rr->set_size(1);
+	rbuf_off_ += (size_t) n;
 
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
+	if (!parser_.get_pushes().empty())
+		handle_pushes();
+	return true;
 }
 
-redis_result* redis_client::get_redis_integer(dbuf_pool* pool)
+bool redis_client::read_more(dbuf_pool* pool)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
+	// δѵţʣռ䲻ʱµ
+	// ջδѵУ֮ǰĽջԱ
+	// ѽĽãڴһͷ
+	size_t left = rbuf_len_ - rbuf_off_;
+	size_t want = parser_.get_want();
+	if (want < left + RBUF_MIN)
+		want = left + RBUF_MIN;
+
+	if (rbuf_ == NULL || rbuf_size_ - rbuf_off_ < want)
 	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
+		size_t size = RBUF_SIZE;
+		if (rbuf_ != NULL)
+			size = rbuf_size_ * 2 > RBUF_MAX ? RBUF_MAX : rbuf_size_ * 2;
+		if (size < want)
+			size = want;
+		char* buf = (char*) pool->dbuf_alloc(size);
+		if (left > 0)
+			memcpy(buf, rbuf_ + rbuf_off_, left);
+
+		rbuf_      = buf;
+		rbuf_size_ = size;
+		rbuf_off_  = 0;
+		rbuf_len_  = left;
 	}
 
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_INTEGER);
-	rr->set_size(1);
+	int ret = conn_.read(rbuf_ + rbuf_len_, rbuf_size_ - rbuf_len_, false);
+	if (ret == -1)
+	{
+		logger_warn("read error: %s, server: %s, fd: %u",
+			last_serror(), addr_, (unsigned) conn_.sock_handle());
+		return false;
+	}
 
-	put_data(pool, rr, buf_.c_str(), buf_.length());
-	return rr;
+	rbuf_len_ += (size_t) ret;
+	return true;
 }
 
-redis_result* redis_client::get_redis_string(dbuf_pool* pool)
+void redis_client::handle_pushes(void)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
-	}
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_STRING);
-	int len = atoi(buf_.c_str());
-	if (len < 0)
-		return rr;
-
-	char*  buf;
+	const std::vector<redis_result*>& pushes = parser_.get_pushes();
 
-	if (!slice_res_)
+	for (std::vector<redis_result*>::const_iterator cit = pushes.begin();
+		cit != pushes.end() && cache_ != NULL; ++cit)
 	{
-		rr->set_size(1);
-		buf = (char*) pool->dbuf_alloc(len + 1);
-		if (len > 0 && conn_.read(buf, (size_t) len) == -1)
+		// ʧЧ֪ͨĵڶԪΪ飬ΪֵʱʾеļʧЧ
+		const redis_result* keys = (*cit)->get_child(1);
+		if (keys == NULL || !keys->is_aggregate())
 		{
-			logger_error("read data error, server: %s", addr_);
-			return NULL;
+			cache_->invalidate_all();
+			continue;
 		}
-		buf[len] = 0;
-		rr->put(buf, (size_t) len);
 
-		//  \r\n
-		buf_.clear();
-		if (conn_.gets(buf_) == false)
+		size_t n = keys->get_size();
+		for (size_t i = 0; i < n; i++)
 		{
-			logger_error("gets line error, server: %s", addr_);
-			return NULL;
+			string_view key = keys->get_child(i)->argv_view();
+			cache_->invalidate(key.data(), key.size());
 		}
-		return rr;
 	}
 
-	// ܷصĴڴֳɲӵڴ洢
-
-#define CHUNK_LENGTH	8192
-
-	size_t size = (size_t) len / CHUNK_LENGTH;
-	if ((size_t) len % CHUNK_LENGTH != 0)
-		size++;
-	rr->set_size(size);
-	int    n;
-
-	while (len > 0)
-	{
-		n = len > CHUNK_LENGTH - 1 ? CHUNK_LENGTH - 1 : len;
-		buf = (char*) pool->dbuf_alloc((size_t) (n + 1));
-		if (conn_.read(buf, (size_t) n) == -1)
-		{
-			logger_error("read data error, server: %s", addr_);
-			return NULL;
-		}
-		buf[n] = 0;
-		rr->put(buf, (size_t) n);
-		len -= n;
-	}
-	
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-	{
-		logger_error("gets line error, server: %s", addr_);
-		return NULL;
-	}
-	return rr;
+	parser_.clear_pushes();
 }
 
-redis_result* redis_client::get_redis_array(dbuf_pool* pool)
+bool redis_client::read_pushes(void)
 {
-	buf_.clear();
-	if (conn_.gets(buf_) == false)
-		return NULL;
+	if (!conn_.opened())
+		return false;
 
-	redis_result* rr = new(pool) redis_result(pool);
-	rr->set_type(REDIS_RESULT_ARRAY);
-	int count = atoi(buf_.c_str());
-	if (count <= 0)
-		return rr;
+	ACL_VSTREAM* vs = conn_.get_vstream();
+	ACL_SOCKET fd = ACL_VSTREAM_SOCK(vs);
 
-	rr->set_size((size_t) count);
+	// ӿʱͨûݿɶʱ
+	if (vs->read_cnt <= 0 && acl_readable(fd) == 0)
+		return true;
 
-	for (int i = 0; i < count; i++)
-	{
-		redis_result* child = get_redis_object(pool);
-		if (child == NULL)
-			return NULL;
-		rr->put(child, i);
-	}
+	dbuf_pool* pool = new dbuf_pool;
+	bool ok = true;
 
-	return rr;
-}
+	parser_.reset(pool);
+	parser_.set_resp3_types(resp3_types_);
 
-redis_result* redis_client::get_redis_object(dbuf_pool* pool)
-{
-	char ch;
-	if (conn_.read(ch) == false)
+	while (true)
 	{
-		logger_warn("read char error: %s, server: %s, fd: %u",
-			last_serror(), addr_, (unsigned) conn_.sock_handle());
-		return NULL;
-	}
+		if (rbuf_off_ < rbuf_len_)
+		{
+			if (!parse_left())
+			{
+				ok = false;
+				break;
+			}
 
-	switch (ch)
-	{
-	case '-':	// ERROR
-		return get_redis_error(pool);
-	case '+':	// STATUS
-		return get_redis_status(pool);
-	case ':':	// INTEGER
-		return get_redis_integer(pool);
-	case '$':	// STRING
-		return get_redis_string(pool);
-	case '*':	// ARRAY
-		return get_redis_array(pool);
-	default:	// INVALID
-		logger_error("invalid first char: %c, %d", ch, ch);
-		return NULL;
+			// ӿʱӦյʧЧ֪֮ͨ
+			if (parser_.finished())
+			{
+				logger_error("unexpected data, server: %s", addr_);
+				ok = false;
+				break;
+			}
+		}
+
+		// ѶϢѴûкʱ
+		if (parser_.idle() && rbuf_off_ == rbuf_len_
+			&& vs->read_cnt <= 0 && acl_readable(fd) == 0)
+		{
+			break;
+		}
+
+		if (!read_more(pool))
+		{
+			ok = false;
+			break;
+		}
 	}
-}
 
-redis_result* redis_client::get_redis_objects(dbuf_pool* pool, size_t nobjs)
-{
-	acl_assert(nobjs >= 1);
+	// ջڴһͷ
+	rbuf_      = NULL;
+	rbuf_size_ = 0;
+	rbuf_off_  = 0;
+	rbuf_len_  = 0;
+	pool->destroy();
 
-	redis_result* objs = new(pool) redis_result(pool);
-	objs->set_type(REDIS_RESULT_ARRAY);
-	objs->set_size(nobjs);
+	if (!ok)
+		close();
+	return ok;
+}
 
-	for (size_t i = 0; i < nobjs; i++)
-	{
-		redis_result* obj = get_redis_object(pool);
-		if (obj == NULL)
-			return NULL;
-		objs->put(obj, i);
-	}
-	return objs;
+void redis_client::unread_left(void)
+{
+	// ںӦݷŻУΪջ汾εڴ
+	// һͷţҺӦʹڴ
+	if (rbuf_off_ < rbuf_len_ && conn_.opened())
+		acl_vstream_unread(conn_.get_vstream(), rbuf_ + rbuf_off_,
+			rbuf_len_ - rbuf_off_);
+
+	rbuf_      = NULL;
+	rbuf_size_ = 0;
+	rbuf_off_  = 0;
+	rbuf_len_  = 0;
 }
 
 const redis_result* redis_client::run(dbuf_pool* pool, const string& req,
@@ -381,13 +487,10 @@ const redis_result* redis_client::run(dbuf_pool* pool, const string& req,
 			return NULL;
 		}
 
-		if (nchildren >= 1)
-			result = get_redis_objects(pool, nchildren);
-		else
-			result = get_redis_object(pool);
-
+		result = get_redis_result(pool, nchildren);
 		if (result != NULL)
 		{
+			unread_left();
 			if (rw_timeout != NULL)
 				conn_.set_rw_timeout(rw_timeout_);
 			return result;
@@ -463,13 +566,10 @@ const redis_result* redis_client::run(dbuf_pool* pool, const redis_request& req,
 			return NULL;
 		}
 
-		if (nchildren >= 1)
-			result = get_redis_objects(pool, nchildren);
-		else
-			result = get_redis_object(pool);
-
+		result = get_redis_result(pool, nchildren);
 		if (result != NULL)
 		{
+			unread_left();
 			if (rw_timeout != NULL)
 				conn_.set_rw_timeout(rw_timeout_);
 			return result;
@@ -491,4 +591,140 @@ const redis_result* redis_client::run(dbuf_pool* pool, const redis_request& req,
 	return NULL;
 }
 
+// ÿ writev ʱ iovec ⳬϵͳ IOV_MAX 
+#define	PIPELINE_IOV_MAX	512
+
+int redis_client::writev_all(const struct iovec* iov, int count)
+{
+	int j, k;
+
+	for (j = 0; j < count; j += PIPELINE_IOV_MAX)
+	{
+		k = count - j;
+		if (k > PIPELINE_IOV_MAX)
+			k = PIPELINE_IOV_MAX;
+		if (conn_.writev(iov + j, k) == -1)
+			return j;
+	}
+
+	return count;
+}
+
+size_t redis_client::run(dbuf_pool* pool, const struct iovec* iov, int count,
+	const size_t* nchildren, const redis_result** results, size_t n,
+	int* rw_timeout /* = NULL */)
+{
+	bool retried = false;
+	size_t i;
+	int j;
+
+	while (true)
+	{
+		if (open() == false)
+			return 0;
+
+		if (rw_timeout != NULL)
+			conn_.set_rw_timeout(*rw_timeout);
+
+		if (check_addr_ && check_connection(conn_) == false)
+		{
+			logger_error("CHECK_CONNECTION FAILED!");
+			close();
+			return 0;
+		}
+
+		j = writev_all(iov, count);
+		if (j < count)
+		{
+			close();
+
+			// дʧܣ˵δյ
+			if (retry_ && !retried && j == 0)
+			{
+				retried = true;
+				continue;
+			}
+
+			logger_error("write to redis(%s) error: %s",
+				addr_, last_serror());
+			return 0;
+		}
+
+		i = read(pool, nchildren, results, n);
+		if (i == n)
+		{
+			if (rw_timeout != NULL)
+				conn_.set_rw_timeout(rw_timeout_);
+			return n;
+		}
+
+		// ֻδκӦʱԣӳеѱ˹رգ
+		// ظִѱ˴
+		if (i > 0 || !retry_ || retried)
+		{
+			logger_error("read from redis(%s) error: %s, %d/%d",
+				addr_, last_serror(), (int) i, (int) n);
+			return i;
+		}
+
+		retried = true;
+	}
+}
+
+int redis_client::send(const struct iovec* iov, int count)
+{
+	bool retried = false;
+
+	while (true)
+	{
+		if (open() == false)
+			return 0;
+
+		if (check_addr_ && check_connection(conn_) == false)
+		{
+			logger_error("CHECK_CONNECTION FAILED!");
+			close();
+			return 0;
+		}
+
+		int j = writev_all(iov, count);
+		if (j == count)
+			return count;
+
+		close();
+
+		// дʧܣ˵δյ
+		if (retry_ && !retried && j == 0)
+		{
+			retried = true;
+			continue;
+		}
+
+		logger_error("write to redis(%s) error: %s",
+			addr_, last_serror());
+		return j;
+	}
+}
+
+size_t redis_client::read(dbuf_pool* pool, const size_t* nchildren,
+	const redis_result** results, size_t n)
+{
+	if (!conn_.opened())
+		return 0;
+
+	size_t i;
+	for (i = 0; i < n; i++)
+	{
+		results[i] = get_redis_result(pool, nchildren[i]);
+		if (results[i] == NULL)
+			break;
+	}
+
+	if (i == n)
+		unread_left();
+	else
+		close();
+	return i;
+}
+
 } // end namespace acl
@@ -0,0 +1,247 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include <algorithm>
+#include <vector>
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/redis/redis_client_cache.hpp"
+#endif
+
+namespace acl
+{
+
+struct redis_client_cache::cache_value
+{
+	string data;
+	bool   nil;
+
+	// ȡֵӵĻʶЩյֵʧЧ֪ͨ
+	std::vector<unsigned long long> owners;
+};
+
+struct redis_client_cache::cache_item
+{
+	string key;
+	cache_value* value;			// GET Ľ
+	std::map<string, cache_value*> fields;	// HGET Ľ
+	std::list<cache_item*>::iterator pos;	//  lru_ еλ
+};
+
+redis_client_cache::redis_client_cache(size_t max_count /* = 10000 */)
+: max_count_(max_count > 0 ? max_count : 1)
+, count_(0)
+, id_(0)
+, hits_(0)
+, misses_(0)
+, invalidations_(0)
+{
+}
+
+redis_client_cache::~redis_client_cache(void)
+{
+	while (!items_.empty())
+		remove(items_.begin());
+}
+
+unsigned long long redis_client_cache::make_id(void)
+{
+	lock_.lock();
+	unsigned long long id = ++id_;
+	lock_.unlock();
+	return id;
+}
+
+void redis_client_cache::reset_statistics(void)
+{
+	lock_.lock();
+	hits_          = 0;
+	misses_        = 0;
+	invalidations_ = 0;
+	lock_.unlock();
+}
+
+bool redis_client_cache::get(unsigned long long id, const char* key,
+	size_t klen, const char* field, size_t flen, dbuf_pool* dbuf,
+	const char** data, size_t* len)
+{
+	string name(key, klen);
+
+	lock_.lock();
+
+	cache_value* value = NULL;
+	std::map<string, cache_item*>::iterator it = items_.find(name);
+	if (it != items_.end())
+	{
+		cache_item* item = it->second;
+		if (field == NULL)
+			value = item->value;
+		else
+		{
+			std::map<string, cache_value*>::iterator fit =
+				item->fields.find(string(field, flen));
+			if (fit != item->fields.end())
+				value = fit->second;
+		}
+
+		// ȡֵӲſʹ֮
+		if (value != NULL && std::find(value->owners.begin(),
+			value->owners.end(), id) == value->owners.end())
+		{
+			value = NULL;
+		}
+
+		if (value != NULL)
+			lru_.splice(lru_.begin(), lru_, item->pos);
+	}
+
+	if (value == NULL)
+	{
+		misses_++;
+		lock_.unlock();
+		return false;
+	}
+
+	hits_++;
+	if (value->nil)
+	{
+		*data = NULL;
+		*len  = 0;
+	}
+	else
+	{
+		// ֵΪݣʹ dbuf_strndup
+		size_t n = value->data.size();
+		char* buf = (char*) dbuf->dbuf_alloc(n + 1);
+		memcpy(buf, value->data.c_str(), n);
+		buf[n] = 0;
+		*data = buf;
+		*len  = n;
+	}
+
+	lock_.unlock();
+	return true;
+}
+
+void redis_client_cache::put(unsigned long long id, const char* key,
+	size_t klen, const char* field, size_t flen, const char* data,
+	size_t len)
+{
+	string name(key, klen);
+
+	lock_.lock();
+
+	cache_item* item;
+	std::map<string, cache_item*>::iterator it = items_.find(name);
+	if (it != items_.end())
+	{
+		item = it->second;
+		lru_.splice(lru_.begin(), lru_, item->pos);
+	}
+	else
+	{
+		item = NEW cache_item;
+		item->key   = name;
+		item->value = NULL;
+		lru_.push_front(item);
+		item->pos = lru_.begin();
+		items_[name] = item;
+	}
+
+	cache_value** slot;
+	if (field == NULL)
+		slot = &item->value;
+	else
+		slot = &item->fields[string(field, flen)];
+
+	cache_value* value = *slot;
+	if (value == NULL)
+	{
+		value = NEW cache_value;
+		*slot = value;
+		count_++;
+	}
+	else if (value->nil != (data == NULL) || (data != NULL
+		&& (value->data.size() != len
+			|| memcmp(value->data.c_str(), data, len) != 0)))
+	{
+		// ֵѱ仯֮ǰȡֵӲʹ֮
+		value->owners.clear();
+	}
+
+	value->nil = data == NULL;
+	if (data != NULL)
+		value->data.copy(data, len);
+	else
+		value->data.clear();
+
+	if (std::find(value->owners.begin(), value->owners.end(), id)
+		== value->owners.end())
+	{
+		value->owners.push_back(id);
+	}
+
+	evict();
+
+	lock_.unlock();
+}
+
+void redis_client_cache::invalidate(const char* key, size_t len)
+{
+	string name(key, len);
+
+	lock_.lock();
+
+	invalidations_++;
+	std::map<string, cache_item*>::iterator it = items_.find(name);
+	if (it != items_.end())
+		remove(it);
+
+	lock_.unlock();
+}
+
+void redis_client_cache::invalidate_all(void)
+{
+	lock_.lock();
+
+	invalidations_++;
+	while (!items_.empty())
+		remove(items_.begin());
+
+	lock_.unlock();
+}
+
+void redis_client_cache::remove(std::map<string, cache_item*>::iterator it)
+{
+	cache_item* item = it->second;
+
+	if (item->value)
+	{
+		delete item->value;
+		count_--;
+	}
+
+	for (std::map<string, cache_value*>::iterator fit = item->fields.begin();
+		fit != item->fields.end(); ++fit)
+	{
+		delete fit->second;
+		count_--;
+	}
+
+	lru_.erase(item->pos);
+	items_.erase(it);
+	delete item;
+}
+
+void redis_client_cache::evict(void)
+{
+	// ̭δʵļշʵļ
+	while (count_ > max_count_ && lru_.size() > 1)
+	{
+		std::map<string, cache_item*>::iterator it =
+			items_.find(lru_.back()->key);
+		if (it == items_.end())
+			break;
+		remove(it);
+	}
+}
+
+} // namespace acl
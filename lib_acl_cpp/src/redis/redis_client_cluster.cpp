@@ -1,7 +1,10 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
 #include <vector>
+#include <map>
 #include "acl_cpp/stdlib/snprintf.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stdlib/thread_queue.hpp"
 #include "acl_cpp/redis/redis_cluster.hpp"
 #include "acl_cpp/redis/redis_slot.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
@@ -9,24 +12,200 @@
 #include "acl_cpp/redis/redis_client_cluster.hpp"
 #endif
 
+#ifndef	ACL_WINDOWS
+#include <sched.h>
+#endif
+
 namespace acl
 {
 
+// ϣӳΪеÿһָһ SEG_SIZE ϣ۵
+// Σ޸ĳϣʱ踴ƶ鼰òڵĶΣĶα¾ɱ
+#define SEG_SHIFT	8
+#define SEG_SIZE	(1 << SEG_SHIFT)
+#define SEG_MASK	(SEG_SIZE - 1)
+
+// ı滻ıʱȴ֮ǰĶȫͷ
+#define RETIRED_MAX	16
+
+// 滻Ĺϣӳӽ飬߳ӳԽ
+// 滻֮۲쵽ûжʱͷţμ reclaim
+struct redis_client_cluster::retired_table
+{
+	redis_client_pool*** top;		// ɵĶ飬Ϊ NULL
+	std::vector<redis_client_pool**> segs;	// ٱ±õĶλӽ
+};
+
+void redis_client_cluster::free_retired(retired_table* table)
+{
+	std::vector<redis_client_pool**>::iterator it = table->segs.begin();
+	for (; it != table->segs.end(); ++it)
+		acl_myfree(*it);
+	if (table->top)
+		acl_myfree(table->top);
+	delete table;
+}
+
+static void atomic_add(ACL_ATOMIC* counter, int n)
+{
+	while (true)
+	{
+		void* old = acl_atomic_get(counter);
+		void* now = (void*) ((size_t) old + n);
+		if (acl_atomic_cas(counter, old, now) == old)
+			break;
+	}
+}
+
+static bool atomic_zero(ACL_ATOMIC* counter)
+{
+	// ԱȽϽķʽȡԱ֤֮ǰ滻֮űȡ
+	return acl_atomic_cas(counter, NULL, NULL) == NULL;
+}
+
+// ʹϣӳӽڼǼΪߣǼ epoch ǰ
+// ָļ
+class redis_slots_reader : public noncopyable
+{
+public:
+	redis_slots_reader(ACL_ATOMIC* epoch, ACL_ATOMIC** readers)
+	{
+		readers_ = readers[(size_t) acl_atomic_get(epoch) & 1];
+		atomic_add(readers_, 1);
+	}
+
+	~redis_slots_reader(void)
+	{
+		atomic_add(readers_, -1);
+	}
+
+private:
+	ACL_ATOMIC* readers_;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// ˢ̵߳Ϣstop_ Ϊ true ʱʾ߳˳ʾˢ
+class redis_slots_msg : public thread_qitem
+{
+public:
+	redis_slots_msg(bool stop) : stop_(stop) {}
+	~redis_slots_msg(void) {}
+
+	bool stop_;
+};
+
+// ̨ˢ¹ϣӳ̣߳ƽʱÿ inter ˢһΣյϢʱˢ
+class redis_slots_refresher : public thread
+{
+public:
+	redis_slots_refresher(redis_client_cluster& cluster, int inter)
+	: cluster_(cluster), inter_(inter > 0 ? inter : 60) {}
+	~redis_slots_refresher(void) {}
+
+	void notify(bool stop)
+	{
+		queue_.push(NEW redis_slots_msg(stop));
+	}
+
+protected:
+	// @override
+	void* run(void)
+	{
+		while (true)
+		{
+			redis_slots_msg* msg = (redis_slots_msg*)
+				queue_.pop(inter_ * 1000);
+			if (msg != NULL)
+			{
+				bool stop = msg->stop_;
+				delete msg;
+				if (stop)
+					break;
+			}
+
+			(void) cluster_.refresh_slots();
+		}
+
+		return NULL;
+	}
+
+private:
+	redis_client_cluster& cluster_;
+	int inter_;
+	thread_queue queue_;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 redis_client_cluster::redis_client_cluster(int max_slot /* = 16384 */)
 : max_slot_(max_slot)
+, pending_(NULL)
+, publish_when_(0)
 , redirect_max_(15)
 , redirect_sleep_(100)
+, cache_(NULL)
+, protocol_(2)
+, scripts_(NULL)
+, preload_(false)
+, read_policy_(REDIS_READ_MASTER)
+, max_conns_(0)
+, refresher_(NULL)
+, moved_limit_(0)
+, moved_when_(0)
+, moved_recent_(0)
+, moved_count_(0)
+, ask_count_(0)
+, refresh_count_(0)
+, change_count_(0)
 {
-	slot_addrs_ = (const char**) acl_mycalloc(max_slot_, sizeof(char*));
+	nsegs_ = (max_slot_ + SEG_SIZE - 1) >> SEG_SHIFT;
+
+	redis_client_pool*** top = (redis_client_pool***)
+		acl_mymalloc(nsegs_ * sizeof(redis_client_pool**));
+	for (int i = 0; i < nsegs_; i++)
+		top[i] = (redis_client_pool**) acl_mycalloc(SEG_SIZE,
+			sizeof(redis_client_pool*));
+
+	slots_ = acl_atomic_new();
+	acl_atomic_set(slots_, top);
+	epoch_ = acl_atomic_new();
+	acl_atomic_set(epoch_, NULL);
+	for (int i = 0; i < 2; i++)
+	{
+		readers_[i] = acl_atomic_new();
+		acl_atomic_set(readers_[i], NULL);
+	}
 }
 
 redis_client_cluster::~redis_client_cluster()
 {
-	acl_myfree(slot_addrs_);
+	stop_refresher();
 
-	std::vector<char*>::iterator it = addrs_.begin();
-	for (; it != addrs_.end(); ++it)
-		acl_myfree(*it);
+	redis_client_pool*** top = (redis_client_pool***)
+		acl_atomic_get(slots_);
+	// δıб޸ĹĶΪ˽
+	if (pending_ != NULL)
+	{
+		for (int i = 0; i < nsegs_; i++)
+		{
+			if (pending_[i] != top[i])
+				acl_myfree(pending_[i]);
+		}
+		acl_myfree(pending_);
+	}
+
+	for (int i = 0; i < nsegs_; i++)
+		acl_myfree(top[i]);
+	acl_myfree(top);
+	acl_atomic_free(slots_);
+
+	std::list<retired_table*>::iterator it = retired_.begin();
+	for (; it != retired_.end(); ++it)
+		free_retired(*it);
+	acl_atomic_free(epoch_);
+	acl_atomic_free(readers_[0]);
+	acl_atomic_free(readers_[1]);
 }
 
 void redis_client_cluster::set_redirect_max(int max)
@@ -53,6 +232,12 @@ connect_pool* redis_client_cluster::create_pool(const char* addr,
 	{
 		pool->set_password(cit->second.c_str());
 	}
+	pool->set_cache(cache_);
+	pool->set_protocol(protocol_);
+	pool->set_script_registry(scripts_, preload_);
+
+	if ((cit = zones_.find(key)) != zones_.end())
+		pool->set_zone(cit->second.c_str());
 
 	return pool;
 }
@@ -62,32 +247,146 @@ redis_client_pool* redis_client_cluster::peek_slot(int slot)
 	if (slot < 0 || slot >= max_slot_)
 		return NULL;
 
-	// Ҫ
-	lock();
+	// ϣӳֻģ˱仯ʱ滻Դ˴
+	redis_slots_reader reader(epoch_, readers_);
+	redis_client_pool*** top = (redis_client_pool***)
+		acl_atomic_get(slots_);
+	return top[slot >> SEG_SHIFT][slot & SEG_MASK];
+}
 
-	if (slot_addrs_[slot] == NULL)
+redis_client_pool* redis_client_cluster::peek_pending(int slot) const
+{
+	// ѼȲ鿴δı
+	redis_client_pool*** top = pending_ ? pending_ : (redis_client_pool***)
+		acl_atomic_get(slots_);
+	return top[slot >> SEG_SHIFT][slot & SEG_MASK];
+}
+
+redis_client_pool*** redis_client_cluster::copy_slots()
+{
+	// Ѽδıʱֱӽӹ֮ʹۻ޸֮
+	if (pending_ != NULL)
 	{
-		unlock();
-		return NULL;
+		redis_client_pool*** top = pending_;
+		pending_ = NULL;
+		return top;
 	}
 
-	// ΪѾ˼ڵ get ʱĵڶΪ false
-	redis_client_pool* conns =
-		(redis_client_pool*) get(slot_addrs_[slot], false);
+	// ƶ飬ڱ޸ǰ뵱ǰ
+	redis_client_pool*** top = (redis_client_pool***)
+		acl_mymalloc(nsegs_ * sizeof(redis_client_pool**));
+	memcpy(top, acl_atomic_get(slots_),
+		nsegs_ * sizeof(redis_client_pool**));
+	return top;
+}
 
-	unlock();
+void redis_client_cluster::set_slot_pool(redis_client_pool*** top, int slot,
+	redis_client_pool* conns) const
+{
+	redis_client_pool*** curr = (redis_client_pool***)
+		acl_atomic_get(slots_);
+	int idx = slot >> SEG_SHIFT;
+
+	// ö뵱ǰʱȸ
+	if (top[idx] == curr[idx])
+	{
+		top[idx] = (redis_client_pool**) acl_mymalloc(SEG_SIZE
+			* sizeof(redis_client_pool*));
+		memcpy(top[idx], curr[idx], SEG_SIZE
+			* sizeof(redis_client_pool*));
+	}
+
+	top[idx][slot & SEG_MASK] = conns;
+}
+
+void redis_client_cluster::publish_slots(redis_client_pool*** top)
+{
+	// Ѽ
+	redis_client_pool*** old = (redis_client_pool***)
+		acl_atomic_xchg(slots_, top);
+
+	std::vector<redis_client_pool**> segs;
+	for (int i = 0; i < nsegs_; i++)
+	{
+		if (old[i] != top[i])
+			segs.push_back(old[i]);
+	}
+
+	retire(old, segs);
+}
+
+void redis_client_cluster::retire(redis_client_pool*** top,
+	const std::vector<redis_client_pool**>& segs)
+{
+	// Ѽ
+	retired_table* old = NEW retired_table;
+	old->top  = top;
+	old->segs = segs;
+	retired_.push_back(old);
+
+	reclaim();
+}
+
+void redis_client_cluster::reclaim(void)
+{
+	// Ѽɱѱ滻ʱûжߣ֮ǰĶ߾
+	// ʣ֮Ķֻܿ±Կͷеľɱ
+	// ʱľɱ࣬ȴ֮ǰĶ߽
+	if (retired_.empty())
+		return;
+	if (retired_.size() >= RETIRED_MAX)
+		synchronize();
+	else if (!atomic_zero(readers_[0]) || !atomic_zero(readers_[1]))
+		return;
 
-	return conns;
+	std::list<retired_table*>::iterator it = retired_.begin();
+	for (; it != retired_.end(); ++it)
+		free_retired(*it);
+	retired_.clear();
+}
+
+void redis_client_cluster::synchronize(void)
+{
+	// Ѽл epoch µĶߵǼһУԭ
+	// еĶ߸ػʱڽΪ 0߿лǰȡ
+	// epoch ֮ǼǣлΣʹȴһ
+	for (int i = 0; i < 2; i++)
+	{
+		size_t epoch = (size_t) acl_atomic_get(epoch_);
+		acl_atomic_cas(epoch_, (void*) epoch, (void*) (epoch ^ 1));
+
+		int ntries = 0;
+		while (!atomic_zero(readers_[epoch & 1]))
+		{
+			if (++ntries < 1000)
+			{
+#ifdef	ACL_WINDOWS
+				Sleep(0);
+#else
+				sched_yield();
+#endif
+			}
+			else
+				acl_doze(1);
+		}
+	}
 }
 
 void redis_client_cluster::clear_slot(int slot)
 {
-	if (slot >= 0 && slot < max_slot_)
+	if (slot < 0 || slot >= max_slot_)
+		return;
+
+	lock();
+
+	if (peek_pending(slot) != NULL)
 	{
-		lock();
-		slot_addrs_[slot] = NULL;
-		unlock();
+		pending_ = copy_slots();
+		set_slot_pool(pending_, slot, NULL);
 	}
+
+	publish_pending();
+	unlock();
 }
 
 void redis_client_cluster::set_slot(int slot, const char* addr)
@@ -95,34 +394,39 @@ void redis_client_cluster::set_slot(int slot, const char* addr)
 	if (slot < 0 || slot >= max_slot_ || addr == NULL || *addr == 0)
 		return;
 
-	// еַõֱַӣȻʹ֮ slot й
-
 	// öδҪ
 	lock();
 
-	std::vector<char*>::const_iterator cit = addrs_.begin();
-	for (; cit != addrs_.end(); ++cit)
-	{
-		if (strcmp((*cit), addr) == 0)
-			break;
-	}
+	// ΪѾ˼ڵ get ʱĵڶΪ false
+	redis_client_pool* conns = (redis_client_pool*) get(addr, false);
 
-	//  slot ַйӳ
-	if (cit != addrs_.end())
-		slot_addrs_[slot] = *cit;
-	else
+	// ӳϵδʱ滻ӳ MOVED ضʱƵ
+	if (peek_pending(slot) != conns)
 	{
-		// ֻԲö̬䷽ʽΪӶʱ
-		// ̬ӵĶ̬ڴַǹ̶ģ
-		// slot_addrs_ ±ַҲԲ
-		char* buf = acl_mystrdup(addr);
-		addrs_.push_back(buf);
-		slot_addrs_[slot] = buf;
+		pending_ = copy_slots();
+		set_slot_pool(pending_, slot, conns);
 	}
 
+	publish_pending();
 	unlock();
 }
 
+void redis_client_cluster::publish_pending(void)
+{
+	// Ѽÿ෢һΣͬһϣ۵޸ۻ
+	// δıУѸƵĶοֱ޸ģ֮ MOVEDˢ
+	// һ MOVED 籩ӳغľʱÿζһΣδ
+	// ڼԻᰴ MOVED ض
+	time_t now = time(NULL);
+	if (pending_ != NULL && now != publish_when_)
+	{
+		publish_when_ = now;
+		publish_slots(copy_slots());
+	}
+	else
+		reclaim();
+}
+
 void redis_client_cluster::set_all_slot(const char* addr, int max_conns)
 {
 	redis_client client(addr, 30, 60, false);
@@ -132,8 +436,46 @@ void redis_client_cluster::set_all_slot(const char* addr, int max_conns)
 	if (slots == NULL)
 		return;
 
+	lock();
+	addr_      = addr;
+	max_conns_ = max_conns;
+	unlock();
+
+	(void) apply_slots(*slots, max_conns);
+}
+
+int redis_client_cluster::apply_slots(const std::vector<redis_slot*>& slots,
+	int max_conns)
+{
+	// ȴнӳأΪ set ڲ½ӳԤȽ
+	// һӣϣл½Ҫȴӽ
 	std::vector<redis_slot*>::const_iterator cit;
-	for (cit = slots->begin(); cit != slots->end(); ++cit)
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
+	{
+		const redis_slot* slot = *cit;
+		const char* ip = slot->get_ip();
+		if (*ip == 0 || slot->get_port() <= 0)
+			continue;
+
+		char buf[128];
+		safe_snprintf(buf, sizeof(buf), "%s:%d", ip, slot->get_port());
+		redis_client_pool* conns = (redis_client_pool*) get(buf);
+		if (conns != NULL)
+			continue;
+
+		conns = (redis_client_pool*) &set(buf, max_conns);
+		connect_client* conn = conns->peek();
+		if (conn != NULL)
+			conns->put(conn, true);
+	}
+
+	// µӳ÷仯ĹϣۣȻһ滻ɱ
+	lock();
+
+	redis_client_pool*** top = NULL;
+	int nchanged = 0;
+
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
 	{
 		const redis_slot* slot = *cit;
 		const char* ip = slot->get_ip();
@@ -147,16 +489,424 @@ void redis_client_cluster::set_all_slot(const char* addr, int max_conns)
 		size_t slot_max = slot->get_slot_max();
 		if ((int) slot_max >= max_slot_ || slot_max < slot_min)
 			continue;
-		
+
 		char buf[128];
 		safe_snprintf(buf, sizeof(buf), "%s:%d", ip, port);
-		redis_client_pool* conns = (redis_client_pool*) get(buf);
-		if (conns == NULL)
-			set(buf, max_conns);
+		redis_client_pool* conns = (redis_client_pool*) get(buf, false);
 
 		for (size_t i = slot_min; i <= slot_max; i++)
-			set_slot((int) i, buf);
+		{
+			if (peek_pending((int) i) == conns)
+				continue;
+			if (top == NULL)
+				top = copy_slots();
+			set_slot_pool(top, (int) i, conns);
+			nchanged++;
+		}
+	}
+
+	// δıһʱҲ轫䷢
+	if (top == NULL && pending_ != NULL)
+		top = copy_slots();
+	if (top != NULL)
+		publish_slots(top);
+
+	unlock();
+
+	// ҪӽʱΪӽ㴴ӳ
+	if (read_policy_ == REDIS_READ_MASTER)
+		return nchanged;
+
+	std::map<string, std::vector<string> > masters;
+	for (cit = slots.begin(); cit != slots.end(); ++cit)
+	{
+		const redis_slot* slot = *cit;
+		if (*slot->get_ip() == 0 || slot->get_port() <= 0)
+			continue;
+
+		string master;
+		master.format("%s:%d", slot->get_ip(), slot->get_port());
+		std::vector<string>& replicas = masters[master];
+		replicas.clear();
+
+		const std::vector<redis_slot*>& slaves = slot->get_slaves();
+		for (std::vector<redis_slot*>::const_iterator it =
+			slaves.begin(); it != slaves.end(); ++it)
+		{
+			if (*(*it)->get_ip() == 0 || (*it)->get_port() <= 0)
+				continue;
+
+			string replica;
+			replica.format("%s:%d", (*it)->get_ip(),
+				(*it)->get_port());
+			replicas.push_back(replica);
+		}
+	}
+
+	for (std::map<string, std::vector<string> >::const_iterator it =
+		masters.begin(); it != masters.end(); ++it)
+	{
+		set_replicas(it->first, it->second, max_conns);
+	}
+
+	return nchanged;
+}
+
+int redis_client_cluster::refresh_slots()
+{
+	// ʹӽ㣬Ȼγ֪Ľ
+	std::vector<string> addrs;
+	int max_conns;
+
+	lock();
+	if (!addr_.empty())
+		addrs.push_back(addr_);
+	for (std::vector<connect_pool*>::const_iterator it = pools_.begin();
+		it != pools_.end(); ++it)
+	{
+		if ((*it)->aliving())
+			addrs.push_back((*it)->get_addr());
+	}
+	max_conns = max_conns_;
+	unlock();
+
+	for (std::vector<string>::const_iterator it = addrs.begin();
+		it != addrs.end(); ++it)
+	{
+		redis_client client(*it, 10, 10, false);
+
+		string key(*it);
+		key.lower();
+		std::map<string, string>::const_iterator cit;
+		if ((cit = passwds_.find(key)) != passwds_.end()
+			|| (cit = passwds_.find("default")) != passwds_.end())
+		{
+			client.set_password(cit->second.c_str());
+		}
+
+		redis_cluster cluster(&client);
+		const std::vector<redis_slot*>* slots = cluster.cluster_slots();
+		if (slots == NULL || slots->empty())
+			continue;
+
+		int nchanged = apply_slots(*slots, max_conns);
+
+		stat_lock_.lock();
+		refresh_count_++;
+		if (nchanged > 0)
+			change_count_++;
+		stat_lock_.unlock();
+
+		if (nchanged > 0)
+			logger("slots changed: %d, from %s", nchanged,
+				it->c_str());
+		return nchanged;
+	}
+
+	logger_warn("no node available for CLUSTER SLOTS");
+	return -1;
+}
+
+void redis_client_cluster::set_replicas(const char* master,
+	const std::vector<string>& replicas, int max_conns)
+{
+	// ȴдӽӳأΪ set ڲ
+	std::vector<string>::const_iterator cit;
+	for (cit = replicas.begin(); cit != replicas.end(); ++cit)
+	{
+		redis_client_pool* conns = (redis_client_pool*) get(*cit);
+		if (conns == NULL)
+			conns = (redis_client_pool*) &set(*cit, max_conns);
+		conns->set_readonly(true);
+	}
+
+	lock();
+
+	redis_client_pool* conns = (redis_client_pool*) get(master, false);
+	if (conns == NULL)
+	{
+		unlock();
+		logger_warn("no pool for master: %s", master);
+		return;
+	}
+
+	// µĴӽ NULL ӳͷ
+	redis_client_pool** arr = NULL;
+	size_t n = 0;
+	for (cit = replicas.begin(); cit != replicas.end(); ++cit)
+	{
+		redis_client_pool* replica = (redis_client_pool*)
+			get(*cit, false);
+		if (replica == NULL || replica == conns)
+			continue;
+		if (arr == NULL)
+			arr = (redis_client_pool**) acl_mycalloc(
+				replicas.size() + 1, sizeof(redis_client_pool*));
+		arr[n++] = replica;
+	}
+
+	// ӽδʱ滻ⶨˢʱƵ
+	redis_client_pool** curr = conns->get_replicas();
+	size_t i = 0;
+	if (curr != NULL && arr != NULL)
+	{
+		while (i < n && curr[i] == arr[i])
+			i++;
+	}
+	if (i == n && (curr == NULL ? n == 0 : curr[n] == NULL))
+	{
+		if (arr != NULL)
+			acl_myfree(arr);
+		unlock();
+		return;
+	}
+
+	redis_client_pool** old = conns->set_replicas(arr);
+	if (old != NULL)
+		retire(NULL, std::vector<redis_client_pool**>(1, old));
+
+	unlock();
+}
+
+void redis_client_cluster::remove_replica(redis_client_pool* conns)
+{
+	// ѼӸĴӽɾӳ
+	for (std::vector<connect_pool*>::iterator it = pools_.begin();
+		it != pools_.end(); ++it)
+	{
+		redis_client_pool* master = (redis_client_pool*) (*it);
+		redis_client_pool** replicas = master->get_replicas();
+		if (replicas == NULL)
+			continue;
+
+		size_t n = 0;
+		bool found = false;
+		for (; replicas[n] != NULL; n++)
+		{
+			if (replicas[n] == conns)
+				found = true;
+		}
+		if (!found)
+			continue;
+
+		redis_client_pool** arr = NULL;
+		if (n > 1)
+		{
+			arr = (redis_client_pool**) acl_mycalloc(n,
+				sizeof(redis_client_pool*));
+			for (size_t i = 0, j = 0; i < n; i++)
+			{
+				if (replicas[i] != conns)
+					arr[j++] = replicas[i];
+			}
+		}
+
+		retire(NULL, std::vector<redis_client_pool**>(1,
+			master->set_replicas(arr)));
+	}
+}
+
+// õ k õĴӽ㣬zone ǿʱͬĽ
+static redis_client_pool* nth_replica(redis_client_pool** replicas,
+	size_t k, const char* zone)
+{
+	for (size_t i = 0; replicas[i] != NULL; i++)
+	{
+		redis_client_pool* replica = replicas[i];
+		if (!replica->aliving())
+			continue;
+		if (zone && strcmp(replica->get_zone(), zone) != 0)
+			continue;
+		if (k-- == 0)
+			return replica;
+	}
+
+	return NULL;
+}
+
+redis_client_pool* redis_client_cluster::peek_read_slot(int slot)
+{
+	redis_client_pool* master = peek_slot(slot);
+	if (master == NULL || read_policy_ == REDIS_READ_MASTER)
+		return master;
+
+	// ӽϣӳһֻģԴ˴
+	redis_slots_reader reader(epoch_, readers_);
+	redis_client_pool** replicas = master->get_replicas();
+	if (replicas == NULL)
+		return master;
+
+	const char* zone = read_policy_ == REDIS_READ_ZONE && !zone_.empty()
+		? zone_.c_str() : NULL;
+	redis_client_pool* best = NULL;
+	double min = 0;
+	size_t n = 0, nzone = 0;
+
+	for (size_t i = 0; replicas[i] != NULL; i++)
+	{
+		redis_client_pool* replica = replicas[i];
+		if (!replica->aliving())
+			continue;
+		n++;
+
+		if (zone && strcmp(replica->get_zone(), zone) == 0)
+			nzone++;
+
+		if (read_policy_ == REDIS_READ_LATENCY)
+		{
+			// δͳӦʱĽ㱻ѡԱӦʱ
+			double ms = replica->get_latency();
+			if (best == NULL || ms < min)
+			{
+				best = replica;
+				min  = ms;
+			}
+		}
+	}
+
+	if (n == 0)
+		return master;
+
+	switch (read_policy_)
+	{
+	case REDIS_READ_LATENCY:
+		return best;
+	case REDIS_READ_ZONE:
+		if (nzone > 0)
+			return nth_replica(replicas,
+				master->next_replica() % nzone, zone);
+		// ûͬĴӽʱѯеĴӽ
+		return nth_replica(replicas, master->next_replica() % n, NULL);
+	default:
+		return nth_replica(replicas, master->next_replica() % n, NULL);
+	}
+}
+
+bool redis_client_cluster::start_refresher(int inter /* = 60 */,
+	int moved_limit /* = 10 */)
+{
+	if (refresher_ != NULL)
+		return false;
+
+	redis_slots_refresher* refresher = NEW
+		redis_slots_refresher(*this, inter);
+	refresher->set_detachable(false);
+	if (!refresher->start())
+	{
+		logger_error("start refresher error");
+		delete refresher;
+		return false;
+	}
+
+	// on_redirect ߳ refresher_
+	stat_lock_.lock();
+	refresher_   = refresher;
+	moved_limit_ = moved_limit;
+	stat_lock_.unlock();
+
+	return true;
+}
+
+void redis_client_cluster::stop_refresher()
+{
+	stat_lock_.lock();
+	redis_slots_refresher* refresher = refresher_;
+	refresher_   = NULL;
+	moved_limit_ = 0;
+	stat_lock_.unlock();
+
+	if (refresher == NULL)
+		return;
+
+	refresher->notify(true);
+	refresher->wait();
+	delete refresher;
+}
+
+void redis_client_cluster::on_redirect(bool moved)
+{
+	stat_lock_.lock();
+
+	if (!moved)
+	{
+		ask_count_++;
+		stat_lock_.unlock();
+		return;
 	}
+
+	moved_count_++;
+
+	// ͳ MOVED Ĵÿ֪ͨˢ߳һ
+	time_t now = time(NULL);
+	if (now != moved_when_)
+	{
+		moved_when_   = now;
+		moved_recent_ = 0;
+	}
+
+	if (++moved_recent_ == moved_limit_ && refresher_ != NULL)
+		refresher_->notify(false);
+
+	stat_lock_.unlock();
+}
+
+redis_client_cluster& redis_client_cluster::set_read_policy(
+	redis_read_policy_t policy)
+{
+	read_policy_ = policy;
+	return *this;
+}
+
+redis_client_cluster& redis_client_cluster::set_local_zone(const char* zone)
+{
+	zone_ = zone ? zone : "";
+	return *this;
+}
+
+redis_client_cluster& redis_client_cluster::set_zone(const char* addr,
+	const char* zone)
+{
+	if (addr == NULL || *addr == 0 || zone == NULL)
+		return *this;
+
+	string key(addr);
+	key.lower();
+	zones_[key] = zone;
+
+	redis_client_pool* conns = (redis_client_pool*) get(addr);
+	if (conns != NULL)
+		conns->set_zone(zone);
+
+	return *this;
+}
+
+void redis_client_cluster::remove(const char* addr)
+{
+	lock();
+
+	redis_client_pool* conns = (redis_client_pool*) get(addr, false);
+	if (conns != NULL)
+	{
+		redis_client_pool*** top = NULL;
+
+		for (int i = 0; i < max_slot_; i++)
+		{
+			if (peek_pending(i) != conns)
+				continue;
+			if (top == NULL)
+				top = copy_slots();
+			set_slot_pool(top, i, NULL);
+		}
+
+		if (top != NULL)
+			publish_slots(top);
+
+		remove_replica(conns);
+	}
+
+	unlock();
+
+	connect_manager::remove(addr);
 }
 
 redis_client_cluster& redis_client_cluster::set_password(
@@ -187,4 +937,47 @@ redis_client_cluster& redis_client_cluster::set_password(
 	return *this;
 }
 
+redis_client_cluster& redis_client_cluster::set_cache(
+	redis_client_cache* cache)
+{
+	cache_ = cache;
+
+	for (std::vector<connect_pool*>::iterator it = pools_.begin();
+		it != pools_.end(); ++it)
+	{
+		((redis_client_pool*) (*it))->set_cache(cache);
+	}
+
+	return *this;
+}
+
+redis_client_cluster& redis_client_cluster::set_protocol(int version)
+{
+	protocol_ = version;
+
+	for (std::vector<connect_pool*>::iterator it = pools_.begin();
+		it != pools_.end(); ++it)
+	{
+		((redis_client_pool*) (*it))->set_protocol(version);
+	}
+
+	return *this;
+}
+
+redis_client_cluster& redis_client_cluster::set_script_registry(
+	redis_script_registry* scripts, bool preload /* = true */)
+{
+	scripts_ = scripts;
+	preload_ = preload;
+
+	for (std::vector<connect_pool*>::iterator it = pools_.begin();
+		it != pools_.end(); ++it)
+	{
+		((redis_client_pool*) (*it))->set_script_registry(scripts,
+			preload);
+	}
+
+	return *this;
+}
+
 } // namespace acl
@@ -0,0 +1,541 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/util.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stream/socket_stream.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_client.hpp"
+#include "acl_cpp/redis/redis_client_mux.hpp"
+#endif
+#include "redis_request.hpp"
+
+namespace acl
+{
+
+// Ԫص
+#define MUX_REQ		0	// ߵ
+#define MUX_STOP	1	// ֪ͨ߳˳
+#define MUX_DRAIN	2	// ֪̹ͨ߳رѶϿ
+
+class mux_item : public thread_qitem
+{
+public:
+	mux_item(int type) : type_(type) {}
+	~mux_item(void) {}
+
+	int type_;
+};
+
+// ߵһڵߵջϷ䣬ߵȴ̶߳Ӧ份
+class mux_req : public mux_item
+{
+public:
+	mux_req(dbuf_pool* dbuf, const struct iovec* iov, size_t count,
+		size_t nchildren)
+	: mux_item(MUX_REQ)
+	, dbuf_(dbuf)
+	, iov_(iov)
+	, count_(count)
+	, nchildren_(nchildren)
+	, result_(NULL)
+	, last_(false)
+	, done_(false)
+	{
+		acl_pthread_mutex_init(&lock_, NULL);
+		acl_pthread_cond_init(&cond_, NULL);
+	}
+
+	~mux_req(void)
+	{
+		acl_pthread_cond_destroy(&cond_);
+		acl_pthread_mutex_destroy(&lock_);
+	}
+
+	void wait(void)
+	{
+		acl_pthread_mutex_lock(&lock_);
+		while (!done_)
+			acl_pthread_cond_wait(&cond_, &lock_);
+		acl_pthread_mutex_unlock(&lock_);
+	}
+
+	void done(const redis_result* result)
+	{
+		acl_pthread_mutex_lock(&lock_);
+		result_ = result;
+		done_   = true;
+		acl_pthread_cond_signal(&cond_);
+		acl_pthread_mutex_unlock(&lock_);
+	}
+
+	dbuf_pool* dbuf_;
+	const struct iovec* iov_;
+	size_t count_;
+	size_t nchildren_;
+	const redis_result* result_;
+	bool last_;			// ǷΪһеһ
+
+private:
+	bool done_;
+	acl_pthread_mutex_t lock_;
+	acl_pthread_cond_t  cond_;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// ·ÿͻеһӣд̴߳ӹȡ
+// Ƚ뱾ӵ;д̰߳;е˳ȡӦ
+// ӵĴ򿪽д߳̽Уرսɶ߳̽Уӳд߳ͨ
+// MUX_DRAIN Ϣȴ߳̽ǰ;ϲرӺ
+class redis_mux_conn
+{
+public:
+	redis_mux_conn(redis_client_mux& mux);
+	~redis_mux_conn(void);
+
+	bool start(void);
+	void wait(void);
+
+	void* write_loop(void);
+	void* read_loop(void);
+
+private:
+	class mux_thread : public thread
+	{
+	public:
+		mux_thread(redis_mux_conn& conn, bool writer)
+		: conn_(conn), writer_(writer) {}
+		~mux_thread(void) {}
+
+	protected:
+		// @override
+		void* run(void)
+		{
+			return writer_ ? conn_.write_loop() : conn_.read_loop();
+		}
+
+	private:
+		redis_mux_conn& conn_;
+		bool writer_;
+	};
+
+	redis_client_mux& mux_;
+	redis_client* conn_;
+	thread_queue inflight_;		// ѷͶδӦ
+	thread_queue drained_;		// ̹߳رӺȷϢ
+	thread_queue acks_;		// ̴߳һȷϢ
+	size_t nbatches_;		// ѷͶδȷϵΣд̷߳
+	mux_thread* writer_;
+	mux_thread* reader_;
+	bool opened_;			// д̷߳
+	bool broken_;
+	locker lock_;
+
+	bool is_broken(void);
+	void set_broken(void);
+	void send(mux_req** reqs, size_t n, std::vector<struct iovec>& iov);
+	bool writev_all(ACL_SOCKET fd, const struct iovec* iov, size_t count);
+};
+
+redis_mux_conn::redis_mux_conn(redis_client_mux& mux)
+: mux_(mux)
+, nbatches_(0)
+, writer_(NULL)
+, reader_(NULL)
+, opened_(false)
+, broken_(false)
+{
+	conn_ = NEW redis_client(mux.addr_, mux.conn_timeout_,
+		mux.rw_timeout_, false);
+	if (!mux.pass_.empty())
+		conn_->set_password(mux.pass_);
+	if (mux.readonly_)
+		conn_->set_readonly(true);
+}
+
+redis_mux_conn::~redis_mux_conn(void)
+{
+	delete writer_;
+	delete reader_;
+	delete conn_;
+}
+
+bool redis_mux_conn::start(void)
+{
+	writer_ = NEW mux_thread(*this, true);
+	reader_ = NEW mux_thread(*this, false);
+	writer_->set_detachable(false);
+	reader_->set_detachable(false);
+
+	if (!reader_->start())
+	{
+		logger_error("start reader error");
+		return false;
+	}
+
+	if (!writer_->start())
+	{
+		logger_error("start writer error");
+		inflight_.push(NEW mux_item(MUX_STOP));
+		reader_->wait();
+		delete reader_;
+		reader_ = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+void redis_mux_conn::wait(void)
+{
+	// д߳˳ǰ֪ͨ߳˳
+	if (writer_)
+		writer_->wait();
+	if (reader_)
+		reader_->wait();
+}
+
+bool redis_mux_conn::is_broken(void)
+{
+	lock_.lock();
+	bool broken = broken_;
+	lock_.unlock();
+	return broken;
+}
+
+void redis_mux_conn::set_broken(void)
+{
+	lock_.lock();
+	broken_ = true;
+	lock_.unlock();
+}
+
+// ÿ writev ʱ iovec ⳬϵͳ IOV_MAX 
+#define	MUX_IOV_MAX	512
+
+bool redis_mux_conn::writev_all(ACL_SOCKET fd, const struct iovec* iov,
+	size_t count)
+{
+	// дֱ߳д׽ֶ߳õ߳ͬʱ
+	// ޸״̬
+	struct iovec vec[MUX_IOV_MAX];
+	size_t i = 0, off = 0;
+
+	while (i < count)
+	{
+		int n = 0;
+		for (size_t j = i; j < count && n < MUX_IOV_MAX; j++, n++)
+		{
+			vec[n].iov_base = (char*) iov[j].iov_base
+				+ (j == i ? off : 0);
+			vec[n].iov_len  = iov[j].iov_len - (j == i ? off : 0);
+		}
+
+		if (mux_.rw_timeout_ > 0
+			&& acl_write_wait(fd, mux_.rw_timeout_) < 0)
+		{
+			logger_error("write to %s timeout", mux_.get_addr());
+			return false;
+		}
+
+		int ret = acl_socket_writev(fd, vec, n, 0, NULL, NULL);
+		if (ret <= 0)
+		{
+			logger_error("write to %s error: %s",
+				mux_.get_addr(), last_serror());
+			return false;
+		}
+
+		// дĲ
+		size_t left = (size_t) ret;
+		while (i < count && left >= iov[i].iov_len - off)
+		{
+			left -= iov[i].iov_len - off;
+			off = 0;
+			i++;
+		}
+		off += left;
+	}
+
+	return true;
+}
+
+void redis_mux_conn::send(mux_req** reqs, size_t n,
+	std::vector<struct iovec>& iov)
+{
+	// ӳȴ̴߳ǰ;󲢹ر
+	if (is_broken())
+	{
+		inflight_.push(NEW mux_item(MUX_DRAIN));
+		delete drained_.pop(-1);
+		opened_ = false;
+
+		lock_.lock();
+		broken_ = false;
+		lock_.unlock();
+	}
+
+	// ̴߳ʱȴ;Уɰȫش
+	if (!opened_)
+	{
+		if (!conn_->open())
+		{
+			for (size_t i = 0; i < n; i++)
+				reqs[i]->done(NULL);
+			return;
+		}
+		opened_ = true;
+	}
+
+	reqs[n - 1]->last_ = true;
+	nbatches_++;
+
+	iov.clear();
+	for (size_t i = 0; i < n; i++)
+		iov.insert(iov.end(), reqs[i]->iov_,
+			reqs[i]->iov_ + reqs[i]->count_);
+
+	ACL_SOCKET fd = conn_->conn_.sock_handle();
+	if (!writev_all(fd, &iov[0], iov.size()))
+	{
+		// رնдԱڶ֪߳̾
+		set_broken();
+		acl_socket_shutdown(fd, SHUT_RDWR);
+	}
+
+	// дŷ;УΪ̻߳ѵߺݼͷţ
+	// յǰ󼴿ܷӦʱҲ밴˳
+	// ̴߳
+	inflight_.push_batch((thread_qitem**) reqs, n);
+	mux_.add_batch(n);
+}
+
+void* redis_mux_conn::write_loop(void)
+{
+	size_t max = mux_.batch_max_;
+	std::vector<thread_qitem*> items(max);
+	std::vector<mux_req*> reqs;
+	std::vector<struct iovec> iov;
+
+	reqs.reserve(max);
+
+	while (true)
+	{
+		// ѷ͵ιʱȵȴӦԱڹлۣ
+		// Ӷʹһϲ󣬻ед߳ȡ
+		while (nbatches_ >= mux_.inflight_max_)
+		{
+			delete acks_.pop(-1);
+			nbatches_--;
+		}
+
+		size_t n = mux_.reqs_.pop_batch(&items[0], max, -1);
+		bool stop = false;
+
+		reqs.clear();
+		for (size_t i = 0; i < n; i++)
+		{
+			mux_item* item = (mux_item*) items[i];
+			if (item->type_ == MUX_REQ)
+				reqs.push_back((mux_req*) item);
+			else if (stop)
+				// ˳Ϣд߳
+				mux_.reqs_.push(item);
+			else
+			{
+				stop = true;
+				delete item;
+			}
+		}
+
+		if (!reqs.empty())
+			send(&reqs[0], reqs.size(), iov);
+
+		if (stop)
+			break;
+	}
+
+	inflight_.push(NEW mux_item(MUX_STOP));
+	return NULL;
+}
+
+void* redis_mux_conn::read_loop(void)
+{
+	while (true)
+	{
+		mux_item* item = (mux_item*) inflight_.pop(-1);
+		if (item == NULL)
+			continue;
+
+		if (item->type_ == MUX_STOP)
+		{
+			delete item;
+			break;
+		}
+
+		if (item->type_ == MUX_DRAIN)
+		{
+			delete item;
+			conn_->close();
+			drained_.push(NEW mux_item(MUX_DRAIN));
+			continue;
+		}
+
+		mux_req* req = (mux_req*) item;
+		bool last = req->last_;
+		if (is_broken())
+		{
+			req->done(NULL);
+			if (last)
+				acks_.push(NEW mux_item(MUX_REQ));
+			continue;
+		}
+
+		// ֱڵߵڴϽӦڻѵǰ
+		// ŻУΪܻͷڴ
+		const redis_result* result =
+			conn_->get_redis_result(req->dbuf_, req->nchildren_);
+		if (result != NULL)
+			conn_->unread_left();
+		else
+		{
+			logger_error("read from %s error", mux_.get_addr());
+			set_broken();
+			acl_socket_shutdown(conn_->conn_.sock_handle(), SHUT_RDWR);
+		}
+
+		// ѵߺ󲻵 req
+		req->done(result);
+		if (last)
+			acks_.push(NEW mux_item(MUX_REQ));
+	}
+
+	return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+redis_client_mux::redis_client_mux(const char* addr, size_t nconns /* = 2 */,
+	int conn_timeout /* = 10 */, int rw_timeout /* = 10 */)
+: addr_(addr)
+, readonly_(false)
+, conn_timeout_(conn_timeout)
+, rw_timeout_(rw_timeout)
+, nconns_(nconns > 0 ? nconns : 1)
+, batch_max_(128)
+, inflight_max_(1)
+, started_(false)
+, requests_(0)
+, batches_(0)
+{
+}
+
+redis_client_mux::~redis_client_mux(void)
+{
+	// ÿд̴֮߳ǰյһ˳Ϣ
+	for (size_t i = 0; i < conns_.size(); i++)
+		reqs_.push(NEW mux_item(MUX_STOP));
+
+	for (std::vector<redis_mux_conn*>::iterator it = conns_.begin();
+		it != conns_.end(); ++it)
+	{
+		(*it)->wait();
+		delete *it;
+	}
+}
+
+redis_client_mux& redis_client_mux::set_password(const char* pass)
+{
+	if (pass && *pass)
+		pass_ = pass;
+	else
+		pass_.clear();
+	return *this;
+}
+
+redis_client_mux& redis_client_mux::set_readonly(bool on)
+{
+	readonly_ = on;
+	return *this;
+}
+
+redis_client_mux& redis_client_mux::set_batch_max(size_t max)
+{
+	if (max > 0)
+		batch_max_ = max;
+	return *this;
+}
+
+redis_client_mux& redis_client_mux::set_inflight_max(size_t max)
+{
+	if (max > 0)
+		inflight_max_ = max;
+	return *this;
+}
+
+bool redis_client_mux::start(void)
+{
+	// Ѽ״ʱһΣӵ߳ʧʱ
+	// ʹӣȫʧʱֱ֮ӷʧܣÿ
+	// ڳڼظ߳
+	if (started_)
+		return !conns_.empty();
+	started_ = true;
+
+	while (conns_.size() < nconns_)
+	{
+		redis_mux_conn* conn = NEW redis_mux_conn(*this);
+		if (!conn->start())
+		{
+			delete conn;
+			logger_error("only %d of %d connections started, addr: %s",
+				(int) conns_.size(), (int) nconns_, addr_.c_str());
+			break;
+		}
+		conns_.push_back(conn);
+	}
+
+	return !conns_.empty();
+}
+
+void redis_client_mux::add_batch(size_t n)
+{
+	lock_.lock();
+	requests_ += n;
+	batches_++;
+	lock_.unlock();
+}
+
+const redis_result* redis_client_mux::run(dbuf_pool* pool,
+	const struct iovec* iov, size_t count, size_t nchildren)
+{
+	lock_.lock();
+	bool ok = start();
+	lock_.unlock();
+
+	if (!ok)
+		return NULL;
+
+	mux_req req(pool, iov, count, nchildren);
+	reqs_.push(&req);
+	req.wait();
+	return req.result_;
+}
+
+const redis_result* redis_client_mux::run(dbuf_pool* pool, const string& req,
+	size_t nchildren)
+{
+	struct iovec iov;
+	iov.iov_base = (void*) req.c_str();
+	iov.iov_len  = req.size();
+	return run(pool, &iov, 1, nchildren);
+}
+
+const redis_result* redis_client_mux::run(dbuf_pool* pool,
+	const redis_request& req, size_t nchildren)
+{
+	return run(pool, req.get_iovec(), req.get_size(), nchildren);
+}
+
+} // namespace acl
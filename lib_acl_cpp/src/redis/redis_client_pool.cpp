@@ -1,6 +1,7 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
 #include "acl_cpp/redis/redis_client.hpp"
+#include "acl_cpp/redis/redis_client_mux.hpp"
 #include "acl_cpp/redis/redis_client_pool.hpp"
 #endif
 
@@ -11,13 +12,35 @@ redis_client_pool::redis_client_pool(const char* addr, size_t count,
 	size_t idx /* = 0 */)
 : connect_pool(addr, count, idx)
 , pass_(NULL)
+, cache_(NULL)
+, protocol_(2)
+, scripts_(NULL)
+, preload_(false)
+, readonly_(false)
+, mux_(NULL)
 {
+	// Ӧʱ估ѯڴӽĶ·ϱƵʣʾԭӷʽд
+	latency_ = acl_atomic_new();
+	acl_atomic_set(latency_, NULL);
+	rr_ = acl_atomic_new();
+	acl_atomic_set(rr_, NULL);
+	replicas_ = acl_atomic_new();
+	acl_atomic_set(replicas_, NULL);
 }
 
 redis_client_pool::~redis_client_pool()
 {
 	if (pass_)
 		acl_myfree(pass_);
+
+	void* replicas = acl_atomic_get(replicas_);
+	if (replicas)
+		acl_myfree(replicas);
+	acl_atomic_free(replicas_);
+	acl_atomic_free(rr_);
+	acl_atomic_free(latency_);
+
+	delete mux_;
 }
 
 redis_client_pool& redis_client_pool::set_password(const char* pass)
@@ -31,12 +54,115 @@ redis_client_pool& redis_client_pool::set_password(const char* pass)
 	return *this;
 }
 
+redis_client_pool& redis_client_pool::set_cache(redis_client_cache* cache)
+{
+	cache_ = cache;
+	return *this;
+}
+
+redis_client_pool& redis_client_pool::set_protocol(int version)
+{
+	protocol_ = version;
+	return *this;
+}
+
+redis_client_pool& redis_client_pool::set_script_registry(
+	redis_script_registry* scripts, bool preload /* = true */)
+{
+	scripts_ = scripts;
+	preload_ = preload;
+	return *this;
+}
+
+redis_client_pool& redis_client_pool::set_readonly(bool on)
+{
+	readonly_ = on;
+	return *this;
+}
+
+redis_client_pool& redis_client_pool::set_zone(const char* zone)
+{
+	zone_ = zone ? zone : "";
+	return *this;
+}
+
+// µӦʱռȨ
+#define EWMA_ALPHA	0.2
+
+void redis_client_pool::add_latency(double ms)
+{
+	double us = ms > 0.001 ? ms * 1000 : 1;
+
+	while (true)
+	{
+		void* old = acl_atomic_get(latency_);
+		double avg = (double) (size_t) old;
+
+		if (avg > 0)
+			avg = avg * (1 - EWMA_ALPHA) + us * EWMA_ALPHA;
+		else
+			avg = us;
+
+		// ߳ͬʱƽֵ¼
+		void* now = (void*) (size_t) (avg >= 1 ? avg : 1);
+		if (acl_atomic_cas(latency_, old, now) == old)
+			break;
+	}
+}
+
+double redis_client_pool::get_latency(void)
+{
+	return (double) (size_t) acl_atomic_get(latency_) / 1000;
+}
+
+redis_client_pool** redis_client_pool::get_replicas(void) const
+{
+	return (redis_client_pool**) acl_atomic_get(replicas_);
+}
+
+redis_client_pool** redis_client_pool::set_replicas(
+	redis_client_pool** replicas)
+{
+	return (redis_client_pool**) acl_atomic_xchg(replicas_, replicas);
+}
+
+unsigned int redis_client_pool::next_replica(void)
+{
+	while (true)
+	{
+		void* old = acl_atomic_get(rr_);
+		void* now = (void*) ((size_t) old + 1);
+		if (acl_atomic_cas(rr_, old, now) == old)
+			return (unsigned int) (size_t) old;
+	}
+}
+
+redis_client_pool& redis_client_pool::set_multiplex(size_t nconns)
+{
+	if (mux_ != NULL)
+		return *this;
+
+	mux_ = NEW redis_client_mux(addr_, nconns, conn_timeout_, rw_timeout_);
+	if (pass_)
+		mux_->set_password(pass_);
+	if (readonly_)
+		mux_->set_readonly(true);
+	return *this;
+}
+
 connect_client* redis_client_pool::create_connect()
 {
 	redis_client* conn = NEW redis_client(addr_, conn_timeout_,
 		rw_timeout_);
 	if (pass_)
 		conn->set_password(pass_);
+	if (cache_)
+		conn->set_cache(cache_);
+	conn->set_protocol(protocol_);
+	if (scripts_)
+		conn->set_script_registry(scripts_, preload_);
+	if (readonly_)
+		conn->set_readonly(true);
 	return conn;
 }
 
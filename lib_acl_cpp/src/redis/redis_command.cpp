@@ -1,13 +1,18 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
+#include <algorithm>
 #include "acl_cpp/stdlib/log.hpp"
 #include "acl_cpp/stdlib/snprintf.hpp"
 #include "acl_cpp/stdlib/dbuf_pool.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
 #include "acl_cpp/redis/redis_client_pool.hpp"
 #include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_client_cache.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
 #include "acl_cpp/redis/redis_command.hpp"
+#include "acl_cpp/redis/redis_pipeline.hpp"
+#include "acl_cpp/redis/redis_async_client.hpp"
+#include "acl_cpp/redis/redis_client_mux.hpp"
 #endif
 #include "redis_request.hpp"
 
@@ -17,15 +22,48 @@ namespace acl
 #define INT_LEN		11
 #define	LONG_LEN	21
 
+// ڵĹϣۣͬ redis ȺкзǿյĹϣǩ {...}
+// ԱǩڵĲּ
+static int get_slot(const char* key, size_t len, int max_slot)
+{
+	const char* l = (const char*) memchr(key, '{', len);
+	if (l != NULL)
+	{
+		const char* r = (const char*) memchr(l + 1, '}',
+				len - (l + 1 - key));
+		if (r != NULL && r > l + 1)
+		{
+			key = l + 1;
+			len = r - key;
+		}
+	}
+
+	unsigned short n = acl_hash_crc16(key, len);
+	return (int) (n % max_slot);
+}
+
 redis_command::redis_command()
 : check_addr_(false)
 , conn_(NULL)
 , cluster_(NULL)
+, pipeline_(NULL)
+, async_(NULL)
+, async_callback_(NULL)
+, async_failed_(false)
+, mux_(NULL)
 , max_conns_(0)
 , used_(0)
 , slot_(-1)
+, split_step_(0)
+, splitter_(NULL)
 , redirect_max_(15)
 , redirect_sleep_(100)
+, cache_key_(NULL)
+, cache_klen_(0)
+, cache_field_(NULL)
+, cache_flen_(0)
+, readonly_(false)
+, mux_unsafe_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -44,11 +82,24 @@ redis_command::redis_command(redis_client* conn)
 : check_addr_(false)
 , conn_(conn)
 , cluster_(NULL)
+, pipeline_(NULL)
+, async_(NULL)
+, async_callback_(NULL)
+, async_failed_(false)
+, mux_(NULL)
 , max_conns_(0)
 , used_(0)
 , slot_(-1)
+, split_step_(0)
+, splitter_(NULL)
 , redirect_max_(15)
 , redirect_sleep_(1)
+, cache_key_(NULL)
+, cache_klen_(0)
+, cache_field_(NULL)
+, cache_flen_(0)
+, readonly_(false)
+, mux_unsafe_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -69,9 +120,22 @@ redis_command::redis_command(redis_client_cluster* cluster, size_t max_conns)
 : check_addr_(false)
 , conn_(NULL)
 , cluster_(cluster)
+, pipeline_(NULL)
+, async_(NULL)
+, async_callback_(NULL)
+, async_failed_(false)
+, mux_(NULL)
 , max_conns_(max_conns)
 , used_(0)
 , slot_(-1)
+, split_step_(0)
+, splitter_(NULL)
+, cache_key_(NULL)
+, cache_klen_(0)
+, cache_field_(NULL)
+, cache_flen_(0)
+, readonly_(false)
+, mux_unsafe_(false)
 , slice_req_(false)
 , request_buf_(NULL)
 , request_obj_(NULL)
@@ -106,6 +170,7 @@ redis_command::~redis_command()
 		acl_myfree(argv_lens_);
 	delete request_buf_;
 	delete request_obj_;
+	delete splitter_;
 	dbuf_->destroy();
 }
 
@@ -129,6 +194,7 @@ void redis_command::clear(bool save_slot /* = false */)
 	}
 	if (!save_slot)
 		slot_ = -1;
+	failed_keys_.clear();
 }
 
 void redis_command::set_slice_request(bool on)
@@ -147,6 +213,7 @@ void redis_command::set_client(redis_client* conn)
 	{
 		conn_ = conn;
 		cluster_ = NULL;
+		mux_ = NULL;
 		set_client_addr(*conn);
 	}
 }
@@ -173,14 +240,41 @@ void redis_command::set_cluster(redis_client_cluster* cluster, size_t max_conns)
 		return;
 
 	conn_ = NULL;
+	mux_ = NULL;
 	redirect_max_ = cluster->get_redirect_max();
 	if (redirect_max_ <= 0)
 		redirect_max_ = 15;
 	redirect_sleep_ = cluster->get_redirect_sleep();
 }
 
+void redis_command::set_pipeline(redis_pipeline* pipeline)
+{
+	pipeline_ = pipeline;
+}
+
+void redis_command::set_async(redis_async_client* client,
+	redis_async_callback* callback)
+{
+	async_ = client;
+	async_callback_ = callback;
+	async_failed_ = false;
+}
+
+void redis_command::set_mux(redis_client_mux* mux)
+{
+	if (mux != NULL)
+	{
+		mux_ = mux;
+		conn_ = NULL;
+		cluster_ = NULL;
+		set_client_addr(mux->get_addr());
+	}
+}
+
 bool redis_command::eof() const
 {
+	if (async_ != NULL)
+		return async_failed_;
 	return conn_ == NULL ? false : conn_->eof();
 }
 
@@ -209,11 +303,14 @@ void redis_command::hash_slot(const char* key)
 
 void redis_command::hash_slot(const char* key, size_t len)
 {
-	// ֻмȺģʽҪϣֵ
-	if (cluster_ == NULL)
+	// ֻмȺģʽҪϣֵܵʽʹùܵ󶨵ļȺ
+	redis_client_cluster* cluster = cluster_;
+	if (cluster == NULL && pipeline_ != NULL)
+		cluster = pipeline_->get_cluster();
+	if (cluster == NULL)
 		return;
 
-	int max_slot = cluster_->get_max_slot();
+	int max_slot = cluster->get_max_slot();
 	if (max_slot <= 0)
 		return;
 
@@ -221,8 +318,21 @@ void redis_command::hash_slot(const char* key, size_t len)
 	if (slot_ >= 0 && slot_ < max_slot)
 		return;
 
-	unsigned short n = acl_hash_crc16(key, len);
-	slot_ = (int) (n % max_slot);
+	slot_ = get_slot(key, len, max_slot);
+}
+
+void redis_command::split_keys(size_t step)
+{
+	split_step_ = step;
+}
+
+void redis_command::set_cache_key(const char* key, size_t klen,
+	const char* field /* = NULL */, size_t flen /* = 0 */)
+{
+	cache_key_   = key;
+	cache_klen_  = klen;
+	cache_field_ = field;
+	cache_flen_  = flen;
 }
 
 const char* redis_command::get_client_addr() const
@@ -371,8 +481,11 @@ redis_client* redis_command::peek_conn(redis_client_cluster* cluster, int slot)
 	{
 		if (slot < 0)
 			conns = (redis_client_pool*) cluster->peek();
-		else if ((conns = cluster->peek_slot(slot)) == NULL)
+		else if ((conns = readonly_ ? cluster->peek_read_slot(slot)
+			: cluster->peek_slot(slot)) == NULL)
+		{
 			conns = (redis_client_pool*) cluster->peek();
+		}
 
 		if (conns == NULL)
 		{
@@ -384,9 +497,29 @@ redis_client* redis_command::peek_conn(redis_client_cluster* cluster, int slot)
 		if (conn != NULL)
 			return conn;
 
+		// ӽ޿ʱڱֱӸĶ㣬ͬ
+		// AUTO_SET_ALIVE ʱŽΪ״̬(ʧʱӳڲ
+		// ˴)ﵽ޵ԭ
+		redis_client_pool* master;
+		if (readonly_ && slot >= 0
+			&& (master = cluster->peek_slot(slot)) != NULL
+			&& master != conns)
+		{
+#ifdef AUTO_SET_ALIVE
+			conns->set_alive(false);
+#endif
+			conns = master;
+			conn  = (redis_client*) conns->peek();
+			if (conn != NULL)
+				return conn;
+		}
+
 		// ȡϣ۵ĵַӳϵ
 		cluster->clear_slot(slot);
 
+		// δ´ֱѡȡһ
+		slot = -1;
+
 #ifdef AUTO_SET_ALIVE
 		// ӳضΪ״̬
 		conns->set_alive(false);
@@ -418,19 +551,34 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 
 	while (n++ < redirect_max_)
 	{
-		// ǷڴƬʽòͬ
-		if (slice_req_)
-			result_ = conn->run(dbuf_, *request_obj_, nchild, timeout);
+		// ӦʱѡӽʱͳƸƽӦʱ
+		if (cluster->get_read_policy() == REDIS_READ_LATENCY)
+		{
+			struct timeval begin, end;
+			gettimeofday(&begin, NULL);
+			result_ = run_conn(conn, nchild, timeout);
+			gettimeofday(&end, NULL);
+
+			if (result_ != NULL && !conn->eof())
+				((redis_client_pool*) conn->get_pool())->add_latency(
+					(end.tv_sec - begin.tv_sec) * 1000.0
+					+ (end.tv_usec - begin.tv_usec) / 1000.0);
+		}
 		else
-			result_ = conn->run(dbuf_, *request_buf_, nchild, timeout);
+			result_ = run_conn(conn, nchild, timeout);
 
 		// 쳣ϿҪ
 		if (conn->eof())
 		{
 			connect_pool* pool = conn->get_pool();
 
-			// ɾϣеĵַӳϵԱ´βʱ»ȡ
-			cluster->clear_slot(slot_);
+			// ɾϣеĵַӳϵԱ´βʱ»ȡ
+			// ӽӶϿʱɾ
+			if ((connect_pool*) cluster->peek_slot(slot_) == pool
+				|| !readonly_)
+			{
+				cluster->clear_slot(slot_);
+			}
 
 			// Ӷ黹ӳض
 			pool->put(conn, false);
@@ -523,6 +671,9 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 			// Ӷ黹ӳض
 			conn->get_pool()->put(conn, true);
 
+			// ͳ MOVED Ƶʣʱɺ̨߳ˢ¹ϣӳ
+			cluster->on_redirect(true);
+
 			const char* addr = get_addr(ptr);
 			if (addr == NULL)
 			{
@@ -560,6 +711,8 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 			// Ӷ黹ӳض
 			conn->get_pool()->put(conn, true);
 
+			cluster->on_redirect(false);
+
 			const char* addr = get_addr(ptr);
 			if (addr == NULL)
 			{
@@ -655,36 +808,307 @@ const redis_result* redis_command::run(redis_client_cluster* cluster,
 	return NULL;
 }
 
+const redis_result* redis_command::run_split(size_t step, size_t nchild,
+	int* timeout)
+{
+	int max_slot = cluster_->get_max_slot();
+	size_t nkeys = argc_ > 1 ? (argc_ - 1) / step : 0;
+
+	if (max_slot <= 0 || nkeys == 0)
+		return run(cluster_, nchild, timeout);
+
+	// Ĺϣۣϣ۽飬ڱּԭʼ˳
+	std::map<int, size_t> slot2group;
+	std::vector<std::vector<size_t> > groups;
+	std::vector<int> slots;
+
+	for (size_t i = 0; i < nkeys; i++)
+	{
+		size_t k = 1 + i * step;
+		int slot = get_slot(argv_[k], argv_lens_[k], max_slot);
+
+		std::map<int, size_t>::iterator it = slot2group.find(slot);
+		if (it != slot2group.end())
+		{
+			groups[it->second].push_back(i);
+			continue;
+		}
+
+		slot2group[slot] = groups.size();
+		groups.push_back(std::vector<size_t>(1, i));
+		slots.push_back(slot);
+	}
+
+	// мͬһϣʱز
+	if (groups.size() == 1)
+	{
+		slot_ = slots[0];
+		return run(cluster_, nchild, timeout);
+	}
+
+	if (splitter_ != NULL && splitter_->get_cluster() != cluster_)
+	{
+		delete splitter_;
+		splitter_ = NULL;
+	}
+	if (splitter_ == NULL)
+		splitter_ = NEW redis_pipeline(cluster_, max_conns_);
+	else
+		splitter_->clear();
+
+	// Ϊÿϣ۴һͨܵ鲢з
+	std::vector<const char*> argv;
+	std::vector<size_t> lens;
+	string req(256);
+
+	for (size_t i = 0; i < groups.size(); i++)
+	{
+		argv.clear();
+		lens.clear();
+		argv.push_back(argv_[0]);
+		lens.push_back(argv_lens_[0]);
+
+		const std::vector<size_t>& group = groups[i];
+		for (size_t j = 0; j < group.size(); j++)
+		{
+			size_t k = 1 + group[j] * step;
+			for (size_t n = 0; n < step; n++)
+			{
+				argv.push_back(argv_[k + n]);
+				lens.push_back(argv_lens_[k + n]);
+			}
+		}
+
+		req.clear();
+		build_request_buf(req, argv.size(), &argv[0], &lens[0]);
+		splitter_->push(req, slots[i], nchild);
+	}
+
+	(void) splitter_->exec();
+	result_ = merge_split(step, groups);
+	return result_;
+}
+
+const redis_result* redis_command::merge_split(size_t step,
+	const std::vector<std::vector<size_t> >& groups)
+{
+	const redis_result* first = NULL, *failed = NULL, *rr;
+	size_t nkeys = (argc_ - 1) / step, i, j;
+
+	// ¼ִʧܵļ
+	for (i = 0; i < groups.size(); i++)
+	{
+		rr = splitter_->get_result(i);
+		if (rr == NULL || rr->get_type() == REDIS_RESULT_ERROR)
+		{
+			if (failed == NULL)
+				failed = rr;
+			failed_keys_.insert(failed_keys_.end(),
+				groups[i].begin(), groups[i].end());
+		}
+		else if (first == NULL)
+			first = rr;
+	}
+
+	std::sort(failed_keys_.begin(), failed_keys_.end());
+
+	if (first == NULL)
+		return failed;
+
+	switch (first->get_type())
+	{
+	case REDIS_RESULT_ARRAY:
+	{
+		// MGET: ԭʼ˳ϲĽʧܵļӦ
+		// Ĵ
+		const redis_result** children = (const redis_result**)
+			dbuf_->dbuf_calloc(sizeof(redis_result*) * nkeys);
+
+		for (i = 0; i < groups.size(); i++)
+		{
+			rr = splitter_->get_result(i);
+			bool ok = rr != NULL && rr->get_type() == REDIS_RESULT_ARRAY;
+			for (j = 0; j < groups[i].size(); j++)
+				children[groups[i][j]] = ok ? rr->get_child(j) : rr;
+		}
+
+		redis_result* result = new(dbuf_) redis_result(dbuf_);
+		result->set_type(REDIS_RESULT_ARRAY);
+		result->set_size(nkeys);
+		for (i = 0; i < nkeys; i++)
+			result->put(children[i], i);
+		return result;
+	}
+	case REDIS_RESULT_INTEGER:
+	{
+		// DEL/EXISTS: ۼӸĽ
+		if (!failed_keys_.empty())
+			return failed;
+
+		long long n = 0;
+		for (i = 0; i < groups.size(); i++)
+			n += splitter_->get_result(i)->get_integer64();
+
+		char* buf = (char*) dbuf_->dbuf_alloc(LONG_LEN);
+		safe_snprintf(buf, LONG_LEN, "%lld", n);
+
+		redis_result* result = new(dbuf_) redis_result(dbuf_);
+		result->set_type(REDIS_RESULT_INTEGER);
+		result->set_size(1);
+		result->put(buf, strlen(buf));
+		return result;
+	}
+	default:
+		// MSET: ɹʱŷسɹ
+		return failed_keys_.empty() ? first : failed;
+	}
+}
+
 const redis_result* redis_command::run(size_t nchild /* = 0 */,
 	int* timeout /* = NULL */)
 {
+	// ȡĲֱǣԱЧ
+	size_t split_step = split_step_;
+	split_step_ = 0;
+
+	// ܵʽ½ݼϣֵ׷ܵУȻͷűεʱڴ
+	if (pipeline_ != NULL)
+	{
+		if (slice_req_)
+			pipeline_->push(*request_obj_, slot_, nchild);
+		else
+			pipeline_->push(*request_buf_, slot_, nchild);
+		used_++;
+		cache_key_ = NULL;
+		clear(false);
+		return NULL;
+	}
+
+	// 첽ʽ½ݽ첽ͻ˷ͣ¼ѭлص
+	if (async_ != NULL)
+	{
+		bool ok;
+		if (slice_req_)
+			ok = async_->send(*request_obj_, nchild, async_callback_);
+		else
+			ok = async_->send(*request_buf_, nchild, async_callback_);
+
+		// ʧʱ callback ѱ NULL ص¼ʧ״̬ eof() ѯ
+		async_failed_ = !ok;
+		if (!ok)
+			logger_error("async send to %s failed", async_->get_addr());
+		used_++;
+		cache_key_ = NULL;
+		clear(false);
+		return NULL;
+	}
+
 	// ϴβʱڴûбͷţڴ˴ǿƽͷţû
 	// ڷʹһʱ clear ʱڴ
 	if (used_ > 0)
 		clear(false);
 	used_++;
 
+	const redis_result* result;
+
 	if (cluster_ != NULL)
-		return run(cluster_, nchild, timeout);
-	if (conn_ == NULL)
+	{
+		if (split_step > 0)
+			result = run_split(split_step, nchild, timeout);
+		else
+			result = run(cluster_, nchild, timeout);
+	}
+	else if (mux_ != NULL)
+	{
+		// ״̬Ӱ칲ͬһӵ
+		if (mux_unsafe_)
+		{
+			logger_error("command not allowed in mux mode");
+			result = result_ = NULL;
+		}
+		// ·÷ʽɹӵĶֱ߳ڱڴϽӦ
+		else if (slice_req_)
+			result = result_ = mux_->run(dbuf_, *request_obj_, nchild);
+		else
+			result = result_ = mux_->run(dbuf_, *request_buf_, nchild);
+	}
+	else if (conn_ == NULL)
 	{
 		logger_error("ERROR: cluster_ and conn_ are all NULL");
-		return NULL;
+		result = NULL;
+	}
+	else
+	{
+		conn_->set_check_addr(check_addr_);
+		result = result_ = run_conn(conn_, nchild, timeout);
 	}
 
-	conn_->set_check_addr(check_addr_);
+	// ͻ˻ǽԱЧ
+	cache_key_ = NULL;
+	return result;
+}
 
+const redis_result* redis_command::run_conn(redis_client* conn,
+	size_t nchild, int* timeout)
+{
+	redis_client_cache* cache = cache_key_ ? conn->get_cache() : NULL;
+
+	// Ѵ CLIENT TRACKING ֮ǰյʧЧ֪ͨѴʱ
+	// ſʹñػ
+	if (cache != NULL && conn->get_cache_id() > 0 && conn->read_pushes())
+	{
+		const char* data;
+		size_t len;
+
+		if (cache->get(conn->get_cache_id(), cache_key_, cache_klen_,
+			cache_field_, cache_flen_, dbuf_, &data, &len))
+		{
+			redis_result* rr = new(dbuf_) redis_result(dbuf_);
+			rr->set_type(REDIS_RESULT_STRING);
+			if (data != NULL)
+			{
+				rr->set_size(1);
+				rr->put(data, len);
+			}
+			return rr;
+		}
+	}
+
+	// ǷڴƬʽòͬ
+	const redis_result* result;
 	if (slice_req_)
-		result_ = conn_->run(dbuf_, *request_obj_, nchild, timeout);
+		result = conn->run(dbuf_, *request_obj_, nchild, timeout);
 	else
-		result_ = conn_->run(dbuf_, *request_buf_, nchild, timeout);
-	return result_;
+		result = conn->run(dbuf_, *request_buf_, nchild, timeout);
+
+	// Ľ CLIENT TRACKING Чʱ뱾ػ棬ֵͬ
+	if (cache != NULL && result != NULL && conn->get_cache_id() > 0
+		&& result->get_type() == REDIS_RESULT_STRING)
+	{
+		if (result->get_size() == 0)
+			cache->put(conn->get_cache_id(), cache_key_,
+				cache_klen_, cache_field_, cache_flen_,
+				NULL, 0);
+		else
+		{
+			string_view value = result->argv_view();
+			cache->put(conn->get_cache_id(), cache_key_,
+				cache_klen_, cache_field_, cache_flen_,
+				value.data(), value.size());
+		}
+	}
+
+	return result;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 void redis_command::logger_result(const redis_result* result)
 {
+	// ܵʽ첽ʽĽΪ
+	if (pipeline_ != NULL || async_ != NULL)
+		return;
+
 	if (result == NULL)
 	{
 		logger_error("result NULL");
@@ -1132,6 +1556,81 @@ int redis_command::get_strings(std::vector<const char*>& names,
 	return (int) names.size();
 }
 
+int redis_command::get_strings(std::vector<string_view>& out)
+{
+	out.clear();
+
+	const redis_result* result = run();
+	if (result == NULL || result->get_type() != REDIS_RESULT_ARRAY)
+	{
+		logger_result(result);
+		return -1;
+	}
+
+	size_t size;
+	const redis_result** children = result->get_children(&size);
+	if (children == NULL)
+		return 0;
+
+	out.reserve(size);
+
+	const redis_result* rr;
+	for (size_t i = 0; i < size; i++)
+	{
+		rr = children[i];
+		if (rr == NULL || rr->get_type() != REDIS_RESULT_STRING)
+			out.push_back(string_view());
+		else
+			out.push_back(rr->argv_view());
+	}
+
+	return (int) size;
+}
+
+int redis_command::get_strings(std::vector<string_view>& names,
+	std::vector<string_view>& values)
+{
+	names.clear();
+	values.clear();
+
+	const redis_result* result = run();
+	if (result == NULL || result->get_type() != REDIS_RESULT_ARRAY)
+	{
+		logger_result(result);
+		return -1;
+	}
+	if (result->get_size() == 0)
+		return 0;
+
+	size_t size;
+	const redis_result** children = result->get_children(&size);
+
+	if (children == NULL)
+		return -1;
+	if (size % 2 != 0)
+		return -1;
+
+	names.reserve(size / 2);
+	values.reserve(size / 2);
+
+	const redis_result* name, *value;
+	for (size_t i = 0; i < size; i += 2)
+	{
+		name = children[i];
+		value = children[i + 1];
+		if (name->get_type() != REDIS_RESULT_STRING
+			|| value->get_type() != REDIS_RESULT_STRING)
+		{
+			continue;
+		}
+
+		names.push_back(name->argv_view());
+		values.push_back(value->argv_view());
+	}
+
+	return (int) names.size();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 const redis_result** redis_command::scan_keys(const char* cmd, const char* key,
@@ -1247,8 +1746,90 @@ void redis_command::clear_request()
 		request_obj_->clear();
 }
 
+// ֻȺģʽ¿ɰ redis_client_cluster::set_read_policy Ĳ
+// ӽ㣬밴ĸ˳
+static const char* __readonly_cmds[] = {
+	"BITCOUNT", "BITPOS", "DBSIZE", "DUMP", "EXISTS", "GEODIST",
+	"GEOHASH", "GEOPOS", "GEORADIUSBYMEMBER_RO", "GEORADIUS_RO",
+	"GEOSEARCH", "GET", "GETBIT", "GETRANGE", "HEXISTS", "HGET",
+	"HGETALL", "HKEYS", "HLEN", "HMGET", "HRANDFIELD", "HSCAN",
+	"HSTRLEN", "HVALS", "KEYS", "LINDEX", "LLEN", "LPOS", "LRANGE",
+	"MGET", "PFCOUNT", "PTTL", "RANDOMKEY", "SCAN", "SCARD",
+	"SDIFF", "SINTER", "SISMEMBER", "SMEMBERS", "SMISMEMBER",
+	"SRANDMEMBER", "SSCAN", "STRLEN", "SUBSTR", "SUNION", "TTL",
+	"TYPE", "XLEN", "XRANGE", "XREVRANGE", "ZCARD", "ZCOUNT",
+	"ZLEXCOUNT", "ZMSCORE", "ZRANDMEMBER", "ZRANGE", "ZRANGEBYLEX",
+	"ZRANGEBYSCORE", "ZRANK", "ZREVRANGE", "ZREVRANGEBYLEX",
+	"ZREVRANGEBYSCORE", "ZREVRANK", "ZSCAN", "ZSCORE",
+};
+
+// ı״̬ӵڶ·÷ʽ̹߳
+// ӣ밴ĸ˳
+static const char* __mux_unsafe_cmds[] = {
+	"AUTH", "BLMOVE", "BLMPOP", "BLPOP", "BRPOP", "BRPOPLPUSH",
+	"BZMPOP", "BZPOPMAX", "BZPOPMIN", "DISCARD", "EXEC", "HELLO",
+	"MONITOR", "MULTI", "PSUBSCRIBE", "PUNSUBSCRIBE", "QUIT",
+	"READONLY", "READWRITE", "RESET", "SELECT", "SSUBSCRIBE",
+	"SUBSCRIBE", "SUNSUBSCRIBE", "UNSUBSCRIBE", "UNWATCH", "WAIT",
+	"WATCH",
+};
+
+static int cmd_cmp(const void* key, const void* elem)
+{
+	return strcmp((const char*) key, *(const char**) elem);
+}
+
+static bool find_cmd(const char* cmds[], size_t n, const char* cmd,
+	size_t len)
+{
+	char buf[32];
+	if (len == 0 || len >= sizeof(buf))
+		return false;
+
+	for (size_t i = 0; i < len; i++)
+		buf[i] = (char) toupper((unsigned char) cmd[i]);
+	buf[len] = 0;
+
+	return bsearch(buf, cmds, n, sizeof(cmds[0]), cmd_cmp) != NULL;
+}
+
+static bool is_readonly(const char* cmd, size_t len)
+{
+	return find_cmd(__readonly_cmds, sizeof(__readonly_cmds)
+		/ sizeof(__readonly_cmds[0]), cmd, len);
+}
+
+static bool is_mux_unsafe(size_t argc, const char* argv[],
+	const size_t lens[])
+{
+	if (find_cmd(__mux_unsafe_cmds, sizeof(__mux_unsafe_cmds)
+		/ sizeof(__mux_unsafe_cmds[0]), argv[0], lens[0]))
+	{
+		return true;
+	}
+
+	// XREAD/XREADGROUP  BLOCK ʱŻ
+	if (!(lens[0] == sizeof("XREAD") - 1 && EQ(argv[0], "XREAD"))
+		&& !(lens[0] == sizeof("XREADGROUP") - 1
+			&& EQ(argv[0], "XREADGROUP")))
+	{
+		return false;
+	}
+
+	for (size_t i = 1; i < argc; i++)
+	{
+		if (lens[i] == sizeof("BLOCK") - 1 && EQ(argv[i], "BLOCK"))
+			return true;
+	}
+	return false;
+}
+
 void redis_command::build_request(size_t argc, const char* argv[], size_t lens[])
 {
+	readonly_ = argc > 0 && is_readonly(argv[0], lens[0]);
+	mux_unsafe_ = mux_ != NULL && argc > 0
+		&& is_mux_unsafe(argc, argv, lens);
+
 	if (slice_req_)
 		build_request2(argc, argv, lens);
 	else
@@ -1262,40 +1843,46 @@ void redis_command::build_request1(size_t argc, const char* argv[], size_t lens[
 	else
 		request_buf_->clear();
 
+	build_request_buf(*request_buf_, argc, argv, lens);
+}
+
+void redis_command::build_request_buf(string& out, size_t argc,
+	const char* argv[], const size_t lens[])
+{
 //#define	USE_FORMAT
 //#define	USE_SNPRINTF
 
 #if	defined(USE_FORMAT)
-	request_buf_->format("*%lu\r\n", (unsigned long) argc);
+	out.format("*%lu\r\n", (unsigned long) argc);
 #elif	defined(USE_SNPRINTF)
 	char  buf[64];
 	snprintf(buf, sizeof(buf), "*%lu\r\n", (unsigned long) argc);
-	request_buf_->append(buf);
+	out.append(buf);
 #else
 	char  buf[64];
 	acl_ui64toa_radix((acl_uint64) argc, buf, sizeof(buf), 10);
-	request_buf_->append("*");
-	request_buf_->append(buf);
-	request_buf_->append("\r\n");
+	out.append("*");
+	out.append(buf);
+	out.append("\r\n");
 #endif
 
 	for (size_t i = 0; i < argc; i++)
 	{
 #if	defined(USE_FORMAT)
-		request_buf_->format_append("$%lu\r\n", (unsigned long) lens[i]);
+		out.format_append("$%lu\r\n", (unsigned long) lens[i]);
 #elif	defined(USE_SNPRINTF)
 		snprintf(buf, sizeof(buf), "$%lu\r\n", (unsigned long) lens[i]);
-		request_buf_->append(buf);
+		out.append(buf);
 #else
 		acl_ui64toa_radix((acl_uint64) lens[i], buf, sizeof(buf), 10);
-		request_buf_->append("$");
-		request_buf_->append(buf);
-		request_buf_->append("\r\n");
+		out.append("$");
+		out.append(buf);
+		out.append("\r\n");
 #endif
-		request_buf_->append(argv[i], lens[i]);
-		request_buf_->append("\r\n");
+		out.append(argv[i], lens[i]);
+		out.append("\r\n");
 	}
-	//printf("%s:\r\n%s\r\n", __FUNCTION__, request_buf_->c_str());
+	//printf("%s:\r\n%s\r\n", __FUNCTION__, out.c_str());
 }
 
 void redis_command::build_request2(size_t argc, const char* argv[], size_t lens[])
@@ -165,6 +165,7 @@ bool redis_hash::hget(const char* key, const char* name,
 
 	hash_slot(key);
 	build_request(3, argv, lens);
+	set_cache_key(key, lens[1], name, name_len);
 	return get_string(result) >= 0 ? true : false;
 }
 
@@ -200,6 +201,17 @@ bool redis_hash::hgetall(const char* key, std::vector<const char*>& names,
 	return get_strings(names, values) < 0 ? false : true;
 }
 
+bool redis_hash::hgetall(const char* key, std::vector<string_view>& names,
+	std::vector<string_view>& values)
+{
+	const char* keys[1];
+	keys[0] = key;
+
+	hash_slot(key);
+	build("HGETALL", NULL, keys, 1);
+	return get_strings(names, values) < 0 ? false : true;
+}
+
 int redis_hash::hdel(const char* key, const char* name)
 {
 	return hdel_fields(key, name, NULL);
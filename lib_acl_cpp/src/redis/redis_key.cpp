@@ -99,6 +99,7 @@ int redis_key::del_keys(const std::vector<string>& keys)
 	if (keys.size() == 1)
 		hash_slot(keys[0].c_str());
 	build("DEL", NULL, keys);
+	split_keys(1);
 	return get_number();
 }
 
@@ -107,6 +108,7 @@ int redis_key::del_keys(const std::vector<const char*>& keys)
 	if (keys.size() == 1)
 		hash_slot(keys[0]);
 	build("DEL", NULL, keys);
+	split_keys(1);
 	return get_number();
 }
 
@@ -115,6 +117,7 @@ int redis_key::del_keys(const char* keys[], size_t argc)
 	if (argc == 1)
 		hash_slot(keys[0]);
 	build("DEL", NULL, keys, argc);
+	split_keys(1);
 	return get_number();
 }
 
@@ -123,6 +126,7 @@ int redis_key::del_keys(const char* keys[], const size_t lens[], size_t argc)
 	if (argc == 1)
 		hash_slot(keys[0], lens[0]);
 	build("DEL", NULL, keys, lens, argc);
+	split_keys(1);
 	return get_number();
 }
 
@@ -158,6 +162,42 @@ bool redis_key::exists(const char* key)
 	return get_number() > 0 ? true : false;
 }
 
+int redis_key::exists_keys(const std::vector<string>& keys)
+{
+	if (keys.size() == 1)
+		hash_slot(keys[0].c_str());
+	build("EXISTS", NULL, keys);
+	split_keys(1);
+	return get_number();
+}
+
+int redis_key::exists_keys(const std::vector<const char*>& keys)
+{
+	if (keys.size() == 1)
+		hash_slot(keys[0]);
+	build("EXISTS", NULL, keys);
+	split_keys(1);
+	return get_number();
+}
+
+int redis_key::exists_keys(const char* keys[], size_t argc)
+{
+	if (argc == 1)
+		hash_slot(keys[0]);
+	build("EXISTS", NULL, keys, argc);
+	split_keys(1);
+	return get_number();
+}
+
+int redis_key::exists_keys(const char* keys[], const size_t lens[], size_t argc)
+{
+	if (argc == 1)
+		hash_slot(keys[0], lens[0]);
+	build("EXISTS", NULL, keys, lens, argc);
+	split_keys(1);
+	return get_number();
+}
+
 int redis_key::expire(const char* key, int n)
 {
 	const char* argv[3];
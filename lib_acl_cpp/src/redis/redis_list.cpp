@@ -505,6 +505,22 @@ bool redis_list::lrange(const char* key, int start, int end,
 	return get_strings(result) < 0 ? false : true;
 }
 
+bool redis_list::lrange(const char* key, int start, int end,
+	std::vector<string_view>& result)
+{
+	char start_s[LONG_LEN], end_s[LONG_LEN];
+	safe_snprintf(start_s, sizeof(start_s), "%d", start);
+	safe_snprintf(end_s, sizeof(end_s), "%d", end);
+
+	const char* names[2];
+	names[0] = start_s;
+	names[1] = end_s;
+
+	hash_slot(key);
+	build("LRANGE", key, names, 2);
+	return get_strings(result) < 0 ? false : true;
+}
+
 int redis_list::lrem(const char* key, int count, const char* value)
 {
 	return lrem(key, count, value, strlen(value));
@@ -0,0 +1,434 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_parser.hpp"
+#endif
+
+namespace acl
+{
+
+// Ƭ洢ݿʱÿƬڴС
+#define CHUNK_LENGTH	8192
+
+redis_parser::redis_parser(void)
+: dbuf_(NULL)
+, status_(PARSE_DONE)
+, type_(0)
+, result_(NULL)
+, bulk_rr_(NULL)
+, bulk_(NULL)
+, bulk_len_(0)
+, bulk_off_(0)
+, piece_len_(0)
+, piece_off_(0)
+, sliced_(false)
+, slice_(false)
+, inplace_(false)
+, want_(0)
+, verbatim_(false)
+, resp3_types_(false)
+{
+}
+
+redis_parser::~redis_parser(void)
+{
+}
+
+void redis_parser::reset(dbuf_pool* dbuf, size_t nchildren /* = 0 */)
+{
+	dbuf_     = dbuf;
+	status_   = PARSE_TYPE;
+	type_     = 0;
+	result_   = NULL;
+	bulk_rr_  = NULL;
+	bulk_     = NULL;
+	bulk_len_ = 0;
+	bulk_off_ = 0;
+	piece_len_ = 0;
+	piece_off_ = 0;
+	sliced_   = false;
+	want_     = 0;
+	verbatim_ = false;
+	line_.clear();
+	frames_.clear();
+	pushes_.clear();
+
+	// ӦϲΪһͬ redis_client::get_redis_objects
+	if (nchildren >= 1)
+	{
+		redis_result* rr = new(dbuf_) redis_result(dbuf_);
+		rr->set_type(REDIS_RESULT_ARRAY);
+		rr->set_size(nchildren);
+
+		parse_frame frame;
+		frame.rr    = rr;
+		frame.count = nchildren;
+		frame.idx   = 0;
+		frame.type  = 0;
+		frames_.push_back(frame);
+	}
+}
+
+void redis_parser::put_data(redis_result* rr, const char* data, size_t len)
+{
+	char* buf = (char*) dbuf_->dbuf_alloc(len + 1);
+	if (len > 0)
+		memcpy(buf, data, len);
+	buf[len] = 0;
+	rr->put(buf, len);
+}
+
+void redis_parser::put_piece(void)
+{
+	const char* ptr = bulk_;
+	size_t len = piece_len_;
+
+	// RESP3  =  3 ֽڵĸʽ˵ : ͷ磺txt:
+	if (verbatim_ && bulk_rr_->idx_ == 0 && len >= 4 && ptr[3] == ':')
+	{
+		ptr += 4;
+		len -= 4;
+	}
+	bulk_rr_->put(ptr, len);
+}
+
+int redis_parser::update(const char* data, size_t len)
+{
+	// ʽ²д
+	inplace_ = false;
+	return parse((char*) data, len);
+}
+
+int redis_parser::update_inplace(char* data, size_t len)
+{
+	inplace_ = true;
+	return parse(data, len);
+}
+
+int redis_parser::parse(char* data, size_t len)
+{
+	char* ptr = data, *end = data + len;
+
+	want_ = 0;
+
+	while (ptr < end)
+	{
+		switch (status_)
+		{
+		case PARSE_TYPE:
+			type_ = *ptr++;
+			if (strchr("-+:$*_,#(=!%~>|", type_) == NULL
+				|| type_ == 0)
+			{
+				logger_error("invalid first char: %c, %d",
+					type_, type_);
+				status_ = PARSE_ERR;
+				return -1;
+			}
+			line_.clear();
+			status_ = PARSE_LINE;
+			break;
+		case PARSE_LINE:
+		{
+			char* lf = (char*) memchr(ptr, '\n', end - ptr);
+
+			// 㿽ʽ£ֱн
+			// ݵһ
+			if (inplace_ && line_.empty())
+			{
+				if (lf == NULL)
+					return (int) (ptr - data);
+
+				char* line = ptr;
+				size_t n = lf - ptr;
+				if (n > 0 && line[n - 1] == '\r')
+					n--;
+				line[n] = 0;
+				ptr = lf + 1;
+
+				if (!on_line(line, n, false))
+				{
+					status_ = PARSE_ERR;
+					return -1;
+				}
+				break;
+			}
+
+			if (lf == NULL)
+			{
+				line_.append(ptr, end - ptr);
+				ptr = end;
+				break;
+			}
+
+			line_.append(ptr, lf - ptr);
+			ptr = lf + 1;
+
+			// ȥβ \r
+			size_t n = line_.length();
+			if (n > 0 && line_[n - 1] == '\r')
+				line_.truncate(n - 1);
+
+			if (!on_line(line_.c_str(), line_.length(), true))
+			{
+				status_ = PARSE_ERR;
+				return -1;
+			}
+			break;
+		}
+		case PARSE_BULK:
+		{
+			size_t n = (size_t) (end - ptr);
+
+			// 㿽ʽ£λеݿ鱻ֱã
+			//  \r дΪ \0
+			if (inplace_ && bulk_ == NULL && !sliced_)
+			{
+				if (n <= bulk_len_)
+				{
+					want_ = bulk_len_ + 2;
+					return (int) (ptr - data);
+				}
+
+				bulk_      = ptr;
+				piece_len_ = bulk_len_;
+				bulk_off_  = bulk_len_;
+				ptr       += bulk_len_;
+				*ptr++     = 0;
+				status_    = PARSE_BULK_END;
+				break;
+			}
+
+			if (bulk_ == NULL)
+			{
+				piece_len_ = bulk_len_ - bulk_off_;
+				if (sliced_ && piece_len_ > CHUNK_LENGTH - 1)
+					piece_len_ = CHUNK_LENGTH - 1;
+				piece_off_ = 0;
+				bulk_      = (char*) dbuf_->dbuf_alloc(piece_len_ + 1);
+				bulk_[piece_len_] = 0;
+			}
+
+			if (n > piece_len_ - piece_off_)
+				n = piece_len_ - piece_off_;
+			if (n > 0)
+				memcpy(bulk_ + piece_off_, ptr, n);
+			piece_off_ += n;
+			bulk_off_  += n;
+			ptr        += n;
+
+			if (piece_off_ < piece_len_)
+				break;
+			if (bulk_off_ == bulk_len_)
+				status_ = PARSE_BULK_END;
+			else
+			{
+				// ǰƬµķƬ
+				put_piece();
+				bulk_ = NULL;
+			}
+			break;
+		}
+		case PARSE_BULK_END:
+			// ݿ \r\n
+			if (*ptr++ == '\n')
+			{
+				put_piece();
+				on_object(bulk_rr_);
+			}
+			break;
+		case PARSE_DONE:
+			return (int) (ptr - data);
+		case PARSE_ERR:
+		default:
+			return -1;
+		}
+	}
+
+	return (int) (ptr - data);
+}
+
+bool redis_parser::on_line(const char* line, size_t len, bool copy)
+{
+	redis_result* rr = new(dbuf_) redis_result(dbuf_);
+
+	switch (type_)
+	{
+	case '-':	// ERROR
+		rr->set_type(REDIS_RESULT_ERROR);
+		break;
+	case '+':	// STATUS
+		rr->set_type(REDIS_RESULT_STATUS);
+		break;
+	case ':':	// INTEGER
+		rr->set_type(REDIS_RESULT_INTEGER);
+		break;
+	case ',':	// RESP3 DOUBLE
+		rr->set_type(result_type(REDIS_RESULT_DOUBLE,
+			REDIS_RESULT_STRING));
+		break;
+	case '(':	// RESP3 BIG NUMBER
+		rr->set_type(result_type(REDIS_RESULT_BIGNUM,
+			REDIS_RESULT_STRING));
+		break;
+	case '#':	// RESP3 BOOLEAN 1  0 洢
+		rr->set_type(result_type(REDIS_RESULT_BOOL,
+			REDIS_RESULT_INTEGER));
+		rr->set_size(1);
+		rr->put(*line == 't' ? "1" : "0", 1);
+		on_object(rr);
+		return true;
+	case '_':	// RESP3 NULLͬ RESP2 Ŀݿ
+		rr->set_type(result_type(REDIS_RESULT_NIL,
+			REDIS_RESULT_STRING));
+		on_object(rr);
+		return true;
+	case '$':	// STRING
+	case '=':	// RESP3 VERBATIM STRING
+	case '!':	// RESP3 BLOB ERROR
+	{
+		rr->set_type(type_ == '!' ? REDIS_RESULT_ERROR
+			: REDIS_RESULT_STRING);
+		long long n = acl_atoi64(line);
+		if (n < 0)
+		{
+			on_object(rr);
+			return true;
+		}
+
+		bulk_rr_  = rr;
+		bulk_len_ = (size_t) n;
+		bulk_off_ = 0;
+		bulk_     = NULL;
+		verbatim_ = type_ == '=';
+		sliced_   = slice_ && type_ != '!'
+			&& bulk_len_ > CHUNK_LENGTH - 1;
+
+		// Ƭ洢ʱÿƬ CHUNK_LENGTH - 1 ֽ
+		if (sliced_)
+			rr->set_size((bulk_len_ + CHUNK_LENGTH - 2)
+				/ (CHUNK_LENGTH - 1));
+		else
+			rr->set_size(1);
+		status_   = PARSE_BULK;
+		return true;
+	}
+	case '*':	// ARRAY
+	case '%':	// RESP3 MAP
+	case '~':	// RESP3 SET
+	case '>':	// RESP3 PUSH
+	case '|':	// RESP3 ATTRIBUTE
+		return on_aggregate(rr, line);
+	default:
+		logger_error("invalid type: %c, %d", type_, type_);
+		return false;
+	}
+
+	rr->set_size(1);
+	if (copy)
+		put_data(rr, line, len);
+	else
+		rr->put(line, len);
+	on_object(rr);
+	return true;
+}
+
+bool redis_parser::on_aggregate(redis_result* rr, const char* line)
+{
+	switch (type_)
+	{
+	case '%':
+		rr->set_type(result_type(REDIS_RESULT_MAP, REDIS_RESULT_ARRAY));
+		break;
+	case '~':
+		rr->set_type(result_type(REDIS_RESULT_SET, REDIS_RESULT_ARRAY));
+		break;
+	case '>':
+		rr->set_type(result_type(REDIS_RESULT_PUSH, REDIS_RESULT_ARRAY));
+		break;
+	default:
+		rr->set_type(REDIS_RESULT_ARRAY);
+		break;
+	}
+
+	int count = atoi(line);
+	if (count <= 0)
+	{
+		// յϢֱӶ
+		if (type_ == '|')
+			status_ = PARSE_TYPE;
+		else
+			on_object(rr);
+		return true;
+	}
+
+	// MAP Ϣļֵ
+	if (type_ == '%' || type_ == '|')
+		count *= 2;
+
+	rr->set_size((size_t) count);
+
+	parse_frame frame;
+	frame.rr    = rr;
+	frame.count = (size_t) count;
+	frame.idx   = 0;
+	frame.type  = type_;
+	frames_.push_back(frame);
+	status_ = PARSE_TYPE;
+	return true;
+}
+
+// ǷΪͻ˻ʧЧ֪ͨ>2 invalidate [key ...]  >2 invalidate _
+static bool is_invalidate(const redis_result* rr)
+{
+	const redis_result* first = rr->get_child(0);
+	if (first == NULL || first->get_type() != REDIS_RESULT_STRING)
+		return false;
+
+	size_t len;
+	const char* ptr = first->get(0, &len);
+	return ptr != NULL && len == sizeof("invalidate") - 1
+		&& memcmp(ptr, "invalidate", len) == 0;
+}
+
+void redis_parser::on_object(redis_result* rr)
+{
+	// ϵĶУֱδ
+	while (!frames_.empty())
+	{
+		parse_frame& frame = frames_.back();
+		frame.rr->put(rr, frame.idx++);
+		if (frame.idx < frame.count)
+		{
+			status_ = PARSE_TYPE;
+			return;
+		}
+
+		rr = frame.rr;
+		char type = frame.type;
+		frames_.pop_back();
+
+		// ϢΪݵĸ˵֮
+		if (type == '|')
+		{
+			status_ = PARSE_TYPE;
+			return;
+		}
+
+		// ʧЧ֪ͨκӦ
+		if (type == '>' && (frames_.empty() || frames_.back().type == 0)
+			&& is_invalidate(rr))
+		{
+			pushes_.push_back(rr);
+			status_ = PARSE_TYPE;
+			return;
+		}
+	}
+
+	result_ = rr;
+	status_ = PARSE_DONE;
+}
+
+} // namespace acl
@@ -0,0 +1,464 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/dbuf_pool.hpp"
+#include "acl_cpp/redis/redis_client.hpp"
+#include "acl_cpp/redis/redis_client_pool.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_pipeline.hpp"
+#endif
+#include "redis_request.hpp"
+
+namespace acl
+{
+
+redis_pipeline::redis_pipeline(redis_client* conn)
+: conn_(conn)
+, cluster_(NULL)
+, max_conns_(0)
+, redirect_max_(15)
+, redirect_sleep_(1)
+{
+	dbuf_ = new dbuf_pool();
+}
+
+redis_pipeline::redis_pipeline(redis_client_cluster* cluster,
+	size_t max_conns /* = 0 */)
+: conn_(NULL)
+, cluster_(cluster)
+, max_conns_(max_conns)
+{
+	dbuf_ = new dbuf_pool();
+
+	if (cluster != NULL)
+	{
+		redirect_max_ = cluster->get_redirect_max();
+		if (redirect_max_ <= 0)
+			redirect_max_ = 15;
+		redirect_sleep_ = cluster->get_redirect_sleep();
+	}
+	else
+	{
+		redirect_max_ = 15;
+		redirect_sleep_ = 1;
+	}
+}
+
+redis_pipeline::~redis_pipeline(void)
+{
+	dbuf_->destroy();
+}
+
+void redis_pipeline::clear(void)
+{
+	cmds_.clear();
+	buf_.clear();
+	dbuf_->dbuf_reset();
+}
+
+void redis_pipeline::push(const string& req, int slot, size_t nchild)
+{
+	pipeline_cmd cmd;
+
+	cmd.off    = buf_.size();
+	cmd.len    = req.size();
+	cmd.slot   = slot;
+	cmd.nchild = nchild;
+	cmd.addr   = NULL;
+	cmd.asking = false;
+	cmd.sent   = false;
+	cmd.result = NULL;
+
+	buf_.append(req.c_str(), req.size());
+	cmds_.push_back(cmd);
+}
+
+void redis_pipeline::push(const redis_request& req, int slot, size_t nchild)
+{
+	pipeline_cmd cmd;
+
+	cmd.off    = buf_.size();
+	cmd.slot   = slot;
+	cmd.nchild = nchild;
+	cmd.addr   = NULL;
+	cmd.asking = false;
+	cmd.sent   = false;
+	cmd.result = NULL;
+
+	// ƬݺϲĻ
+	const struct iovec* iov = req.get_iovec();
+	size_t size = req.get_size();
+	for (size_t i = 0; i < size; i++)
+		buf_.append((const char*) iov[i].iov_base, iov[i].iov_len);
+
+	cmd.len = buf_.size() - cmd.off;
+	cmds_.push_back(cmd);
+}
+
+const redis_result* redis_pipeline::get_result(size_t i) const
+{
+	if (i >= cmds_.size())
+		return NULL;
+	return cmds_[i].result;
+}
+
+bool redis_pipeline::exec(void)
+{
+	if (cmds_.empty())
+		return true;
+
+	// ͷϴִеĽøض״̬
+	dbuf_->dbuf_reset();
+	for (std::vector<pipeline_cmd>::iterator it = cmds_.begin();
+		it != cmds_.end(); ++it)
+	{
+		(*it).addr   = NULL;
+		(*it).asking = false;
+		(*it).sent   = false;
+		(*it).result = NULL;
+	}
+
+	if (cluster_ != NULL)
+		return exec_cluster();
+	return exec_client();
+}
+
+bool redis_pipeline::exec_client(void)
+{
+	if (conn_ == NULL)
+	{
+		logger_error("ERROR: cluster_ and conn_ are all NULL");
+		return false;
+	}
+
+	size_t n = cmds_.size();
+	std::vector<size_t> nchildren(n);
+	std::vector<const redis_result*> results(n);
+
+	for (size_t i = 0; i < n; i++)
+		nchildren[i] = cmds_[i].nchild;
+
+	// ǼȺģʽģԽһд
+	struct iovec iov;
+	iov.iov_base = (char*) buf_.c_str();
+	iov.iov_len  = buf_.size();
+
+	size_t nread = conn_->run(dbuf_, &iov, 1, &nchildren[0],
+			&results[0], n);
+	for (size_t i = 0; i < nread; i++)
+		cmds_[i].result = results[i];
+
+	return nread == n;
+}
+
+struct redis_pipeline::pipeline_group
+{
+	connect_pool* pool;
+	redis_client* conn;
+	bool unsent;			// Ƿȫδд
+	std::vector<size_t> cmds;	//  cmds_ е±
+	std::vector<struct iovec> iov;
+	std::vector<size_t> nchildren;
+};
+
+bool redis_pipeline::exec_cluster(void)
+{
+	size_t n = cmds_.size(), i, nread;
+	int    round = 0;
+
+	while (round++ < redirect_max_)
+	{
+		// δõڽӳؽз飬˳
+		// ѱдȴδõӦѱִУط
+		std::vector<pipeline_group> groups;
+
+		for (i = 0; i < n; i++)
+		{
+			if (cmds_[i].result != NULL || cmds_[i].sent)
+				continue;
+
+			connect_pool* pool = get_pool(cmds_[i]);
+			if (pool == NULL)
+			{
+				logger_error("no pool available, slot: %d",
+					cmds_[i].slot);
+				continue;
+			}
+
+			size_t j;
+			for (j = 0; j < groups.size(); j++)
+			{
+				if (groups[j].pool == pool)
+					break;
+			}
+			if (j == groups.size())
+			{
+				groups.push_back(pipeline_group());
+				groups[j].pool   = pool;
+				groups[j].conn   = NULL;
+				groups[j].unsent = false;
+			}
+			groups[j].cmds.push_back(i);
+		}
+
+		if (groups.empty())
+			break;
+
+		if (round >= 3 && redirect_sleep_ > 0)
+		{
+			logger("redirect %d, waiting ...", round - 1);
+			acl_doze(redirect_sleep_);
+		}
+
+		// ȽдԵĽ㣬ζȡӦʹ㲢
+		// ܺʱӽĽǸʱ֮
+		for (i = 0; i < groups.size(); i++)
+			send(groups[i]);
+
+		nread = 0;
+		for (i = 0; i < groups.size(); i++)
+			nread += read(groups[i]);
+
+		// ûжκν˵нã򲻱
+		if (nread == 0)
+			break;
+
+		// ض󣬱ضһ·
+		size_t nredirect = 0;
+		for (i = 0; i < n; i++)
+		{
+			if (cmds_[i].result != NULL && redirect(cmds_[i]))
+				nredirect++;
+		}
+
+		if (nredirect == 0)
+			break;
+	}
+
+	bool ok = true;
+	for (i = 0; i < n; i++)
+	{
+		if (cmds_[i].result == NULL)
+		{
+			ok = false;
+			break;
+		}
+	}
+
+	if (!ok && round > redirect_max_)
+		logger_warn("too many redirect: %d, max: %d",
+			round, redirect_max_);
+	return ok;
+}
+
+connect_pool* redis_pipeline::get_pool(const pipeline_cmd& cmd)
+{
+	connect_pool* pool;
+
+	// ضضĵַõַӳز̬
+	if (cmd.addr != NULL)
+	{
+		if ((pool = cluster_->get(cmd.addr)) == NULL)
+			pool = &cluster_->set(cmd.addr, max_conns_);
+		return pool;
+	}
+
+	// Ѿ˹ϣֵȴӱػвҶӦӳ
+	// δҵмȺһõӳض
+	if (cmd.slot < 0 || (pool = cluster_->peek_slot(cmd.slot)) == NULL)
+		pool = cluster_->peek();
+	return pool;
+}
+
+bool redis_pipeline::send(pipeline_group& group)
+{
+	static char asking[] = "ASKING\r\n";
+
+	group.conn = (redis_client*) group.pool->peek();
+	if (group.conn == NULL)
+	{
+		logger_error("peek NULL, addr: %s", group.pool->get_addr());
+		for (size_t i = 0; i < group.cmds.size(); i++)
+			cluster_->clear_slot(cmds_[group.cmds[i]].slot);
+#ifdef AUTO_SET_ALIVE
+		group.pool->set_alive(false);
+#endif
+		return false;
+	}
+
+	group.iov.reserve(group.cmds.size());
+	group.nchildren.reserve(group.cmds.size());
+
+	for (size_t i = 0; i < group.cmds.size(); i++)
+	{
+		const pipeline_cmd& cmd = cmds_[group.cmds[i]];
+
+		//  ASK ضҪȷ ASKING 
+		if (cmd.asking)
+		{
+			struct iovec v;
+			v.iov_base = asking;
+			v.iov_len  = sizeof(asking) - 1;
+			group.iov.push_back(v);
+			group.nchildren.push_back(0);
+		}
+
+		char* ptr = (char*) buf_.c_str() + cmd.off;
+
+		// ϲڻڵԼ iovec ĸ
+		if (!cmd.asking && !group.iov.empty()
+			&& (char*) group.iov.back().iov_base
+			+ group.iov.back().iov_len == ptr)
+		{
+			group.iov.back().iov_len += cmd.len;
+		}
+		else
+		{
+			struct iovec v;
+			v.iov_base = ptr;
+			v.iov_len  = cmd.len;
+			group.iov.push_back(v);
+		}
+		group.nchildren.push_back(cmd.nchild);
+	}
+
+	// һʼд㲻һбط
+	for (size_t i = 0; i < group.cmds.size(); i++)
+		cmds_[group.cmds[i]].sent = true;
+
+	// дʧʱѱرգֻзδյκʱڶ׶ͨ
+	// run Ӳ
+	int count = (int) group.iov.size();
+	int n = group.conn->send(&group.iov[0], count);
+	group.unsent = n == 0;
+	return n == count;
+}
+
+size_t redis_pipeline::read(pipeline_group& group)
+{
+	redis_client* conn = group.conn;
+	if (conn == NULL)
+		return 0;
+
+	size_t n = group.nchildren.size();
+	std::vector<const redis_result*> results(n);
+
+	size_t nread;
+
+	// ͽ׶δдκʱӲͱѱ
+	// дʹδκӦҲطΪ˿ִЩ
+	if (group.unsent)
+		nread = conn->run(dbuf_, &group.iov[0], (int) group.iov.size(),
+				&group.nchildren[0], &results[0], n);
+	else
+		nread = conn->read(dbuf_, &group.nchildren[0], &results[0], n);
+
+	// Ľ˳ȡ ASKING Ľ
+	size_t got = 0;
+	for (size_t i = 0, j = 0; i < group.cmds.size() && j < nread; i++, j++)
+	{
+		pipeline_cmd& cmd = cmds_[group.cmds[i]];
+		if (cmd.asking && ++j >= nread)
+			break;
+		cmd.result = results[j];
+		cmd.addr   = NULL;
+		cmd.asking = false;
+		got++;
+	}
+
+	// 쳣ϿɾϣеĵַӳϵԱ´»ȡ
+	if (conn->eof())
+	{
+		for (size_t i = 0; i < group.cmds.size(); i++)
+		{
+			if (cmds_[group.cmds[i]].result == NULL)
+				cluster_->clear_slot(cmds_[group.cmds[i]].slot);
+		}
+		group.pool->put(conn, false);
+	}
+	else
+		group.pool->put(conn, true);
+
+	group.conn = NULL;
+	return got;
+}
+
+#define	EQ(x, y) !strncasecmp((x), (y), sizeof(y) -1)
+
+bool redis_pipeline::redirect(pipeline_cmd& cmd)
+{
+	if (cmd.result->get_type() != REDIS_RESULT_ERROR)
+		return false;
+
+	const char* ptr = cmd.result->get_error();
+	if (ptr == NULL || *ptr == 0)
+		return false;
+
+	if (EQ(ptr, "MOVED"))
+	{
+		cluster_->on_redirect(true);
+
+		const char* addr = get_addr(ptr);
+		if (addr == NULL)
+		{
+			logger_warn("MOVED invalid, ptr: %s", ptr);
+			return false;
+		}
+
+		// MOVED ʾϣѾǨƣҪ¹ϣ۵ĵַӳϵ
+		// ϣӳдŵӳأȴõַӳ
+		if (cluster_->get(addr) == NULL)
+			cluster_->set(addr, max_conns_);
+		cluster_->set_slot(cmd.slot, addr);
+		cmd.addr   = addr;
+		cmd.asking = false;
+	}
+	else if (EQ(ptr, "ASK"))
+	{
+		cluster_->on_redirect(false);
+
+		const char* addr = get_addr(ptr);
+		if (addr == NULL)
+		{
+			logger_warn("ASK invalid, ptr: %s", ptr);
+			return false;
+		}
+
+		// ASK ʾϣǨƣ½
+		cmd.addr   = addr;
+		cmd.asking = true;
+	}
+	else if (EQ(ptr, "CLUSTERDOWN"))
+	{
+		// һʧЧΣһִ
+		cluster_->clear_slot(cmd.slot);
+		cmd.addr   = NULL;
+		cmd.asking = false;
+	}
+	else
+		return false;
+
+	cmd.result = NULL;
+	cmd.sent   = false;
+	return true;
+}
+
+const char* redis_pipeline::get_addr(const char* info)
+{
+	char* cmd = dbuf_->dbuf_strdup(info);
+	char* slot = strchr(cmd, ' ');
+	if (slot == NULL)
+		return NULL;
+	*slot++ = 0;
+	char* addr = strchr(slot, ' ');
+	if (addr == NULL)
+		return NULL;
+	*addr++ = 0;
+	if (*addr == 0)
+		return NULL;
+
+	return addr;
+}
+
+} // namespace acl
@@ -90,7 +90,7 @@ redis_result& redis_result::put(const char* buf, size_t len)
 
 size_t redis_result::get_size() const
 {
-	if (result_type_ == REDIS_RESULT_ARRAY)
+	if (is_aggregate())
 		return children_idx_;
 	else if (result_type_ == REDIS_RESULT_STRING)
 	{
@@ -106,8 +106,11 @@ int redis_result::get_integer(bool* success /* = NULL */) const
 {
 	if (success)
 		*success = false;
-	if (result_type_ != REDIS_RESULT_INTEGER)
+	if (result_type_ != REDIS_RESULT_INTEGER
+		&& result_type_ != REDIS_RESULT_BOOL)
+	{
 		return -1;
+	}
 	const char* ptr = get(0);
 	if (ptr == NULL || *ptr == 0)
 		return -1;
@@ -120,8 +123,11 @@ long long int redis_result::get_integer64(bool* success /* = NULL */) const
 {
 	if (success)
 		*success = false;
-	if (result_type_ != REDIS_RESULT_INTEGER)
+	if (result_type_ != REDIS_RESULT_INTEGER
+		&& result_type_ != REDIS_RESULT_BOOL)
+	{
 		return -1;
+	}
 	const char* ptr = get(0);
 	if (ptr == NULL || *ptr == 0)
 		return -1;
@@ -134,8 +140,11 @@ double redis_result::get_double(bool* success /* = NULL */) const
 {
 	if (success)
 		*success = false;
-	if (result_type_ != REDIS_RESULT_STRING)
+	if (result_type_ != REDIS_RESULT_STRING
+		&& result_type_ != REDIS_RESULT_DOUBLE)
+	{
 		return -1;
+	}
 	const char* ptr = get(0);
 	if (ptr == NULL || *ptr == 0)
 		return -1;
@@ -228,6 +237,26 @@ int redis_result::argv_to_string(char* buf, size_t size) const
 	return length;
 }
 
+string_view redis_result::argv_view(void) const
+{
+	if (idx_ == 0)
+		return string_view();
+	if (idx_ == 1)
+		return string_view(argv_[0], lens_[0]);
+
+	// ݱƬ洢ʱҪڴϺϲڴ
+	size_t len = get_length();
+	char* buf = (char*) dbuf_->dbuf_alloc(len + 1);
+	char* ptr = buf;
+	for (size_t i = 0; i < idx_; i++)
+	{
+		memcpy(ptr, argv_[i], lens_[i]);
+		ptr += lens_[i];
+	}
+	*ptr = 0;
+	return string_view(buf, len);
+}
+
 redis_result& redis_result::put(const redis_result* rr, size_t idx)
 {
 	if (children_ == NULL)
@@ -272,8 +301,7 @@ const redis_result** redis_result::get_children(size_t* size) const
 
 const string& redis_result::to_string(string& out) const
 {
-	redis_result_t type = get_type();
-	if (type != REDIS_RESULT_ARRAY)
+	if (!is_aggregate())
 	{
 		string buf;
 		argv_to_string(buf);
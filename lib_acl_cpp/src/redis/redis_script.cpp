@@ -4,6 +4,8 @@
 #include "acl_cpp/stdlib/snprintf.hpp"
 #include "acl_cpp/redis/redis_client.hpp"
 #include "acl_cpp/redis/redis_result.hpp"
+#include "acl_cpp/redis/redis_client_cluster.hpp"
+#include "acl_cpp/redis/redis_script_registry.hpp"
 #include "acl_cpp/redis/redis_script.hpp"
 #endif
 
@@ -14,16 +16,19 @@ namespace acl
 
 redis_script::redis_script()
 : redis_command(NULL)
+, scripts_(NULL)
 {
 }
 
 redis_script::redis_script(redis_client* conn)
 : redis_command(conn)
+, scripts_(NULL)
 {
 }
 
 redis_script::redis_script(redis_client_cluster* cluster, size_t max_conns)
 : redis_command(cluster, max_conns)
+, scripts_(NULL)
 {
 }
 
@@ -31,6 +36,39 @@ redis_script::~redis_script()
 {
 }
 
+void redis_script::set_script_registry(redis_script_registry* scripts)
+{
+	scripts_ = scripts;
+}
+
+redis_script_registry* redis_script::get_script_registry(void) const
+{
+	// ܵ첽ʽ޷յ NOSCRIPT 
+	if (get_pipeline() != NULL || get_async() != NULL)
+		return NULL;
+	if (scripts_ != NULL)
+		return scripts_;
+
+	redis_client_cluster* cluster = get_cluster();
+	if (cluster != NULL)
+		return cluster->get_script_registry();
+
+	redis_client* conn = get_client();
+	if (conn != NULL)
+		return conn->get_script_registry();
+
+	return NULL;
+}
+
+static bool is_noscript(const redis_result* result)
+{
+	if (result == NULL || result->get_type() != REDIS_RESULT_ERROR)
+		return false;
+
+	const char* err = result->get_error();
+	return err != NULL && strncasecmp(err, "NOSCRIPT", 8) == 0;
+}
+
 bool redis_script::eval_status(const char* script,
 	const std::vector<string>& keys,
 	const std::vector<string>& args,
@@ -373,6 +411,66 @@ const redis_result* redis_script::eval_cmd(const char* cmd,
 	const char* script,
 	const std::vector<string>& keys,
 	const std::vector<string>& args)
+{
+	redis_script_registry* scripts = get_script_registry();
+	if (scripts == NULL)
+		return eval_request(cmd, script, keys, args);
+
+	const char* sha1, *body;
+	if (strcasecmp(cmd, "EVAL") == 0)
+	{
+		sha1 = scripts->add(script);
+		body = script;
+	}
+	else
+	{
+		sha1 = script;
+		body = scripts->get_script(sha1);
+	}
+
+	const redis_result* result = eval_request("EVALSHA", sha1, keys, args);
+	if (body == NULL || !is_noscript(result))
+		return result;
+
+	// ûиýű(ִ SCRIPT FLUSH)ʱ EVAL 
+	// ͬһϣڵĽ㣬ýͬʱỺýű֮ EVALSHA ɳɹ
+	clear(true);
+	return eval_request("EVAL", body, keys, args);
+}
+
+const redis_result* redis_script::eval_cmd(const char* cmd,
+	const char* script,
+	const std::vector<const char*>& keys,
+	const std::vector<const char*>& args)
+{
+	redis_script_registry* scripts = get_script_registry();
+	if (scripts == NULL)
+		return eval_request(cmd, script, keys, args);
+
+	const char* sha1, *body;
+	if (strcasecmp(cmd, "EVAL") == 0)
+	{
+		sha1 = scripts->add(script);
+		body = script;
+	}
+	else
+	{
+		sha1 = script;
+		body = scripts->get_script(sha1);
+	}
+
+	const redis_result* result = eval_request("EVALSHA", sha1, keys, args);
+	if (body == NULL || !is_noscript(result))
+		return result;
+
+	clear(true);
+	return eval_request("EVAL", body, keys, args);
+}
+
+const redis_result* redis_script::eval_request(const char* cmd,
+	const char* script,
+	const std::vector<string>& keys,
+	const std::vector<string>& args)
 {
 	size_t argc = 3 + keys.size() + args.size();
 	const char** argv = (const char**)
@@ -416,7 +514,7 @@ const redis_result* redis_script::eval_cmd(const char* cmd,
 	return run();
 }
 
-const redis_result* redis_script::eval_cmd(const char* cmd,
+const redis_result* redis_script::eval_request(const char* cmd,
 	const char* script,
 	const std::vector<const char*>& keys,
 	const std::vector<const char*>& args)
@@ -456,6 +554,9 @@ const redis_result* redis_script::eval_cmd(const char* cmd,
 
 	acl_assert(i == argc);
 
+	if (keys.size() == 1)
+		hash_slot(keys[0]);
+
 	build_request(argc, argv, lens);
 	return run();
 }
@@ -0,0 +1,129 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/sha1.hpp"
+#include "acl_cpp/redis/redis_client.hpp"
+#include "acl_cpp/redis/redis_script.hpp"
+#include "acl_cpp/redis/redis_script_registry.hpp"
+#endif
+
+namespace acl
+{
+
+redis_script_registry::redis_script_registry(void)
+{
+}
+
+redis_script_registry::~redis_script_registry(void)
+{
+}
+
+void redis_script_registry::sha1_hex(const char* data, size_t len,
+	string& out)
+{
+	sha1 sha;
+	sha.input(data, (unsigned) len);
+
+	unsigned digest[5];
+	sha.result(digest);
+
+	out.clear();
+	for (size_t i = 0; i < 5; i++)
+		out.format_append("%08x", digest[i]);
+}
+
+const char* redis_script_registry::add(const char* script)
+{
+	string key(script);
+
+	lock_.lock();
+	std::map<string, string>::iterator it = scripts_.find(key);
+	if (it != scripts_.end())
+	{
+		const char* sha = it->second.c_str();
+		lock_.unlock();
+		return sha;
+	}
+	lock_.unlock();
+
+	// ״עʱժҪ߳
+	string sha;
+	sha1_hex(key.c_str(), key.size(), sha);
+
+	lock_.lock();
+	it = scripts_.find(key);
+	if (it == scripts_.end())
+	{
+		it = scripts_.insert(std::make_pair(key, sha)).first;
+		shas_[sha] = it->first.c_str();
+		order_.push_back(it->first.c_str());
+	}
+	const char* ptr = it->second.c_str();
+	lock_.unlock();
+
+	return ptr;
+}
+
+const char* redis_script_registry::get_script(const char* sha1) const
+{
+	string key(sha1);
+	key.lower();
+
+	lock_.lock();
+	std::map<string, const char*>::const_iterator cit = shas_.find(key);
+	const char* script = cit != shas_.end() ? cit->second : NULL;
+	lock_.unlock();
+
+	return script;
+}
+
+size_t redis_script_registry::size(void) const
+{
+	lock_.lock();
+	size_t n = order_.size();
+	lock_.unlock();
+	return n;
+}
+
+bool redis_script_registry::preload(redis_client& conn)
+{
+	string addr(conn.get_addr());
+	addr.lower();
+
+	// ظýδصĽűorder_ еĽűֻ
+	std::vector<const char*> scripts;
+	lock_.lock();
+	std::map<string, size_t>::const_iterator cit = loaded_.find(addr);
+	size_t from = cit != loaded_.end() ? cit->second : 0;
+	for (size_t i = from; i < order_.size(); i++)
+		scripts.push_back(order_[i]);
+	lock_.unlock();
+
+	if (scripts.empty())
+		return true;
+
+	redis_script cmd(&conn);
+	string buf, sha;
+
+	for (std::vector<const char*>::const_iterator it = scripts.begin();
+		it != scripts.end(); ++it)
+	{
+		cmd.clear();
+		buf = *it;
+		if (cmd.script_load(buf, sha) == false)
+		{
+			logger_error("SCRIPT LOAD to %s error: %s",
+				conn.get_addr(), cmd.result_error());
+			return false;
+		}
+	}
+
+	lock_.lock();
+	size_t& n = loaded_[addr];
+	if (n < from + scripts.size())
+		n = from + scripts.size();
+	lock_.unlock();
+
+	return true;
+}
+
+} // namespace acl
@@ -186,6 +186,7 @@ bool redis_string::get(const char* key, size_t len, string& buf)
 
 	hash_slot(key, len);
 	build_request(2, argv, lens);
+	set_cache_key(key, len);
 	return get_string(buf) >= 0 ? true : false;
 }
 
@@ -207,6 +208,7 @@ const redis_result* redis_string::get(const char* key, size_t len)
 
 	hash_slot(key, len);
 	build_request(2, argv, lens);
+	set_cache_key(key, len);
 	const redis_result* result = run();
 	if (result == NULL)
 		return NULL;
@@ -611,6 +613,7 @@ int redis_string::bitop(const char* op, const char* destkey,
 bool redis_string::mset(const std::map<string, string>& objs)
 {
 	build("MSET", NULL, objs);
+	split_keys(2);
 	return check_status();
 }
 
@@ -618,12 +621,14 @@ bool redis_string::mset(const std::vector<string>& keys,
 	const std::vector<string>& values)
 {
 	build("MSET", NULL, keys, values);
+	split_keys(2);
 	return check_status();
 }
 
 bool redis_string::mset(const char* keys[], const char* values[], size_t argc)
 {
 	build("MSET", NULL, keys, values, argc);
+	split_keys(2);
 	return check_status();
 }
 
@@ -631,6 +636,7 @@ bool redis_string::mset(const char* keys[], const size_t keys_len[],
 	const char* values[], const size_t values_len[], size_t argc)
 {
 	build("MSET", NULL, keys, keys_len, values, values_len, argc);
+	split_keys(2);
 	return check_status();
 }
 
@@ -668,6 +674,7 @@ bool redis_string::mget(const std::vector<string>& keys,
 	std::vector<string>* out /* = NULL */)
 {
 	build("MGET", NULL, keys);
+	split_keys(1);
 	return get_strings(out) >= 0 ? true : false;
 }
 
@@ -675,6 +682,23 @@ bool redis_string::mget(const std::vector<const char*>& keys,
 	std::vector<string>* out /* = NULL */)
 {
 	build("MGET", NULL, keys);
+	split_keys(1);
+	return get_strings(out) >= 0 ? true : false;
+}
+
+bool redis_string::mget(const std::vector<string>& keys,
+	std::vector<string_view>& out)
+{
+	build("MGET", NULL, keys);
+	split_keys(1);
+	return get_strings(out) >= 0 ? true : false;
+}
+
+bool redis_string::mget(const std::vector<const char*>& keys,
+	std::vector<string_view>& out)
+{
+	build("MGET", NULL, keys);
+	split_keys(1);
 	return get_strings(out) >= 0 ? true : false;
 }
 
@@ -691,6 +715,7 @@ bool redis_string::mget(std::vector<string>* out, const char* first_key, ...)
 	va_end(ap);
 
 	build("MGET", NULL, keys);
+	split_keys(1);
 	return get_strings(out) >= 0 ? true : false;
 }
 
@@ -698,6 +723,7 @@ bool redis_string::mget(const char* keys[], size_t argc,
 	std::vector<string>* out /* = NULL */)
 {
 	build("MGET", NULL, keys, argc);
+	split_keys(1);
 	return get_strings(out) >= 0 ? true : false;
 }
 
@@ -705,6 +731,7 @@ bool redis_string::mget(const char* keys[], const size_t keys_len[],
 	size_t argc, std::vector<string>* out /* = NULL */)
 {
 	build("MGET", NULL, keys, keys_len, argc);
+	split_keys(1);
 	return get_strings(out) >= 0 ? true : false;
 }
 
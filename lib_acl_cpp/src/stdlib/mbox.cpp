@@ -10,7 +10,7 @@ namespace acl
 
 static void free_callback(void *ctx)
 {
-	mbox* o = (mbox*) ctx;
+	mobj* o = (mobj*) ctx;
 	delete o;
 }
 
@@ -23,11 +23,24 @@
 
 namespace acl {
 
+#ifdef	ACL_CPP_STRING_SSO
+// ֤ǶĿռ ACL_VSTRING ṹ
+typedef char vbf_obj_size_check[sizeof(ACL_VSTRING) <= 128 ? 1 : -1];
+#endif
+
 void string::init(size_t len)
 {
 	if (len < 1)
 		len = 1;
+#ifdef	ACL_CPP_STRING_SSO
+	vbf_ = (ACL_VSTRING*) vbf_obj_.data_;
+	if (len <= (size_t) SSO_SIZE)
+		acl_vstring_embed(vbf_, sso_buf_, SSO_SIZE);
+	else
+		acl_vstring_init(vbf_, len);
+#else
 	vbf_ = ALLOC(len);
+#endif
 	list_tmp_ = NULL;
 	vector_tmp_ = NULL;
 	pair_tmp_ = NULL;
@@ -36,6 +49,19 @@ void string::init(size_t len)
 	line_state_offset_ = 0;
 }
 
+void string::reset_vbf(ACL_VSTRING* vbf)
+{
+#ifdef	ACL_CPP_STRING_SSO
+	// ӹ vbf Ļͷṹ acl_vstring_alloc ȷ䣩
+	acl_vstring_free_buf(vbf_);
+	memcpy(vbf_, vbf, sizeof(ACL_VSTRING));
+	acl_myfree(vbf);
+#else
+	FREE(vbf_);
+	vbf_ = vbf;
+#endif
+}
+
 string::string(void) : use_bin_(false)
 {
 	init(64);
@@ -84,10 +110,58 @@ string::string(const void* s, size_t n) : use_bin_(false)
 	TERM(vbf_);
 }
 
+#ifdef	ACL_USE_CPP11
+string::string(string&& s) : use_bin_(s.use_bin_)
+{
+#ifdef	ACL_CPP_STRING_SSO
+	// ַǶַӹϵĻԴָʹ
+	// Ƕڴ
+	vbf_ = (ACL_VSTRING*) vbf_obj_.data_;
+	if (s.vbf_->vbuf.flags & ACL_VBUF_FLAG_EMBED)
+	{
+		acl_vstring_embed(vbf_, sso_buf_, SSO_SIZE);
+		MCP(vbf_, STR(s.vbf_), LEN(s.vbf_));
+		TERM(vbf_);
+		RSET(s.vbf_);
+		TERM(s.vbf_);
+	}
+	else
+	{
+		memcpy(vbf_, s.vbf_, sizeof(ACL_VSTRING));
+		acl_vstring_embed(s.vbf_, s.sso_buf_, SSO_SIZE);
+	}
+	scan_ptr_ = NULL;
+#else
+	// ֱӽӹԴĻԴһµĿջԱ֤ƶ
+	// ΪõĿմ
+	vbf_ = s.vbf_;
+	scan_ptr_ = s.scan_ptr_;
+	s.vbf_ = ALLOC(1);
+	TERM(s.vbf_);
+#endif
+	s.scan_ptr_ = NULL;
+
+	list_tmp_ = NULL;
+	vector_tmp_ = NULL;
+	pair_tmp_ = NULL;
+	line_state_ = s.line_state_;
+	line_state_offset_ = s.line_state_offset_;
+	s.line_state_ = NULL;
+	s.line_state_offset_ = 0;
+}
+#endif
+
 string::string(ACL_FILE_HANDLE fd, size_t max, size_t n)
 {
 	if (n < 1)
 		n = 1;
+#ifdef	ACL_CPP_STRING_SSO
+	init(1);
+	if (fd >= 0)
+		reset_vbf(acl_vstring_mmap_alloc(fd, (ssize_t) max, (ssize_t) n));
+	else
+		space(n);
+#else
 	if (fd >= 0)
 		vbf_ = acl_vstring_mmap_alloc(fd, (ssize_t) max, (ssize_t) n);
 	else
@@ -98,11 +172,16 @@ string::string(ACL_FILE_HANDLE fd, size_t max, size_t n)
 	scan_ptr_ = NULL;
 	line_state_ = NULL;
 	line_state_offset_ = 0;
+#endif
 }
 
 string::~string()
 {
+#ifdef	ACL_CPP_STRING_SSO
+	acl_vstring_free_buf(vbf_);
+#else
 	FREE(vbf_);
+#endif
 	delete list_tmp_;
 	delete vector_tmp_;
 	delete pair_tmp_;
@@ -234,6 +313,39 @@ string& string::operator =(const string* s)
 	return *this;
 }
 
+#ifdef	ACL_USE_CPP11
+string& string::operator =(string&& s)
+{
+	if (this == &s)
+		return *this;
+
+#ifdef	ACL_CPP_STRING_SSO
+	// vbf_ ָǶĽṹֱַӸƣַӹ
+	// ĻͬʱԴָʹǶ
+	if (s.vbf_->vbuf.flags & ACL_VBUF_FLAG_EMBED)
+	{
+		MCP(vbf_, STR(s.vbf_), LEN(s.vbf_));
+		TERM(vbf_);
+		RSET(s.vbf_);
+		TERM(s.vbf_);
+	}
+	else
+	{
+		acl_vstring_free_buf(vbf_);
+		memcpy(vbf_, s.vbf_, sizeof(ACL_VSTRING));
+		acl_vstring_embed(s.vbf_, s.sso_buf_, SSO_SIZE);
+	}
+#else
+	std::swap(vbf_, s.vbf_);
+	RSET(s.vbf_);
+	TERM(s.vbf_);
+#endif
+	scan_ptr_ = NULL;
+	s.scan_ptr_ = NULL;
+	return *this;
+}
+#endif
+
 string& string::operator =(acl_int64 n)
 {
 	if (use_bin_)
@@ -765,7 +877,7 @@ bool string::operator <(const string& s) const
 {
 	size_t nLeft = LEN(vbf_);
 	size_t nRight = LEN(s.vbf_);
-	size_t n = nLeft > nRight ? nLeft : nRight;
+	size_t n = nLeft < nRight ? nLeft : nRight;
 	int   ret = memcmp(STR(vbf_), STR(s.vbf_), n);
 	if (ret < 0)
 		return true;
@@ -780,7 +892,7 @@ bool string::operator >(const string& s) const
 {
 	size_t nLeft = LEN(vbf_);
 	size_t nRight = LEN(s.vbf_);
-	size_t n = nLeft > nRight ? nLeft : nRight;
+	size_t n = nLeft < nRight ? nLeft : nRight;
 	int   ret = memcmp(STR(vbf_), STR(s.vbf_), n);
 	if (ret > 0)
 		return true;
@@ -1304,8 +1416,7 @@ string& string::strip(const char* needle, bool each /* false */)
 		// ҪʱΪʽͷԴ
 		if (pVbf != NULL)
 		{
-			FREE(vbf_);
-			vbf_ = pVbf;
+			reset_vbf(pVbf);
 		}
 
 		return *this;
@@ -1338,8 +1449,7 @@ string& string::strip(const char* needle, bool each /* false */)
 
 	if (pVbf != NULL)
 	{
-		FREE(vbf_);
-		vbf_ = pVbf;
+		reset_vbf(pVbf);
 	}
 	return *this;
 }
@@ -1503,8 +1613,7 @@ string& string::base64_encode(void)
 	size_t n = (dlen * 4) / 3;
 	ACL_VSTRING *s = ALLOC(n) ;
 	acl_vstring_base64_encode(s, c_str(), (int) dlen);
-	FREE(vbf_);
-	vbf_ = s;
+	reset_vbf(s);
 	return *this;
 }
 
@@ -1526,8 +1635,7 @@ string& string::base64_decode(void)
 	ACL_VSTRING *s = ALLOC(n) ;
 	if (acl_vstring_base64_decode(s, c_str(), (int) dlen) == NULL)
 		RSET(s);
-	FREE(vbf_);
-	vbf_ = s;
+	reset_vbf(s);
 	TERM(vbf_);
 	return *this;
 }
@@ -1695,4 +1803,42 @@ string& string::parse_int64(acl_uint64 n)
 	return s;
 }
 
+string operator+(const string& l, const string& r)
+{
+	string s(l.length() + r.length() + 1);
+	s.append(l).append(r);
+	return s;
+}
+
+string operator+(const string& l, const char* r)
+{
+	size_t n = r ? strlen(r) : 0;
+	string s(l.length() + n + 1);
+	s.append(l).append(r, n);
+	return s;
+}
+
+string operator+(const char* l, const string& r)
+{
+	size_t n = l ? strlen(l) : 0;
+	string s(n + r.length() + 1);
+	s.append(l, n).append(r);
+	return s;
+}
+
+#ifdef	ACL_USE_CPP11
+string operator+(string&& l, const string& r)
+{
+	l.append(r);
+	return std::move(l);
+}
+
+string operator+(string&& l, const char* r)
+{
+	if (r)
+		l.append(r);
+	return std::move(l);
+}
+#endif
+
 } // namespace acl
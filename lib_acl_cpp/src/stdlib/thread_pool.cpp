@@ -12,8 +12,11 @@ thread_pool::thread_pool()
 : stack_size_(0)
 , threads_limit_(100)
 , thread_idle_(0)
+, lockfree_(false)
+, shed_wait_(0)
 , thr_pool_(NULL)
 {
+	memset(stats_, 0, sizeof(stats_));
 	thr_attr_ = (acl_pthread_pool_attr_t*)
 		acl_mycalloc(1, sizeof(acl_pthread_pool_attr_t));
 }
@@ -44,6 +47,18 @@ thread_pool& thread_pool::set_idle(int ttl)
 	return *this;
 }
 
+thread_pool& thread_pool::set_lockfree(bool yes)
+{
+	lockfree_ = yes;
+	return *this;
+}
+
+thread_pool& thread_pool::set_shed_wait(int ms)
+{
+	shed_wait_ = ms > 0 ? ms : 0;
+	return *this;
+}
+
 void thread_pool::start()
 {
 	if (thr_pool_)
@@ -52,6 +67,7 @@ void thread_pool::start()
 	acl_pthread_pool_attr_set_stacksize(thr_attr_, stack_size_);
 	acl_pthread_pool_attr_set_threads_limit(thr_attr_, (int) threads_limit_);
 	acl_pthread_pool_attr_set_idle_timeout(thr_attr_, thread_idle_);
+	acl_pthread_pool_attr_set_lockfree(thr_attr_, lockfree_ ? 1 : 0);
 
 	thr_pool_ = acl_pthread_pool_create(thr_attr_);
 	acl_pthread_pool_atinit(thr_pool_, thread_init, this);
@@ -98,6 +114,135 @@ bool thread_pool::execute(thread_job* job)
 	return run(job);
 }
 
+static long long now_ms(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (long long) tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+bool thread_pool::overloaded(long long now) const
+{
+	// ȼеĶ׼ȼŶõ
+	for (int i = 0; i < PRIO_MAX; i++)
+	{
+		if (!queues_[i].empty()
+			&& now - queues_[i].front().stamp > shed_wait_)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool thread_pool::run(thread_job* job, int prio, int timeout /* = 0 */)
+{
+	if (job == NULL)
+	{
+		logger_error("job null!");
+		return false;
+	}
+
+	if (thr_pool_ == NULL)
+	{
+		logger_error("start() not called yet!");
+		return false;
+	}
+
+	if (prio < PRIO_HIGH)
+		prio = PRIO_HIGH;
+	else if (prio >= PRIO_MAX)
+		prio = PRIO_LOW;
+
+	sched_job sj;
+	sj.job      = job;
+	sj.stamp    = now_ms();
+	sj.deadline = timeout > 0 ? sj.stamp + timeout : 0;
+
+	lock_.lock();
+	if (shed_wait_ > 0 && prio != PRIO_HIGH && overloaded(sj.stamp))
+	{
+		stats_[prio].nreject++;
+		lock_.unlock();
+		return false;
+	}
+	queues_[prio].push_back(sj);
+	lock_.unlock();
+
+	// ÿӦ̳߳еһεȣɱȵ߳ѡȡȼߵ
+	acl_pthread_pool_add(thr_pool_, thread_sched, this);
+	return true;
+}
+
+bool thread_pool::get_stat(int prio, thread_pool_stat& out)
+{
+	if (prio < PRIO_HIGH || prio >= PRIO_MAX)
+		return false;
+
+	lock_.lock();
+	out = stats_[prio];
+	lock_.unlock();
+	return true;
+}
+
+void thread_pool::sched_one()
+{
+	int prio, reason = -1;
+
+	lock_.lock();
+
+	for (prio = PRIO_HIGH; prio < PRIO_MAX; prio++)
+	{
+		if (!queues_[prio].empty())
+			break;
+	}
+
+	if (prio == PRIO_MAX)
+	{
+		lock_.unlock();
+		logger_error("no job in queues!");
+		return;
+	}
+
+	sched_job sj = queues_[prio].front();
+	queues_[prio].pop_front();
+
+	long long now = now_ms(), wait = now - sj.stamp;
+	thread_pool_stat& stat = stats_[prio];
+
+	if (sj.deadline > 0 && now > sj.deadline)
+	{
+		stat.nexpired++;
+		reason = DROP_EXPIRED;
+	}
+	else if (shed_wait_ > 0 && prio != PRIO_HIGH && wait > shed_wait_)
+	{
+		stat.nshed++;
+		reason = DROP_SHED;
+	}
+	else
+	{
+		stat.njobs++;
+		stat.wait_total += wait;
+		if (wait > stat.wait_max)
+			stat.wait_max = wait;
+	}
+
+	lock_.unlock();
+
+	if (reason >= 0)
+		job_on_drop(sj.job, reason);
+	else
+		sj.job->run();
+}
+
+void thread_pool::thread_sched(void* arg)
+{
+	thread_pool* threads = (thread_pool*) arg;
+	threads->sched_one();
+}
+
 int  thread_pool::threads_count() const
 {
 	if (thr_pool_ == NULL)
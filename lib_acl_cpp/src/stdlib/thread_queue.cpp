@@ -3,14 +3,26 @@
 #include "acl_cpp/stdlib/thread_queue.hpp"
 #endif
 
+#ifndef	ACL_WINDOWS
+#include <sched.h>
+#endif
+
 namespace acl
 {
 
 thread_queue::thread_queue()
+: ring_(NULL)
 {
 	queue_ = (ACL_AQUEUE*) acl_aqueue_new();
 }
 
+thread_queue::thread_queue(size_t size, bool mpsc /* = true */)
+: queue_(NULL)
+{
+	ring_ = acl_lfqueue_create((unsigned) size, mpsc ?
+		ACL_LFQUEUE_F_MPSC : ACL_LFQUEUE_F_SPSC);
+}
+
 static void free_qitem(void* item)
 {
 	thread_qitem* qitem = (thread_qitem *) item;
@@ -19,25 +31,95 @@ static void free_qitem(void* item)
 
 thread_queue::~thread_queue()
 {
-	acl_aqueue_free(queue_, free_qitem);
+	if (queue_)
+		acl_aqueue_free(queue_, free_qitem);
+	else
+		acl_lfqueue_free(ring_, free_qitem);
+}
+
+// ζʱȴȡԪأó CPUʧܺ
+static void ring_backoff(int& ntries)
+{
+	if (++ntries < 1000)
+	{
+#ifdef	ACL_WINDOWS
+		Sleep(0);
+#else
+		sched_yield();
+#endif
+	}
+	else
+		acl_doze(1);
 }
 
 bool thread_queue::push(thread_qitem* item)
 {
-	return acl_aqueue_push(queue_, item) == -1 ? false : true;
+	if (queue_)
+		return acl_aqueue_push(queue_, item) == -1 ? false : true;
+
+	int ntries = 0;
+	while (acl_lfqueue_push(ring_, item) == -1)
+		ring_backoff(ntries);
+	return true;
+}
+
+bool thread_queue::push_batch(thread_qitem** items, size_t n)
+{
+	if (queue_)
+		return acl_aqueue_push_batch(queue_, (void**) items,
+			(int) n) == -1 ? false : true;
+
+	size_t i = 0;
+	int ntries = 0;
+	while (true)
+	{
+		i += acl_lfqueue_push_batch(ring_, (void**) items + i,
+			(int) (n - i));
+		if (i >= n)
+			break;
+		ring_backoff(ntries);
+	}
+	return true;
 }
 
 thread_qitem* thread_queue::pop(int wait_ms /* = -1 */)
 {
+	if (ring_)
+		return (thread_qitem*) acl_lfqueue_pop(ring_, wait_ms);
+
 	int wait_sec = wait_ms / 1000;
 	int wait_usec = (wait_ms % 1000) * 1000;
 	return (thread_qitem*) acl_aqueue_pop_timedwait(
 				queue_, wait_sec, wait_usec);
 }
 
+size_t thread_queue::pop_batch(thread_qitem** items, size_t max,
+	int wait_ms /* = -1 */)
+{
+	int n;
+
+	if (ring_)
+		n = acl_lfqueue_pop_batch(ring_, (void**) items,
+			(int) max, wait_ms);
+	else
+		n = acl_aqueue_pop_batch(queue_, (void**) items, (int) max,
+			wait_ms / 1000, (wait_ms % 1000) * 1000);
+	return n > 0 ? (size_t) n : 0;
+}
+
+void thread_queue::set_spin(int nspin)
+{
+	if (queue_)
+		acl_aqueue_set_spin(queue_, nspin);
+	else
+		acl_lfqueue_set_spin(ring_, nspin);
+}
+
 int thread_queue::qlen() const
 {
-	return acl_aqueue_qlen(queue_);
+	if (queue_)
+		return acl_aqueue_qlen(queue_);
+	return acl_lfqueue_qlen(ring_);
 }
 
 } // namespace acl
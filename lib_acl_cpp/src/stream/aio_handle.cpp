@@ -1,10 +1,12 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
 #include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
 #include "acl_cpp/stream/aio_timer_callback.hpp"
 #include "acl_cpp/stream/aio_handle.hpp"
 #endif
 #include "aio_timer_delay_free.hpp"
+#include "aio_post_channel.hpp"
 
 namespace acl
 {
@@ -14,6 +16,9 @@ aio_handle::aio_handle(aio_handle_type engine_type /* = ENGINE_SELECT */,
 : stop_(false)
 , nstream_(0)
 , engine_type_(engine_type)
+, post_channel_(NULL)
+, post_lock_(NEW locker)
+, post_enabled_(false)
 {
 	int   event_type;
 
@@ -48,6 +53,9 @@ aio_handle::aio_handle(ACL_AIO* aio)
 	: aio_(aio)
 	, stop_(false)
 	, nstream_(0)
+	, post_channel_(NULL)
+	, post_lock_(NEW locker)
+	, post_enabled_(false)
 {
 	acl_assert(aio_);
 	int event_type = acl_aio_event_mode(aio);
@@ -74,6 +82,10 @@ aio_handle::aio_handle(ACL_AIO* aio)
 
 aio_handle::~aio_handle()
 {
+	// ֪ͨͨ¼ͷǰر
+	delete post_channel_;
+	delete post_lock_;
+
 	if (inner_alloc_)
 		acl_aio_free(aio_);
 
@@ -172,6 +184,56 @@ void aio_handle::delay_free(aio_delay_free* callback)
 		set_timer(delay_free_timer_, 100000, 0);
 }
 
+aio_post_channel* aio_handle::get_post_channel()
+{
+	post_lock_->lock();
+	if (post_channel_ == NULL)
+	{
+		// ֪ͨ¼¼߳ע
+		aio_post_channel* channel = NEW aio_post_channel(*this);
+		if (channel->open())
+			post_channel_ = channel;
+		else
+			delete channel;
+	}
+	aio_post_channel* channel = post_channel_;
+	post_lock_->unlock();
+	return channel;
+}
+
+void aio_handle::enable_post_channel()
+{
+	if (post_enabled_)
+		return;
+
+	post_lock_->lock();
+	aio_post_channel* channel = post_channel_;
+	post_lock_->unlock();
+
+	if (channel != NULL)
+	{
+		channel->enable();
+		post_enabled_ = true;
+	}
+}
+
+bool aio_handle::open_post_channel()
+{
+	if (get_post_channel() == NULL)
+		return false;
+	enable_post_channel();
+	return true;
+}
+
+bool aio_handle::post(aio_post_callback* callback)
+{
+	acl_assert(callback);
+	aio_post_channel* channel = get_post_channel();
+	if (channel == NULL)
+		return false;
+	return channel->post(callback);
+}
+
 void aio_handle::destroy_timer(aio_timer_callback* callback)
 {
 	delay_free_timer_->del(callback);
@@ -219,6 +281,8 @@ void aio_handle::set_rbuf_size(int n)
 
 bool aio_handle::check()
 {
+	// ֻ֪ͨ¼߳ע
+	enable_post_channel();
 	acl_aio_loop(aio_);
 	if (stop_)
 		return false;
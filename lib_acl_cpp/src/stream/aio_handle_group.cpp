@@ -0,0 +1,290 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stdlib/locker.hpp"
+#include "acl_cpp/stdlib/thread.hpp"
+#include "acl_cpp/stream/aio_listen_stream.hpp"
+#include "acl_cpp/stream/aio_socket_stream.hpp"
+#include "acl_cpp/stream/aio_handle_group.hpp"
+#endif
+
+namespace acl
+{
+
+// ڵ¼棬ͨ첽Ļصάĸ
+class aio_group_handle : public aio_handle
+{
+public:
+	aio_group_handle(aio_handle_type engine_type)
+	: aio_handle(engine_type), load_(0) {}
+	~aio_group_handle() {}
+
+	int load()
+	{
+		lock_.lock();
+		int n = load_;
+		lock_.unlock();
+		return n;
+	}
+
+	void add_load(int n)
+	{
+		lock_.lock();
+		load_ += n;
+		lock_.unlock();
+	}
+
+protected:
+	void on_increase()
+	{
+		add_load(1);
+	}
+
+	void on_decrease()
+	{
+		add_load(-1);
+	}
+
+private:
+	locker lock_;
+	int load_;
+};
+
+// һ¼߳
+class aio_group_loop : public thread
+{
+public:
+	aio_group_loop(aio_handle_type engine_type) : handle_(engine_type)
+	{
+		set_detachable(false);
+	}
+	~aio_group_loop() {}
+
+	aio_group_handle& get_handle()
+	{
+		return handle_;
+	}
+
+protected:
+	void* run()
+	{
+		// Ԥע֪ͨʹ׸ַܱ
+		if (handle_.open_post_channel() == false)
+			logger_error("open post channel failed");
+
+		while (handle_.check()) {}
+
+		// ټһͷ˳ǰرյ첽
+		handle_.check();
+		return NULL;
+	}
+
+private:
+	aio_group_handle handle_;
+};
+
+// ¼߳˳־
+class aio_stop_task : public aio_post_callback
+{
+public:
+	aio_stop_task(aio_handle& handle) : handle_(handle) {}
+	~aio_stop_task() {}
+
+	void post_callback()
+	{
+		handle_.stop();
+		delete this;
+	}
+
+	void post_cancel()
+	{
+		delete this;
+	}
+
+private:
+	aio_handle& handle_;
+};
+
+// Ŀ¼߳ΪӴ첽صչ
+class aio_accept_task : public aio_post_callback
+{
+public:
+	aio_accept_task(aio_group_handle& handle, ACL_VSTREAM* client)
+	: handle_(handle), client_(client) {}
+	~aio_accept_task() {}
+
+	std::vector<aio_accept_callback*> callbacks_;
+
+	void post_callback()
+	{
+		// ַתΪ첽
+		handle_.add_load(-1);
+
+		ACL_ASTREAM* as = acl_aio_open(handle_.get_handle(), client_);
+		aio_socket_stream* ss = NEW aio_socket_stream(&handle_, as, true);
+
+		std::vector<aio_accept_callback*>::iterator it =
+			callbacks_.begin();
+		for (; it != callbacks_.end(); ++it)
+		{
+			if ((*it)->accept_callback(ss) == false)
+			{
+				ss->close();
+				break;
+			}
+		}
+		delete this;
+	}
+
+	void post_cancel()
+	{
+		cancel();
+	}
+
+	void cancel()
+	{
+		handle_.add_load(-1);
+		acl_vstream_close(client_);
+		delete this;
+	}
+
+private:
+	aio_group_handle& handle_;
+	ACL_VSTREAM* client_;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+aio_handle_group::aio_handle_group(size_t nloops,
+	aio_handle_type engine_type /* = ENGINE_KERNEL */)
+: dispatch_type_(AIO_DISPATCH_ROUND_ROBIN)
+, next_(0)
+, nstarted_(0)
+{
+	acl_assert(nloops > 0);
+
+	for (size_t i = 0; i < nloops; i++)
+		loops_.push_back(NEW aio_group_loop(engine_type));
+}
+
+aio_handle_group::~aio_handle_group()
+{
+	stop();
+
+	std::vector<aio_group_loop*>::iterator it = loops_.begin();
+	for (; it != loops_.end(); ++it)
+		delete *it;
+}
+
+aio_handle_group& aio_handle_group::set_dispatch(aio_dispatch_type type)
+{
+	dispatch_type_ = type;
+	return *this;
+}
+
+bool aio_handle_group::start()
+{
+	if (nstarted_ > 0)
+		return true;
+
+	for (; nstarted_ < loops_.size(); nstarted_++)
+	{
+		if (loops_[nstarted_]->start() == false)
+		{
+			logger_error("start aio loop thread failed");
+			// ߳
+			stop();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void aio_handle_group::stop()
+{
+	for (size_t i = 0; i < nstarted_; i++)
+	{
+		aio_handle& handle = loops_[i]->get_handle();
+		handle.post(NEW aio_stop_task(handle));
+	}
+
+	for (size_t i = 0; i < nstarted_; i++)
+		loops_[i]->wait();
+
+	nstarted_ = 0;
+}
+
+size_t aio_handle_group::size() const
+{
+	return loops_.size();
+}
+
+aio_handle& aio_handle_group::get(size_t i) const
+{
+	acl_assert(i < loops_.size());
+	return loops_[i]->get_handle();
+}
+
+int aio_handle_group::load(size_t i) const
+{
+	acl_assert(i < loops_.size());
+	return loops_[i]->get_handle().load();
+}
+
+aio_handle& aio_handle_group::peek()
+{
+	size_t n = loops_.size();
+
+	if (dispatch_type_ == AIO_DISPATCH_LEAST_LOAD)
+	{
+		// ѭλÿʼңʹͬ¼汻ѡ
+		size_t start = next_++ % n, min_i = start;
+		int    min_load = loops_[start]->get_handle().load();
+
+		for (size_t i = 1; i < n && min_load > 0; i++)
+		{
+			size_t j = (start + i) % n;
+			int    load = loops_[j]->get_handle().load();
+			if (load < min_load)
+			{
+				min_load = load;
+				min_i    = j;
+			}
+		}
+		return loops_[min_i]->get_handle();
+	}
+
+	return loops_[next_++ % n]->get_handle();
+}
+
+bool aio_handle_group::dispatch(ACL_VSTREAM* client,
+	aio_accept_callback* callback)
+{
+	acl_assert(callback);
+	std::list<aio_accept_callback*> callbacks;
+	callbacks.push_back(callback);
+	return dispatch(client, callbacks);
+}
+
+bool aio_handle_group::dispatch(ACL_VSTREAM* client,
+	const std::list<aio_accept_callback*>& callbacks)
+{
+	aio_group_handle& handle = static_cast<aio_group_handle&>(peek());
+	aio_accept_task* task = NEW aio_accept_task(handle, client);
+
+	task->callbacks_.assign(callbacks.begin(), callbacks.end());
+
+	// ַʹСطַܼʱ֪ͻ
+	handle.add_load(1);
+
+	if (handle.post(task) == false)
+	{
+		logger_error("post to aio loop failed, close client");
+		task->cancel();
+		return false;
+	}
+	return true;
+}
+
+} // namespace acl
@@ -1,9 +1,11 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
 #include "acl_cpp/stdlib/snprintf.hpp"
 #include "acl_cpp/stream/aio_handle.hpp"
 #include "acl_cpp/stream/aio_socket_stream.hpp"
 #include "acl_cpp/stream/aio_listen_stream.hpp"
+#include "acl_cpp/stream/aio_handle_group.hpp"
 #endif
 
 namespace acl
@@ -12,6 +14,7 @@ namespace acl
 aio_listen_stream::aio_listen_stream(aio_handle *handle)
 	: aio_stream(handle)
 	, accept_hooked_(false)
+	, group_(NULL)
 {
 	addr_[0] = 0;
 }
@@ -38,6 +41,11 @@ void aio_listen_stream::add_accept_callback(aio_accept_callback* callback)
 	accept_callbacks_.push_back(callback);
 }
 
+void aio_listen_stream::set_group(aio_handle_group* group)
+{
+	group_ = group;
+}
+
 bool aio_listen_stream::open(const char* addr)
 {
 	ACL_VSTREAM *sstream = acl_vstream_listen(addr, 128);
@@ -69,6 +77,18 @@ void aio_listen_stream::hook_accept()
 		return;
 	accept_hooked_ = true;
 
+	if (group_ != NULL)
+	{
+		// ɱ acceptٽӷַ¼
+		acl_aio_ctl(stream_,
+			ACL_AIO_CTL_LISTEN_FN, listen_callback,
+			ACL_AIO_CTL_CTX, this,
+			ACL_AIO_CTL_END);
+		acl_aio_set_accept_nloop(stream_, 64);
+		acl_aio_listen(stream_);
+		return;
+	}
+
 	acl_aio_ctl(stream_,
 		ACL_AIO_CTL_ACCEPT_FN, accept_callback,
 		ACL_AIO_CTL_CTX, this,
@@ -92,4 +112,21 @@ int aio_listen_stream::accept_callback(ACL_ASTREAM* stream, void* ctx)
 	return 0;
 }
 
+int aio_listen_stream::listen_callback(ACL_ASTREAM* stream, void* ctx)
+{
+	aio_listen_stream* as = (aio_listen_stream*) ctx;
+	ACL_VSTREAM* client = acl_vstream_accept(acl_aio_vstream(stream),
+			NULL, 0);
+	if (client == NULL)
+	{
+		int ret = acl_last_error();
+		if (ret != ACL_EAGAIN && ret != ACL_ECONNABORTED)
+			logger_error("accept error %s", last_serror());
+		return -1;
+	}
+
+	as->group_->dispatch(client, as->accept_callbacks_);
+	return 0;
+}
+
 }  // namespace acl
@@ -225,6 +225,42 @@ void aio_ostream::disable_write()
 	acl_aio_disable_write(stream_);
 }
 
+void aio_ostream::set_cork(bool on, int limit /* = 65536 */)
+{
+	acl_assert(stream_);
+	acl_aio_set_cork(stream_, on ? (limit > 0 ? limit : 65536) : 0);
+}
+
+bool aio_ostream::get_cork() const
+{
+	acl_assert(stream_);
+	return acl_aio_get_cork(stream_) > 0;
+}
+
+void aio_ostream::set_water(int low, int high)
+{
+	acl_assert(stream_);
+	acl_aio_set_water(stream_, low, high, write_water, this);
+}
+
+void aio_ostream::set_write_limit(int limit)
+{
+	acl_assert(stream_);
+	acl_aio_set_write_limit(stream_, limit);
+}
+
+int aio_ostream::get_write_left() const
+{
+	acl_assert(stream_);
+	return acl_aio_write_left(stream_);
+}
+
+int aio_ostream::get_write_peak() const
+{
+	acl_assert(stream_);
+	return acl_aio_write_peak(stream_);
+}
+
 void aio_ostream::write(const void* data, int len,
 	acl_int64 delay /* = 0 */,
 	aio_timer_writer* callback /* = NULL */)
@@ -306,4 +342,20 @@ int aio_ostream::write_wakup(ACL_ASTREAM* stream acl_unused, void* ctx)
 	return 0;
 }
 
+int aio_ostream::write_water(ACL_ASTREAM* stream acl_unused, void* ctx,
+	int high)
+{
+	aio_ostream* out = (aio_ostream*) ctx;
+	std::list<AIO_CALLBACK*>::iterator it = out->write_callbacks_.begin();
+	for (; it != out->write_callbacks_.end(); ++it)
+	{
+		if ((*it)->enable == false || (*it)->callback == NULL)
+			continue;
+
+		if ((*it)->callback->write_water_callback(high != 0) == false)
+			return -1;
+	}
+	return 0;
+}
+
 }  // namespace acl
@@ -0,0 +1,172 @@
+#include "acl_stdafx.hpp"
+#ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/log.hpp"
+#include "acl_cpp/stream/aio_handle.hpp"
+#endif
+#include "aio_post_channel.hpp"
+
+#if defined(ACL_LINUX) && !defined(MINGW)
+# include <sys/eventfd.h>
+# define HAS_EVENTFD
+#endif
+
+namespace acl
+{
+
+aio_post_channel::aio_post_channel(aio_handle& handle)
+: handle_(handle)
+, in_(NULL)
+, out_(ACL_SOCKET_INVALID)
+, signaled_(false)
+, enabled_(false)
+{
+}
+
+aio_post_channel::~aio_post_channel()
+{
+	// رʱ¼עĹرջص¼ɾȵ
+	// acl_event_disable_readwrite¼ѭδС¼Դ
+	// ӳע״̬ʱ epoll_ctl DEL ʧܶ˳
+	if (in_ != NULL)
+	{
+		if (out_ != ACL_SOCKET_INVALID
+			&& out_ != ACL_VSTREAM_SOCK(in_))
+		{
+			acl_socket_close(out_);
+		}
+		acl_vstream_close(in_);
+	}
+
+	// ֪ͨδִеͷ
+	cancel(ready_);
+	cancel(queue_);
+}
+
+void aio_post_channel::cancel(std::vector<aio_post_callback*>& callbacks)
+{
+	std::vector<aio_post_callback*>::iterator it = callbacks.begin();
+	for (; it != callbacks.end(); ++it)
+		(*it)->post_cancel();
+	callbacks.clear();
+}
+
+bool aio_post_channel::open()
+{
+	ACL_SOCKET fd;
+
+#ifdef HAS_EVENTFD
+	int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (efd < 0)
+	{
+		logger_error("eventfd error %s", last_serror());
+		return false;
+	}
+	fd   = efd;
+	out_ = efd;
+#else
+	ACL_SOCKET fds[2];
+	if (acl_sane_socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+	{
+		logger_error("socketpair error %s", last_serror());
+		return false;
+	}
+	acl_non_blocking(fds[0], ACL_NON_BLOCKING);
+	acl_non_blocking(fds[1], ACL_NON_BLOCKING);
+# ifndef ACL_WINDOWS
+	acl_close_on_exec(fds[0], ACL_CLOSE_ON_EXEC);
+	acl_close_on_exec(fds[1], ACL_CLOSE_ON_EXEC);
+# endif
+	fd   = fds[0];
+	out_ = fds[1];
+#endif
+
+	in_ = acl_vstream_fdopen(fd, O_RDWR, 64, 0, ACL_VSTREAM_TYPE_SOCK);
+	return true;
+}
+
+void aio_post_channel::enable()
+{
+	// ¼̰߳ȫʽ¼߳ע¼ǰ
+	// Ͷݣ֪ͨѴڿɶ״̬ע󼴻ᱻ
+	if (enabled_)
+		return;
+	acl_event_enable_read(acl_aio_event(handle_.get_handle()), in_, 0,
+		read_callback, this);
+	enabled_ = true;
+}
+
+bool aio_post_channel::post(aio_post_callback* callback)
+{
+	bool need_wakeup;
+
+	lock_.lock();
+	queue_.push_back(callback);
+	// ¼δ֪ͨʱд֪ͨԼϵͳô
+	need_wakeup = !signaled_;
+	signaled_ = true;
+	lock_.unlock();
+
+	if (need_wakeup)
+		wakeup();
+	return true;
+}
+
+void aio_post_channel::wakeup()
+{
+#ifdef HAS_EVENTFD
+	eventfd_t n = 1;
+	if (eventfd_write(out_, n) < 0 && errno != EAGAIN)
+		logger_error("eventfd_write error %s", last_serror());
+#else
+	char ch = 0;
+	if (acl_socket_write(out_, &ch, 1, 0, NULL, NULL) < 0
+		&& acl_last_error() != ACL_EAGAIN)
+	{
+		logger_error("write to socketpair error %s", last_serror());
+	}
+#endif
+}
+
+void aio_post_channel::drain()
+{
+#ifdef HAS_EVENTFD
+	eventfd_t n;
+	(void) eventfd_read(ACL_VSTREAM_SOCK(in_), &n);
+#else
+	char buf[256];
+	while (acl_socket_read(ACL_VSTREAM_SOCK(in_), buf, sizeof(buf),
+		0, NULL, NULL) == (int) sizeof(buf)) {}
+#endif
+}
+
+void aio_post_channel::run()
+{
+	// ȶ֪ͨȡ񣬱֤Ͷݵһٴλ¼
+	drain();
+
+	lock_.lock();
+	ready_.swap(queue_);
+	signaled_ = false;
+	lock_.unlock();
+
+	std::vector<aio_post_callback*>::iterator it = ready_.begin();
+	for (; it != ready_.end(); ++it)
+		(*it)->post_callback();
+	ready_.clear();
+}
+
+void aio_post_channel::read_callback(int event_type, ACL_EVENT*,
+	ACL_VSTREAM*, void* ctx)
+{
+	aio_post_channel* channel = (aio_post_channel*) ctx;
+
+	if ((event_type & ACL_EVENT_READ) == 0)
+	{
+		logger_error("unexpected event type: %d", event_type);
+		return;
+	}
+
+	channel->run();
+}
+
+} // namespace acl
@@ -0,0 +1,47 @@
+#pragma once
+#include "acl_cpp/acl_cpp_define.hpp"
+#include <vector>
+#include "acl_cpp/stdlib/locker.hpp"
+
+struct ACL_EVENT;
+struct ACL_VSTREAM;
+
+namespace acl
+{
+
+class aio_handle;
+class aio_post_callback;
+
+/**
+ * ߳¼ͶͨȼĶУͨ eventfd
+ * (Linux)  socketpair (ƽ̨) ¼棬¼ִ߳
+ */
+class aio_post_channel
+{
+public:
+	aio_post_channel(aio_handle& handle);
+	~aio_post_channel();
+
+	bool open();
+	void enable();
+	bool post(aio_post_callback* callback);
+
+private:
+	aio_handle& handle_;
+	ACL_VSTREAM* in_;
+	ACL_SOCKET out_;
+	bool signaled_;
+	bool enabled_;
+	locker lock_;
+	std::vector<aio_post_callback*> queue_;
+	std::vector<aio_post_callback*> ready_;
+
+	void wakeup();
+	void drain();
+	void run();
+	static void cancel(std::vector<aio_post_callback*>& callbacks);
+	static void read_callback(int event_type, ACL_EVENT* event,
+		ACL_VSTREAM* stream, void* ctx);
+};
+
+} // namespace acl
@@ -1,5 +1,7 @@
 #include "acl_stdafx.hpp"
 #ifndef ACL_PREPARE_COMPILE
+#include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/string_view.hpp"
 #include "acl_cpp/stream/ifstream.hpp"
 #endif
 
@@ -10,6 +12,19 @@ bool ifstream::open_read(const char* path)
 	return open(path, O_RDONLY, 0200);
 }
 
+bool ifstream::open_mmap(const char* path)
+{
+	if (open_read(path) == false)
+		return false;
+	(void) acl_vstream_mmap(stream_);
+	return true;
+}
+
+bool ifstream::mapped(void) const
+{
+	return acl_vstream_mapped(stream_) ? true : false;
+}
+
 bool ifstream::load(acl::string* s)
 {
 	if (s == NULL)
@@ -19,14 +34,10 @@ bool ifstream::load(acl::string* s)
 	if (fseek(0, SEEK_SET) == -1)
 		return false;
 
-	char buf[4096];
-	int   ret;
-	while (1) {
-		if ((ret = read(buf, sizeof(buf), false)) < 0)
-			break;
-
-		s->append(buf, ret);
-	}
+	// ֱ(ڴӳ)еݣԼһݿ
+	string_view data;
+	while (read_ref(data, 1024 * 1024))
+		s->append(data.data(), data.size());
 
 	return true;
 }
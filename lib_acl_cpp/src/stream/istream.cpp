@@ -2,6 +2,7 @@
 #ifndef ACL_PREPARE_COMPILE
 #include "acl_cpp/stdlib/log.hpp"
 #include "acl_cpp/stdlib/string.hpp"
+#include "acl_cpp/stdlib/string_view.hpp"
 #include "acl_cpp/stream/istream.hpp"
 #endif
 
@@ -128,6 +129,39 @@ bool istream::gets(void* buf, size_t* size, bool nonl /* = true */)
 	}
 }
 
+bool istream::gets_ref(string_view& line, bool nonl /* = true */)
+{
+	const char* ptr;
+	int   ret;
+
+	if (nonl)
+		ret = acl_vstream_gets_nonl_ref(stream_, &ptr);
+	else
+		ret = acl_vstream_gets_ref(stream_, &ptr);
+	if (ret == ACL_VSTREAM_EOF) {
+		CHECK_ERROR(errno);
+		line = string_view();
+		return false;
+	}
+
+	line = string_view(ptr, (size_t) ret);
+	return true;
+}
+
+bool istream::read_ref(string_view& data, size_t max)
+{
+	const void* ptr;
+	int   ret = acl_vstream_read_ref(stream_, &ptr, max);
+	if (ret == ACL_VSTREAM_EOF) {
+		CHECK_ERROR(errno);
+		data = string_view();
+		return false;
+	}
+
+	data = string_view((const char*) ptr, (size_t) ret);
+	return true;
+}
+
 bool istream::gets(string& s, bool nonl /* = true */, size_t max /* = 0 */)
 {
 	char buf[8192];
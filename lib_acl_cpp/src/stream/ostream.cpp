@@ -45,6 +45,15 @@ int ostream::writev(const struct iovec *v, int count, bool loop /* = true */)
 	return ret;
 }
 
+int ostream::chain_write(const void* data, size_t size,
+	void (*free_fn)(void*) /* = NULL */, void* ctx /* = NULL */)
+{
+	int   ret = acl_vstream_chain_add(stream_, data, size, free_fn, ctx);
+	if (ret == ACL_VSTREAM_EOF)
+		eof_ = true;
+	return ret;
+}
+
 int ostream::vformat(const char* fmt, va_list ap)
 {
 	int   ret = acl_vstream_vfprintf(stream_, fmt, ap);